@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Audio configuration constants
+ *
+ * HFP delivers SCO audio in ~7.5ms frames:
+ * - CVSD: 8kHz,  60 samples, 120 bytes per frame
+ * - mSBC: 16kHz, 120 samples, 240 bytes per frame
+ *
+ * See docs/ARCHITECTURE.md "Audio Buffer Architecture".
+ */
+struct AudioConfig {
+    static constexpr uint32_t SAMPLE_RATE_NARROWBAND = 8000;   // CVSD codec
+    static constexpr uint32_t SAMPLE_RATE_WIDEBAND = 16000;    // mSBC codec
+
+    // Speaker and mic hardware run at this rate for every codec;
+    // narrowband SCO audio is converted 2:1 in software (HalfbandConverter)
+    static constexpr uint32_t I2S_SAMPLE_RATE = SAMPLE_RATE_WIDEBAND;
+    static constexpr uint8_t CHANNELS = 1;                      // Mono
+    static constexpr uint8_t BYTES_PER_SAMPLE = 2;              // 16-bit PCM
+
+    // M5 mic magnification. Kept 12dB below the level speech needs so close
+    // talkers don't clip; AutomaticGainControl makes up the difference
+    static constexpr uint8_t MIC_MAGNIFICATION = 4;
+
+    // Frame sizes based on HFP timing (~7.5ms per frame)
+    static constexpr uint32_t FRAME_DURATION_US = 7500;
+    static constexpr uint16_t FRAME_SAMPLES_8K = 60;    // 60 samples @ 8kHz = 7.5ms
+    static constexpr uint16_t FRAME_SAMPLES_16K = 120;  // 120 samples @ 16kHz = 7.5ms
+
+    // Buffer sizes (in bytes)
+    static constexpr size_t FRAME_SIZE_8K = FRAME_SAMPLES_8K * BYTES_PER_SAMPLE;    // 120 bytes
+    static constexpr size_t FRAME_SIZE_16K = FRAME_SAMPLES_16K * BYTES_PER_SAMPLE;  // 240 bytes
+    static constexpr size_t MAX_FRAME_SIZE = FRAME_SIZE_16K;
+
+    // Drift correction stretches an output frame by up to a couple of samples
+    static constexpr size_t MAX_OUTPUT_FRAME_SAMPLES = FRAME_SAMPLES_16K + 4;
+
+    /**
+     * Samples in one 7.5ms SCO frame at the given rate
+     */
+    static constexpr size_t frameSamples(uint32_t sampleRate) {
+        return (sampleRate == SAMPLE_RATE_NARROWBAND) ? FRAME_SAMPLES_8K : FRAME_SAMPLES_16K;
+    }
+
+    // End-to-end latency budget for the speaker path (TTS -> Speaker)
+    static constexpr uint32_t MAX_LATENCY_US = 50000;
+
+    // Task layout: Bluedroid runs on core 0 (CONFIG_BT_BLUEDROID_PINNED_TO_CORE_0),
+    // all audio processing runs on core 1
+    static constexpr int AUDIO_TASK_CORE = 1;
+    static constexpr uint8_t SPEAKER_TASK_PRIORITY = 7;  // M5 spk_task (mixer -> I2S DMA)
+    static constexpr uint8_t PLAYOUT_TASK_PRIORITY = 6;  // AudioEngine (jitter buffer -> mixer)
+    static constexpr uint8_t CAPTURE_TASK_PRIORITY = 4;  // M5MicCapture (mic -> ring)
+    static constexpr uint8_t WAKE_WORD_TASK_PRIORITY = 2; // WakeWordListener (keyword spotting between sessions)
+    static constexpr uint8_t RECORDER_TASK_PRIORITY = 1; // SessionRecorder (flash writes, core 0)
+    static constexpr uint8_t UI_TASK_PRIORITY = 1;       // M5Compositor (log + status redraws, core 0)
+
+    // Speaker I2S DMA: two descriptors of one SCO frame each (double buffering)
+    static constexpr size_t SPEAKER_DMA_BUF_COUNT = 2;
+
+    // M5.Speaker.playRaw() queues this many buffers per channel before blocking
+    static constexpr size_t SPEAKER_QUEUE_FRAMES = 2;
+};
@@ -0,0 +1,212 @@
+#include "AudioEngine.h"
+#include <cstdlib>
+#include <cstring>
+
+extern "C" {
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+}
+
+void AudioEngine::begin(IBoard* board, JitterBuffer* source, EchoCanceller* echoReference) {
+    if (m_task) return;
+
+    m_board = board;
+    m_source = source;
+    m_echoReference = echoReference;
+    m_earcons.init();
+
+    xTaskCreatePinnedToCore(
+        engineTask,
+        "audio_engine",
+        TASK_STACK,
+        this,
+        AudioConfig::PLAYOUT_TASK_PRIORITY,
+        &m_task,
+        AudioConfig::AUDIO_TASK_CORE
+    );
+}
+
+void AudioEngine::setActive(bool active) {
+    if (active) {
+        m_framesPlayed.store(0, std::memory_order_relaxed);
+        m_fillFrames.store(0, std::memory_order_relaxed);
+        m_concealedFrames.store(0, std::memory_order_relaxed);
+        m_comfortFrames.store(0, std::memory_order_relaxed);
+        m_maxPlcUs.store(0, std::memory_order_relaxed);
+        m_lateFrames.store(0, std::memory_order_relaxed);
+        m_maxPeriodUs.store(0, std::memory_order_relaxed);
+        m_maxEarconUs.store(0, std::memory_order_relaxed);
+        m_sessionReset.store(true, std::memory_order_release);
+    }
+
+    m_active.store(active, std::memory_order_release);
+    if (active && m_task) {
+        xTaskNotifyGive(m_task);
+    }
+}
+
+bool AudioEngine::playEarcon(EarconMixer::Cue cue, int16_t gain) {
+    if (!m_active.load(std::memory_order_relaxed)) return false;
+    return m_earcons.play(cue, gain);
+}
+
+AudioEngine::Stats AudioEngine::getStats() const {
+    Stats s;
+    s.framesPlayed = m_framesPlayed.load(std::memory_order_relaxed);
+    s.fillFrames = m_fillFrames.load(std::memory_order_relaxed);
+    s.concealedFrames = m_concealedFrames.load(std::memory_order_relaxed);
+    s.comfortFrames = m_comfortFrames.load(std::memory_order_relaxed);
+    s.maxPlcUs = m_maxPlcUs.load(std::memory_order_relaxed);
+    s.lateFrames = m_lateFrames.load(std::memory_order_relaxed);
+    s.maxPeriodUs = m_maxPeriodUs.load(std::memory_order_relaxed);
+    s.maxEarconUs = m_maxEarconUs.load(std::memory_order_relaxed);
+    s.driftPpm = m_drift.ppm();
+    return s;
+}
+
+// ============================================================
+// ENGINE TASK
+// ============================================================
+
+void AudioEngine::engineTask(void* arg) {
+    static_cast<AudioEngine*>(arg)->engineLoop();
+}
+
+void AudioEngine::engineLoop() {
+    while (true) {
+        if (!m_active.load(std::memory_order_acquire)) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        // Consumed here rather than on wakeup: a quick setActive(false) then
+        // setActive(true) may never leave the loop idle, but still resets
+        if (m_sessionReset.exchange(false, std::memory_order_acquire)) {
+            uint32_t rate = m_source->sampleRate();
+            m_plc.reset(rate);
+            m_comfort.reset();
+            m_drift.reset();
+            m_resampler.reset();
+            m_farEndAudible.store(false, std::memory_order_relaxed);
+            m_upsampler.reset();
+            m_earcons.reset();
+            m_linkToI2s = (rate == AudioConfig::I2S_SAMPLE_RATE) ? nullptr : &m_upsampler;
+            m_lastWriteUs = 0;
+            m_nextFrameUs = esp_timer_get_time();
+        }
+
+        size_t samples = renderFrame() / AudioConfig::BYTES_PER_SAMPLE;
+        updateFarEndLevel(samples);
+
+        // Drift compensation: stretch/shrink the frame by a few ppm so the
+        // jitter buffer neither fills nor drains against the I2S clock
+        m_drift.update(m_source->fill(), m_source->targetDepth());
+        m_resampler.setRatioPpm(m_drift.ppm());
+        size_t capacity = sizeof(m_output) / sizeof(m_output[0]);
+        if (m_linkToI2s) {
+            // Leave room to upsample in place
+            samples = m_resampler.process(m_frame, samples, m_output, capacity / 2);
+            samples = m_linkToI2s->process(m_output, samples, m_output);
+        } else {
+            samples = m_resampler.process(m_frame, samples, m_output, capacity);
+        }
+        size_t len = samples * AudioConfig::BYTES_PER_SAMPLE;
+
+        // UI cues on top of the far-end audio, at the I2S rate
+        int64_t mixStart = esp_timer_get_time();
+        if (m_earcons.mix(m_output, samples) > 0) {
+            uint32_t cost = static_cast<uint32_t>(esp_timer_get_time() - mixStart);
+            if (cost > m_maxEarconUs.load(std::memory_order_relaxed)) {
+                m_maxEarconUs.store(cost, std::memory_order_relaxed);
+            }
+        }
+
+        // Blocks while both output buffers are queued (paces us at the I2S rate)
+        m_board->writeAudio(reinterpret_cast<const uint8_t*>(m_output), len);
+        if (m_echoReference) {
+            m_echoReference->pushReference(m_output, samples);
+        }
+
+        // Output period accounting
+        int64_t now = esp_timer_get_time();
+        if (m_lastWriteUs != 0) {
+            uint32_t period = static_cast<uint32_t>(now - m_lastWriteUs);
+            if (period > m_maxPeriodUs.load(std::memory_order_relaxed)) {
+                m_maxPeriodUs.store(period, std::memory_order_relaxed);
+            }
+            if (period > LATE_PERIOD_US) {
+                m_lateFrames.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        m_lastWriteUs = now;
+
+        pace(len);
+    }
+}
+
+size_t AudioEngine::renderFrame() {
+    size_t len = m_source->pop(reinterpret_cast<uint8_t*>(m_frame), sizeof(m_frame));
+    size_t samples = len / AudioConfig::BYTES_PER_SAMPLE;
+
+    if (len > 0) {
+        m_framesPlayed.fetch_add(1, std::memory_order_relaxed);
+        if (m_plc.isCorrupt(m_frame, samples)) {
+            // Link delivered a zero-filled frame in the middle of speech
+            concealFrame(samples);
+        } else {
+            m_plc.processGood(m_frame, samples);
+            m_comfort.analyze(m_frame, samples);
+        }
+        return len;
+    }
+
+    // Priming or underrun: keep the output clock running.
+    // PLC outputs silence until it has history to work from.
+    // Comfort noise takes over once it has faded out.
+    samples = AudioConfig::frameSamples(m_source->sampleRate());
+    m_fillFrames.fetch_add(1, std::memory_order_relaxed);
+    concealFrame(samples);
+    return samples * AudioConfig::BYTES_PER_SAMPLE;
+}
+
+void AudioEngine::concealFrame(size_t samples) {
+    int64_t start = esp_timer_get_time();
+    bool synthesized = m_plc.conceal(m_frame, samples);
+    if (synthesized) {
+        m_concealedFrames.fetch_add(1, std::memory_order_relaxed);
+    } else if (m_comfort.hasModel()) {
+        m_comfort.generate(m_frame, samples);
+        m_comfortFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+    uint32_t cost = static_cast<uint32_t>(esp_timer_get_time() - start);
+
+    if (cost > m_maxPlcUs.load(std::memory_order_relaxed)) {
+        m_maxPlcUs.store(cost, std::memory_order_relaxed);
+    }
+}
+
+void AudioEngine::updateFarEndLevel(size_t samples) {
+    uint32_t level = 0;
+    for (size_t i = 0; i < samples; i++) {
+        level += static_cast<uint32_t>(abs(m_frame[i]));
+    }
+    m_farEndAudible.store(samples > 0 && level >= AUDIBLE_LEVEL * samples, std::memory_order_relaxed);
+}
+
+void AudioEngine::pace(size_t frameBytes) {
+    int64_t frameUs = static_cast<int64_t>(frameBytes / AudioConfig::BYTES_PER_SAMPLE) * 1000000
+                      / AudioConfig::I2S_SAMPLE_RATE;
+    m_nextFrameUs += frameUs;
+
+    int64_t now = esp_timer_get_time();
+    int64_t ahead = m_nextFrameUs - now;
+
+    if (ahead < -static_cast<int64_t>(AudioConfig::MAX_LATENCY_US)) {
+        // Fell far behind (e.g. blocked by a flash write) - resynchronize
+        m_nextFrameUs = now;
+    } else if (ahead > 3 * frameUs) {
+        // Sink is not blocking (speaker disabled) - don't run ahead of real time
+        vTaskDelay(pdMS_TO_TICKS((ahead - 2 * frameUs) / 1000));
+    }
+}
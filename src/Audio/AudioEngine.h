@@ -0,0 +1,153 @@
+#pragma once
+
+#include "AudioConfig.h"
+#include "ComfortNoise.h"
+#include "DriftCompensator.h"
+#include "EarconMixer.h"
+#include "EchoCanceller.h"
+#include "FractionalResampler.h"
+#include "HalfbandConverter.h"
+#include "JitterBuffer.h"
+#include "PacketLossConcealer.h"
+#include "../HAL/IBoard.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+typedef struct tskTaskControlBlock* TaskHandle_t;
+
+/**
+ * Speaker Audio Engine
+ *
+ * Owns speaker playout on a dedicated task pinned to the audio core
+ * (core 1), away from Bluedroid on core 0. The engine runs on the output
+ * clock rather than on packet arrivals:
+ *
+ *   JitterBuffer --pop--> engine task --writeAudio--> M5 mixer --> I2S DMA
+ *
+ * Jitter buffering, concealment and drift correction run at the SCO link
+ * rate. The I2S side always runs at AudioConfig::I2S_SAMPLE_RATE; for
+ * narrowband links the engine switches in a 2:1 upsampler when it is
+ * activated, so a codec change never restarts the speaker driver.
+ *
+ * - Exactly one frame is written per output period; writeAudio() blocks
+ *   while the board's double-buffered output queue is full, which paces
+ *   the loop at the I2S rate
+ * - When the jitter buffer has underrun, or hands out a frame the link
+ *   zero-filled, the packet loss concealer synthesizes a replacement;
+ *   once the concealer has faded out (or has no history), comfort noise
+ *   matched to the far end's background takes over. Before any audio has
+ *   arrived the fill frame is silence. Either way the output stream never
+ *   stalls or restarts
+ * - If the board does not block (speaker disabled), the engine paces
+ *   itself from esp_timer so it never spins
+ * - Clock drift between the phone's SCO clock and the I2S clock is
+ *   absorbed by a fractional resampler, steered by a drift compensator
+ *   that holds the jitter buffer at its target depth. The same correction
+ *   is published for the mic path (driftPpm())
+ *
+ * - UI earcons are mixed into each frame after resampling (EarconMixer),
+ *   so the echo canceller reference includes them
+ *
+ * Glitch accounting: an output period that takes more than 1.5 frames
+ * means the DMA ran dry (auto-cleared to silence) and is counted as late.
+ */
+class AudioEngine {
+public:
+    struct Stats {
+        uint32_t framesPlayed;    // Frames taken from the jitter buffer
+        uint32_t fillFrames;      // Frames filled on priming/underrun (silence or PLC)
+        uint32_t concealedFrames; // Missing/corrupt frames replaced by PLC audio
+        uint32_t comfortFrames;   // Frames filled with comfort noise (PLC faded out)
+        uint32_t maxPlcUs;        // Worst PLC/comfort noise cost for one frame
+        uint32_t lateFrames;      // Output periods over 1.5 frames (audible glitch)
+        uint32_t maxPeriodUs;     // Worst output period seen
+        uint32_t maxEarconUs;     // Worst earcon mix cost for one frame
+        float driftPpm;           // Current SCO vs. I2S clock correction
+    };
+
+    /**
+     * Start the engine task (idle until setActive(true))
+     * @param board Speaker sink
+     * @param source Jitter buffer fed by the SCO incoming-audio callback
+     * @param echoReference Receives every sample written to the board (optional)
+     */
+    void begin(IBoard* board, JitterBuffer* source, EchoCanceller* echoReference = nullptr);
+
+    /**
+     * Start/stop playout (SCO link up/down)
+     * Statistics are cleared on activation.
+     */
+    void setActive(bool active);
+
+    bool isActive() const { return m_active.load(std::memory_order_relaxed); }
+
+    Stats getStats() const;
+
+    /**
+     * Current clock drift correction (positive = SCO clock runs fast)
+     * Safe to call from any task.
+     */
+    float driftPpm() const { return m_drift.ppm(); }
+
+    /**
+     * Far-end audio is currently playing (last frame above AUDIBLE_LEVEL)
+     * Safe to call from any task.
+     */
+    bool isFarEndAudible() const { return m_farEndAudible.load(std::memory_order_relaxed); }
+
+    /**
+     * Mix a UI cue into the speaker stream (from the loop task)
+     * @return false if playout is not active or the cue queue is full
+     */
+    bool playEarcon(EarconMixer::Cue cue, int16_t gain = EarconMixer::DEFAULT_GAIN);
+
+    /**
+     * Rendered cue samples, for the board speaker when playout is not active
+     */
+    const int16_t* earconClip(EarconMixer::Cue cue, size_t* length) const { return m_earcons.clip(cue, length); }
+
+    EarconMixer::Stats getEarconStats() const { return m_earcons.getStats(); }
+
+private:
+    static constexpr uint32_t TASK_STACK = 4096;
+    static constexpr uint32_t LATE_PERIOD_US = AudioConfig::FRAME_DURATION_US * 3 / 2;
+    static constexpr uint32_t AUDIBLE_LEVEL = 64;  // Mean |x| of a frame with far-end audio
+
+    IBoard* m_board = nullptr;
+    JitterBuffer* m_source = nullptr;
+    EchoCanceller* m_echoReference = nullptr;
+    TaskHandle_t m_task = nullptr;
+    std::atomic<bool> m_active{false};
+    std::atomic<bool> m_sessionReset{false};   // Set by setActive(true), consumed by the task
+    std::atomic<bool> m_farEndAudible{false};
+
+    // Engine-task state
+    int16_t m_frame[AudioConfig::MAX_FRAME_SIZE / AudioConfig::BYTES_PER_SAMPLE];
+    alignas(16) int16_t m_output[AudioConfig::MAX_OUTPUT_FRAME_SAMPLES];
+    PacketLossConcealer m_plc;
+    ComfortNoise m_comfort;
+    DriftCompensator m_drift;
+    FractionalResampler m_resampler;
+    HalfbandUpsampler m_upsampler;
+    HalfbandUpsampler* m_linkToI2s = nullptr;  // nullptr when the link runs at the I2S rate
+    EarconMixer m_earcons;
+    int64_t m_lastWriteUs = 0;
+    int64_t m_nextFrameUs = 0;
+
+    std::atomic<uint32_t> m_framesPlayed{0};
+    std::atomic<uint32_t> m_fillFrames{0};
+    std::atomic<uint32_t> m_concealedFrames{0};
+    std::atomic<uint32_t> m_comfortFrames{0};
+    std::atomic<uint32_t> m_maxPlcUs{0};
+    std::atomic<uint32_t> m_lateFrames{0};
+    std::atomic<uint32_t> m_maxPeriodUs{0};
+    std::atomic<uint32_t> m_maxEarconUs{0};
+
+    static void engineTask(void* arg);
+    void engineLoop();
+    size_t renderFrame();
+    void concealFrame(size_t samples);
+    void updateFarEndLevel(size_t samples);
+    void pace(size_t frameBytes);
+};
@@ -0,0 +1,87 @@
+#include "AutomaticGainControl.h"
+#include "DspKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+// std::min/max take these by reference, which needs a definition in C++11
+constexpr int32_t AutomaticGainControl::MIN_GAIN;
+constexpr int32_t AutomaticGainControl::MAX_GAIN;
+
+void AutomaticGainControl::reset(uint32_t sampleRate) {
+    m_subBlock = sampleRate / 1000;
+    m_envelope = 0;
+    m_gain = INITIAL_GAIN;
+
+    m_gainStat.store(INITIAL_GAIN, std::memory_order_relaxed);
+    m_clippedSamples.store(0, std::memory_order_relaxed);
+    m_limitedBlocks.store(0, std::memory_order_relaxed);
+    m_gatedBlocks.store(0, std::memory_order_relaxed);
+}
+
+AutomaticGainControl::Stats AutomaticGainControl::getStats() const {
+    Stats s;
+    s.gainDb = 20.0f * log10f(static_cast<float>(m_gainStat.load(std::memory_order_relaxed)) / UNITY);
+    s.clippedSamples = m_clippedSamples.load(std::memory_order_relaxed);
+    s.limitedBlocks = m_limitedBlocks.load(std::memory_order_relaxed);
+    s.gatedBlocks = m_gatedBlocks.load(std::memory_order_relaxed);
+    return s;
+}
+
+void AutomaticGainControl::process(const int16_t* in, int16_t* out, size_t samples) {
+    bool adapt = m_enabled.load(std::memory_order_relaxed);
+    if (!adapt) {
+        m_gain = INITIAL_GAIN;
+    }
+
+    while (samples > 0) {
+        size_t n = std::min(samples, m_subBlock);
+        processSubBlock(in, out, n, adapt);
+        in += n;
+        out += n;
+        samples -= n;
+    }
+    m_gainStat.store(m_gain, std::memory_order_relaxed);
+}
+
+// ============================================================
+// GAIN COMPUTER
+// ============================================================
+
+void AutomaticGainControl::processSubBlock(const int16_t* in, int16_t* out, size_t samples, bool adapt) {
+    int32_t peak = 0;
+    uint32_t clipped = 0;
+    for (size_t i = 0; i < samples; i++) {
+        int32_t mag = abs(static_cast<int32_t>(in[i]));
+        peak = std::max(peak, mag);
+        clipped += (mag >= 32767);
+    }
+    if (clipped) m_clippedSamples.fetch_add(clipped, std::memory_order_relaxed);
+
+    if (adapt) {
+        // Envelope: jump to louder peaks, decay toward softer ones. The step
+        // rounds up so the envelope settles on the peak rather than up to
+        // 63 above it, which would keep quiet noise out of the gate.
+        int32_t decay = (m_envelope - peak + (1 << ENVELOPE_DECAY_SHIFT) - 1) >> ENVELOPE_DECAY_SHIFT;
+        m_envelope = std::max(peak, m_envelope - decay);
+
+        if (m_envelope < GATE_LEVEL) {
+            m_gatedBlocks.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            // Fast attack (drop straight to the target), slow recovery
+            int32_t desired = std::min(std::max((TARGET_PEAK << GAIN_SHIFT) / m_envelope, MIN_GAIN), MAX_GAIN);
+            m_gain = std::min(desired, m_gain + (m_gain >> GAIN_RECOVERY_SHIFT) + 1);
+        }
+    }
+
+    // Limiter: the gain for this sub-block keeps its peak under LIMIT_PEAK.
+    // The peak is known before the gain is applied (1ms look-ahead).
+    int32_t gain = m_gain;
+    if (peak * (gain >> 4) > (LIMIT_PEAK << (GAIN_SHIFT - 4))) {
+        gain = (LIMIT_PEAK << GAIN_SHIFT) / peak;
+        m_limitedBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Q12 gain tops out just under 16x, so it fits the kernel's int16 as Q11
+    Dsp::gainQ15(in, out, samples, static_cast<int16_t>(gain >> 1), GAIN_SHIFT - 1);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "AudioConfig.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Mic-path Automatic Gain Control
+ *
+ * Brings soft and close talkers to the same level before the phone's
+ * speech recognizer hears them. The mic is captured with headroom
+ * (AudioConfig::MIC_MAGNIFICATION) and the AGC makes up the gain.
+ *
+ * - Peak envelope per 1ms sub-block: instant attack, ~64ms decay
+ * - Gain steers the envelope toward TARGET_PEAK: it drops at once when
+ *   the input gets louder and recovers at ~8dB/s when it gets softer
+ * - Noise gate: below GATE_LEVEL the gain is held, so pauses and
+ *   background noise are not pumped up
+ * - Peak limiter: the gain for a sub-block is capped so its peak stays
+ *   under LIMIT_PEAK (the sub-block is its own 1ms look-ahead)
+ *
+ * Fixed point throughout (Q12 gain, at most two divisions per 1ms
+ * sub-block, min/max instead of branches in the sample loops), so it
+ * stays cheap on the ESP32-PICO in the StickC Plus2.
+ *
+ * Threading: setEnabled()/getStats() from any task, everything else from
+ * the mic path (SCO outgoing-audio callback).
+ */
+class AutomaticGainControl {
+public:
+    struct Stats {
+        float gainDb;             // Current gain
+        uint32_t clippedSamples;  // Input samples at full scale (clipped before the AGC)
+        uint32_t limitedBlocks;   // Sub-blocks where the limiter capped the gain
+        uint32_t gatedBlocks;     // Sub-blocks below the noise gate (gain held)
+    };
+
+    /**
+     * Clear state and configure for a link rate (mic path side)
+     * @param sampleRate 8000 or 16000
+     */
+    void reset(uint32_t sampleRate);
+
+    /**
+     * Runtime switch; while disabled the stage applies a fixed gain equal
+     * to the old hard-coded mic magnification (the limiter stays on)
+     */
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * Apply gain to one block of mic samples
+     * @param in Input samples
+     * @param out Output samples (may alias in)
+     * @param samples Sample count
+     */
+    void process(const int16_t* in, int16_t* out, size_t samples);
+
+    Stats getStats() const;
+
+private:
+    static constexpr int GAIN_SHIFT = 12;
+    static constexpr int32_t UNITY = 1 << GAIN_SHIFT;
+    static constexpr int32_t INITIAL_GAIN = UNITY * 16 / AudioConfig::MIC_MAGNIFICATION;
+    static constexpr int32_t MIN_GAIN = UNITY / 4;                   // -12dB
+    static constexpr int32_t MAX_GAIN = 64925;                       // +24dB (keeps x * gain in int32)
+
+    static constexpr int32_t TARGET_PEAK = 8192;    // -12dBFS
+    static constexpr int32_t LIMIT_PEAK = 29205;    // -1dBFS
+    static constexpr int32_t GATE_LEVEL = 100;      // Envelope below this is not speech
+    static constexpr int ENVELOPE_DECAY_SHIFT = 6;  // 64 sub-blocks
+    static constexpr int GAIN_RECOVERY_SHIFT = 10;  // +1/1024 per sub-block, ~8dB/s
+
+    std::atomic<bool> m_enabled{true};
+
+    size_t m_subBlock = AudioConfig::SAMPLE_RATE_WIDEBAND / 1000;
+    int32_t m_envelope = 0;
+    int32_t m_gain = INITIAL_GAIN;
+
+    std::atomic<int32_t> m_gainStat{INITIAL_GAIN};
+    std::atomic<uint32_t> m_clippedSamples{0};
+    std::atomic<uint32_t> m_limitedBlocks{0};
+    std::atomic<uint32_t> m_gatedBlocks{0};
+
+    void processSubBlock(const int16_t* in, int16_t* out, size_t samples, bool adapt);
+};
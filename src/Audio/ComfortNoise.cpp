@@ -0,0 +1,129 @@
+#include "ComfortNoise.h"
+#include "DspKernels.h"
+#include <cmath>
+#include <cstring>
+
+static constexpr float FULL_SCALE_POWER = 32768.0f * 32768.0f;
+
+static inline int16_t saturate16(float v) {
+    if (v > 32767.0f) return 32767;
+    if (v < -32768.0f) return -32768;
+    return static_cast<int16_t>(v);
+}
+
+void ComfortNoise::reset() {
+    m_floorValid = false;
+    m_backgroundFrames = 0;
+    m_modelDirty = false;
+    memset(m_autocorr, 0, sizeof(m_autocorr));
+    memset(m_lpc, 0, sizeof(m_lpc));
+    memset(m_history, 0, sizeof(m_history));
+
+    // White noise at the default level: variance of uniform [-1, 1) is 1/3
+    float power = FULL_SCALE_POWER * powf(10.0f, DEFAULT_LEVEL_DB / 10.0f);
+    m_excitation = sqrtf(3.0f * power);
+}
+
+float ComfortNoise::levelDb() const {
+    if (!hasModel() || m_autocorr[0] <= 0.0f) return DEFAULT_LEVEL_DB;
+    return 10.0f * log10f(m_autocorr[0] / FULL_SCALE_POWER);
+}
+
+// ============================================================
+// ANALYSIS
+// ============================================================
+
+void ComfortNoise::analyze(const int16_t* samples, size_t count) {
+    while (count > 0) {
+        size_t n = (count > MAX_CHUNK) ? MAX_CHUNK : count;
+        analyzeChunk(samples, n);
+        samples += n;
+        count -= n;
+    }
+}
+
+void ComfortNoise::analyzeChunk(const int16_t* samples, size_t count) {
+    if (count <= ORDER) return;
+    for (size_t i = 0; i < count; i++) {
+        m_work[i] = samples[i];
+    }
+
+    float r[ORDER + 1];
+    for (size_t k = 0; k <= ORDER; k++) {
+        r[k] = Dsp::dotProduct(m_work, m_work + k, count - k) / static_cast<float>(count);
+    }
+
+    // Noise floor: follow dips at once, creep up slowly
+    float levelDb = 10.0f * log10f(r[0] / FULL_SCALE_POWER + 1e-10f);
+    if (!m_floorValid || levelDb < m_floorDb) {
+        m_floorDb = levelDb;
+        m_floorValid = true;
+    } else {
+        m_floorDb += FLOOR_RISE_DB;
+    }
+    if (levelDb > m_floorDb + BACKGROUND_DB) return;
+
+    float weight = (m_backgroundFrames == 0) ? 1.0f : (1.0f - SMOOTHING);
+    for (size_t k = 0; k <= ORDER; k++) {
+        m_autocorr[k] += weight * (r[k] - m_autocorr[k]);
+    }
+    m_backgroundFrames++;
+    m_modelDirty = true;
+}
+
+void ComfortNoise::updateModel() {
+    m_modelDirty = false;
+
+    // Levinson-Durbin
+    float err = m_autocorr[0] * WHITE_NOISE_CORRECTION;
+    if (err <= 0.0f) {
+        m_excitation = 0.0f;   // Digital silence is the background
+        return;
+    }
+    float a[ORDER + 1] = {1.0f};
+    for (size_t i = 1; i <= ORDER; i++) {
+        float acc = m_autocorr[i];
+        for (size_t j = 1; j < i; j++) {
+            acc += a[j] * m_autocorr[i - j];
+        }
+        float k = -acc / err;
+
+        float prev[ORDER + 1];
+        memcpy(prev, a, sizeof(a));
+        for (size_t j = 1; j < i; j++) {
+            a[j] = prev[j] + k * prev[i - j];
+        }
+        a[i] = k;
+        err *= 1.0f - k * k;
+        if (err <= 0.0f) {
+            err = 0.0f;
+            break;
+        }
+    }
+
+    memcpy(m_lpc, a + 1, sizeof(m_lpc));
+    m_excitation = sqrtf(3.0f * err);
+}
+
+// ============================================================
+// SYNTHESIS
+// ============================================================
+
+void ComfortNoise::generate(int16_t* out, size_t count) {
+    if (m_modelDirty) {
+        updateModel();
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        m_seed = m_seed * 1664525u + 1013904223u;
+        float noise = static_cast<float>(static_cast<int32_t>(m_seed)) * (1.0f / 2147483648.0f);
+
+        float y = m_excitation * noise;
+        for (size_t j = 0; j < ORDER; j++) {
+            y -= m_lpc[j] * m_history[j];
+        }
+        memmove(m_history + 1, m_history, (ORDER - 1) * sizeof(float));
+        m_history[0] = y;
+        out[i] = saturate16(y);
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Comfort Noise Generator
+ *
+ * Fills frames that would otherwise be dead silence (speaker underruns
+ * past the concealer, failed mic reads) with noise shaped like the
+ * stream's own background, in the style of RFC 3389:
+ *
+ * - analyze() sees every good frame and tracks the noise floor (follows
+ *   dips at once, creeps up slowly); frames within BACKGROUND_DB of it
+ *   are background and update a smoothed autocorrelation
+ * - generate() drives an order-10 all-pole LPC filter (Levinson-Durbin
+ *   on that autocorrelation) with white noise scaled to the background
+ *   level
+ *
+ * Before any background has been seen the output is white noise at
+ * DEFAULT_LEVEL_DB. The cost is a few microseconds per frame.
+ *
+ * Not thread-safe; one instance per direction, owned by that path's task.
+ */
+class ComfortNoise {
+public:
+    static constexpr size_t ORDER = 10;
+    static constexpr float BACKGROUND_DB = 6.0f;
+    static constexpr float DEFAULT_LEVEL_DB = -70.0f;   // dBFS
+
+    /**
+     * Forget the background model (new stream)
+     */
+    void reset();
+
+    /**
+     * Observe a good frame (any content; only background updates the model)
+     */
+    void analyze(const int16_t* samples, size_t count);
+
+    /**
+     * Write count samples of comfort noise
+     */
+    void generate(int16_t* out, size_t count);
+
+    /**
+     * A background model has been measured
+     */
+    bool hasModel() const { return m_backgroundFrames > 0; }
+
+    /**
+     * Background level in dBFS (DEFAULT_LEVEL_DB until measured)
+     */
+    float levelDb() const;
+
+private:
+    static constexpr size_t MAX_CHUNK = 256;
+    static constexpr float FLOOR_RISE_DB = 0.02f;   // Per analyzed frame
+    static constexpr float SMOOTHING = 0.9f;        // Autocorrelation average across frames
+    static constexpr float WHITE_NOISE_CORRECTION = 1.0001f;   // -40dB floor keeps the LPC stable
+
+    float m_floorDb = 0.0f;
+    bool m_floorValid = false;
+    uint32_t m_backgroundFrames = 0;
+    float m_autocorr[ORDER + 1];    // Per-sample, smoothed
+    bool m_modelDirty = false;
+
+    float m_lpc[ORDER];             // a[1..ORDER]: x[n] = e[n] - sum a[j] x[n-j]
+    float m_excitation = 0.0f;      // Uniform noise amplitude
+    float m_history[ORDER];         // Synthesis filter memory, newest first
+    uint32_t m_seed = 1;
+
+    alignas(16) float m_work[MAX_CHUNK];
+
+    void analyzeChunk(const int16_t* samples, size_t count);
+    void updateModel();
+};
@@ -0,0 +1,30 @@
+#include "DriftCompensator.h"
+
+void DriftCompensator::reset() {
+    m_fillAvg = 0.0f;
+    m_integral = 0.0f;
+    m_primed = false;
+    m_ppm.store(0.0f, std::memory_order_relaxed);
+}
+
+void DriftCompensator::update(uint32_t fill, uint32_t target) {
+    float f = static_cast<float>(fill);
+    if (!m_primed) {
+        m_fillAvg = f;
+        m_primed = true;
+    } else {
+        m_fillAvg += (f - m_fillAvg) * FILL_SMOOTHING;
+    }
+
+    float error = m_fillAvg - static_cast<float>(target);
+
+    // Integrate, with anti-windup: the integral alone never exceeds the limit
+    m_integral += KI * error;
+    if (m_integral > MAX_PPM) m_integral = MAX_PPM;
+    if (m_integral < -MAX_PPM) m_integral = -MAX_PPM;
+
+    float ppm = KP * error + m_integral;
+    if (ppm > MAX_PPM) ppm = MAX_PPM;
+    if (ppm < -MAX_PPM) ppm = -MAX_PPM;
+    m_ppm.store(ppm, std::memory_order_relaxed);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * SCO vs. I2S Clock Drift Compensator
+ *
+ * The phone's SCO clock and the badge's I2S clock differ by up to a few
+ * hundred ppm. Uncorrected, the speaker jitter buffer slowly fills (adding
+ * latency until frames are trimmed) or drains (underruns) over a long
+ * answer, and the mic ring drifts the same way in the other direction.
+ *
+ * A PI controller watches the smoothed jitter-buffer fill against its
+ * target depth and produces a ppm correction:
+ * - Playout resampler runs at +ppm (fill above target -> consume faster)
+ * - Mic resampler runs at -ppm (the phone consumes mic audio at the same
+ *   relative rate it produces speaker audio)
+ *
+ * update() is called from the audio engine once per output frame;
+ * ppm() may be read from any task.
+ */
+class DriftCompensator {
+public:
+    // Correction limit, comfortably above worst-case crystal tolerance
+    static constexpr float MAX_PPM = 1000.0f;
+
+    void reset();
+
+    /**
+     * Feed one observation of the speaker jitter buffer
+     * @param fill Frames currently buffered
+     * @param target Target depth in frames
+     */
+    void update(uint32_t fill, uint32_t target);
+
+    /**
+     * Current correction (positive = SCO clock faster than I2S)
+     */
+    float ppm() const { return m_ppm.load(std::memory_order_relaxed); }
+
+private:
+    // Tuned for 7.5ms updates: fill EMA ~0.5s, integral time ~8s
+    static constexpr float FILL_SMOOTHING = 1.0f / 64.0f;
+    static constexpr float KP = 40.0f;      // ppm per frame of error
+    static constexpr float KI = 0.04f;      // ppm per frame of error per update
+
+    float m_fillAvg = 0.0f;
+    float m_integral = 0.0f;
+    bool m_primed = false;
+    std::atomic<float> m_ppm{0.0f};
+};
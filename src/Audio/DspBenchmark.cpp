@@ -0,0 +1,247 @@
+#include "DspBenchmark.h"
+#include "DspKernels.h"
+#include "Fft.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+extern "C" {
+#include "esp_cpu.h"
+}
+
+typedef void (*KernelFn)();
+
+static constexpr size_t FRAME = DspBenchmark::FRAME;
+static constexpr size_t STAGES = 4;
+static constexpr size_t FFT_POINTS = 256;
+
+// Inputs (PIE paths need 16-byte alignment)
+alignas(16) static int16_t s_q15A[FRAME];
+alignas(16) static int16_t s_q15B[FRAME];
+alignas(16) static int8_t s_q7A[FRAME];
+alignas(16) static int8_t s_q7B[FRAME];
+alignas(16) static float s_floatA[2 * FRAME];
+alignas(16) static float s_floatB[2 * FRAME];
+static int16_t s_stateQ15[4 * STAGES];
+static float s_state[2 * STAGES];
+
+// Kernel output, and the reference's output for comparison
+union BenchOutput {
+    int16_t q15[FRAME];
+    float f[2 * FFT_POINTS];
+    int64_t i64;
+    int32_t i32;
+};
+alignas(16) static BenchOutput s_out;
+static BenchOutput s_ref;
+static size_t s_outBytes;
+
+static const Biquad BIQUAD = {0.2f, 0.4f, 0.2f, -0.6f, 0.2f};
+static const BiquadQ15 BIQUAD_Q15 = {3277, 6554, 3277, -9830, 3277};
+static Biquad s_biquads[STAGES];
+static BiquadQ15 s_biquadsQ15[STAGES];
+static Fft s_fft;
+
+// ============================================================
+// KERNEL WRAPPERS (one frame each; filters restart from zero state)
+// ============================================================
+
+template <class D> static void dotQ15() {
+    s_out.i64 = D::dotProductQ15(s_q15A, s_q15B, FRAME);
+    s_outBytes = sizeof(s_out.i64);
+}
+
+template <class D> static void mixQ15() {
+    D::mixQ15(s_q15A, s_q15B, s_out.q15, FRAME);
+    s_outBytes = FRAME * sizeof(int16_t);
+}
+
+template <class D> static void gainQ15() {
+    D::gainQ15(s_q15A, s_out.q15, FRAME, 23170, 15);   // -3dB (a boost skips the PIE path)
+    s_outBytes = FRAME * sizeof(int16_t);
+}
+
+template <class D> static void windowQ15() {
+    D::windowQ15(s_q15A, s_q15B, s_out.q15, FRAME);
+    s_outBytes = FRAME * sizeof(int16_t);
+}
+
+template <class D> static void biquadQ15() {
+    memset(s_stateQ15, 0, sizeof(s_stateQ15));
+    D::biquadCascadeQ15(s_biquadsQ15, s_stateQ15, STAGES, s_q15A, s_out.q15, FRAME);
+    s_outBytes = FRAME * sizeof(int16_t);
+}
+
+template <class D> static void dotQ7() {
+    s_out.i32 = D::dotProductQ7(s_q7A, s_q7B, FRAME);
+    s_outBytes = sizeof(s_out.i32);
+}
+
+template <class D> static void dot() {
+    s_out.f[0] = D::dotProduct(s_floatA, s_floatB, FRAME);
+    s_outBytes = sizeof(float);
+}
+
+template <class D> static void mix() {
+    D::mix(s_floatA, s_floatB, s_out.f, FRAME);
+    s_outBytes = FRAME * sizeof(float);
+}
+
+template <class D> static void scale() {
+    D::scale(s_floatA, s_out.f, FRAME, 1.4142f);
+    s_outBytes = FRAME * sizeof(float);
+}
+
+template <class D> static void multiply() {
+    D::multiply(s_floatA, s_floatB, s_out.f, FRAME);
+    s_outBytes = FRAME * sizeof(float);
+}
+
+template <class D> static void biquad() {
+    memset(s_state, 0, sizeof(s_state));
+    D::biquadCascade(s_biquads, s_state, STAGES, s_floatA, s_out.f, FRAME);
+    s_outBytes = FRAME * sizeof(float);
+}
+
+template <class D> static void complexMac() {
+    memset(s_out.f, 0, FRAME * sizeof(float));
+    D::complexMac(s_floatA, s_floatB, s_out.f, FRAME / 2, true);
+    s_outBytes = FRAME * sizeof(float);
+}
+
+static void fftComplex() {
+    for (size_t i = 0; i < FFT_POINTS; i++) {
+        s_out.f[2 * i] = (i < FRAME) ? s_floatA[i] : 0.0f;
+        s_out.f[2 * i + 1] = 0.0f;
+    }
+    s_fft.forward(s_out.f);
+    s_outBytes = (FFT_POINTS / 2 + 1) * 2 * sizeof(float);
+}
+
+static void fftReal() {
+    memcpy(s_out.f, s_floatA, FRAME * sizeof(float));
+    memset(s_out.f + FRAME, 0, (FFT_POINTS - FRAME) * sizeof(float));
+    s_fft.forwardReal(s_out.f);
+    s_outBytes = (FFT_POINTS / 2 + 1) * 2 * sizeof(float);
+}
+
+// ============================================================
+// HARNESS
+// ============================================================
+
+static uint32_t cyclesPerFrame(KernelFn fn) {
+    fn();  // Warm the cache
+    uint32_t start = esp_cpu_get_ccount();
+    for (uint32_t i = 0; i < DspBenchmark::ITERATIONS; i++) {
+        fn();
+    }
+    return (esp_cpu_get_ccount() - start) / DspBenchmark::ITERATIONS;
+}
+
+/**
+ * Run fn once and compare with the stored reference output
+ * @return 0 when bit-exact, otherwise the worst relative error (floats)
+ *         or -1 (integers)
+ */
+static float compareWithReference(KernelFn fn, bool isFloat) {
+    fn();
+    if (memcmp(&s_out, &s_ref, s_outBytes) == 0) return 0.0f;
+    if (!isFloat) return -1.0f;
+
+    float scale = 1e-20f;
+    float worst = 0.0f;
+    for (size_t i = 0; i < s_outBytes / sizeof(float); i++) {
+        scale = fmaxf(scale, fabsf(s_ref.f[i]));
+    }
+    for (size_t i = 0; i < s_outBytes / sizeof(float); i++) {
+        worst = fmaxf(worst, fabsf(s_out.f[i] - s_ref.f[i]) / scale);
+    }
+    return worst;
+}
+
+static void describe(char* text, size_t size, float error) {
+    if (error == 0.0f) {
+        snprintf(text, size, "exact");
+    } else if (error < 0.0f) {
+        snprintf(text, size, "MISMATCH");
+    } else {
+        snprintf(text, size, "err %.1e", static_cast<double>(error));
+    }
+}
+
+static void benchKernel(IBoard* board, const char* name, bool isFloat,
+                        KernelFn ref, KernelFn xtensa, KernelFn pie) {
+    ref();
+    memcpy(&s_ref, &s_out, s_outBytes);
+    uint32_t refCycles = cyclesPerFrame(ref);
+
+    char xtResult[16];
+    describe(xtResult, sizeof(xtResult), compareWithReference(xtensa, isFloat));
+    uint32_t xtCycles = cyclesPerFrame(xtensa);
+
+    if (pie) {
+        char pieResult[16];
+        describe(pieResult, sizeof(pieResult), compareWithReference(pie, isFloat));
+        uint32_t pieCycles = cyclesPerFrame(pie);
+        board->logf("[DSP] %-10s ref %5u xt %5u pie %5u cyc  %s/%s",
+            name, refCycles, xtCycles, pieCycles, xtResult, pieResult);
+    } else {
+        board->logf("[DSP] %-10s ref %5u xt %5u cyc  %s", name, refCycles, xtCycles, xtResult);
+    }
+}
+
+void DspBenchmark::run(IBoard* board) {
+    // Deterministic full-scale test signals
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < FRAME; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        s_q15A[i] = static_cast<int16_t>(seed >> 16);
+        seed = seed * 1664525u + 1013904223u;
+        s_q15B[i] = static_cast<int16_t>(seed >> 16);
+        s_q7A[i] = static_cast<int8_t>(s_q15A[i] >> 8);
+        s_q7B[i] = static_cast<int8_t>(s_q15B[i] >> 8);
+    }
+    for (size_t i = 0; i < 2 * FRAME; i++) {
+        s_floatA[i] = s_q15A[i % FRAME] / 32768.0f;
+        s_floatB[i] = s_q15B[(i * 7) % FRAME] / 32768.0f;
+    }
+    for (size_t s = 0; s < STAGES; s++) {
+        s_biquads[s] = BIQUAD;
+        s_biquadsQ15[s] = BIQUAD_Q15;
+    }
+    s_fft.init(FFT_POINTS);
+
+    board->logf("[DSP] %u samples/frame, %u runs", static_cast<unsigned>(FRAME),
+        static_cast<unsigned>(ITERATIONS));
+
+#if defined(DSP_HAS_PIE)
+#define DSP_PIE_VARIANT(kernel) (&kernel<DspPie>)
+#else
+#define DSP_PIE_VARIANT(kernel) (static_cast<KernelFn>(nullptr))
+#endif
+
+    benchKernel(board, "dotQ15", false, &dotQ15<DspReference>, &dotQ15<DspXtensa>, DSP_PIE_VARIANT(dotQ15));
+    benchKernel(board, "mixQ15", false, &mixQ15<DspReference>, &mixQ15<DspXtensa>, DSP_PIE_VARIANT(mixQ15));
+    benchKernel(board, "gainQ15", false, &gainQ15<DspReference>, &gainQ15<DspXtensa>, DSP_PIE_VARIANT(gainQ15));
+    benchKernel(board, "windowQ15", false, &windowQ15<DspReference>, &windowQ15<DspXtensa>, DSP_PIE_VARIANT(windowQ15));
+    benchKernel(board, "biquadQ15", false, &biquadQ15<DspReference>, &biquadQ15<DspXtensa>, DSP_PIE_VARIANT(biquadQ15));
+    benchKernel(board, "dotQ7", false, &dotQ7<DspReference>, &dotQ7<DspXtensa>, DSP_PIE_VARIANT(dotQ7));
+    benchKernel(board, "dot", true, &dot<DspReference>, &dot<DspXtensa>, DSP_PIE_VARIANT(dot));
+    benchKernel(board, "mix", true, &mix<DspReference>, &mix<DspXtensa>, DSP_PIE_VARIANT(mix));
+    benchKernel(board, "scale", true, &scale<DspReference>, &scale<DspXtensa>, DSP_PIE_VARIANT(scale));
+    benchKernel(board, "multiply", true, &multiply<DspReference>, &multiply<DspXtensa>, DSP_PIE_VARIANT(multiply));
+    benchKernel(board, "biquad", true, &biquad<DspReference>, &biquad<DspXtensa>, DSP_PIE_VARIANT(biquad));
+    benchKernel(board, "cmac", true, &complexMac<DspReference>, &complexMac<DspXtensa>, DSP_PIE_VARIANT(complexMac));
+
+#undef DSP_PIE_VARIANT
+
+    // Real FFT against the complex transform of the same frame, zero-padded
+    fftComplex();
+    memcpy(&s_ref, &s_out, s_outBytes);
+    uint32_t complexCycles = cyclesPerFrame(&fftComplex);
+    char result[16];
+    describe(result, sizeof(result), compareWithReference(&fftReal, true));
+    uint32_t realCycles = cyclesPerFrame(&fftReal);
+    board->logf("[DSP] fft%-7u cplx %5u real %5u cyc  %s",
+        static_cast<unsigned>(FFT_POINTS), complexCycles, realCycles, result);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "../HAL/IBoard.h"
+
+/**
+ * DSP Kernel Benchmark
+ *
+ * Times every DspKernels variant built for this target on one 120-sample
+ * frame (7.5ms at 16kHz) and checks its output against DspReference on
+ * the same input. One log line per kernel:
+ *
+ *   [DSP] mixQ15     ref  1234 xt   456 pie   78 cyc  exact
+ *
+ * "exact" means bit-identical to the reference; float reductions that
+ * sum in a different order report their worst relative error instead.
+ *
+ * Build with -DDSP_BENCHMARK (platformio.ini) to run it once at boot.
+ */
+class DspBenchmark {
+public:
+    static constexpr size_t FRAME = 120;
+    static constexpr uint32_t ITERATIONS = 64;
+
+    static void run(IBoard* board);
+};
@@ -0,0 +1,356 @@
+#include "DspKernels.h"
+
+static inline int16_t saturate16(int32_t v) {
+    if (v > 32767) return 32767;
+    if (v < -32768) return -32768;
+    return static_cast<int16_t>(v);
+}
+
+static inline int16_t saturate16(int64_t v) {
+    if (v > 32767) return 32767;
+    if (v < -32768) return -32768;
+    return static_cast<int16_t>(v);
+}
+
+// ============================================================
+// REFERENCE (portable, one sample at a time)
+// ============================================================
+
+int64_t DspReference::dotProductQ15(const int16_t* a, const int16_t* b, size_t n) {
+    int64_t acc = 0;
+    for (size_t i = 0; i < n; i++) {
+        acc += static_cast<int32_t>(a[i]) * b[i];
+    }
+    return acc;
+}
+
+void DspReference::mixQ15(const int16_t* a, const int16_t* b, int16_t* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = saturate16(static_cast<int32_t>(a[i]) + b[i]);
+    }
+}
+
+void DspReference::gainQ15(const int16_t* in, int16_t* out, size_t n, int16_t gain, int shift) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = saturate16((static_cast<int32_t>(in[i]) * gain) >> shift);
+    }
+}
+
+void DspReference::windowQ15(const int16_t* in, const int16_t* window, int16_t* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = saturate16((static_cast<int32_t>(in[i]) * window[i]) >> 15);
+    }
+}
+
+void DspReference::biquadCascadeQ15(const BiquadQ15* stages, int16_t* state, size_t stageCount,
+                                    const int16_t* in, int16_t* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        int16_t x = in[i];
+        for (size_t s = 0; s < stageCount; s++) {
+            const BiquadQ15& q = stages[s];
+            int16_t* st = state + 4 * s;
+            int64_t acc = static_cast<int64_t>(q.b0) * x + static_cast<int64_t>(q.b1) * st[0]
+                        + static_cast<int64_t>(q.b2) * st[1] - static_cast<int64_t>(q.a1) * st[2]
+                        - static_cast<int64_t>(q.a2) * st[3];
+            int16_t y = saturate16((acc + (1 << 13)) >> 14);
+            st[1] = st[0];
+            st[0] = x;
+            st[3] = st[2];
+            st[2] = y;
+            x = y;
+        }
+        out[i] = x;
+    }
+}
+
+int32_t DspReference::dotProductQ7(const int8_t* a, const int8_t* b, size_t n) {
+    int32_t acc = 0;
+    for (size_t i = 0; i < n; i++) {
+        acc += static_cast<int32_t>(a[i]) * b[i];
+    }
+    return acc;
+}
+
+float DspReference::dotProduct(const float* a, const float* b, size_t n) {
+    float acc = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        acc += a[i] * b[i];
+    }
+    return acc;
+}
+
+void DspReference::mix(const float* a, const float* b, float* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = a[i] + b[i];
+    }
+}
+
+void DspReference::scale(const float* in, float* out, size_t n, float gain) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = in[i] * gain;
+    }
+}
+
+void DspReference::multiply(const float* in, const float* window, float* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = in[i] * window[i];
+    }
+}
+
+void DspReference::biquadCascade(const Biquad* stages, float* state, size_t stageCount,
+                                 const float* in, float* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        float x = in[i];
+        for (size_t s = 0; s < stageCount; s++) {
+            const Biquad& q = stages[s];
+            float* st = state + 2 * s;
+            float y = q.b0 * x + st[0];
+            st[0] = q.b1 * x - q.a1 * y + st[1];
+            st[1] = q.b2 * x - q.a2 * y;
+            x = y;
+        }
+        out[i] = x;
+    }
+}
+
+void DspReference::complexMac(const float* x, const float* w, float* acc, size_t bins, bool conjugateX) {
+    float sign = conjugateX ? -1.0f : 1.0f;
+    for (size_t k = 0; k < bins; k++) {
+        float xr = x[2 * k];
+        float xi = sign * x[2 * k + 1];
+        acc[2 * k] += xr * w[2 * k] - xi * w[2 * k + 1];
+        acc[2 * k + 1] += xr * w[2 * k + 1] + xi * w[2 * k];
+    }
+}
+
+// ============================================================
+// XTENSA (LX6/LX7: unrolled by 4, coefficients kept in registers)
+// ============================================================
+
+int64_t DspXtensa::dotProductQ15(const int16_t* a, const int16_t* b, size_t n) {
+    // A single product can reach 2^30, so the partial sums must be 64-bit
+    int64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += static_cast<int32_t>(a[i]) * b[i];
+        s1 += static_cast<int32_t>(a[i + 1]) * b[i + 1];
+        s2 += static_cast<int32_t>(a[i + 2]) * b[i + 2];
+        s3 += static_cast<int32_t>(a[i + 3]) * b[i + 3];
+    }
+    for (; i < n; i++) {
+        s0 += static_cast<int32_t>(a[i]) * b[i];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+void DspXtensa::mixQ15(const int16_t* a, const int16_t* b, int16_t* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int32_t v0 = static_cast<int32_t>(a[i]) + b[i];
+        int32_t v1 = static_cast<int32_t>(a[i + 1]) + b[i + 1];
+        int32_t v2 = static_cast<int32_t>(a[i + 2]) + b[i + 2];
+        int32_t v3 = static_cast<int32_t>(a[i + 3]) + b[i + 3];
+        out[i] = saturate16(v0);
+        out[i + 1] = saturate16(v1);
+        out[i + 2] = saturate16(v2);
+        out[i + 3] = saturate16(v3);
+    }
+    for (; i < n; i++) {
+        out[i] = saturate16(static_cast<int32_t>(a[i]) + b[i]);
+    }
+}
+
+void DspXtensa::gainQ15(const int16_t* in, int16_t* out, size_t n, int16_t gain, int shift) {
+    const int32_t g = gain;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int32_t v0 = (in[i] * g) >> shift;
+        int32_t v1 = (in[i + 1] * g) >> shift;
+        int32_t v2 = (in[i + 2] * g) >> shift;
+        int32_t v3 = (in[i + 3] * g) >> shift;
+        out[i] = saturate16(v0);
+        out[i + 1] = saturate16(v1);
+        out[i + 2] = saturate16(v2);
+        out[i + 3] = saturate16(v3);
+    }
+    for (; i < n; i++) {
+        out[i] = saturate16((in[i] * g) >> shift);
+    }
+}
+
+void DspXtensa::windowQ15(const int16_t* in, const int16_t* window, int16_t* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int32_t v0 = (in[i] * static_cast<int32_t>(window[i])) >> 15;
+        int32_t v1 = (in[i + 1] * static_cast<int32_t>(window[i + 1])) >> 15;
+        int32_t v2 = (in[i + 2] * static_cast<int32_t>(window[i + 2])) >> 15;
+        int32_t v3 = (in[i + 3] * static_cast<int32_t>(window[i + 3])) >> 15;
+        out[i] = saturate16(v0);
+        out[i + 1] = saturate16(v1);
+        out[i + 2] = saturate16(v2);
+        out[i + 3] = saturate16(v3);
+    }
+    for (; i < n; i++) {
+        out[i] = saturate16((in[i] * static_cast<int32_t>(window[i])) >> 15);
+    }
+}
+
+void DspXtensa::biquadCascadeQ15(const BiquadQ15* stages, int16_t* state, size_t stageCount,
+                                 const int16_t* in, int16_t* out, size_t n) {
+    // Stage by stage over the whole block: coefficients and state stay in
+    // registers, and each stage sees exactly the reference's input sequence
+    const int16_t* src = in;
+    for (size_t s = 0; s < stageCount; s++) {
+        const int32_t b0 = stages[s].b0, b1 = stages[s].b1, b2 = stages[s].b2;
+        const int32_t a1 = stages[s].a1, a2 = stages[s].a2;
+        int16_t* st = state + 4 * s;
+        int32_t x1 = st[0], x2 = st[1], y1 = st[2], y2 = st[3];
+        for (size_t i = 0; i < n; i++) {
+            int32_t x = src[i];
+            int64_t acc = static_cast<int64_t>(b0 * x) + b1 * x1 + b2 * x2 - a1 * y1
+                        - static_cast<int64_t>(a2 * y2);
+            int16_t y = saturate16((acc + (1 << 13)) >> 14);
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            out[i] = y;
+        }
+        st[0] = static_cast<int16_t>(x1);
+        st[1] = static_cast<int16_t>(x2);
+        st[2] = static_cast<int16_t>(y1);
+        st[3] = static_cast<int16_t>(y2);
+        src = out;
+    }
+    if (stageCount == 0 && out != in) {
+        for (size_t i = 0; i < n; i++) out[i] = in[i];
+    }
+}
+
+int32_t DspXtensa::dotProductQ7(const int8_t* a, const int8_t* b, size_t n) {
+    int32_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += static_cast<int32_t>(a[i]) * b[i];
+        s1 += static_cast<int32_t>(a[i + 1]) * b[i + 1];
+        s2 += static_cast<int32_t>(a[i + 2]) * b[i + 2];
+        s3 += static_cast<int32_t>(a[i + 3]) * b[i + 3];
+    }
+    for (; i < n; i++) {
+        s0 += static_cast<int32_t>(a[i]) * b[i];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+float DspXtensa::dotProduct(const float* a, const float* b, size_t n) {
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += a[i] * b[i];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < n; i++) {
+        s0 += a[i] * b[i];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+void DspXtensa::mix(const float* a, const float* b, float* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float v0 = a[i] + b[i];
+        float v1 = a[i + 1] + b[i + 1];
+        float v2 = a[i + 2] + b[i + 2];
+        float v3 = a[i + 3] + b[i + 3];
+        out[i] = v0;
+        out[i + 1] = v1;
+        out[i + 2] = v2;
+        out[i + 3] = v3;
+    }
+    for (; i < n; i++) {
+        out[i] = a[i] + b[i];
+    }
+}
+
+void DspXtensa::scale(const float* in, float* out, size_t n, float gain) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float v0 = in[i] * gain;
+        float v1 = in[i + 1] * gain;
+        float v2 = in[i + 2] * gain;
+        float v3 = in[i + 3] * gain;
+        out[i] = v0;
+        out[i + 1] = v1;
+        out[i + 2] = v2;
+        out[i + 3] = v3;
+    }
+    for (; i < n; i++) {
+        out[i] = in[i] * gain;
+    }
+}
+
+void DspXtensa::multiply(const float* in, const float* window, float* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float v0 = in[i] * window[i];
+        float v1 = in[i + 1] * window[i + 1];
+        float v2 = in[i + 2] * window[i + 2];
+        float v3 = in[i + 3] * window[i + 3];
+        out[i] = v0;
+        out[i + 1] = v1;
+        out[i + 2] = v2;
+        out[i + 3] = v3;
+    }
+    for (; i < n; i++) {
+        out[i] = in[i] * window[i];
+    }
+}
+
+void DspXtensa::biquadCascade(const Biquad* stages, float* state, size_t stageCount,
+                              const float* in, float* out, size_t n) {
+    const float* src = in;
+    for (size_t s = 0; s < stageCount; s++) {
+        const float b0 = stages[s].b0, b1 = stages[s].b1, b2 = stages[s].b2;
+        const float a1 = stages[s].a1, a2 = stages[s].a2;
+        float s0 = state[2 * s];
+        float s1 = state[2 * s + 1];
+        for (size_t i = 0; i < n; i++) {
+            float x = src[i];
+            float y = b0 * x + s0;
+            s0 = b1 * x - a1 * y + s1;
+            s1 = b2 * x - a2 * y;
+            out[i] = y;
+        }
+        state[2 * s] = s0;
+        state[2 * s + 1] = s1;
+        src = out;
+    }
+    if (stageCount == 0 && out != in) {
+        for (size_t i = 0; i < n; i++) out[i] = in[i];
+    }
+}
+
+void DspXtensa::complexMac(const float* x, const float* w, float* acc, size_t bins, bool conjugateX) {
+    // Separate loops keep the sign out of the inner loop
+    if (conjugateX) {
+        for (size_t k = 0; k < bins; k++) {
+            float xr = x[0], xi = x[1], wr = w[0], wi = w[1];
+            acc[0] += xr * wr + xi * wi;
+            acc[1] += xr * wi - xi * wr;
+            x += 2;
+            w += 2;
+            acc += 2;
+        }
+    } else {
+        for (size_t k = 0; k < bins; k++) {
+            float xr = x[0], xi = x[1], wr = w[0], wi = w[1];
+            acc[0] += xr * wr - xi * wi;
+            acc[1] += xr * wi + xi * wr;
+            x += 2;
+            w += 2;
+            acc += 2;
+        }
+    }
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#if defined(ESP_PLATFORM)
+#include "sdkconfig.h"
+#endif
+
+/**
+ * DSP Kernels
+ *
+ * Inner loops shared by the audio stages, in Q15, int8 and float, with one
+ * implementation per target behind the same static interface:
+ *
+ *   DspReference   Portable C++ (Linux host, and the reference every other
+ *                  variant is checked against)
+ *   DspXtensa      Unrolled, pointer-walking loops for the Xtensa cores
+ *                  (ESP32-PICO in the StickC Plus2, and the base for S3)
+ *   DspPie         ESP32-S3 PIE 128-bit SIMD for the integer kernels it covers;
+ *                  inherits DspXtensa for the rest (PIE has no float lanes)
+ *
+ * 'Dsp' names the best variant for the build target. Q15 and int8 kernels
+ * are bit-exact across variants. Float kernels that reduce (dotProduct,
+ * complexMac) may differ in the last bits because the sum order differs;
+ * element-wise float kernels are exact. DspBenchmark checks both.
+ *
+ * All kernels allow out to alias in. PIE paths need 16-byte aligned
+ * buffers and fall back to DspXtensa otherwise (alignas(16) on the
+ * buffers that matter).
+ */
+
+/**
+ * Float biquad, transposed direct form II
+ * y = b0*x + s0;  s0 = b1*x - a1*y + s1;  s1 = b2*x - a2*y
+ */
+struct Biquad {
+    float b0, b1, b2, a1, a2;
+};
+
+/**
+ * Q15 biquad, direct form I with Q14 coefficients (range +-2)
+ * State per stage: x1, x2, y1, y2
+ */
+struct BiquadQ15 {
+    int16_t b0, b1, b2, a1, a2;
+};
+
+class DspReference {
+public:
+    // ---- Q15 ----
+
+    /**
+     * Exact sum of a[i] * b[i] (n at most 256 keeps it within 40 bits)
+     */
+    static int64_t dotProductQ15(const int16_t* a, const int16_t* b, size_t n);
+
+    /**
+     * out = saturate(a + b)
+     */
+    static void mixQ15(const int16_t* a, const int16_t* b, int16_t* out, size_t n);
+
+    /**
+     * out = saturate((in * gain) >> shift)
+     */
+    static void gainQ15(const int16_t* in, int16_t* out, size_t n, int16_t gain, int shift);
+
+    /**
+     * out = saturate((in * window) >> 15)
+     * Truncating, as the PIE multiply is; a window's half-LSB bias is
+     * far below its sidelobes.
+     */
+    static void windowQ15(const int16_t* in, const int16_t* window, int16_t* out, size_t n);
+
+    /**
+     * Cascade of Q15 biquads, processed in order
+     * @param state 4 * stageCount values, zeroed to start
+     */
+    static void biquadCascadeQ15(const BiquadQ15* stages, int16_t* state, size_t stageCount,
+                                 const int16_t* in, int16_t* out, size_t n);
+
+    // ---- int8 ----
+
+    /**
+     * Exact sum of a[i] * b[i] (n below 2^17 keeps it within 32 bits)
+     * The inner product of quantized convolution layers (KeywordModel).
+     */
+    static int32_t dotProductQ7(const int8_t* a, const int8_t* b, size_t n);
+
+    // ---- float ----
+
+    static float dotProduct(const float* a, const float* b, size_t n);
+
+    /**
+     * out = a + b
+     */
+    static void mix(const float* a, const float* b, float* out, size_t n);
+
+    /**
+     * out = in * gain
+     */
+    static void scale(const float* in, float* out, size_t n, float gain);
+
+    /**
+     * out = in * window (element-wise product)
+     */
+    static void multiply(const float* in, const float* window, float* out, size_t n);
+
+    /**
+     * Cascade of float biquads, processed in order
+     * @param state 2 * stageCount values, zeroed to start
+     */
+    static void biquadCascade(const Biquad* stages, float* state, size_t stageCount,
+                              const float* in, float* out, size_t n);
+
+    /**
+     * Complex multiply-accumulate on interleaved re/im bins: acc += x * w,
+     * or acc += conj(x) * w when conjugateX is set
+     */
+    static void complexMac(const float* x, const float* w, float* acc, size_t bins, bool conjugateX);
+};
+
+class DspXtensa {
+public:
+    static int64_t dotProductQ15(const int16_t* a, const int16_t* b, size_t n);
+    static void mixQ15(const int16_t* a, const int16_t* b, int16_t* out, size_t n);
+    static void gainQ15(const int16_t* in, int16_t* out, size_t n, int16_t gain, int shift);
+    static void windowQ15(const int16_t* in, const int16_t* window, int16_t* out, size_t n);
+    static void biquadCascadeQ15(const BiquadQ15* stages, int16_t* state, size_t stageCount,
+                                 const int16_t* in, int16_t* out, size_t n);
+    static int32_t dotProductQ7(const int8_t* a, const int8_t* b, size_t n);
+
+    static float dotProduct(const float* a, const float* b, size_t n);
+    static void mix(const float* a, const float* b, float* out, size_t n);
+    static void scale(const float* in, float* out, size_t n, float gain);
+    static void multiply(const float* in, const float* window, float* out, size_t n);
+    static void biquadCascade(const Biquad* stages, float* state, size_t stageCount,
+                              const float* in, float* out, size_t n);
+    static void complexMac(const float* x, const float* w, float* acc, size_t bins, bool conjugateX);
+};
+
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+#define DSP_HAS_PIE 1
+
+class DspPie : public DspXtensa {
+public:
+    static int64_t dotProductQ15(const int16_t* a, const int16_t* b, size_t n);
+    static void mixQ15(const int16_t* a, const int16_t* b, int16_t* out, size_t n);
+
+    /**
+     * Vector path only for gains that cannot saturate (|gain| up to
+     * 2^shift, e.g. any attenuation); a boost that can goes through DspXtensa
+     */
+    static void gainQ15(const int16_t* in, int16_t* out, size_t n, int16_t gain, int shift);
+    static void windowQ15(const int16_t* in, const int16_t* window, int16_t* out, size_t n);
+    static int32_t dotProductQ7(const int8_t* a, const int8_t* b, size_t n);
+};
+
+typedef DspPie Dsp;
+#elif defined(__XTENSA__)
+typedef DspXtensa Dsp;
+#else
+typedef DspReference Dsp;
+#endif
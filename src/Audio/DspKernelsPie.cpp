@@ -0,0 +1,177 @@
+#include "DspKernels.h"
+
+#if defined(DSP_HAS_PIE)
+
+// ESP32-S3 PIE kernels. EE.VLD.128 ignores the low four address bits, so
+// the vector paths only run on 16-byte aligned buffers; the tail short of
+// a full vector and any unaligned call go through DspXtensa. Loops use LOOPNEZ (zero
+// overhead).
+
+static inline bool aligned16(const void* p) {
+    return (reinterpret_cast<uintptr_t>(p) & 15) == 0;
+}
+
+// EE.VMUL.S16 shifts each 32-bit product right by SAR and keeps 16 bits.
+// The kernels below only hand it products whose shifted value fits, or
+// fix up the one that cannot, so the result does not depend on whether
+// the lane wraps or saturates on overflow.
+
+/**
+ * (in * gain) >> shift stays in int16 for every in: gain in
+ * [-(2^shift - 1), 2^shift]
+ */
+static inline bool gainFits(int16_t gain, int shift) {
+    int32_t unity = static_cast<int32_t>(1) << shift;
+    return gain <= unity && gain > -unity;
+}
+
+int64_t DspPie::dotProductQ15(const int16_t* a, const int16_t* b, size_t n) {
+    size_t vectors = n / 8;
+    if (vectors == 0 || !aligned16(a) || !aligned16(b)) {
+        return DspXtensa::dotProductQ15(a, b, n);
+    }
+
+    // 8 products per instruction into the 40-bit ACCX accumulator; exact
+    // for n <= 256 (256 * 2^30 = 2^38)
+    const int16_t* pa = a;
+    const int16_t* pb = b;
+    uint32_t lo;
+    uint32_t hi;
+    asm volatile (
+        "ee.zero.accx\n"
+        "loopnez %[count], 1f\n"
+        "ee.vld.128.ip q0, %[pa], 16\n"
+        "ee.vld.128.ip q1, %[pb], 16\n"
+        "ee.vmulas.s16.accx q0, q1\n"
+        "1:\n"
+        "rur.accx_0 %[lo]\n"
+        "rur.accx_1 %[hi]\n"
+        : [pa] "+r" (pa), [pb] "+r" (pb), [lo] "=r" (lo), [hi] "=r" (hi)
+        : [count] "r" (vectors)
+        : "memory"
+    );
+    // ACCX_1 holds bits 32..39; sign-extend from bit 39
+    int64_t sum = (static_cast<int64_t>(static_cast<int8_t>(hi & 0xff)) << 32) | lo;
+
+    size_t done = vectors * 8;
+    return sum + DspXtensa::dotProductQ15(a + done, b + done, n - done);
+}
+
+void DspPie::mixQ15(const int16_t* a, const int16_t* b, int16_t* out, size_t n) {
+    size_t vectors = n / 8;
+    if (vectors == 0 || !aligned16(a) || !aligned16(b) || !aligned16(out)) {
+        DspXtensa::mixQ15(a, b, out, n);
+        return;
+    }
+
+    // EE.VADDS.S16: 8 lanes of saturating 16-bit addition
+    const int16_t* pa = a;
+    const int16_t* pb = b;
+    int16_t* po = out;
+    asm volatile (
+        "loopnez %[count], 1f\n"
+        "ee.vld.128.ip q0, %[pa], 16\n"
+        "ee.vld.128.ip q1, %[pb], 16\n"
+        "ee.vadds.s16 q2, q0, q1\n"
+        "ee.vst.128.ip q2, %[po], 16\n"
+        "1:\n"
+        : [pa] "+r" (pa), [pb] "+r" (pb), [po] "+r" (po)
+        : [count] "r" (vectors)
+        : "memory"
+    );
+
+    size_t done = vectors * 8;
+    DspXtensa::mixQ15(a + done, b + done, out + done, n - done);
+}
+
+void DspPie::gainQ15(const int16_t* in, int16_t* out, size_t n, int16_t gain, int shift) {
+    size_t vectors = n / 8;
+    if (vectors == 0 || !aligned16(in) || !aligned16(out) || !gainFits(gain, shift)) {
+        DspXtensa::gainQ15(in, out, n, gain, shift);
+        return;
+    }
+
+    // Gain broadcast to all 8 lanes, one multiply-and-shift per vector
+    const int16_t* pi = in;
+    int16_t* po = out;
+    asm volatile (
+        "wsr.sar %[shift]\n"
+        "ee.vldbc.16 q1, %[gain]\n"
+        "loopnez %[count], 1f\n"
+        "ee.vld.128.ip q0, %[pi], 16\n"
+        "ee.vmul.s16 q2, q0, q1\n"
+        "ee.vst.128.ip q2, %[po], 16\n"
+        "1:\n"
+        : [pi] "+r" (pi), [po] "+r" (po)
+        : [count] "r" (vectors), [shift] "r" (shift), [gain] "r" (&gain)
+        : "memory"
+    );
+
+    size_t done = vectors * 8;
+    DspXtensa::gainQ15(in + done, out + done, n - done, gain, shift);
+}
+
+void DspPie::windowQ15(const int16_t* in, const int16_t* window, int16_t* out, size_t n) {
+    size_t vectors = n / 8;
+    if (vectors == 0 || !aligned16(in) || !aligned16(window) || !aligned16(out)) {
+        DspXtensa::windowQ15(in, window, out, n);
+        return;
+    }
+
+    // Only -32768 * -32768 leaves int16 (2^30 >> 15). Every in-range result
+    // is above -32768, so a lane holding it is that product wrapped: flip
+    // it to 32767 (EE.VCMP.EQ gives an all-ones lane mask). A saturated
+    // lane already holds 32767 and is left alone.
+    static const int16_t mostNegative = -32768;
+    const int16_t* pi = in;
+    const int16_t* pw = window;
+    int16_t* po = out;
+    asm volatile (
+        "wsr.sar %[shift]\n"
+        "ee.vldbc.16 q3, %[neg]\n"
+        "loopnez %[count], 1f\n"
+        "ee.vld.128.ip q0, %[pi], 16\n"
+        "ee.vld.128.ip q1, %[pw], 16\n"
+        "ee.vmul.s16 q2, q0, q1\n"
+        "ee.vcmp.eq.s16 q4, q2, q3\n"
+        "ee.xorq q2, q2, q4\n"
+        "ee.vst.128.ip q2, %[po], 16\n"
+        "1:\n"
+        : [pi] "+r" (pi), [pw] "+r" (pw), [po] "+r" (po)
+        : [count] "r" (vectors), [shift] "r" (15), [neg] "r" (&mostNegative)
+        : "memory"
+    );
+
+    size_t done = vectors * 8;
+    DspXtensa::windowQ15(in + done, window + done, out + done, n - done);
+}
+
+int32_t DspPie::dotProductQ7(const int8_t* a, const int8_t* b, size_t n) {
+    size_t vectors = n / 16;
+    if (vectors == 0 || !aligned16(a) || !aligned16(b)) {
+        return DspXtensa::dotProductQ7(a, b, n);
+    }
+
+    // 16 products per instruction into ACCX; the sum fits 32 bits for the
+    // lengths the interface allows, so ACCX_0 alone holds it
+    const int8_t* pa = a;
+    const int8_t* pb = b;
+    uint32_t lo;
+    asm volatile (
+        "ee.zero.accx\n"
+        "loopnez %[count], 1f\n"
+        "ee.vld.128.ip q0, %[pa], 16\n"
+        "ee.vld.128.ip q1, %[pb], 16\n"
+        "ee.vmulas.s8.accx q0, q1\n"
+        "1:\n"
+        "rur.accx_0 %[lo]\n"
+        : [pa] "+r" (pa), [pb] "+r" (pb), [lo] "=r" (lo)
+        : [count] "r" (vectors)
+        : "memory"
+    );
+
+    size_t done = vectors * 16;
+    return static_cast<int32_t>(lo) + DspXtensa::dotProductQ7(a + done, b + done, n - done);
+}
+
+#endif
@@ -0,0 +1,139 @@
+#include "EarconMixer.h"
+#include "DspKernels.h"
+#include <cmath>
+
+void EarconMixer::init() {
+    // One tone for a trigger; a rising/falling fifth for start/stop
+    static const Tone TRIGGER[] = {{1047.0f, 60000}};
+    static const Tone START[] = {{784.0f, 60000}, {1175.0f, 80000}};
+    static const Tone STOP[] = {{1175.0f, 60000}, {784.0f, 80000}};
+
+    size_t offset = 0;
+    offset = render(offset, TRIGGER, 1);
+    m_clips[static_cast<size_t>(Cue::Trigger)] = Clip{0, offset};
+
+    size_t start = offset;
+    offset = render(offset, START, 2);
+    m_clips[static_cast<size_t>(Cue::SessionStart)] = Clip{start, offset - start};
+
+    start = offset;
+    offset = render(offset, STOP, 2);
+    m_clips[static_cast<size_t>(Cue::SessionStop)] = Clip{start, offset - start};
+
+    reset();
+}
+
+/**
+ * Render tones back to back from offset
+ * @return End offset, rounded up to 8 samples so every clip starts aligned
+ */
+size_t EarconMixer::render(size_t offset, const Tone* tones, size_t count) {
+    const float rate = static_cast<float>(AudioConfig::I2S_SAMPLE_RATE);
+    const size_t edge = static_cast<size_t>(EDGE_US * rate / 1000000.0f);
+
+    for (size_t t = 0; t < count; t++) {
+        size_t length = static_cast<size_t>(tones[t].durationUs * rate / 1000000.0f);
+        if (offset + length > POOL_SAMPLES) length = POOL_SAMPLES - offset;
+
+        float step = 6.283185307f * tones[t].hz / rate;
+        for (size_t i = 0; i < length; i++) {
+            float envelope = 1.0f;
+            if (i < edge) {
+                envelope = 0.5f - 0.5f * cosf(3.141592654f * static_cast<float>(i) / edge);
+            } else if (i >= length - edge) {
+                envelope = 0.5f - 0.5f * cosf(3.141592654f * static_cast<float>(length - 1 - i) / edge);
+            }
+            m_pool[offset + i] = static_cast<int16_t>(CLIP_LEVEL * envelope * sinf(step * i));
+        }
+        offset += length;
+    }
+
+    size_t end = (offset + 7) & ~static_cast<size_t>(7);
+    if (end > POOL_SAMPLES) end = POOL_SAMPLES;
+    for (size_t i = offset; i < end; i++) {
+        m_pool[i] = 0;
+    }
+    return end;
+}
+
+bool EarconMixer::play(Cue cue, int16_t gain) {
+    uint32_t w = m_queueWrite.load(std::memory_order_relaxed);
+    uint32_t r = m_queueRead.load(std::memory_order_acquire);
+    if (w - r >= QUEUE_SIZE || cue >= Cue::COUNT) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    m_queue[w % QUEUE_SIZE] = Request{cue, gain};
+    m_queueWrite.store(w + 1, std::memory_order_release);
+    return true;
+}
+
+void EarconMixer::reset() {
+    for (size_t v = 0; v < MAX_VOICES; v++) {
+        m_voices[v].remaining = 0;
+    }
+}
+
+// ============================================================
+// MIXING (engine task)
+// ============================================================
+
+void EarconMixer::start(const Request& request) {
+    // A free voice, or the one closest to its end
+    Voice* voice = &m_voices[0];
+    for (size_t v = 0; v < MAX_VOICES; v++) {
+        if (m_voices[v].remaining < voice->remaining) {
+            voice = &m_voices[v];
+        }
+    }
+    if (voice->remaining > 0) {
+        m_replaced.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const Clip& clip = m_clips[static_cast<size_t>(request.cue)];
+    voice->data = m_pool + clip.offset;
+    voice->remaining = clip.length;
+    voice->gain = request.gain;
+    m_played.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t EarconMixer::mix(int16_t* out, size_t count) {
+    uint32_t w = m_queueWrite.load(std::memory_order_acquire);
+    uint32_t r = m_queueRead.load(std::memory_order_relaxed);
+    for (; r != w; r++) {
+        start(m_queue[r % QUEUE_SIZE]);
+    }
+    m_queueRead.store(r, std::memory_order_release);
+
+    size_t mixed = 0;
+    for (size_t v = 0; v < MAX_VOICES; v++) {
+        Voice& voice = m_voices[v];
+        if (voice.remaining == 0) continue;
+
+        size_t n = (voice.remaining < count) ? voice.remaining : count;
+        Dsp::gainQ15(voice.data, m_scratch, n, voice.gain, 15);
+        Dsp::mixQ15(out, m_scratch, out, n);
+        voice.data += n;
+        voice.remaining -= n;
+        mixed++;
+    }
+    return mixed;
+}
+
+const int16_t* EarconMixer::clip(Cue cue, size_t* length) const {
+    if (cue >= Cue::COUNT) {
+        *length = 0;
+        return nullptr;
+    }
+    const Clip& c = m_clips[static_cast<size_t>(cue)];
+    *length = c.length;
+    return m_pool + c.offset;
+}
+
+EarconMixer::Stats EarconMixer::getStats() const {
+    Stats s;
+    s.played = m_played.load(std::memory_order_relaxed);
+    s.dropped = m_dropped.load(std::memory_order_relaxed);
+    s.replaced = m_replaced.load(std::memory_order_relaxed);
+    return s;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "AudioConfig.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Earcon Mixer
+ *
+ * Short UI cues mixed into the speaker stream on the engine task, so they
+ * play over (not instead of) the far-end audio and never touch
+ * M5.Speaker's channel state:
+ *
+ *   jitter buffer -> PLC -> resample -> mix() -> writeAudio / AEC reference
+ *
+ * Cue clips are rendered once by init() at the I2S rate (tone pairs with
+ * raised-cosine edges), so playing one is a gain and a saturating add per
+ * sample (Dsp::gainQ15 / Dsp::mixQ15). A cue starts on the first sample of
+ * the next output frame and continues sample-contiguously across frames.
+ * Up to MAX_VOICES cues overlap, each with its own gain; a cue arriving
+ * with every voice busy replaces the one closest to its end.
+ *
+ * Because the mix happens before the echo canceller's reference tap, cues
+ * are cancelled from the mic path like any other speaker audio.
+ *
+ * Outside a session nothing calls mix(); clip() hands the rendered samples
+ * to the board speaker instead (IBoard::playClip).
+ *
+ * play() is called from one task (the loop); mix() and reset() from the
+ * engine task.
+ */
+class EarconMixer {
+public:
+    enum class Cue : uint8_t {
+        Trigger,         // Trigger accepted
+        SessionStart,    // Voice session is up (rising pair)
+        SessionStop,     // Session ending (falling pair)
+        COUNT
+    };
+
+    static constexpr size_t MAX_VOICES = 2;
+    static constexpr int16_t DEFAULT_GAIN = 16384;   // Q15, -6dB on a -6dBFS clip
+
+    struct Stats {
+        uint32_t played;     // Cues started
+        uint32_t dropped;    // Requests lost to a full queue
+        uint32_t replaced;   // Cues cut short by a newer one
+    };
+
+    /**
+     * Render the cue clips (once, before the engine runs)
+     */
+    void init();
+
+    /**
+     * Queue a cue for the next output frame
+     * @param gain Q15 gain for this cue
+     * @return false if the request queue is full
+     */
+    bool play(Cue cue, int16_t gain = DEFAULT_GAIN);
+
+    /**
+     * Stop every voice (engine activation)
+     * Queued requests stay; play() is only called while playout is active.
+     */
+    void reset();
+
+    /**
+     * Mix active cues into out at the I2S rate
+     * @return Number of voices mixed (0: out untouched)
+     */
+    size_t mix(int16_t* out, size_t count);
+
+    /**
+     * Rendered samples of a cue at the I2S rate (valid after init())
+     * For playing a cue outside a session, where mix() is not running.
+     * @param length Set to the clip length in samples
+     * @return nullptr for an unknown cue
+     */
+    const int16_t* clip(Cue cue, size_t* length) const;
+
+    Stats getStats() const;
+
+private:
+    static constexpr size_t QUEUE_SIZE = 4;     // Power of two
+    static constexpr size_t POOL_SAMPLES = 6144;
+    static constexpr float CLIP_LEVEL = 16384.0f;   // -6dBFS
+    static constexpr uint32_t EDGE_US = 5000;       // Attack/release per tone
+
+    struct Tone {
+        float hz;
+        uint32_t durationUs;
+    };
+
+    struct Clip {
+        size_t offset;
+        size_t length;
+    };
+
+    struct Voice {
+        const int16_t* data = nullptr;
+        size_t remaining = 0;
+        int16_t gain = 0;
+    };
+
+    struct Request {
+        Cue cue;
+        int16_t gain;
+    };
+
+    alignas(16) int16_t m_pool[POOL_SAMPLES];
+    alignas(16) int16_t m_scratch[AudioConfig::MAX_OUTPUT_FRAME_SAMPLES];
+    Clip m_clips[static_cast<size_t>(Cue::COUNT)];
+    Voice m_voices[MAX_VOICES];
+
+    Request m_queue[QUEUE_SIZE];
+    std::atomic<uint32_t> m_queueWrite{0};
+    std::atomic<uint32_t> m_queueRead{0};
+
+    std::atomic<uint32_t> m_played{0};
+    std::atomic<uint32_t> m_dropped{0};
+    std::atomic<uint32_t> m_replaced{0};
+
+    size_t render(size_t offset, const Tone* tones, size_t count);
+    void start(const Request& request);
+};
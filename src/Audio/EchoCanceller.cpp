@@ -0,0 +1,226 @@
+#include "EchoCanceller.h"
+#include "DspKernels.h"
+#include <cmath>
+#include <cstring>
+
+extern "C" {
+#include "esp_timer.h"
+}
+
+static inline int16_t saturate16(float v) {
+    if (v > 32767.0f) return 32767;
+    if (v < -32768.0f) return -32768;
+    return static_cast<int16_t>(v);
+}
+
+void EchoCanceller::reset() {
+    m_fft.init(FFT_SIZE);
+
+    m_refRing.flush();
+    m_refPrimed = false;
+
+    memset(m_refPrev, 0, sizeof(m_refPrev));
+    m_blockFill = 0;
+    memset(m_outQueue, 0, sizeof(m_outQueue));
+    m_outLen = BLOCK;
+
+    memset(m_refSpectra, 0, sizeof(m_refSpectra));
+    m_refHead = 0;
+    resetFilter();
+
+    m_blocks.store(0, std::memory_order_relaxed);
+    m_frozenBlocks.store(0, std::memory_order_relaxed);
+    m_refUnderruns.store(0, std::memory_order_relaxed);
+    m_refResyncs.store(0, std::memory_order_relaxed);
+    m_resets.store(0, std::memory_order_relaxed);
+    m_maxBlockUs.store(0, std::memory_order_relaxed);
+}
+
+void EchoCanceller::resetFilter() {
+    memset(m_weights, 0, sizeof(m_weights));
+    memset(m_refPower, 0, sizeof(m_refPower));
+    m_constrainNext = 0;
+    m_micPower = 0.0f;
+    m_outPower = 0.0f;
+    m_frozenRun = 0;
+    m_divergedRun = 0;
+    m_erleDb.store(0.0f, std::memory_order_relaxed);
+}
+
+void EchoCanceller::pushReference(const int16_t* samples, size_t count) {
+    m_refRing.write(samples, count);
+}
+
+EchoCanceller::Stats EchoCanceller::getStats() const {
+    Stats s;
+    s.blocks = m_blocks.load(std::memory_order_relaxed);
+    s.frozenBlocks = m_frozenBlocks.load(std::memory_order_relaxed);
+    s.refUnderruns = m_refUnderruns.load(std::memory_order_relaxed);
+    s.refResyncs = m_refResyncs.load(std::memory_order_relaxed);
+    s.resets = m_resets.load(std::memory_order_relaxed);
+    s.maxBlockUs = m_maxBlockUs.load(std::memory_order_relaxed);
+    s.erleDb = m_erleDb.load(std::memory_order_relaxed);
+    return s;
+}
+
+// ============================================================
+// MIC PATH
+// ============================================================
+
+void EchoCanceller::process(const int16_t* mic, int16_t* out, size_t samples) {
+    if (samples > MAX_INPUT) samples = MAX_INPUT;
+
+    fetchReference(samples);
+
+    for (size_t i = 0; i < samples; i++) {
+        m_micBlock[m_blockFill] = mic[i];
+        m_refBlock[m_blockFill] = m_refScratch[i];
+        if (++m_blockFill == BLOCK) {
+            int64_t start = esp_timer_get_time();
+            runBlock();
+            uint32_t cost = static_cast<uint32_t>(esp_timer_get_time() - start);
+            if (cost > m_maxBlockUs.load(std::memory_order_relaxed)) {
+                m_maxBlockUs.store(cost, std::memory_order_relaxed);
+            }
+            m_blockFill = 0;
+        }
+    }
+
+    // The queue was primed with one block, so it always holds enough
+    memcpy(out, m_outQueue, samples * sizeof(int16_t));
+    m_outLen -= samples;
+    memmove(m_outQueue, m_outQueue + samples, m_outLen * sizeof(int16_t));
+}
+
+void EchoCanceller::fetchReference(size_t samples) {
+    size_t available = m_refRing.available();
+
+    if (!m_refPrimed) {
+        if (available < REF_DELAY_SAMPLES + samples) {
+            // Speaker idle or still starting: nothing to cancel yet
+            memset(m_refScratch, 0, samples * sizeof(int16_t));
+            return;
+        }
+        m_refRing.skip(available - REF_DELAY_SAMPLES - samples);
+        m_refPrimed = true;
+    } else if (available < samples) {
+        // Speaker stalled - the pairing is lost, so start over
+        m_refUnderruns.fetch_add(1, std::memory_order_relaxed);
+        m_refRing.flush();
+        m_refPrimed = false;
+        memset(m_refScratch, 0, samples * sizeof(int16_t));
+        return;
+    } else if (available > REF_DELAY_SAMPLES + REF_SLACK_SAMPLES + samples) {
+        // Mic samples were dropped upstream - drop reference to match
+        m_refRing.skip(available - REF_DELAY_SAMPLES - samples);
+        m_refResyncs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    m_refRing.read(m_refScratch, samples);
+}
+
+// ============================================================
+// ADAPTIVE FILTER
+// ============================================================
+
+void EchoCanceller::runBlock() {
+    const float invN = 1.0f / static_cast<float>(FFT_SIZE);
+
+    // Spectrum of the reference [previous block | current block]
+    for (size_t i = 0; i < BLOCK; i++) {
+        m_work[i] = m_refPrev[i];
+        m_work[BLOCK + i] = m_refBlock[i];
+    }
+    m_fft.forwardReal(m_work);
+    memcpy(m_refPrev, m_refBlock, sizeof(m_refPrev));
+
+    m_refHead = (m_refHead + PARTITIONS - 1) % PARTITIONS;
+    float* newest = m_refSpectra[m_refHead];
+    memcpy(newest, m_work, sizeof(m_refSpectra[0]));
+    for (size_t k = 0; k < BINS; k++) {
+        float p = newest[2 * k] * newest[2 * k] + newest[2 * k + 1] * newest[2 * k + 1];
+        m_refPower[k] = POWER_SMOOTHING * m_refPower[k] + (1.0f - POWER_SMOOTHING) * p;
+    }
+
+    // Echo estimate: sum of W[p] * X[now - p]
+    memset(m_work, 0, sizeof(m_work));
+    for (size_t p = 0; p < PARTITIONS; p++) {
+        Dsp::complexMac(m_refSpectra[(m_refHead + p) % PARTITIONS], m_weights[p], m_work, BINS, false);
+    }
+    m_fft.inverseReal(m_work);
+
+    // Overlap-save: the second half holds the linear convolution
+    float error[BLOCK];
+    float micEnergy = 0.0f;
+    float echoEnergy = 0.0f;
+    float outEnergy = 0.0f;
+    float refLevel = 0.0f;
+    for (size_t i = 0; i < BLOCK; i++) {
+        float echo = m_work[BLOCK + i] * invN;
+        float mic = m_micBlock[i];
+        float e = mic - echo;
+        error[i] = e;
+        m_outQueue[m_outLen++] = saturate16(e);
+
+        micEnergy += mic * mic;
+        echoEnergy += echo * echo;
+        outEnergy += e * e;
+        refLevel += fabsf(static_cast<float>(m_refBlock[i]));
+    }
+
+    if (refLevel < REF_ACTIVE_LEVEL * BLOCK) return;  // Nothing to learn from
+    m_blocks.fetch_add(1, std::memory_order_relaxed);
+
+    // Divergence guard: cancelling should never add energy
+    if (outEnergy > 2.0f * micEnergy) {
+        if (++m_divergedRun >= DIVERGED_BLOCKS) {
+            resetFilter();
+            m_resets.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+    m_divergedRun = 0;
+
+    // Double talk: once converged, a residual the echo model can't explain
+    // is near-end speech. Hold adaptation so the filter doesn't learn it.
+    float erle = m_erleDb.load(std::memory_order_relaxed);
+    if (erle > CONVERGED_ERLE_DB && outEnergy > DOUBLE_TALK_RATIO * echoEnergy
+        && m_frozenRun < MAX_FROZEN_BLOCKS) {
+        m_frozenRun++;
+        m_frozenBlocks.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    m_frozenRun = 0;
+
+    m_micPower = 0.95f * m_micPower + 0.05f * micEnergy;
+    m_outPower = 0.95f * m_outPower + 0.05f * outEnergy;
+    m_erleDb.store(10.0f * log10f((m_micPower + 1.0f) / (m_outPower + 1.0f)), std::memory_order_relaxed);
+
+    // Error spectrum of [zeros | e], normalized per bin
+    memset(m_work, 0, BLOCK * sizeof(float));
+    memcpy(m_work + BLOCK, error, sizeof(error));
+    m_fft.forwardReal(m_work);
+
+    const float regularization = static_cast<float>(FFT_SIZE) * REF_ACTIVE_LEVEL * REF_ACTIVE_LEVEL;
+    for (size_t k = 0; k < BINS; k++) {
+        float g = STEP / (static_cast<float>(PARTITIONS) * m_refPower[k] + regularization);
+        m_work[2 * k] *= g;
+        m_work[2 * k + 1] *= g;
+    }
+
+    // W[p] += conj(X[now - p]) * E
+    for (size_t p = 0; p < PARTITIONS; p++) {
+        Dsp::complexMac(m_refSpectra[(m_refHead + p) % PARTITIONS], m_work, m_weights[p], BINS, true);
+    }
+
+    // Gradient constraint, one partition per block: keep each partition's
+    // impulse response within its BLOCK taps (no circular wrap)
+    float* w = m_weights[m_constrainNext];
+    memcpy(m_work, w, sizeof(m_weights[0]));
+    m_fft.inverseReal(m_work);
+    Dsp::scale(m_work, m_work, BLOCK, invN);
+    memset(m_work + BLOCK, 0, BLOCK * sizeof(float));
+    m_fft.forwardReal(m_work);
+    memcpy(w, m_work, sizeof(m_weights[0]));
+    m_constrainNext = (m_constrainNext + 1) % PARTITIONS;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "AudioConfig.h"
+#include "Fft.h"
+#include "SampleRing.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Acoustic Echo Canceller (partitioned-block frequency-domain NLMS)
+ *
+ * On the CoreS3 the speaker and mics are centimetres apart, so TTS output
+ * leaks straight back into the mic stream. The canceller models the
+ * speaker -> mic path with an adaptive FIR filter and subtracts its
+ * estimate of the echo from every captured sample.
+ *
+ *   AudioEngine --pushReference()--> reference ring (bulk delay)
+ *                                          |
+ *   IBoard::readAudio --> process() ---- echo estimate ----> mic path
+ *
+ * - Runs at AudioConfig::I2S_SAMPLE_RATE on both streams. Speaker and mic
+ *   share the I2S clock, so once the reference has been primed to the
+ *   bulk delay, pairing samples one-for-one keeps them aligned
+ * - Filter: 8 partitions of 64 taps (32ms of echo tail after a 30ms bulk
+ *   delay), 128-point FFT overlap-save, per-bin step normalization
+ * - Adaptation is held during double talk (a residual the converged echo
+ *   model can't explain) and the filter is reset if it diverges
+ * - Adds one block (4ms) of latency
+ *
+ * Threading: pushReference() is called by the audio engine task, all
+ * other methods by the mic path (SCO outgoing-audio callback).
+ */
+class EchoCanceller {
+public:
+    // Largest block accepted by process()
+    static constexpr size_t MAX_INPUT = 256;
+
+    struct Stats {
+        uint32_t blocks;        // Blocks processed while the reference was active
+        uint32_t frozenBlocks;  // Blocks with adaptation held for double talk
+        uint32_t refUnderruns;  // Reference ran dry - re-primed (alignment lost)
+        uint32_t refResyncs;    // Reference backlog trimmed back to the bulk delay
+        uint32_t resets;        // Filter resets after divergence
+        uint32_t maxBlockUs;    // Worst cost of one block
+        float erleDb;           // Smoothed echo return loss enhancement
+    };
+
+    /**
+     * Clear the filter and reference stream (mic path side)
+     */
+    void reset();
+
+    /**
+     * Producer: speaker samples exactly as handed to the board
+     */
+    void pushReference(const int16_t* samples, size_t count);
+
+    /**
+     * Cancel echo from one block of mic samples
+     * @param mic Captured samples
+     * @param out Echo-cancelled samples (may alias mic)
+     * @param samples Sample count (at most MAX_INPUT)
+     */
+    void process(const int16_t* mic, int16_t* out, size_t samples);
+
+    Stats getStats() const;
+
+private:
+    static constexpr size_t BLOCK = 64;
+    static constexpr size_t FFT_SIZE = 2 * BLOCK;
+    static constexpr size_t BINS = FFT_SIZE / 2 + 1;           // Real-signal spectrum
+    static constexpr size_t PARTITIONS = 8;
+    static constexpr size_t REF_RING_SAMPLES = 2048;           // 128ms @ 16kHz
+    static constexpr size_t REF_DELAY_SAMPLES = 480;           // 30ms bulk delay
+    static constexpr size_t REF_SLACK_SAMPLES = 480;           // Backlog tolerated above the delay
+
+    // Adaptation
+    static constexpr float STEP = 0.5f;                 // NLMS step size
+    static constexpr float POWER_SMOOTHING = 0.7f;      // Per-bin reference power average
+    static constexpr float REF_ACTIVE_LEVEL = 64.0f;    // Mean |ref| below which we don't adapt
+    static constexpr float DOUBLE_TALK_RATIO = 0.125f;  // Residual over echo estimate (-9dB)
+    static constexpr float CONVERGED_ERLE_DB = 10.0f;   // Double-talk detection armed above this
+    static constexpr uint32_t MAX_FROZEN_BLOCKS = 250;  // 1s: assume the echo path changed
+    static constexpr uint32_t DIVERGED_BLOCKS = 8;      // Output louder than mic this long -> reset
+
+    // Reference stream
+    SampleRing<REF_RING_SAMPLES> m_refRing;
+    bool m_refPrimed = false;
+    int16_t m_refScratch[MAX_INPUT];
+
+    // Block assembly and output queue (one block of latency)
+    int16_t m_micBlock[BLOCK];
+    int16_t m_refBlock[BLOCK];
+    int16_t m_refPrev[BLOCK];
+    size_t m_blockFill = 0;
+    int16_t m_outQueue[BLOCK + MAX_INPUT];
+    size_t m_outLen = 0;
+
+    // Frequency-domain filter state (interleaved re/im)
+    Fft m_fft;
+    float m_weights[PARTITIONS][2 * BINS];
+    float m_refSpectra[PARTITIONS][2 * BINS];  // Ring, newest at m_refHead
+    size_t m_refHead = 0;
+    float m_refPower[BINS];
+    float m_work[FFT_SIZE + 2];   // Real block / half spectrum
+    size_t m_constrainNext = 0;
+
+    // Control
+    float m_micPower = 0.0f;
+    float m_outPower = 0.0f;
+    uint32_t m_frozenRun = 0;
+    uint32_t m_divergedRun = 0;
+
+    std::atomic<uint32_t> m_blocks{0};
+    std::atomic<uint32_t> m_frozenBlocks{0};
+    std::atomic<uint32_t> m_refUnderruns{0};
+    std::atomic<uint32_t> m_refResyncs{0};
+    std::atomic<uint32_t> m_resets{0};
+    std::atomic<uint32_t> m_maxBlockUs{0};
+    std::atomic<float> m_erleDb{0.0f};
+
+    void fetchReference(size_t samples);
+    void runBlock();
+    void resetFilter();
+};
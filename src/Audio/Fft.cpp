@@ -0,0 +1,115 @@
+#include "Fft.h"
+#include <cmath>
+
+void Fft::init(size_t size) {
+    if (size > MAX_SIZE) size = MAX_SIZE;
+    m_size = size;
+    for (size_t k = 0; k < size / 2; k++) {
+        float a = 6.283185307f * static_cast<float>(k) / static_cast<float>(size);
+        m_twiddle[2 * k] = cosf(a);
+        m_twiddle[2 * k + 1] = -sinf(a);
+    }
+}
+
+void Fft::forwardReal(float* data) const {
+    // The samples, read as interleaved re/im, are z[n] = x[2n] + j*x[2n+1]
+    const size_t half = m_size / 2;
+    transform(data, half, false);
+
+    // Split Z into the spectra of the even and odd samples and combine:
+    // X[k] = E[k] + W^k * O[k],  X[half - k] = conj(E[k] - W^k * O[k])
+    float r0 = data[0];
+    float i0 = data[1];
+    data[0] = r0 + i0;
+    data[1] = 0.0f;
+    data[2 * half] = r0 - i0;
+    data[2 * half + 1] = 0.0f;
+
+    for (size_t k = 1; k <= half / 2; k++) {
+        float* a = data + 2 * k;
+        float* b = data + 2 * (half - k);
+        float er = 0.5f * (a[0] + b[0]);
+        float ei = 0.5f * (a[1] - b[1]);
+        float or_ = 0.5f * (a[1] + b[1]);
+        float oi = -0.5f * (a[0] - b[0]);
+        float wr = m_twiddle[2 * k];
+        float wi = m_twiddle[2 * k + 1];
+        float tr = wr * or_ - wi * oi;
+        float ti = wr * oi + wi * or_;
+        a[0] = er + tr;
+        a[1] = ei + ti;
+        b[0] = er - tr;
+        b[1] = -(ei - ti);
+    }
+}
+
+void Fft::inverseReal(float* data) const {
+    const size_t half = m_size / 2;
+
+    // Rebuild Z[k] = E[k] + j*O[k] (scaled by 2 so the result matches the
+    // unscaled size-point convention)
+    float x0 = data[0];
+    float xh = data[2 * half];
+    data[0] = x0 + xh;
+    data[1] = x0 - xh;
+
+    for (size_t k = 1; k <= half / 2; k++) {
+        float* a = data + 2 * k;
+        float* b = data + 2 * (half - k);
+        float er = a[0] + b[0];
+        float ei = a[1] - b[1];
+        float dr = a[0] - b[0];
+        float di = a[1] + b[1];
+        // O[k] = conj(W^k) * (X[k] - conj(X[half - k]))
+        float wr = m_twiddle[2 * k];
+        float wi = m_twiddle[2 * k + 1];
+        float or_ = wr * dr + wi * di;
+        float oi = wr * di - wi * dr;
+        // Z[k] = E + jO, Z[half - k] = conj(E) + j*conj(O)
+        a[0] = er - oi;
+        a[1] = ei + or_;
+        b[0] = er + oi;
+        b[1] = -ei + or_;
+    }
+
+    transform(data, half, true);
+}
+
+void Fft::transform(float* data, size_t n, bool inverse) const {
+
+    // Bit-reversal permutation
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            float re = data[2 * i];
+            float im = data[2 * i + 1];
+            data[2 * i] = data[2 * j];
+            data[2 * i + 1] = data[2 * j + 1];
+            data[2 * j] = re;
+            data[2 * j + 1] = im;
+        }
+    }
+
+    // Iterative decimation-in-time butterflies
+    float sign = inverse ? -1.0f : 1.0f;
+    for (size_t len = 2; len <= n; len <<= 1) {
+        size_t half = len / 2;
+        size_t stride = m_size / len;
+        for (size_t i = 0; i < n; i += len) {
+            for (size_t k = 0; k < half; k++) {
+                float wr = m_twiddle[2 * k * stride];
+                float wi = sign * m_twiddle[2 * k * stride + 1];
+                float* a = data + 2 * (i + k);
+                float* b = data + 2 * (i + k + half);
+                float br = b[0] * wr - b[1] * wi;
+                float bi = b[0] * wi + b[1] * wr;
+                b[0] = a[0] - br;
+                b[1] = a[1] - bi;
+                a[0] += br;
+                a[1] += bi;
+            }
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Radix-2 complex FFT for the audio DSP stages
+ *
+ * In place on interleaved re/im floats, unscaled in both directions
+ * (inverse(forward(x)) == size * x).
+ *
+ * Real signals go through forwardReal()/inverseReal(), which pack the
+ * signal into a half-size complex transform and split the result, for
+ * about half the cost of transforming it as complex with zero imaginary
+ * parts.
+ */
+class Fft {
+public:
+    static constexpr size_t MAX_SIZE = 256;
+
+    /**
+     * Prepare twiddles for a transform size
+     * @param size Power of two, at most MAX_SIZE
+     */
+    void init(size_t size);
+
+    size_t size() const { return m_size; }
+
+    void forward(float* data) const { transform(data, m_size, false); }
+    void inverse(float* data) const { transform(data, m_size, true); }
+
+    /**
+     * Real forward transform, in place
+     * @param data size real samples in; size / 2 + 1 interleaved re/im bins
+     *             out (size + 2 floats)
+     */
+    void forwardReal(float* data) const;
+
+    /**
+     * Real inverse transform, in place (inverseReal(forwardReal(x)) == size * x)
+     * @param data size / 2 + 1 interleaved re/im bins in; size real samples out
+     */
+    void inverseReal(float* data) const;
+
+private:
+    size_t m_size = 0;
+    float m_twiddle[MAX_SIZE];   // e^(-j*2*pi*k/N) for k < N/2, re/im pairs
+
+    void transform(float* data, size_t n, bool inverse) const;
+};
@@ -0,0 +1,58 @@
+#include "FractionalResampler.h"
+#include <cstring>
+
+void FractionalResampler::reset() {
+    m_step = ONE;
+    m_pos = 2 * ONE;
+    memset(m_history, 0, sizeof(m_history));
+}
+
+void FractionalResampler::setRatioPpm(float ppm) {
+    // 2^32 * ppm * 1e-6, applied as a signed offset to 1.0
+    int64_t offset = static_cast<int64_t>(ppm * 4294.967296f);
+    m_step = static_cast<uint64_t>(static_cast<int64_t>(ONE) + offset);
+}
+
+size_t FractionalResampler::inputFor(size_t outSamples) const {
+    if (outSamples == 0) return 0;
+    // The last output interpolates around m_work[last], which needs m_work[last + 2]
+    uint64_t last = m_pos + m_step * (outSamples - 1);
+    size_t index = static_cast<size_t>(last >> 32);
+    return (index > HISTORY - 3) ? index - (HISTORY - 3) : 0;
+}
+
+size_t FractionalResampler::process(const int16_t* in, size_t inSamples, int16_t* out, size_t maxOut) {
+    if (inSamples > MAX_INPUT) inSamples = MAX_INPUT;
+
+    memcpy(m_work, m_history, sizeof(m_history));
+    memcpy(m_work + HISTORY, in, inSamples * sizeof(int16_t));
+
+    size_t produced = 0;
+    while (produced < maxOut) {
+        size_t i = static_cast<size_t>(m_pos >> 32);
+        if (i + 2 >= HISTORY + inSamples) break;  // Needs m_work[i + 2]
+
+        // Catmull-Rom cubic between m_work[i] and m_work[i + 1]
+        float t = static_cast<float>(static_cast<uint32_t>(m_pos) >> 8) * (1.0f / 16777216.0f);
+        float xm1 = m_work[i - 1];
+        float x0 = m_work[i];
+        float x1 = m_work[i + 1];
+        float x2 = m_work[i + 2];
+        float y = x0 + 0.5f * t * (x1 - xm1 + t * (2.0f * xm1 - 5.0f * x0 + 4.0f * x1 - x2
+                  + t * (3.0f * (x0 - x1) + x2 - xm1)));
+
+        if (y > 32767.0f) y = 32767.0f;
+        if (y < -32768.0f) y = -32768.0f;
+        out[produced++] = static_cast<int16_t>(y);
+        m_pos += m_step;
+    }
+
+    // Slide: keep the last HISTORY samples, rebase the read position.
+    // If maxOut cut the block short, drop the unread input rather than
+    // letting the position fall behind the history.
+    memcpy(m_history, m_work + inSamples, sizeof(m_history));
+    uint64_t consumed = static_cast<uint64_t>(inSamples) << 32;
+    if (m_pos < consumed + ONE) m_pos = consumed + ONE;
+    m_pos -= consumed;
+    return produced;
+}
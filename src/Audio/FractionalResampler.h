@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Fractional-ratio streaming resampler for clock drift compensation
+ *
+ * Converts between two nominally equal sample rates that differ by a few
+ * hundred ppm (SCO link clock vs. I2S clock). Uses 4-point cubic Hermite
+ * interpolation with a Q32.32 read position, so ratios can be steered in
+ * steps far below 1ppm without accumulating rounding drift.
+ *
+ * Streaming: the last four input samples are carried across calls, so
+ * frames can be fed one at a time without seams. Adds two samples of delay.
+ *
+ * Not thread-safe; one instance per audio path.
+ */
+class FractionalResampler {
+public:
+    // Largest input block accepted by process()
+    static constexpr size_t MAX_INPUT = 256;
+
+    /**
+     * Clear history and return to a 1:1 ratio
+     */
+    void reset();
+
+    /**
+     * Set the conversion ratio as a ppm offset
+     * Positive: consume input faster than output (output fewer samples).
+     * Negative: consume input slower (output more samples).
+     */
+    void setRatioPpm(float ppm);
+
+    /**
+     * Input samples needed to produce exactly outSamples with process()
+     */
+    size_t inputFor(size_t outSamples) const;
+
+    /**
+     * Resample one block
+     * @param in Input samples (at most MAX_INPUT)
+     * @param inSamples Number of input samples, all of which are consumed
+     * @param out Output buffer
+     * @param maxOut Capacity of out (inSamples + 2 always suffices for |ppm| < 1%)
+     * @return Number of output samples written
+     */
+    size_t process(const int16_t* in, size_t inSamples, int16_t* out, size_t maxOut);
+
+private:
+    static constexpr size_t HISTORY = 4;
+    static constexpr uint64_t ONE = 1ULL << 32;
+
+    uint64_t m_step = ONE;       // Input samples per output sample (Q32.32)
+    uint64_t m_pos = 2 * ONE;    // Read position into [history | input] (Q32.32)
+    int16_t m_history[HISTORY] = {0, 0, 0, 0};
+    int16_t m_work[HISTORY + MAX_INPUT];
+};
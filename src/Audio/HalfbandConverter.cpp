@@ -0,0 +1,77 @@
+#include "HalfbandConverter.h"
+#include <cstring>
+
+// Non-zero off-centre taps of the half-band FIR, innermost first (h[31 +- (2i + 1)]).
+// 63-tap windowed sinc, Kaiser beta 7, normalized to unity DC gain.
+static const float HALFBAND_TAPS[16] = {
+     3.172464180e-01f, -1.029285869e-01f,  5.848872226e-02f, -3.847447195e-02f,
+     2.677057646e-02f, -1.900655210e-02f,  1.350955410e-02f, -9.494843120e-03f,
+     6.534554549e-03f, -4.363677364e-03f,  2.798948005e-03f, -1.702140689e-03f,
+     9.628413694e-04f, -4.903487273e-04f,  2.099117173e-04f, -6.090562917e-05f,
+};
+
+static inline int16_t saturate16(float v) {
+    if (v > 32767.0f) return 32767;
+    if (v < -32768.0f) return -32768;
+    return static_cast<int16_t>(v);
+}
+
+// ============================================================
+// UPSAMPLER (8kHz -> 16kHz)
+// ============================================================
+
+void HalfbandUpsampler::reset() {
+    memset(m_work, 0, sizeof(m_work));
+}
+
+size_t HalfbandUpsampler::process(const int16_t* in, size_t inSamples, int16_t* out) {
+    if (inSamples > MAX_INPUT) inSamples = MAX_INPUT;
+    memcpy(m_work + HISTORY, in, inSamples * sizeof(int16_t));
+
+    for (size_t k = 0; k < inSamples; k++) {
+        // x[0] is the newest input; outputs are centred 15 samples back
+        const int16_t* x = m_work + HISTORY + k;
+
+        // Interpolated phase: halfway between x[-16] and x[-15]
+        float acc = 0.0f;
+        for (int i = 0; i < 16; i++) {
+            acc += HALFBAND_TAPS[i] * static_cast<float>(x[i - 15] + x[-16 - i]);
+        }
+        out[2 * k] = saturate16(2.0f * acc);
+
+        // Centre-tap phase: the input sample itself
+        out[2 * k + 1] = x[-15];
+    }
+
+    memmove(m_work, m_work + inSamples, HISTORY * sizeof(int16_t));
+    return 2 * inSamples;
+}
+
+// ============================================================
+// DOWNSAMPLER (16kHz -> 8kHz)
+// ============================================================
+
+void HalfbandDownsampler::reset() {
+    memset(m_work, 0, sizeof(m_work));
+}
+
+size_t HalfbandDownsampler::process(const int16_t* in, size_t inSamples, int16_t* out) {
+    if (inSamples > MAX_INPUT) inSamples = MAX_INPUT;
+    inSamples &= ~static_cast<size_t>(1);
+    memcpy(m_work + HISTORY, in, inSamples * sizeof(int16_t));
+
+    size_t outSamples = inSamples / 2;
+    for (size_t k = 0; k < outSamples; k++) {
+        // Newest input of this pair; the filter spans x[-62] .. x[0]
+        const int16_t* x = m_work + HISTORY + 2 * k + 1;
+
+        float acc = 0.5f * static_cast<float>(x[-31]);
+        for (int i = 0; i < 16; i++) {
+            acc += HALFBAND_TAPS[i] * static_cast<float>(x[2 * i - 30] + x[-32 - 2 * i]);
+        }
+        out[k] = saturate16(acc);
+    }
+
+    memmove(m_work, m_work + inSamples, HISTORY * sizeof(int16_t));
+    return outSamples;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * 2:1 polyphase half-band sample rate converters (8kHz <-> 16kHz)
+ *
+ * The I2S clock runs at a fixed 16kHz; narrowband (CVSD) SCO audio is
+ * converted at the edge instead of restarting the speaker and mic drivers
+ * on every codec negotiation.
+ *
+ * Both directions share one 63-tap Kaiser half-band FIR:
+ * - Passband ripple < 0.01dB to 3.4kHz, stopband > 70dB from 4.6kHz
+ * - Every other tap is zero and the centre tap is 0.5, so each output
+ *   costs 16 multiplies (symmetric pairs are pre-added)
+ * - Group delay ~1ms (15.5 samples at 8kHz)
+ *
+ * Streaming: filter history is carried across calls. Not thread-safe;
+ * one instance per audio path.
+ */
+class HalfbandUpsampler {
+public:
+    // Largest input block accepted by process()
+    static constexpr size_t MAX_INPUT = 128;
+
+    void reset();
+
+    /**
+     * Interpolate 8kHz to 16kHz
+     * @param in Input samples (at most MAX_INPUT)
+     * @param inSamples Number of input samples
+     * @param out Output buffer, room for 2 * inSamples (may alias in)
+     * @return Number of output samples written (2 * inSamples)
+     */
+    size_t process(const int16_t* in, size_t inSamples, int16_t* out);
+
+private:
+    static constexpr size_t HISTORY = 31;
+
+    int16_t m_work[HISTORY + MAX_INPUT] = {0};
+};
+
+class HalfbandDownsampler {
+public:
+    // Largest input block accepted by process()
+    static constexpr size_t MAX_INPUT = 256;
+
+    void reset();
+
+    /**
+     * Decimate 16kHz to 8kHz
+     * @param in Input samples (at most MAX_INPUT, even count)
+     * @param inSamples Number of input samples; an odd trailing sample is dropped
+     * @param out Output buffer, room for inSamples / 2 (may alias in)
+     * @return Number of output samples written (inSamples / 2)
+     */
+    size_t process(const int16_t* in, size_t inSamples, int16_t* out);
+
+private:
+    static constexpr size_t HISTORY = 61;
+
+    int16_t m_work[HISTORY + MAX_INPUT] = {0};
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Lock-free fixed-width histogram
+ *
+ * One task adds values, any task reads. Bucket b counts values in
+ * [b * WIDTH, (b + 1) * WIDTH); the last bucket also takes everything
+ * above the range. Buckets are relaxed atomics, so a reader may see an
+ * add() half-applied (count and buckets one apart) but never blocks the
+ * writer.
+ */
+template <size_t BUCKETS, uint32_t WIDTH>
+class Histogram {
+    static_assert(BUCKETS >= 2 && WIDTH > 0, "Histogram needs a range");
+
+public:
+    static constexpr uint32_t RANGE = BUCKETS * WIDTH;
+
+    void add(uint32_t value) {
+        size_t b = value / WIDTH;
+        if (b >= BUCKETS) b = BUCKETS - 1;
+        m_buckets[b].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        if (value > m_max.load(std::memory_order_relaxed)) {
+            m_max.store(value, std::memory_order_relaxed);
+        }
+        if (value < m_min.load(std::memory_order_relaxed)) {
+            m_min.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    uint32_t count() const { return m_count.load(std::memory_order_relaxed); }
+    uint32_t max() const { return m_max.load(std::memory_order_relaxed); }
+    uint32_t min() const { return count() ? m_min.load(std::memory_order_relaxed) : 0; }
+
+    /**
+     * Upper edge of the bucket holding the pct-th percentile
+     * Clamped to max(), so values past the range report the true maximum.
+     * @return 0 if empty
+     */
+    uint32_t percentile(uint32_t pct) const {
+        uint32_t counts[BUCKETS];
+        uint64_t total = 0;
+        for (size_t b = 0; b < BUCKETS; b++) {
+            counts[b] = m_buckets[b].load(std::memory_order_relaxed);
+            total += counts[b];
+        }
+        if (total == 0) return 0;
+
+        uint64_t target = (total * pct + 99) / 100;
+        if (target == 0) target = 1;
+        uint64_t seen = 0;
+        uint32_t top = max();
+        for (size_t b = 0; b < BUCKETS; b++) {
+            seen += counts[b];
+            if (seen >= target) {
+                uint32_t edge = static_cast<uint32_t>((b + 1) * WIDTH);
+                return (b == BUCKETS - 1 || edge > top) ? top : edge;
+            }
+        }
+        return top;
+    }
+
+    /**
+     * Clear all counts (racing add() calls may survive partially)
+     */
+    void reset() {
+        for (size_t b = 0; b < BUCKETS; b++) {
+            m_buckets[b].store(0, std::memory_order_relaxed);
+        }
+        m_count.store(0, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+        m_min.store(UINT32_MAX, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint32_t> m_buckets[BUCKETS] = {};
+    std::atomic<uint32_t> m_count{0};
+    std::atomic<uint32_t> m_max{0};
+    std::atomic<uint32_t> m_min{UINT32_MAX};
+};
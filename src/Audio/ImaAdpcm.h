@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * IMA ADPCM (4 bits/sample)
+ *
+ * Encoder and decoder share adpcmStep() so both track the same predictor.
+ * Callers pack two codes per byte, low nibble first (the WAV layout).
+ */
+
+static const int16_t ADPCM_STEPS[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+    11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+    32767
+};
+
+static const int8_t ADPCM_INDEX_STEP[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+/**
+ * Apply one code to the decoder state
+ * @return The decoded sample (the new predictor)
+ */
+static inline int16_t adpcmStep(uint8_t code, int16_t& predictor, uint8_t& index) {
+    int step = ADPCM_STEPS[index];
+    int diff = step >> 3;
+    if (code & 4) diff += step;
+    if (code & 2) diff += step >> 1;
+    if (code & 1) diff += step >> 2;
+
+    int value = predictor + ((code & 8) ? -diff : diff);
+    value = std::max(-32768, std::min(32767, value));
+    predictor = static_cast<int16_t>(value);
+
+    int next = index + ADPCM_INDEX_STEP[code & 7];
+    index = static_cast<uint8_t>(std::max(0, std::min(88, next)));
+    return predictor;
+}
+
+/**
+ * Encode one sample and advance the state as the decoder will
+ * @return 4-bit code
+ */
+static inline uint8_t adpcmEncode(int16_t sample, int16_t& predictor, uint8_t& index) {
+    int step = ADPCM_STEPS[index];
+    int diff = sample - predictor;
+    uint8_t code = 0;
+    if (diff < 0) {
+        code = 8;
+        diff = -diff;
+    }
+    if (diff >= step) { code |= 4; diff -= step; }
+    step >>= 1;
+    if (diff >= step) { code |= 2; diff -= step; }
+    step >>= 1;
+    if (diff >= step) { code |= 1; }
+
+    adpcmStep(code, predictor, index);
+    return code;
+}
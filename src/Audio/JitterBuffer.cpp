@@ -0,0 +1,159 @@
+#include "JitterBuffer.h"
+#include <cstring>
+
+void JitterBuffer::reset(uint32_t sampleRate) {
+    m_sampleRate.store(sampleRate, std::memory_order_relaxed);
+    m_producerReset.store(true, std::memory_order_release);
+    m_consumerReset.store(true, std::memory_order_release);
+}
+
+// ============================================================
+// PRODUCER (Bluedroid incoming-audio callback)
+// ============================================================
+
+bool JitterBuffer::push(const uint8_t* data, size_t len, int64_t arrivalUs) {
+    if (data == nullptr || len == 0) return true;
+
+    if (m_producerReset.exchange(false, std::memory_order_acquire)) {
+        m_firstArrivalUs = arrivalUs;
+        m_mediaSamples = 0;
+        m_haveTransit = false;
+        m_jitterQ4 = 0;
+        m_framesIn.store(0, std::memory_order_relaxed);
+        m_overruns.store(0, std::memory_order_relaxed);
+    }
+
+    updateJitter(len, arrivalUs);
+
+    // Split oversized packets across slots
+    while (len > 0) {
+        size_t chunk = (len > AudioConfig::MAX_FRAME_SIZE) ? AudioConfig::MAX_FRAME_SIZE : len;
+        if (!pushSlot(data, chunk)) {
+            return false;
+        }
+        data += chunk;
+        len -= chunk;
+    }
+    return true;
+}
+
+bool JitterBuffer::pushSlot(const uint8_t* data, size_t len) {
+    uint32_t w = m_writeIdx.load(std::memory_order_relaxed);
+    uint32_t r = m_readIdx.load(std::memory_order_acquire);
+
+    if (w - r >= CAPACITY_FRAMES) {
+        // Ring full - drop the incoming frame, consumer owns the read side
+        m_overruns.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Slot& slot = m_slots[w & INDEX_MASK];
+    memcpy(slot.data, data, len);
+    slot.len = static_cast<uint16_t>(len);
+
+    m_writeIdx.store(w + 1, std::memory_order_release);
+    m_framesIn.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void JitterBuffer::updateJitter(size_t len, int64_t arrivalUs) {
+    uint32_t rate = m_sampleRate.load(std::memory_order_relaxed);
+    if (rate == 0) return;
+
+    // Relative transit: wall-clock elapsed minus media time delivered so far
+    int64_t mediaUs = static_cast<int64_t>(m_mediaSamples * 1000000ULL / rate);
+    int64_t transitUs = (arrivalUs - m_firstArrivalUs) - mediaUs;
+    m_mediaSamples += len / AudioConfig::BYTES_PER_SAMPLE;
+
+    if (!m_haveTransit) {
+        m_lastTransitUs = transitUs;
+        m_haveTransit = true;
+        return;
+    }
+
+    int64_t d = transitUs - m_lastTransitUs;
+    m_lastTransitUs = transitUs;
+    if (d < 0) d = -d;
+    if (d > static_cast<int64_t>(AudioConfig::MAX_LATENCY_US)) {
+        d = AudioConfig::MAX_LATENCY_US;  // Ignore stalls beyond budget (e.g. link re-setup)
+    }
+
+    // RFC 3550: J += (|D| - J) / 16, kept in Q4 to avoid losing precision
+    m_jitterQ4 += static_cast<uint32_t>(d) - (m_jitterQ4 >> 4);
+    uint32_t jitterUs = m_jitterQ4 >> 4;
+    m_jitterUs.store(jitterUs, std::memory_order_relaxed);
+
+    // Cover ~3x the mean deviation, rounded up to whole frames
+    uint32_t frameUs = AudioConfig::FRAME_DURATION_US;
+    uint32_t depth = MIN_DEPTH_FRAMES + (3 * jitterUs + frameUs - 1) / frameUs;
+    if (depth > MAX_DEPTH_FRAMES) depth = MAX_DEPTH_FRAMES;
+    m_targetDepth.store(depth, std::memory_order_relaxed);
+}
+
+// ============================================================
+// CONSUMER (speaker playout task)
+// ============================================================
+
+size_t JitterBuffer::pop(uint8_t* out, size_t maxLen) {
+    if (m_consumerReset.exchange(false, std::memory_order_acquire)) {
+        m_readIdx.store(m_writeIdx.load(std::memory_order_acquire), std::memory_order_release);
+        m_priming = true;
+        m_framesOut.store(0, std::memory_order_relaxed);
+        m_underruns.store(0, std::memory_order_relaxed);
+        m_trimmed.store(0, std::memory_order_relaxed);
+    }
+
+    uint32_t r = m_readIdx.load(std::memory_order_relaxed);
+    uint32_t w = m_writeIdx.load(std::memory_order_acquire);
+    uint32_t available = w - r;
+    uint32_t target = m_targetDepth.load(std::memory_order_relaxed);
+
+    if (m_priming) {
+        if (available < target) return 0;
+        m_priming = false;
+    }
+
+    if (available == 0) {
+        m_underruns.fetch_add(1, std::memory_order_relaxed);
+        m_priming = true;
+        return 0;
+    }
+
+    // Pull latency back toward target if the producer got ahead of us
+    if (available > target + TRIM_HYSTERESIS_FRAMES) {
+        r++;
+        available--;
+        m_trimmed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const Slot& slot = m_slots[r & INDEX_MASK];
+    size_t len = (slot.len > maxLen) ? maxLen : slot.len;
+    memcpy(out, slot.data, len);
+
+    m_readIdx.store(r + 1, std::memory_order_release);
+    m_framesOut.fetch_add(1, std::memory_order_relaxed);
+    return len;
+}
+
+// ============================================================
+// DIAGNOSTICS
+// ============================================================
+
+uint32_t JitterBuffer::fill() const {
+    uint32_t r = m_readIdx.load(std::memory_order_acquire);
+    uint32_t w = m_writeIdx.load(std::memory_order_acquire);
+    return w - r;
+}
+
+JitterBuffer::Stats JitterBuffer::getStats() const {
+    Stats s;
+    s.framesIn = m_framesIn.load(std::memory_order_relaxed);
+    s.framesOut = m_framesOut.load(std::memory_order_relaxed);
+    s.underruns = m_underruns.load(std::memory_order_relaxed);
+    s.overruns = m_overruns.load(std::memory_order_relaxed);
+    s.trimmed = m_trimmed.load(std::memory_order_relaxed);
+    s.jitterUs = m_jitterUs.load(std::memory_order_relaxed);
+    s.targetDepth = m_targetDepth.load(std::memory_order_relaxed);
+    s.fill = fill();
+    return s;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "AudioConfig.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Adaptive SCO Jitter Buffer
+ *
+ * Single-producer / single-consumer lock-free frame queue between the
+ * HFP incoming-audio callback (producer, Bluedroid task) and the speaker
+ * playout path (consumer). Every frame is copied into a slot owned by the
+ * buffer, so the BT stack is free to reuse its callback memory as soon as
+ * push() returns.
+ *
+ * Depth adaptation:
+ * - The producer estimates interarrival jitter RFC 3550 style, comparing
+ *   arrival time against the media time carried by the frames
+ * - The playout target depth is derived from that estimate and clamped
+ *   so the buffered audio never exceeds the speaker latency budget
+ * - After an underrun the consumer re-primes to the target depth before
+ *   resuming; when the fill drifts well above target it trims one frame
+ *
+ * Threading:
+ * - push() must only be called from one task, pop() from one other task
+ * - reset() may be called from any task; each side applies it lazily
+ */
+class JitterBuffer {
+public:
+    // Ring capacity in frames (power of two for cheap index masking)
+    static constexpr uint32_t CAPACITY_FRAMES = 8;
+
+    // Adaptive target depth limits (5 frames = 37.5ms, leaves DMA headroom under 50ms)
+    static constexpr uint32_t MIN_DEPTH_FRAMES = 1;
+    static constexpr uint32_t MAX_DEPTH_FRAMES = 5;
+
+    // Frames above target tolerated before trimming latency
+    static constexpr uint32_t TRIM_HYSTERESIS_FRAMES = 2;
+
+    /**
+     * Counters exposed for diagnostics
+     * Counts are per stream: each side clears its own when it applies reset().
+     */
+    struct Stats {
+        uint32_t framesIn;       // Frames accepted by push()
+        uint32_t framesOut;      // Frames handed out by pop()
+        uint32_t underruns;      // pop() found nothing while playing
+        uint32_t overruns;       // push() found the ring full (frame dropped)
+        uint32_t trimmed;        // Frames discarded to pull latency back to target
+        uint32_t jitterUs;       // Current interarrival jitter estimate
+        uint32_t targetDepth;    // Current target depth (frames)
+        uint32_t fill;           // Frames currently buffered
+    };
+
+    /**
+     * Request a flush and restart of jitter estimation
+     * Call when a new SCO stream starts (codec negotiated)
+     * @param sampleRate Sample rate of the incoming PCM (8000 or 16000)
+     */
+    void reset(uint32_t sampleRate);
+
+    /**
+     * Producer: copy one frame into the ring
+     * Frames larger than a slot are split across several slots.
+     * @param data PCM 16-bit signed samples
+     * @param len Number of bytes
+     * @param arrivalUs Arrival timestamp (esp_timer_get_time())
+     * @return true if the whole frame was queued
+     */
+    bool push(const uint8_t* data, size_t len, int64_t arrivalUs);
+
+    /**
+     * Consumer: copy the next frame out of the ring
+     * @param out Destination buffer
+     * @param maxLen Size of destination (should be >= AudioConfig::MAX_FRAME_SIZE)
+     * @return Bytes copied, 0 while priming or on underrun
+     */
+    size_t pop(uint8_t* out, size_t maxLen);
+
+    Stats getStats() const;
+
+    uint32_t fill() const;
+    uint32_t targetDepth() const { return m_targetDepth.load(std::memory_order_relaxed); }
+    uint32_t sampleRate() const { return m_sampleRate.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint32_t INDEX_MASK = CAPACITY_FRAMES - 1;
+
+    struct Slot {
+        uint16_t len;
+        uint8_t data[AudioConfig::MAX_FRAME_SIZE];
+    };
+
+    Slot m_slots[CAPACITY_FRAMES];
+
+    // Ring indices (free-running, masked on access)
+    std::atomic<uint32_t> m_writeIdx{0};   // Owned by producer
+    std::atomic<uint32_t> m_readIdx{0};    // Owned by consumer
+
+    // Reset handshake (applied lazily by each side)
+    std::atomic<bool> m_producerReset{true};
+    std::atomic<bool> m_consumerReset{true};
+    std::atomic<uint32_t> m_sampleRate{AudioConfig::SAMPLE_RATE_WIDEBAND};
+
+    // Producer-owned jitter estimator state
+    int64_t m_firstArrivalUs = 0;
+    uint64_t m_mediaSamples = 0;
+    int64_t m_lastTransitUs = 0;
+    bool m_haveTransit = false;
+    uint32_t m_jitterQ4 = 0;               // Jitter estimate in 1/16 us
+
+    // Consumer-owned playout state
+    bool m_priming = true;
+
+    // Shared readouts
+    std::atomic<uint32_t> m_targetDepth{2};
+    std::atomic<uint32_t> m_jitterUs{0};
+
+    // Counters (framesIn/overruns producer-side, the rest consumer-side)
+    std::atomic<uint32_t> m_framesIn{0};
+    std::atomic<uint32_t> m_framesOut{0};
+    std::atomic<uint32_t> m_underruns{0};
+    std::atomic<uint32_t> m_overruns{0};
+    std::atomic<uint32_t> m_trimmed{0};
+
+    void updateJitter(size_t len, int64_t arrivalUs);
+    bool pushSlot(const uint8_t* data, size_t len);
+};
@@ -0,0 +1,441 @@
+#include "KeywordModel.h"
+#include "DspKernels.h"
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+static constexpr size_t HEADER_BYTES = 32;
+static constexpr size_t LAYER_HEADER_BYTES = 12;
+
+static inline uint16_t getLe16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t getLe32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8)
+         | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static inline float getFloat(const uint8_t* p) {
+    uint32_t bits = getLe32(p);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline size_t align16(size_t bytes) {
+    return (bytes + 15) & ~static_cast<size_t>(15);
+}
+
+/**
+ * Bounds-checked walk over the blob; each array is padded to 4 bytes
+ */
+struct BlobReader {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    bool ok;
+
+    const uint8_t* take(size_t bytes) {
+        size_t padded = (bytes + 3) & ~static_cast<size_t>(3);
+        if (!ok || size - pos < padded) {
+            ok = false;
+            return nullptr;
+        }
+        const uint8_t* p = data + pos;
+        pos += padded;
+        return p;
+    }
+};
+
+/**
+ * acc * multiplier * 2^(shift - 31), rounded half up, offset and clamped
+ * (shift in [-31, 30] keeps the 64-bit product and rounding term in range)
+ */
+static inline int8_t requantize(int32_t acc, int32_t multiplier, int shift,
+                                int32_t zero, int32_t lo, int32_t hi) {
+    int right = 31 - shift;
+    int64_t v = (static_cast<int64_t>(acc) * multiplier + (static_cast<int64_t>(1) << (right - 1))) >> right;
+    v += zero;
+    if (v < lo) v = lo;
+    if (v > hi) v = hi;
+    return static_cast<int8_t>(v);
+}
+
+KeywordModel::~KeywordModel() {
+    release();
+}
+
+void KeywordModel::release() {
+    delete[] m_storage;
+    m_storage = nullptr;
+    m_storageBytes = 0;
+    m_layerCount = 0;
+    m_macs = 0;
+    m_activations[0] = m_activations[1] = nullptr;
+    m_patch = nullptr;
+    m_accumulators = nullptr;
+}
+
+// ============================================================
+// LOADING
+// ============================================================
+
+bool KeywordModel::loadFile(const char* path) {
+    release();
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+
+    bool loaded = false;
+    long size = 0;
+    if (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) > 0 && fseek(file, 0, SEEK_SET) == 0) {
+        uint8_t* blob = new (std::nothrow) uint8_t[size];
+        if (blob && fread(blob, 1, static_cast<size_t>(size), file) == static_cast<size_t>(size)) {
+            loaded = load(blob, static_cast<size_t>(size));
+        }
+        delete[] blob;
+    }
+    fclose(file);
+    return loaded;
+}
+
+bool KeywordModel::load(const uint8_t* blob, size_t size) {
+    release();
+
+    BlobReader reader = {blob, size, 0, true};
+    const uint8_t* header = reader.take(HEADER_BYTES);
+    if (!header || memcmp(header, "KWS1", 4) != 0) return false;
+
+    Info info;
+    info.frames = getLe16(header + 4);
+    info.coefficients = header[6];
+    info.features = header[7];
+    info.melBands = header[8];
+    info.classes = header[9];
+    info.keywordClass = header[10];
+    size_t layerCount = header[11];
+    info.inputScale = getFloat(header + 12);
+    info.inputZeroPoint = static_cast<int8_t>(header[16]);
+    info.outputScale = getFloat(header + 20);
+
+    if (info.frames == 0 || info.coefficients == 0 || info.features > 1) return false;
+    if (info.classes == 0 || info.classes > MAX_CLASSES || info.keywordClass >= info.classes) return false;
+    if (layerCount == 0 || layerCount > MAX_LAYERS) return false;
+    if (!(info.inputScale > 0.0f) || !(info.outputScale > 0.0f)) return false;
+
+    // First pass: shapes, validation, and where each layer's parameters
+    // sit in the blob; the Layer pointers are blob pointers until copied
+    const uint8_t* blobWeights[MAX_LAYERS];
+    const uint8_t* blobBias[MAX_LAYERS];
+    const uint8_t* blobMultiplier[MAX_LAYERS];
+    const uint8_t* blobShift[MAX_LAYERS];
+
+    size_t h = info.frames;
+    size_t w = info.coefficients;
+    size_t c = 1;
+    int8_t zero = info.inputZeroPoint;
+    size_t paramBytes = 0;
+    size_t maxActivation = 0;
+    size_t maxPatch = 0;
+    size_t maxChannels = 0;
+    uint64_t macs = 0;
+
+    for (size_t i = 0; i < layerCount; i++) {
+        const uint8_t* lh = reader.take(LAYER_HEADER_BYTES);
+        if (!lh) return false;
+
+        Layer& layer = m_layers[i];
+        layer.type = static_cast<LayerType>(lh[0]);
+        layer.kernelH = lh[1];
+        layer.kernelW = lh[2];
+        layer.strideH = lh[3];
+        layer.strideW = lh[4];
+        bool same = lh[5] == 1;
+        layer.outZero = static_cast<int8_t>(lh[8]);
+        layer.actMin = static_cast<int8_t>(lh[9]);
+        layer.actMax = static_cast<int8_t>(lh[10]);
+        layer.inH = static_cast<uint16_t>(h);
+        layer.inW = static_cast<uint16_t>(w);
+        layer.inC = static_cast<uint16_t>(c);
+        layer.inZero = zero;
+        layer.padTop = 0;
+        layer.padLeft = 0;
+        layer.rowBytes = 0;
+
+        if (lh[5] > 1 || layer.actMin > layer.actMax) return false;
+
+        size_t channels;   // Per-channel parameter count
+        if (layer.type == LayerType::AvgPool) {
+            layer.outH = 1;
+            layer.outW = 1;
+            layer.outC = static_cast<uint16_t>(c);
+            channels = 1;
+            blobWeights[i] = nullptr;
+            blobBias[i] = nullptr;
+            macs += h * w * c;
+        } else if (layer.type == LayerType::Conv || layer.type == LayerType::Depthwise) {
+            size_t kh = layer.kernelH;
+            size_t kw = layer.kernelW;
+            size_t sh = layer.strideH;
+            size_t sw = layer.strideW;
+            if (kh == 0 || kw == 0 || sh == 0 || sw == 0) return false;
+
+            size_t outH;
+            size_t outW;
+            if (same) {
+                outH = (h + sh - 1) / sh;
+                outW = (w + sw - 1) / sw;
+                size_t needH = (outH - 1) * sh + kh;
+                size_t needW = (outW - 1) * sw + kw;
+                layer.padTop = static_cast<uint16_t>(needH > h ? (needH - h) / 2 : 0);
+                layer.padLeft = static_cast<uint16_t>(needW > w ? (needW - w) / 2 : 0);
+            } else {
+                if (h < kh || w < kw) return false;
+                outH = (h - kh) / sh + 1;
+                outW = (w - kw) / sw + 1;
+            }
+            layer.outH = static_cast<uint16_t>(outH);
+            layer.outW = static_cast<uint16_t>(outW);
+
+            size_t weightBytes;
+            if (layer.type == LayerType::Conv) {
+                channels = getLe16(lh + 6);
+                if (channels == 0 || channels > MAX_CHANNELS) return false;
+                size_t k = kh * kw * c;
+                layer.rowBytes = align16(k);
+                weightBytes = channels * k;
+                paramBytes += align16(channels * layer.rowBytes);
+                if (k > maxPatch) maxPatch = k;
+                macs += static_cast<uint64_t>(outH) * outW * channels * k;
+            } else {
+                channels = c;
+                weightBytes = kh * kw * c;
+                paramBytes += align16(weightBytes);
+                macs += static_cast<uint64_t>(outH) * outW * c * kh * kw;
+            }
+            layer.outC = static_cast<uint16_t>(channels);
+
+            blobWeights[i] = reader.take(weightBytes);
+            blobBias[i] = reader.take(channels * sizeof(int32_t));
+            paramBytes += align16(channels * sizeof(int32_t));
+        } else {
+            return false;
+        }
+
+        blobMultiplier[i] = reader.take(channels * sizeof(int32_t));
+        blobShift[i] = reader.take(channels);
+        paramBytes += align16(channels * sizeof(int32_t)) + align16(channels);
+        if (!reader.ok) return false;
+        for (size_t ch = 0; ch < channels; ch++) {
+            int8_t shift = static_cast<int8_t>(blobShift[i][ch]);
+            if (shift < -31 || shift > 30) return false;
+        }
+
+        h = layer.outH;
+        w = layer.outW;
+        c = layer.outC;
+        zero = layer.outZero;
+        if (c > maxChannels) maxChannels = c;
+        if (h * w * c > maxActivation) maxActivation = h * w * c;
+    }
+
+    if (reader.pos != size) return false;
+    if (h != 1 || w != 1 || c != info.classes) return false;
+    info.outputZeroPoint = zero;
+
+    // One allocation, 16 bytes of slack to align its start
+    size_t total = paramBytes + 2 * align16(maxActivation) + align16(maxPatch)
+                 + align16(maxChannels * sizeof(int32_t)) + 16;
+    m_storage = new (std::nothrow) uint8_t[total];
+    if (!m_storage) return false;
+    m_storageBytes = total;
+    uint8_t* next = reinterpret_cast<uint8_t*>(align16(reinterpret_cast<uintptr_t>(m_storage)));
+    auto carve = [&next](size_t bytes) {
+        uint8_t* p = next;
+        next += align16(bytes);
+        return p;
+    };
+
+    // Second pass: copy parameters, folding the input zero point into the
+    // conv bias: sum((x - zp) * w) = sum(x * w) - zp * sum(w), and a patch
+    // padded with zp adds exactly zp * w there, so padding needs no care
+    for (size_t i = 0; i < layerCount; i++) {
+        Layer& layer = m_layers[i];
+        size_t channels = (layer.type == LayerType::AvgPool) ? 1 : layer.outC;
+
+        if (layer.type == LayerType::Conv) {
+            size_t k = static_cast<size_t>(layer.kernelH) * layer.kernelW * layer.inC;
+            int8_t* weights = reinterpret_cast<int8_t*>(carve(channels * layer.rowBytes));
+            int32_t* bias = reinterpret_cast<int32_t*>(carve(channels * sizeof(int32_t)));
+            for (size_t ch = 0; ch < channels; ch++) {
+                const int8_t* src = reinterpret_cast<const int8_t*>(blobWeights[i]) + ch * k;
+                memcpy(weights + ch * layer.rowBytes, src, k);
+                memset(weights + ch * layer.rowBytes + k, 0, layer.rowBytes - k);
+                int32_t sum = 0;
+                for (size_t j = 0; j < k; j++) sum += src[j];
+                bias[ch] = static_cast<int32_t>(getLe32(blobBias[i] + 4 * ch)) - layer.inZero * sum;
+            }
+            layer.weights = weights;
+            layer.bias = bias;
+        } else if (layer.type == LayerType::Depthwise) {
+            size_t bytes = static_cast<size_t>(layer.kernelH) * layer.kernelW * layer.inC;
+            int8_t* weights = reinterpret_cast<int8_t*>(carve(bytes));
+            int32_t* bias = reinterpret_cast<int32_t*>(carve(channels * sizeof(int32_t)));
+            memcpy(weights, blobWeights[i], bytes);
+            for (size_t ch = 0; ch < channels; ch++) {
+                bias[ch] = static_cast<int32_t>(getLe32(blobBias[i] + 4 * ch));
+            }
+            layer.weights = weights;
+            layer.bias = bias;
+        } else {
+            layer.weights = nullptr;
+            layer.bias = nullptr;
+        }
+
+        int32_t* multiplier = reinterpret_cast<int32_t*>(carve(channels * sizeof(int32_t)));
+        int8_t* shift = reinterpret_cast<int8_t*>(carve(channels));
+        for (size_t ch = 0; ch < channels; ch++) {
+            multiplier[ch] = static_cast<int32_t>(getLe32(blobMultiplier[i] + 4 * ch));
+        }
+        memcpy(shift, blobShift[i], channels);
+        layer.multiplier = multiplier;
+        layer.shift = shift;
+    }
+
+    m_activations[0] = reinterpret_cast<int8_t*>(carve(maxActivation));
+    m_activations[1] = reinterpret_cast<int8_t*>(carve(maxActivation));
+    m_patch = reinterpret_cast<int8_t*>(carve(maxPatch));
+    m_accumulators = reinterpret_cast<int32_t*>(carve(maxChannels * sizeof(int32_t)));
+
+    m_info = info;
+    m_layerCount = layerCount;
+    m_macs = (macs > UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(macs);
+    return true;
+}
+
+// ============================================================
+// INFERENCE
+// ============================================================
+
+const int8_t* KeywordModel::invoke(const int8_t* input) {
+    const int8_t* in = input;
+    int8_t* out = nullptr;
+    for (size_t i = 0; i < m_layerCount; i++) {
+        const Layer& layer = m_layers[i];
+        out = m_activations[i % 2];
+        switch (layer.type) {
+            case LayerType::Conv:
+                runConv(layer, in, out);
+                break;
+            case LayerType::Depthwise:
+                runDepthwise(layer, in, out);
+                break;
+            case LayerType::AvgPool:
+                runAvgPool(layer, in, out);
+                break;
+        }
+        in = out;
+    }
+    return out;
+}
+
+void KeywordModel::runConv(const Layer& layer, const int8_t* in, int8_t* out) {
+    const int inH = layer.inH;
+    const int inW = layer.inW;
+    const size_t inC = layer.inC;
+    const size_t k = static_cast<size_t>(layer.kernelH) * layer.kernelW * inC;
+    const bool pointwise = layer.kernelH == 1 && layer.kernelW == 1 && layer.padTop == 0 && layer.padLeft == 0;
+
+    for (int oy = 0; oy < layer.outH; oy++) {
+        for (int ox = 0; ox < layer.outW; ox++) {
+            const int y0 = oy * layer.strideH - layer.padTop;
+            const int x0 = ox * layer.strideW - layer.padLeft;
+
+            // im2col: the receptive field as one contiguous row, padded
+            // with the input zero point (pointwise reads the pixel in place)
+            const int8_t* patch;
+            if (pointwise) {
+                patch = in + (static_cast<size_t>(y0) * inW + x0) * inC;
+            } else {
+                int8_t* p = m_patch;
+                for (int ky = 0; ky < layer.kernelH; ky++) {
+                    int iy = y0 + ky;
+                    for (int kx = 0; kx < layer.kernelW; kx++) {
+                        int ix = x0 + kx;
+                        if (iy < 0 || iy >= inH || ix < 0 || ix >= inW) {
+                            memset(p, layer.inZero, inC);
+                        } else {
+                            memcpy(p, in + (static_cast<size_t>(iy) * inW + ix) * inC, inC);
+                        }
+                        p += inC;
+                    }
+                }
+                patch = m_patch;
+            }
+
+            int8_t* o = out + (static_cast<size_t>(oy) * layer.outW + ox) * layer.outC;
+            const int8_t* row = layer.weights;
+            for (size_t oc = 0; oc < layer.outC; oc++, row += layer.rowBytes) {
+                int32_t acc = layer.bias[oc] + Dsp::dotProductQ7(patch, row, k);
+                o[oc] = requantize(acc, layer.multiplier[oc], layer.shift[oc],
+                                   layer.outZero, layer.actMin, layer.actMax);
+            }
+        }
+    }
+}
+
+void KeywordModel::runDepthwise(const Layer& layer, const int8_t* in, int8_t* out) {
+    const int inH = layer.inH;
+    const int inW = layer.inW;
+    const size_t channels = layer.inC;
+    const int32_t zero = layer.inZero;
+    int32_t* acc = m_accumulators;
+
+    for (int oy = 0; oy < layer.outH; oy++) {
+        for (int ox = 0; ox < layer.outW; ox++) {
+            const int y0 = oy * layer.strideH - layer.padTop;
+            const int x0 = ox * layer.strideW - layer.padLeft;
+            memcpy(acc, layer.bias, channels * sizeof(int32_t));
+
+            // Padding is skipped: it would add (zp - zp) * w
+            for (int ky = 0; ky < layer.kernelH; ky++) {
+                int iy = y0 + ky;
+                if (iy < 0 || iy >= inH) continue;
+                for (int kx = 0; kx < layer.kernelW; kx++) {
+                    int ix = x0 + kx;
+                    if (ix < 0 || ix >= inW) continue;
+                    const int8_t* px = in + (static_cast<size_t>(iy) * inW + ix) * channels;
+                    const int8_t* w = layer.weights + (static_cast<size_t>(ky) * layer.kernelW + kx) * channels;
+                    for (size_t ch = 0; ch < channels; ch++) {
+                        acc[ch] += (px[ch] - zero) * w[ch];
+                    }
+                }
+            }
+
+            int8_t* o = out + (static_cast<size_t>(oy) * layer.outW + ox) * channels;
+            for (size_t ch = 0; ch < channels; ch++) {
+                o[ch] = requantize(acc[ch], layer.multiplier[ch], layer.shift[ch],
+                                   layer.outZero, layer.actMin, layer.actMax);
+            }
+        }
+    }
+}
+
+void KeywordModel::runAvgPool(const Layer& layer, const int8_t* in, int8_t* out) {
+    const size_t channels = layer.inC;
+    const size_t pixels = static_cast<size_t>(layer.inH) * layer.inW;
+    const int32_t zero = layer.inZero;
+    int32_t* acc = m_accumulators;
+
+    memset(acc, 0, channels * sizeof(int32_t));
+    for (size_t p = 0; p < pixels; p++) {
+        const int8_t* px = in + p * channels;
+        for (size_t ch = 0; ch < channels; ch++) {
+            acc[ch] += px[ch] - zero;
+        }
+    }
+    for (size_t ch = 0; ch < channels; ch++) {
+        out[ch] = requantize(acc[ch], layer.multiplier[0], layer.shift[0],
+                             layer.outZero, layer.actMin, layer.actMax);
+    }
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Quantized Keyword-Spotting Network (int8 DS-CNN)
+ *
+ * Runs a small convolutional classifier over a window of feature frames
+ * (LogMelFrontEnd output) and returns one int8 logit per class. The
+ * network comes from a model blob; the engine supports the layers a
+ * depthwise-separable CNN needs:
+ *
+ *   CONV        Any kernel and stride, valid or same padding (pointwise
+ *               1x1 and the final fully-connected layer are convs too)
+ *   DEPTHWISE   One filter per channel
+ *   AVGPOOL     Global average over height and width
+ *
+ * Arithmetic follows the usual int8 scheme: int8 activations with a
+ * per-tensor zero point, symmetric int8 weights, int32 bias, and a
+ * per-channel fixed-point multiplier (Q31) and shift that rescale the
+ * int32 accumulator to the next layer's scale, rounded, offset by its
+ * zero point and clamped to the activation range (ReLU is a clamp at the
+ * zero point). Conv inner products are Dsp::dotProductQ7 over an im2col
+ * patch; the input zero point is folded into the bias at load time.
+ *
+ * Blob layout (little-endian, arrays padded to 4 bytes):
+ *
+ *   Header, 32 bytes
+ *     0  "KWS1"
+ *     4  u16 frames        input height (feature frames)
+ *     6  u8  coefficients  input width (features per frame)
+ *     7  u8  features      LogMelFrontEnd::Output (0 log-mel, 1 MFCC)
+ *     8  u8  melBands
+ *     9  u8  classes
+ *     10 u8  keywordClass  the class that triggers a session
+ *     11 u8  layers
+ *     12 f32 inputScale    feature = (q - inputZeroPoint) * inputScale
+ *     16 i8  inputZeroPoint
+ *     20 f32 outputScale   logit = (q - last layer's zero point) * outputScale
+ *   Per layer, a 12-byte header
+ *     0  u8  type (1 CONV, 2 DEPTHWISE, 3 AVGPOOL)
+ *     1  u8  kernelH, kernelW, strideH, strideW
+ *     5  u8  padding (0 valid, 1 same)
+ *     6  u16 outChannels (CONV; others keep the input's)
+ *     8  i8  outputZeroPoint, activationMin, activationMax
+ *   then its parameters
+ *     CONV       i8 weights[out][kh][kw][in], i32 bias[out],
+ *                i32 multiplier[out], i8 shift[out]
+ *     DEPTHWISE  i8 weights[kh][kw][ch], i32 bias[ch],
+ *                i32 multiplier[ch], i8 shift[ch]
+ *     AVGPOOL    i32 multiplier, i8 shift (the 1/(h*w) is folded in)
+ *
+ * The last layer must produce 1x1xclasses. load() copies everything it
+ * needs, so the blob can be freed afterwards.
+ *
+ * Not thread-safe; owned by one KeywordSpotter.
+ */
+class KeywordModel {
+public:
+    static constexpr size_t MAX_LAYERS = 16;
+    static constexpr size_t MAX_CHANNELS = 256;
+    static constexpr size_t MAX_CLASSES = 16;
+
+    struct Info {
+        uint16_t frames;
+        uint8_t coefficients;
+        uint8_t features;
+        uint8_t melBands;
+        uint8_t classes;
+        uint8_t keywordClass;
+        float inputScale;
+        int8_t inputZeroPoint;
+        float outputScale;
+        int8_t outputZeroPoint;
+    };
+
+    KeywordModel() = default;
+    ~KeywordModel();
+
+    KeywordModel(const KeywordModel&) = delete;
+    KeywordModel& operator=(const KeywordModel&) = delete;
+
+    /**
+     * Parse and copy a model blob, replacing any earlier model
+     * @return false if the blob is malformed, unsupported or does not fit
+     *         in memory (the model is left empty)
+     */
+    bool load(const uint8_t* blob, size_t size);
+
+    /**
+     * load() from a file (SPIFFS on the board, any path on the host); an
+     * unreadable file also leaves the model empty
+     */
+    bool loadFile(const char* path);
+
+    bool isLoaded() const { return m_layerCount > 0; }
+    const Info& info() const { return m_info; }
+
+    /**
+     * Input size: frames * coefficients features, frame-major
+     */
+    size_t inputSize() const { return static_cast<size_t>(m_info.frames) * m_info.coefficients; }
+
+    /**
+     * Multiply-accumulates per inference, and bytes held (parameters and
+     * activations)
+     */
+    uint32_t macs() const { return m_macs; }
+    size_t memoryBytes() const { return m_storageBytes; }
+
+    /**
+     * Classify one window
+     * @param input inputSize() quantized features
+     * @return info().classes logits, valid until the next invoke()
+     */
+    const int8_t* invoke(const int8_t* input);
+
+private:
+    enum class LayerType : uint8_t { Conv = 1, Depthwise = 2, AvgPool = 3 };
+
+    struct Layer {
+        LayerType type;
+        uint8_t kernelH, kernelW, strideH, strideW;
+        uint16_t inH, inW, inC;
+        uint16_t outH, outW, outC;
+        uint16_t padTop, padLeft;
+        int8_t inZero, outZero, actMin, actMax;
+        size_t rowBytes;          // CONV: weight row stride (16-byte multiple)
+        const int8_t* weights;
+        const int32_t* bias;      // CONV: input zero point folded in
+        const int32_t* multiplier;
+        const int8_t* shift;
+    };
+
+    Info m_info = {};
+    Layer m_layers[MAX_LAYERS];
+    size_t m_layerCount = 0;
+    uint32_t m_macs = 0;
+
+    // One allocation: parameters, two activation buffers, the im2col patch
+    // and the depthwise accumulators, each 16-byte aligned
+    uint8_t* m_storage = nullptr;
+    size_t m_storageBytes = 0;
+    int8_t* m_activations[2] = {nullptr, nullptr};
+    int8_t* m_patch = nullptr;
+    int32_t* m_accumulators = nullptr;
+
+    void release();
+    void runConv(const Layer& layer, const int8_t* in, int8_t* out);
+    void runDepthwise(const Layer& layer, const int8_t* in, int8_t* out);
+    void runAvgPool(const Layer& layer, const int8_t* in, int8_t* out);
+};
@@ -0,0 +1,149 @@
+#include "KeywordSpotter.h"
+#include <cmath>
+#include <cstring>
+
+extern "C" {
+#include "esp_cpu.h"
+}
+
+bool KeywordSpotter::begin(KeywordModel* model) {
+    if (!model || !model->isLoaded()) return false;
+    const KeywordModel::Info& info = model->info();
+    if (model->inputSize() > MAX_FEATURES) return false;
+
+    LogMelFrontEnd::Config config;
+    config.output = static_cast<LogMelFrontEnd::Output>(info.features);
+    config.bands = info.melBands;
+    config.coefficients = info.coefficients;
+    config.scale = info.inputScale;
+    config.zeroPoint = info.inputZeroPoint;
+    if (!m_frontEnd.init(config)) return false;
+
+    m_model = model;
+    reset();
+    resetStats();
+    return true;
+}
+
+void KeywordSpotter::reset() {
+    m_decimator.reset();
+    memset(m_window, 0, sizeof(m_window));
+    m_hopFill = 0;
+    memset(m_features, 0, sizeof(m_features));
+    m_framesSeen = 0;
+    m_hopsSinceInference = 0;
+    m_posteriorCount = 0;
+    m_posteriorNext = 0;
+    m_score = 0.0f;
+    m_refractoryHops = 0;
+}
+
+KeywordSpotter::Stats KeywordSpotter::getStats() const {
+    Stats s;
+    s.inferences = m_inferences.load(std::memory_order_relaxed);
+    s.detections = m_detections.load(std::memory_order_relaxed);
+    s.lastCycles = m_lastCycles.load(std::memory_order_relaxed);
+    s.maxCycles = m_maxCycles.load(std::memory_order_relaxed);
+    s.frontEndCycles = m_frontEndCycles.load(std::memory_order_relaxed);
+    return s;
+}
+
+void KeywordSpotter::resetStats() {
+    m_inferences.store(0, std::memory_order_relaxed);
+    m_detections.store(0, std::memory_order_relaxed);
+    m_lastCycles.store(0, std::memory_order_relaxed);
+    m_maxCycles.store(0, std::memory_order_relaxed);
+    m_frontEndCycles.store(0, std::memory_order_relaxed);
+}
+
+// ============================================================
+// STREAM
+// ============================================================
+
+bool KeywordSpotter::process(const int16_t* samples, size_t count) {
+    if (!m_model) return false;
+
+    bool detected = false;
+    const size_t block = HalfbandDownsampler::MAX_INPUT;
+    for (size_t pos = 0; pos + 2 <= count; pos += block) {
+        size_t n = (count - pos < block) ? count - pos : block;
+        size_t decimated = m_decimator.process(samples + pos, n, m_decimated);
+
+        for (size_t i = 0; i < decimated; i++) {
+            m_window[WINDOW - HOP + m_hopFill] = m_decimated[i];
+            if (++m_hopFill == HOP) {
+                detected = runHop() || detected;
+                memmove(m_window, m_window + HOP, (WINDOW - HOP) * sizeof(int16_t));
+                m_hopFill = 0;
+            }
+        }
+    }
+    return detected;
+}
+
+/**
+ * One 20ms hop: a feature row, and an inference every INFERENCE_HOPS
+ * @return true on detection
+ */
+bool KeywordSpotter::runHop() {
+    const KeywordModel::Info& info = m_model->info();
+    const size_t rowBytes = info.coefficients;
+    const size_t frames = info.frames;
+
+    memmove(m_features, m_features + rowBytes, (frames - 1) * rowBytes);
+    uint32_t start = esp_cpu_get_ccount();
+    m_frontEnd.compute(m_window, m_features + (frames - 1) * rowBytes);
+    uint32_t cycles = esp_cpu_get_ccount() - start;
+    if (cycles > m_frontEndCycles.load(std::memory_order_relaxed)) {
+        m_frontEndCycles.store(cycles, std::memory_order_relaxed);
+    }
+
+    if (m_framesSeen < frames) m_framesSeen++;
+    if (m_refractoryHops > 0) m_refractoryHops--;
+    if (++m_hopsSinceInference < INFERENCE_HOPS || m_framesSeen < frames) return false;
+    m_hopsSinceInference = 0;
+
+    start = esp_cpu_get_ccount();
+    const int8_t* logits = m_model->invoke(m_features);
+    cycles = esp_cpu_get_ccount() - start;
+    m_inferences.fetch_add(1, std::memory_order_relaxed);
+    m_lastCycles.store(cycles, std::memory_order_relaxed);
+    if (cycles > m_maxCycles.load(std::memory_order_relaxed)) {
+        m_maxCycles.store(cycles, std::memory_order_relaxed);
+    }
+
+    // Moving average of the last SMOOTHING posteriors
+    m_posteriors[m_posteriorNext] = keywordPosterior(logits);
+    m_posteriorNext = (m_posteriorNext + 1) % SMOOTHING;
+    if (m_posteriorCount < SMOOTHING) m_posteriorCount++;
+    float sum = 0.0f;
+    for (size_t i = 0; i < m_posteriorCount; i++) sum += m_posteriors[i];
+    m_score = sum / static_cast<float>(SMOOTHING);
+
+    if (m_refractoryHops > 0 || m_score < m_threshold.load(std::memory_order_relaxed)) return false;
+
+    m_refractoryHops = REFRACTORY_MS * LogMelFrontEnd::SAMPLE_RATE / 1000 / HOP;
+    m_posteriorCount = 0;
+    m_posteriorNext = 0;
+    m_detections.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+/**
+ * Softmax probability of the keyword class
+ */
+float KeywordSpotter::keywordPosterior(const int8_t* logits) const {
+    const KeywordModel::Info& info = m_model->info();
+    float values[KeywordModel::MAX_CLASSES];
+    float largest = -1e30f;
+    for (size_t c = 0; c < info.classes; c++) {
+        values[c] = (logits[c] - info.outputZeroPoint) * info.outputScale;
+        if (values[c] > largest) largest = values[c];
+    }
+    float total = 0.0f;
+    for (size_t c = 0; c < info.classes; c++) {
+        values[c] = expf(values[c] - largest);
+        total += values[c];
+    }
+    return values[info.keywordClass] / total;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "HalfbandConverter.h"
+#include "KeywordModel.h"
+#include "LogMelFrontEnd.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Streaming Keyword Spotter ("Hey Badge")
+ *
+ * Feeds mic audio through the front end and a KeywordModel and decides
+ * when the keyword was said:
+ *
+ * - 16kHz mic audio is decimated to 8kHz (HalfbandDownsampler), framed
+ *   into 32ms windows every 20ms hop and turned into one feature row each
+ * - The model sees the last info().frames rows (about a second) and runs
+ *   every INFERENCE_HOPS hops
+ * - The keyword's softmax posterior is averaged over the last SMOOTHING
+ *   inferences; detection is that average reaching the threshold, then
+ *   nothing for REFRACTORY_MS so one utterance triggers once
+ *
+ * The front end and each inference are timed in CPU cycles (host: ns).
+ *
+ * Threading: begin()/reset()/process() from one task (WakeWordListener),
+ * setThreshold()/getStats() from any.
+ */
+class KeywordSpotter {
+public:
+    static constexpr uint32_t INPUT_RATE = 16000;
+    static constexpr size_t INFERENCE_HOPS = 4;      // 80ms between inferences
+    static constexpr size_t SMOOTHING = 3;           // Posteriors averaged
+    static constexpr uint32_t REFRACTORY_MS = 1500;
+    static constexpr float DEFAULT_THRESHOLD = 0.8f;
+
+    // Largest model window accepted (frames * coefficients)
+    static constexpr size_t MAX_FEATURES = 64 * LogMelFrontEnd::MAX_BANDS;
+
+    struct Stats {
+        uint32_t inferences;
+        uint32_t detections;
+        uint32_t lastCycles;        // Last inference
+        uint32_t maxCycles;         // Worst inference
+        uint32_t frontEndCycles;    // Worst feature frame
+    };
+
+    /**
+     * Bind a loaded model and configure the front end from its header
+     * @return false if the model's features or window are not supported
+     */
+    bool begin(KeywordModel* model);
+
+    /**
+     * Clear the stream: features, smoothing and refractory start over
+     * (after the mic was handed to a session)
+     */
+    void reset();
+
+    void setThreshold(float threshold) { m_threshold.store(threshold, std::memory_order_relaxed); }
+    float getThreshold() const { return m_threshold.load(std::memory_order_relaxed); }
+
+    /**
+     * Consume mic audio
+     * @param samples PCM at INPUT_RATE (any even block size)
+     * @return true if the keyword was detected within this block
+     */
+    bool process(const int16_t* samples, size_t count);
+
+    /**
+     * Smoothed keyword posterior after the last inference (0..1)
+     */
+    float score() const { return m_score; }
+
+    Stats getStats() const;
+    void resetStats();
+
+private:
+    static constexpr size_t WINDOW = LogMelFrontEnd::WINDOW;
+    static constexpr size_t HOP = LogMelFrontEnd::HOP;
+
+    KeywordModel* m_model = nullptr;
+    LogMelFrontEnd m_frontEnd;
+    HalfbandDownsampler m_decimator;
+    std::atomic<float> m_threshold{DEFAULT_THRESHOLD};
+
+    // 8kHz window; the newest HOP samples are appended at the end
+    alignas(16) int16_t m_window[WINDOW];
+    size_t m_hopFill = 0;
+    int16_t m_decimated[HalfbandDownsampler::MAX_INPUT / 2];
+
+    // Model input, oldest frame first; scrolled up one row per hop
+    alignas(16) int8_t m_features[MAX_FEATURES];
+    size_t m_framesSeen = 0;
+    size_t m_hopsSinceInference = 0;
+
+    float m_posteriors[SMOOTHING];
+    size_t m_posteriorCount = 0;
+    size_t m_posteriorNext = 0;
+    float m_score = 0.0f;
+    uint32_t m_refractoryHops = 0;
+
+    std::atomic<uint32_t> m_inferences{0};
+    std::atomic<uint32_t> m_detections{0};
+    std::atomic<uint32_t> m_lastCycles{0};
+    std::atomic<uint32_t> m_maxCycles{0};
+    std::atomic<uint32_t> m_frontEndCycles{0};
+
+    bool runHop();
+    float keywordPosterior(const int8_t* logits) const;
+};
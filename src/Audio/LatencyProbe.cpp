@@ -0,0 +1,207 @@
+#include "LatencyProbe.h"
+#include <cmath>
+#include <cstring>
+
+bool LatencyProbe::trigger(uint32_t sampleRate) {
+    if (isBusy()) return false;
+
+    if (sampleRate != m_sampleRate) {
+        buildChirp(sampleRate);
+    }
+    m_probes.fetch_add(1, std::memory_order_relaxed);
+    m_state.store(State::Armed, std::memory_order_release);
+    return true;
+}
+
+void LatencyProbe::cancel() {
+    // A probe left Armed or Sending would chirp over the next session's
+    // first frames; one left Listening would be closed by its first
+    // incoming frame and counted as a miss
+    m_listening = false;
+    m_sendPos = 0;
+    m_found = false;
+    m_state.store(State::Idle, std::memory_order_release);
+}
+
+void LatencyProbe::buildChirp(uint32_t sampleRate) {
+    m_sampleRate = sampleRate;
+    m_fft.init(FFT_SIZE);
+
+    // Linear sweep: phase = 2*pi*(f0*t + (f1 - f0)*t^2 / (2*T))
+    const float duration = static_cast<float>(CHIRP_SAMPLES) / static_cast<float>(sampleRate);
+    const float sweep = (CHIRP_HIGH_HZ - CHIRP_LOW_HZ) / (2.0f * duration);
+    m_chirpEnergy = 0.0f;
+    for (size_t i = 0; i < CHIRP_SAMPLES; i++) {
+        float t = static_cast<float>(i) / static_cast<float>(sampleRate);
+        float phase = 6.283185307f * (CHIRP_LOW_HZ * t + sweep * t * t);
+        float window = 0.5f - 0.5f * cosf(6.283185307f * static_cast<float>(i) / (CHIRP_SAMPLES - 1));
+        m_chirp[i] = CHIRP_LEVEL * window * sinf(phase);
+        m_chirpEnergy += m_chirp[i] * m_chirp[i];
+    }
+
+    // Correlation is multiplication by the conjugate spectrum
+    memset(m_filter, 0, sizeof(m_filter));
+    memcpy(m_filter, m_chirp, sizeof(m_chirp));
+    m_fft.forwardReal(m_filter);
+    for (size_t k = 0; k <= FFT_SIZE / 2; k++) {
+        m_filter[2 * k + 1] = -m_filter[2 * k + 1];
+    }
+}
+
+// ============================================================
+// OUTGOING (CHIRP)
+// ============================================================
+
+void LatencyProbe::processOutgoing(int16_t* samples, size_t count, int64_t nowUs) {
+    State state = m_state.load(std::memory_order_acquire);
+    if (state == State::Armed) {
+        m_sendPos = 0;
+        m_sentUs = nowUs;
+        state = State::Sending;
+        m_state.store(state, std::memory_order_relaxed);
+    }
+    if (state != State::Sending) return;
+
+    size_t n = CHIRP_SAMPLES - m_sendPos;
+    if (n > count) n = count;
+    for (size_t i = 0; i < n; i++) {
+        samples[i] = static_cast<int16_t>(lrintf(m_chirp[m_sendPos + i]));
+    }
+    m_sendPos += n;
+
+    if (m_sendPos == CHIRP_SAMPLES) {
+        m_state.store(State::Listening, std::memory_order_release);
+    }
+}
+
+// ============================================================
+// INCOMING (MATCHED FILTER)
+// ============================================================
+
+void LatencyProbe::processIncoming(const int16_t* samples, size_t count, int64_t nowUs) {
+    if (m_state.load(std::memory_order_acquire) != State::Listening) {
+        m_listening = false;
+        return;
+    }
+
+    if (!m_listening) {
+        m_listening = true;
+        m_inputFill = 0;
+        m_inputBase = 0;
+        m_samplesIn = 0;
+        m_stampCount = 0;
+        m_bestPeak = 0.0f;
+        m_found = false;
+    }
+
+    m_stamps[m_stampCount % STAMPS] = FrameStamp{m_samplesIn, nowUs};
+    m_stampCount++;
+    m_samplesIn += static_cast<uint32_t>(count);
+
+    for (size_t i = 0; i < count; i++) {
+        m_input[m_inputFill++] = samples[i];
+        if (m_inputFill < FFT_SIZE) continue;
+
+        // A match is confirmed one block later, in case the true peak
+        // straddles the block boundary
+        bool confirm = m_found;
+        correlateBlock();
+        if (confirm) {
+            finish(true);
+            return;
+        }
+
+        memmove(m_input, m_input + HOP, (FFT_SIZE - HOP) * sizeof(float));
+        m_inputFill = FFT_SIZE - HOP;
+        m_inputBase += HOP;
+    }
+
+    if (nowUs - m_sentUs > static_cast<int64_t>(TIMEOUT_US)) {
+        finish(m_found);
+    }
+}
+
+void LatencyProbe::correlateBlock() {
+    memcpy(m_work, m_input, FFT_SIZE * sizeof(float));
+    m_fft.forwardReal(m_work);
+    for (size_t k = 0; k <= FFT_SIZE / 2; k++) {
+        float re = m_work[2 * k];
+        float im = m_work[2 * k + 1];
+        m_work[2 * k] = re * m_filter[2 * k] - im * m_filter[2 * k + 1];
+        m_work[2 * k + 1] = re * m_filter[2 * k + 1] + im * m_filter[2 * k];
+    }
+    m_fft.inverseReal(m_work);
+
+    // Energy of the input under the chirp at each lag (prefix sums)
+    m_energy[0] = 0.0f;
+    for (size_t n = 0; n < FFT_SIZE; n++) {
+        m_energy[n + 1] = m_energy[n] + m_input[n] * m_input[n];
+    }
+
+    const float floor = ENERGY_FLOOR * m_chirpEnergy;
+    const float scale = 1.0f / static_cast<float>(FFT_SIZE);
+    for (size_t lag = 0; lag < HOP; lag++) {
+        float energy = m_energy[lag + CHIRP_SAMPLES] - m_energy[lag];
+        if (energy < 0.0f) energy = 0.0f;
+        float peak = fabsf(m_work[lag] * scale) / sqrtf(m_chirpEnergy * (energy + floor));
+        if (peak >= DETECT_THRESHOLD && peak > m_bestPeak) {
+            m_bestPeak = peak;
+            m_bestIndex = m_inputBase + static_cast<uint32_t>(lag);
+            m_found = true;
+        }
+    }
+}
+
+int64_t LatencyProbe::sampleTimeUs(uint32_t index) const {
+    // Latest remembered frame starting at or before the sample
+    size_t oldest = (m_stampCount > STAMPS) ? m_stampCount - STAMPS : 0;
+    const FrameStamp* stamp = &m_stamps[oldest % STAMPS];
+    for (size_t i = m_stampCount; i > oldest; i--) {
+        const FrameStamp& s = m_stamps[(i - 1) % STAMPS];
+        if (s.index <= index) {
+            stamp = &s;
+            break;
+        }
+    }
+    int64_t offset = static_cast<int64_t>(index) - static_cast<int64_t>(stamp->index);
+    return stamp->timeUs + offset * 1000000 / static_cast<int64_t>(m_sampleRate);
+}
+
+void LatencyProbe::finish(bool detected) {
+    if (detected) {
+        uint32_t rtt = static_cast<uint32_t>(sampleTimeUs(m_bestIndex) - m_sentUs);
+        uint32_t count = m_detected.load(std::memory_order_relaxed);
+        if (count == 0 || rtt < m_minUs.load(std::memory_order_relaxed)) {
+            m_minUs.store(rtt, std::memory_order_relaxed);
+        }
+        if (rtt > m_maxUs.load(std::memory_order_relaxed)) {
+            m_maxUs.store(rtt, std::memory_order_relaxed);
+        }
+        m_lastUs.store(rtt, std::memory_order_relaxed);
+        m_lastPeak.store(static_cast<uint32_t>(m_bestPeak * 100.0f), std::memory_order_relaxed);
+        m_detected.store(count + 1, std::memory_order_relaxed);
+        m_resultReady.store(true, std::memory_order_release);
+    } else {
+        m_missed.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_listening = false;
+    m_state.store(State::Idle, std::memory_order_release);
+}
+
+bool LatencyProbe::takeResult(uint32_t* roundTripUs) {
+    if (!m_resultReady.exchange(false, std::memory_order_acquire)) return false;
+    *roundTripUs = m_lastUs.load(std::memory_order_relaxed);
+    return true;
+}
+
+LatencyProbe::Stats LatencyProbe::getStats() const {
+    Stats s;
+    s.probes = m_probes.load(std::memory_order_relaxed);
+    s.detected = m_detected.load(std::memory_order_relaxed);
+    s.missed = m_missed.load(std::memory_order_relaxed);
+    s.lastUs = m_lastUs.load(std::memory_order_relaxed);
+    s.minUs = m_minUs.load(std::memory_order_relaxed);
+    s.maxUs = m_maxUs.load(std::memory_order_relaxed);
+    s.lastPeak = m_lastPeak.load(std::memory_order_relaxed);
+    return s;
+}
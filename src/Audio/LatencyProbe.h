@@ -0,0 +1,148 @@
+#pragma once
+
+#include "Fft.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Round-Trip Latency Probe (diagnostic)
+ *
+ * Measures the SCO round trip through a phone that loops the uplink back
+ * to the downlink (e.g. a loopback mode in the companion app):
+ *
+ *   trigger() -> processOutgoing() replaces the start of the next mic
+ *   frame(s) with a marker chirp -> phone -> processIncoming() runs a
+ *   matched filter over the returning audio
+ *
+ * The chirp is a Hann-windowed linear sweep over CHIRP_LOW_HZ..CHIRP_HIGH_HZ
+ * (inside both the CVSD and mSBC passbands). Detection is an overlap-save
+ * cross-correlation (FFT_SIZE real FFTs, one per HOP incoming samples),
+ * normalized by the energy under the chirp, so the threshold does not
+ * depend on the loopback gain.
+ *
+ * The round trip is taken from callback timestamps: the outgoing callback
+ * that carried the first chirp sample, and the incoming callback holding
+ * the correlation peak plus the peak's offset in that frame. It covers
+ * stack, radio and phone in both directions; the on-device buffering on
+ * either side (mic ring, jitter buffer, speaker DMA) is added by the
+ * caller to get mouth-to-ear.
+ *
+ * No platform dependencies, so the detector runs unchanged on a Linux
+ * host against a simulated loopback. processOutgoing() and
+ * processIncoming() are called from the SCO callbacks; trigger(),
+ * cancel(), takeResult() and getStats() from any one other task.
+ */
+class LatencyProbe {
+public:
+    static constexpr size_t FFT_SIZE = 256;
+    static constexpr size_t CHIRP_SAMPLES = 128;         // 16ms at 8kHz, 8ms at 16kHz
+    static constexpr size_t HOP = FFT_SIZE - CHIRP_SAMPLES;
+    static constexpr float CHIRP_LOW_HZ = 400.0f;
+    static constexpr float CHIRP_HIGH_HZ = 3200.0f;
+    static constexpr float CHIRP_LEVEL = 8192.0f;        // -12dBFS peak
+    static constexpr float DETECT_THRESHOLD = 0.5f;      // Normalized correlation
+    static constexpr uint32_t TIMEOUT_US = 1000000;
+
+    struct Stats {
+        uint32_t probes;        // Chirps sent
+        uint32_t detected;
+        uint32_t missed;        // No match within TIMEOUT_US
+        uint32_t lastUs;        // Most recent round trip
+        uint32_t minUs;
+        uint32_t maxUs;
+        uint32_t lastPeak;      // Normalized correlation of the last match (percent)
+    };
+
+    /**
+     * Send a chirp with the next outgoing frame
+     * @param sampleRate SCO link rate
+     * @return false if a probe is still in flight
+     */
+    bool trigger(uint32_t sampleRate);
+
+    bool isBusy() const { return m_state.load(std::memory_order_acquire) != State::Idle; }
+
+    /**
+     * Drop a probe in flight without counting it (the SCO link went down)
+     *
+     * The next trigger() starts clean, with a chirp for its own rate. Call
+     * once the SCO callbacks have stopped.
+     */
+    void cancel();
+
+    /**
+     * Outgoing SCO callback: overwrite samples with the chirp while sending
+     */
+    void processOutgoing(int16_t* samples, size_t count, int64_t nowUs);
+
+    /**
+     * Incoming SCO callback: look for the returning chirp
+     */
+    void processIncoming(const int16_t* samples, size_t count, int64_t nowUs);
+
+    /**
+     * Fetch a new measurement once
+     * @return false if nothing was measured since the last call
+     */
+    bool takeResult(uint32_t* roundTripUs);
+
+    Stats getStats() const;
+
+private:
+    enum class State : uint8_t {
+        Idle,
+        Armed,       // Waiting for the next outgoing frame
+        Sending,     // Chirp spans outgoing frames
+        Listening    // Matched filter running on incoming audio
+    };
+
+    static constexpr size_t STAMPS = 16;   // Incoming frames remembered for timing
+    static constexpr float ENERGY_FLOOR = 1e-3f;   // Relative to the chirp energy
+
+    struct FrameStamp {
+        uint32_t index;       // First sample, counted from the start of listening
+        int64_t timeUs;
+    };
+
+    std::atomic<State> m_state{State::Idle};
+    uint32_t m_sampleRate = 0;
+    Fft m_fft;
+
+    // Built by trigger() before the probe is armed
+    float m_chirp[CHIRP_SAMPLES];
+    float m_filter[FFT_SIZE + 2];   // Conjugate chirp spectrum
+    float m_chirpEnergy = 0.0f;
+
+    // Outgoing callback
+    size_t m_sendPos = 0;
+    int64_t m_sentUs = 0;          // Published with State::Listening
+
+    // Incoming callback
+    bool m_listening = false;
+    float m_input[FFT_SIZE];
+    size_t m_inputFill = 0;
+    uint32_t m_inputBase = 0;      // Sample index of m_input[0]
+    uint32_t m_samplesIn = 0;
+    FrameStamp m_stamps[STAMPS];
+    size_t m_stampCount = 0;
+    float m_bestPeak = 0.0f;
+    uint32_t m_bestIndex = 0;
+    bool m_found = false;
+    alignas(16) float m_work[FFT_SIZE + 2];
+    float m_energy[FFT_SIZE + 1];
+
+    std::atomic<uint32_t> m_probes{0};
+    std::atomic<uint32_t> m_detected{0};
+    std::atomic<uint32_t> m_missed{0};
+    std::atomic<uint32_t> m_lastUs{0};
+    std::atomic<uint32_t> m_minUs{0};
+    std::atomic<uint32_t> m_maxUs{0};
+    std::atomic<uint32_t> m_lastPeak{0};
+    std::atomic<bool> m_resultReady{false};
+
+    void buildChirp(uint32_t sampleRate);
+    void correlateBlock();
+    int64_t sampleTimeUs(uint32_t index) const;
+    void finish(bool detected);
+};
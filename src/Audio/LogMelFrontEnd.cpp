@@ -0,0 +1,124 @@
+#include "LogMelFrontEnd.h"
+#include "DspKernels.h"
+#include <cmath>
+#include <cstring>
+
+static inline float hzToMel(float hz) {
+    return 2595.0f * log10f(1.0f + hz / 700.0f);
+}
+
+static inline float melToHz(float mel) {
+    return 700.0f * (powf(10.0f, mel / 2595.0f) - 1.0f);
+}
+
+bool LogMelFrontEnd::init(const Config& config) {
+    if (config.bands == 0 || config.bands > MAX_BANDS) return false;
+    if (config.coefficients == 0 || config.coefficients > config.bands) return false;
+    if (config.output == Output::LogMel && config.coefficients != config.bands) return false;
+    if (config.output != Output::LogMel && config.output != Output::Mfcc) return false;
+    if (!(config.scale > 0.0f)) return false;
+
+    m_config = config;
+    m_inverseScale = 1.0f / config.scale;
+    m_fft.init(WINDOW);
+
+    // Periodic Hann, Q15
+    for (size_t i = 0; i < WINDOW; i++) {
+        float a = 6.283185307f * static_cast<float>(i) / static_cast<float>(WINDOW);
+        m_hann[i] = static_cast<int16_t>(lrintf((0.5f - 0.5f * cosf(a)) * 32767.0f));
+    }
+
+    buildFilterbank();
+
+    // DCT-II, orthonormal
+    const size_t bands = config.bands;
+    for (size_t c = 0; c < config.coefficients; c++) {
+        float norm = sqrtf((c == 0 ? 1.0f : 2.0f) / static_cast<float>(bands));
+        for (size_t b = 0; b < bands; b++) {
+            m_dct[c][b] = norm * cosf(3.14159265f * c * (b + 0.5f) / bands);
+        }
+    }
+    return true;
+}
+
+void LogMelFrontEnd::buildFilterbank() {
+    const size_t bands = m_config.bands;
+    const float binHz = static_cast<float>(SAMPLE_RATE) / WINDOW;
+    const float lowMel = hzToMel(LOW_HZ);
+    const float step = (hzToMel(HIGH_HZ) - lowMel) / static_cast<float>(bands + 1);
+
+    size_t used = 0;
+    for (size_t b = 0; b < bands; b++) {
+        float lower = melToHz(lowMel + step * b);
+        float center = melToHz(lowMel + step * (b + 1));
+        float upper = melToHz(lowMel + step * (b + 2));
+
+        m_first[b] = 0;
+        m_count[b] = 0;
+        m_offset[b] = static_cast<uint16_t>(used);
+        for (size_t k = 1; k < BINS && used < 2 * BINS; k++) {
+            float hz = k * binHz;
+            float w = 0.0f;
+            if (hz > lower && hz < center) {
+                w = (hz - lower) / (center - lower);
+            } else if (hz >= center && hz < upper) {
+                w = (upper - hz) / (upper - center);
+            }
+            if (w <= 0.0f) continue;
+            if (m_count[b] == 0) m_first[b] = static_cast<uint8_t>(k);
+            m_weights[used++] = w;
+            m_count[b]++;
+        }
+
+        // A band narrower than a bin takes the bin nearest its centre
+        if (m_count[b] == 0 && used < 2 * BINS) {
+            m_first[b] = static_cast<uint8_t>(lrintf(center / binHz));
+            m_weights[used++] = 1.0f;
+            m_count[b] = 1;
+        }
+    }
+}
+
+// ============================================================
+// PER FRAME
+// ============================================================
+
+void LogMelFrontEnd::computeFloat(const int16_t* window, float* features) {
+    Dsp::windowQ15(window, m_hann, m_windowed, WINDOW);
+    for (size_t i = 0; i < WINDOW; i++) {
+        m_work[i] = m_windowed[i] * (1.0f / 32768.0f);
+    }
+    m_fft.forwardReal(m_work);
+
+    // |X|^2: square re and im in place, then sum the pairs
+    Dsp::multiply(m_work, m_work, m_work, 2 * BINS);
+    for (size_t k = 0; k < BINS; k++) {
+        m_power[k] = m_work[2 * k] + m_work[2 * k + 1];
+    }
+
+    const size_t bands = m_config.bands;
+    float* logMel = (m_config.output == Output::LogMel) ? features : m_logMel;
+    for (size_t b = 0; b < bands; b++) {
+        float energy = Dsp::dotProduct(&m_power[m_first[b]], &m_weights[m_offset[b]], m_count[b]);
+        logMel[b] = logf(energy + LOG_FLOOR);
+    }
+
+    if (m_config.output == Output::Mfcc) {
+        for (size_t c = 0; c < m_config.coefficients; c++) {
+            features[c] = Dsp::dotProduct(m_dct[c], m_logMel, bands);
+        }
+    }
+}
+
+void LogMelFrontEnd::compute(const int16_t* window, int8_t* features) {
+    float values[MAX_BANDS];
+    computeFloat(window, values);
+
+    const int32_t zeroPoint = m_config.zeroPoint;
+    for (size_t c = 0; c < m_config.coefficients; c++) {
+        int32_t q = static_cast<int32_t>(lrintf(values[c] * m_inverseScale)) + zeroPoint;
+        if (q > 127) q = 127;
+        if (q < -128) q = -128;
+        features[c] = static_cast<int8_t>(q);
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Fft.h"
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Log-mel / MFCC Feature Front End for the keyword spotter
+ *
+ * Turns one 32ms window of 8kHz audio into the int8 feature row a
+ * KeywordModel takes, every 20ms hop:
+ *
+ * - Periodic Hann window in Q15 (Dsp::windowQ15), 256-point real FFT
+ * - Power spectrum into up to 40 triangular mel bands, 125Hz to 3.8kHz,
+ *   each band a dot product over its few bins (Dsp::dotProduct)
+ * - Natural log with a floor, so digital silence stays finite
+ * - Optionally a DCT-II to the first MFCCs (one Dsp::dotProduct each)
+ * - Quantized with the model's input scale and zero point, saturating
+ *
+ * 8kHz keeps a 32ms window within Fft::MAX_SIZE; the mic's 16kHz goes
+ * through the same half-band decimator as narrowband SCO first.
+ *
+ * Not thread-safe; owned by one KeywordSpotter.
+ */
+class LogMelFrontEnd {
+public:
+    static constexpr uint32_t SAMPLE_RATE = 8000;
+    static constexpr size_t WINDOW = 256;     // 32ms, also the FFT size
+    static constexpr size_t HOP = 160;        // 20ms
+    static constexpr size_t MAX_BANDS = 40;
+
+    enum class Output : uint8_t {
+        LogMel = 0,   // One feature per mel band
+        Mfcc = 1      // DCT of the log-mel bands, first 'coefficients' kept
+    };
+
+    struct Config {
+        Output output;
+        uint8_t bands;          // Mel bands, at most MAX_BANDS
+        uint8_t coefficients;   // Features per frame: bands for LogMel, at most bands for Mfcc
+        float scale;            // Quantization: feature = (q - zeroPoint) * scale
+        int8_t zeroPoint;
+    };
+
+    /**
+     * Build the window, filterbank and DCT for a configuration
+     * @return false if the configuration is out of range
+     */
+    bool init(const Config& config);
+
+    const Config& config() const { return m_config; }
+
+    /**
+     * Features of one window
+     * @param window WINDOW samples at SAMPLE_RATE, oldest first
+     * @param features coefficients values out
+     */
+    void compute(const int16_t* window, int8_t* features);
+
+    /**
+     * The same features before quantization (log of power, full-scale
+     * sine = 1.0 amplitude), for choosing a model's input scale
+     */
+    void computeFloat(const int16_t* window, float* features);
+
+private:
+    static constexpr size_t BINS = WINDOW / 2 + 1;
+    static constexpr float LOW_HZ = 125.0f;
+    static constexpr float HIGH_HZ = 3800.0f;
+    static constexpr float LOG_FLOOR = 1e-6f;   // Power floor: ln = -13.8
+
+    Config m_config = {Output::LogMel, 0, 0, 1.0f, 0};
+    float m_inverseScale = 1.0f;
+    Fft m_fft;
+
+    alignas(16) int16_t m_hann[WINDOW];
+    alignas(16) int16_t m_windowed[WINDOW];
+    float m_work[WINDOW + 2];        // Real frame / half spectrum
+    float m_power[BINS];
+    float m_logMel[MAX_BANDS];
+
+    // Sparse filterbank: band b weighs bins first[b] .. first[b] + count[b] - 1
+    // with m_weights[offset[b] ...]. Triangles overlap by half, so every
+    // bin is in at most two bands.
+    uint8_t m_first[MAX_BANDS];
+    uint8_t m_count[MAX_BANDS];
+    uint16_t m_offset[MAX_BANDS];
+    float m_weights[2 * BINS];
+
+    float m_dct[MAX_BANDS][MAX_BANDS];   // [coefficient][band], orthonormal
+
+    void buildFilterbank();
+};
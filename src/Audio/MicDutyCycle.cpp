@@ -0,0 +1,71 @@
+#include "MicDutyCycle.h"
+
+void MicDutyCycle::reset(uint32_t sampleRate) {
+    m_sampleRate = sampleRate;
+    m_vad.reset(sampleRate);
+    m_state = State::Settling;
+    m_remaining = samplesFor(SETTLE_MS);
+    m_sleepDue = false;
+    m_onRemainder = 0;
+
+    m_sleeps.store(0, std::memory_order_relaxed);
+    m_wakeups.store(0, std::memory_order_relaxed);
+    m_onMs.store(0, std::memory_order_relaxed);
+    m_offMs.store(0, std::memory_order_relaxed);
+}
+
+bool MicDutyCycle::onChunk(const int16_t* samples, size_t count) {
+    m_onRemainder += count;
+    size_t perMs = samplesFor(1);
+    m_onMs.fetch_add(static_cast<uint32_t>(m_onRemainder / perMs), std::memory_order_relaxed);
+    m_onRemainder %= perMs;
+
+    if (m_state == State::Settling) {
+        if (count < m_remaining) {
+            m_remaining -= count;
+            return false;
+        }
+        m_state = State::Sniffing;
+        m_remaining = samplesFor(SNIFF_MS);
+        return false;
+    }
+
+    m_vad.process(samples, count, false);
+    if (m_vad.isSpeech()) {
+        if (m_state == State::Sniffing) m_wakeups.fetch_add(1, std::memory_order_relaxed);
+        m_state = State::Awake;
+        m_remaining = samplesFor(HOLD_MS);
+        return true;
+    }
+
+    if (count < m_remaining) {
+        m_remaining -= count;
+        return true;
+    }
+    if (m_state == State::Awake) {
+        // Hold expired: one more quiet sniff window before sleeping
+        m_state = State::Sniffing;
+        m_remaining = samplesFor(SNIFF_MS);
+        return true;
+    }
+    m_sleepDue = m_enabled.load(std::memory_order_relaxed);
+    m_remaining = samplesFor(SNIFF_MS);
+    if (m_sleepDue) m_sleeps.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void MicDutyCycle::onWake(uint32_t sleptMs) {
+    m_offMs.fetch_add(sleptMs, std::memory_order_relaxed);
+    m_sleepDue = false;
+    m_state = State::Settling;
+    m_remaining = samplesFor(SETTLE_MS);
+}
+
+MicDutyCycle::Stats MicDutyCycle::getStats() const {
+    Stats s;
+    s.sleeps = m_sleeps.load(std::memory_order_relaxed);
+    s.wakeups = m_wakeups.load(std::memory_order_relaxed);
+    s.onMs = m_onMs.load(std::memory_order_relaxed);
+    s.offMs = m_offMs.load(std::memory_order_relaxed);
+    return s;
+}
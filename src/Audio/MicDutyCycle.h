@@ -0,0 +1,89 @@
+#pragma once
+
+#include "VoiceActivityDetector.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Mic Duty Cycle for wake-word listening
+ *
+ * Decides when the mic may be powered down between sessions. While the
+ * room is quiet the mic sniffs: SNIFF_MS of audio, then SLEEP_MS off. A
+ * sniff that hears speech (VoiceActivityDetector, the same detector as the
+ * session endpointing) keeps the mic on until HOLD_MS after the last
+ * speech, long enough for the keyword and the pause around it.
+ *
+ * After each power-up the first SETTLE_MS are dropped (I2S start-up and
+ * the mic's DC settling would read as an onset).
+ *
+ * The cost is the start of a keyword said while the mic sleeps: up to
+ * SLEEP_MS of it is never heard. The spotter sees the audio it does get
+ * concatenated, gaps removed.
+ *
+ * No platform dependencies. onChunk()/sleepDue()/onWake() from the
+ * capture task, setEnabled()/getStats() from any.
+ */
+class MicDutyCycle {
+public:
+    static constexpr uint32_t SNIFF_MS = 60;
+    static constexpr uint32_t SLEEP_MS = 180;
+    static constexpr uint32_t SETTLE_MS = 15;
+    static constexpr uint32_t HOLD_MS = 2000;
+
+    struct Stats {
+        uint32_t sleeps;      // Times the mic was switched off
+        uint32_t wakeups;     // Sniffs that heard speech and kept the mic on
+        uint32_t onMs;        // Audio captured (settling included)
+        uint32_t offMs;       // Time switched off
+    };
+
+    /**
+     * Start over with the mic on
+     * @param sampleRate Capture rate
+     */
+    void reset(uint32_t sampleRate);
+
+    /**
+     * Runtime switch; when off the mic is never put to sleep
+     */
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * A chunk the mic has just captured
+     * @return true to pass it on to the spotter, false while settling
+     */
+    bool onChunk(const int16_t* samples, size_t count);
+
+    /**
+     * The mic should be switched off now for SLEEP_MS
+     */
+    bool sleepDue() const { return m_sleepDue; }
+
+    /**
+     * The mic is on again
+     * @param sleptMs Time it was off (less than SLEEP_MS if woken early)
+     */
+    void onWake(uint32_t sleptMs);
+
+    Stats getStats() const;
+
+private:
+    enum class State : uint8_t { Settling, Sniffing, Awake };
+
+    VoiceActivityDetector m_vad;
+    std::atomic<bool> m_enabled{true};
+    uint32_t m_sampleRate = 16000;
+    State m_state = State::Settling;
+    size_t m_remaining = 0;      // Samples left to settle, sniff or hold
+    bool m_sleepDue = false;
+    size_t m_onRemainder = 0;    // Captured samples short of a whole ms
+
+    std::atomic<uint32_t> m_sleeps{0};
+    std::atomic<uint32_t> m_wakeups{0};
+    std::atomic<uint32_t> m_onMs{0};
+    std::atomic<uint32_t> m_offMs{0};
+
+    size_t samplesFor(uint32_t ms) const { return static_cast<size_t>(m_sampleRate) * ms / 1000; }
+};
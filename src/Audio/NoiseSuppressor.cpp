@@ -0,0 +1,199 @@
+#include "NoiseSuppressor.h"
+#include "DspKernels.h"
+#include <cmath>
+#include <cstring>
+
+extern "C" {
+#include "esp_cpu.h"
+}
+
+static inline int16_t saturate16(float v) {
+    if (v > 32767.0f) return 32767;
+    if (v < -32768.0f) return -32768;
+    return static_cast<int16_t>(v);
+}
+
+void NoiseSuppressor::reset(uint32_t sampleRate) {
+    m_hop = AudioConfig::frameSamples(sampleRate);
+
+    size_t window = 2 * m_hop;
+    size_t fftSize = 64;
+    while (fftSize < window) fftSize <<= 1;
+    m_fft.init(fftSize);
+    m_bins = fftSize / 2 + 1;
+
+    // Periodic sqrt-Hann: squared windows overlap-add to exactly 1 at 50%
+    for (size_t i = 0; i < window; i++) {
+        float a = 6.283185307f * static_cast<float>(i) / static_cast<float>(window);
+        m_window[i] = sqrtf(0.5f - 0.5f * cosf(a));
+    }
+
+    clearState();
+    m_wasEnabled = false;
+
+    m_frames.store(0, std::memory_order_relaxed);
+    m_overBudget.store(0, std::memory_order_relaxed);
+    m_maxCycles.store(0, std::memory_order_relaxed);
+}
+
+void NoiseSuppressor::clearState() {
+    m_inputFill = 0;
+    memset(m_analysis, 0, sizeof(m_analysis));
+    memset(m_overlap, 0, sizeof(m_overlap));
+    memset(m_outQueue, 0, sizeof(m_outQueue));
+    m_outLen = m_hop;
+
+    memset(m_psd, 0, sizeof(m_psd));
+    memset(m_noise, 0, sizeof(m_noise));
+    memset(m_cleanPrev, 0, sizeof(m_cleanPrev));
+    m_subIdx = 0;
+    m_subFrames = 0;
+    m_frameCount = 0;
+}
+
+NoiseSuppressor::Stats NoiseSuppressor::getStats() const {
+    Stats s;
+    s.frames = m_frames.load(std::memory_order_relaxed);
+    s.overBudget = m_overBudget.load(std::memory_order_relaxed);
+    s.maxCycles = m_maxCycles.load(std::memory_order_relaxed);
+    return s;
+}
+
+// ============================================================
+// MIC PATH
+// ============================================================
+
+void NoiseSuppressor::process(const int16_t* in, int16_t* out, size_t samples) {
+    if (samples > MAX_INPUT) samples = MAX_INPUT;
+
+    if (!m_enabled.load(std::memory_order_relaxed)) {
+        if (out != in) memcpy(out, in, samples * sizeof(int16_t));
+        m_wasEnabled = false;
+        return;
+    }
+    if (!m_wasEnabled) {
+        // (Re-)enabled: start from a clean noise estimate
+        clearState();
+        m_wasEnabled = true;
+    }
+
+    for (size_t i = 0; i < samples; i++) {
+        m_input[m_inputFill] = in[i];
+        if (++m_inputFill == m_hop) {
+            uint32_t start = esp_cpu_get_ccount();
+            runFrame();
+            uint32_t cycles = esp_cpu_get_ccount() - start;
+
+            m_frames.fetch_add(1, std::memory_order_relaxed);
+            if (cycles > CYCLE_BUDGET) {
+                m_overBudget.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (cycles > m_maxCycles.load(std::memory_order_relaxed)) {
+                m_maxCycles.store(cycles, std::memory_order_relaxed);
+            }
+            m_inputFill = 0;
+        }
+    }
+
+    // The queue was primed with one hop, so it always holds enough
+    memcpy(out, m_outQueue, samples * sizeof(int16_t));
+    m_outLen -= samples;
+    memmove(m_outQueue, m_outQueue + samples, m_outLen * sizeof(int16_t));
+}
+
+// ============================================================
+// SPECTRAL PROCESSING
+// ============================================================
+
+void NoiseSuppressor::runFrame() {
+    const size_t hop = m_hop;
+    const size_t window = 2 * hop;
+    const size_t n = m_fft.size();
+
+    // Analysis window: [previous hop | new hop]
+    memmove(m_analysis, m_analysis + hop, hop * sizeof(float));
+    for (size_t i = 0; i < hop; i++) {
+        m_analysis[hop + i] = m_input[i];
+    }
+    Dsp::multiply(m_analysis, m_window, m_work, window);
+    memset(m_work + window, 0, (n - window) * sizeof(float));
+    m_fft.forwardReal(m_work);
+
+    // The first window is half zero padding, which would seed the minimum
+    // tracker low for its whole span: that frame passes through (no noise
+    // estimate yet) and the spectral state starts from the first full one
+    if (m_frameCount > 0) {
+        for (size_t k = 0; k < m_bins; k++) {
+            float p = m_work[2 * k] * m_work[2 * k] + m_work[2 * k + 1] * m_work[2 * k + 1];
+            m_psd[k] = (m_frameCount == 1) ? p : PSD_SMOOTHING * m_psd[k] + (1.0f - PSD_SMOOTHING) * p;
+        }
+        updateNoise();
+    }
+
+    // Wiener gain from the decision-directed a-priori SNR
+    for (size_t k = 0; k < m_bins; k++) {
+        float p = m_work[2 * k] * m_work[2 * k] + m_work[2 * k + 1] * m_work[2 * k + 1];
+        float noise = m_noise[k] + 1.0f;
+        float posteriori = p / noise - 1.0f;
+        if (posteriori < 0.0f) posteriori = 0.0f;
+        float priori = DD_SMOOTHING * m_cleanPrev[k] / noise + (1.0f - DD_SMOOTHING) * posteriori;
+        float gain = priori / (1.0f + priori);
+        if (gain < GAIN_FLOOR) gain = GAIN_FLOOR;
+
+        m_cleanPrev[k] = gain * gain * p;
+        m_work[2 * k] *= gain;
+        m_work[2 * k + 1] *= gain;
+    }
+
+    m_fft.inverseReal(m_work);
+
+    // Synthesis window and overlap-add; the first hop is complete
+    const float invN = 1.0f / static_cast<float>(n);
+    for (size_t i = 0; i < window; i++) {
+        m_overlap[i] += m_work[i] * invN * m_window[i];
+    }
+    for (size_t i = 0; i < hop; i++) {
+        m_outQueue[m_outLen++] = saturate16(m_overlap[i]);
+    }
+    memmove(m_overlap, m_overlap + hop, hop * sizeof(float));
+    memset(m_overlap + hop, 0, hop * sizeof(float));
+
+    m_frameCount++;
+}
+
+void NoiseSuppressor::updateNoise() {
+    if (m_frameCount == 1) {
+        for (size_t k = 0; k < m_bins; k++) {
+            m_currentMin[k] = m_psd[k];
+            m_windowMin[k] = m_psd[k];
+            for (size_t u = 0; u < SUBWINDOWS; u++) {
+                m_subMin[u][k] = m_psd[k];
+            }
+        }
+    } else {
+        for (size_t k = 0; k < m_bins; k++) {
+            if (m_psd[k] < m_currentMin[k]) m_currentMin[k] = m_psd[k];
+        }
+    }
+
+    // Subwindow complete: retire it into the ring and rescan the window
+    if (++m_subFrames >= SUBWINDOW_FRAMES) {
+        m_subFrames = 0;
+        m_subIdx = (m_subIdx + 1) % SUBWINDOWS;
+        for (size_t k = 0; k < m_bins; k++) {
+            m_subMin[m_subIdx][k] = m_currentMin[k];
+            m_currentMin[k] = m_psd[k];
+
+            float m = m_subMin[0][k];
+            for (size_t u = 1; u < SUBWINDOWS; u++) {
+                if (m_subMin[u][k] < m) m = m_subMin[u][k];
+            }
+            m_windowMin[k] = m;
+        }
+    }
+
+    for (size_t k = 0; k < m_bins; k++) {
+        float m = (m_currentMin[k] < m_windowMin[k]) ? m_currentMin[k] : m_windowMin[k];
+        m_noise[k] = MIN_BIAS * m;
+    }
+}
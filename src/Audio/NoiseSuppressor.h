@@ -0,0 +1,114 @@
+#pragma once
+
+#include "AudioConfig.h"
+#include "Fft.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Mic-path Spectral Noise Suppressor
+ *
+ * Removes stationary background noise (HVAC, fans, office murmur) before
+ * mic audio reaches the phone's speech recognizer.
+ *
+ * - STFT with 7.5ms hops (one SCO frame) and 15ms sqrt-Hann windows,
+ *   zero-padded to a 128/256-point FFT at 8kHz/16kHz
+ * - Noise PSD by minimum statistics: the smoothed periodogram's minimum
+ *   over a ~1.4s sliding window, bias compensated. Tracks slowly varying
+ *   noise without a voice activity detector
+ * - Decision-directed a-priori SNR and Wiener gain, floored at -15dB so
+ *   residual noise stays natural and speech onsets are not clipped
+ * - Adds 15ms of latency (one hop of buffering plus one of overlap)
+ *
+ * Each frame's cost is measured in CPU cycles against CYCLE_BUDGET.
+ * The stage can be switched off at runtime; it is then a plain copy.
+ *
+ * Threading: setEnabled()/getStats() from any task, everything else from
+ * the mic path (SCO outgoing-audio callback).
+ */
+class NoiseSuppressor {
+public:
+    // Largest block accepted by process()
+    static constexpr size_t MAX_INPUT = 256;
+
+    // Per-frame budget: ~1ms of a 240MHz core, 13% of a 7.5ms frame
+    static constexpr uint32_t CYCLE_BUDGET = 240000;
+
+    struct Stats {
+        uint32_t frames;        // Frames processed while enabled
+        uint32_t overBudget;    // Frames that exceeded CYCLE_BUDGET
+        uint32_t maxCycles;     // Worst frame cost
+    };
+
+    /**
+     * Clear all state and configure for a link rate (mic path side)
+     * @param sampleRate 8000 or 16000
+     */
+    void reset(uint32_t sampleRate);
+
+    /**
+     * Runtime switch; takes effect on the next process() call
+     */
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * Suppress noise in one block of mic samples
+     * @param in Input samples
+     * @param out Output samples (may alias in)
+     * @param samples Sample count (at most MAX_INPUT)
+     */
+    void process(const int16_t* in, int16_t* out, size_t samples);
+
+    Stats getStats() const;
+
+private:
+    static constexpr size_t MAX_HOP = AudioConfig::FRAME_SAMPLES_16K;
+    static constexpr size_t MAX_WINDOW = 2 * MAX_HOP;
+    static constexpr size_t MAX_BINS = Fft::MAX_SIZE / 2 + 1;
+
+    // Minimum statistics: SUBWINDOWS x SUBWINDOW_FRAMES hops of history
+    static constexpr size_t SUBWINDOWS = 8;
+    static constexpr uint32_t SUBWINDOW_FRAMES = 24;
+    static constexpr float MIN_BIAS = 1.8f;           // Minimum-to-mean correction
+    static constexpr float PSD_SMOOTHING = 0.85f;     // Periodogram smoothing
+    static constexpr float DD_SMOOTHING = 0.98f;      // Decision-directed SNR weight
+    static constexpr float GAIN_FLOOR = 0.18f;        // -15dB
+
+    std::atomic<bool> m_enabled{true};
+    bool m_wasEnabled = false;
+
+    size_t m_hop = MAX_HOP;
+    size_t m_bins = MAX_BINS;
+    Fft m_fft;
+    float m_window[MAX_WINDOW];     // sqrt-Hann, analysis and synthesis
+
+    // Framing: input hop, analysis history, overlap-add tail, output queue
+    int16_t m_input[MAX_HOP];
+    size_t m_inputFill = 0;
+    float m_analysis[MAX_WINDOW];
+    float m_overlap[Fft::MAX_SIZE];
+    int16_t m_outQueue[MAX_HOP + MAX_INPUT];
+    size_t m_outLen = 0;
+    float m_work[Fft::MAX_SIZE + 2];   // Real frame / half spectrum
+
+    // Spectral state per bin
+    float m_psd[MAX_BINS];          // Smoothed periodogram
+    float m_noise[MAX_BINS];        // Noise estimate
+    float m_cleanPrev[MAX_BINS];    // Previous frame's |G * Y|^2
+    float m_subMin[SUBWINDOWS][MAX_BINS];
+    float m_currentMin[MAX_BINS];   // Minimum of the subwindow in progress
+    float m_windowMin[MAX_BINS];    // Minimum of the completed subwindows
+    size_t m_subIdx = 0;
+    uint32_t m_subFrames = 0;
+    uint32_t m_frameCount = 0;
+
+    std::atomic<uint32_t> m_frames{0};
+    std::atomic<uint32_t> m_overBudget{0};
+    std::atomic<uint32_t> m_maxCycles{0};
+
+    void clearState();
+    void runFrame();
+    void updateNoise();
+};
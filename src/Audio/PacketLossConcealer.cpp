@@ -0,0 +1,192 @@
+#include "PacketLossConcealer.h"
+#include <cstring>
+
+static inline int16_t saturate16(float v) {
+    if (v > 32767.0f) return 32767;
+    if (v < -32768.0f) return -32768;
+    return static_cast<int16_t>(v);
+}
+
+void PacketLossConcealer::reset(uint32_t sampleRate) {
+    m_rateFactor = (sampleRate <= 8000) ? 1 : 2;
+    m_historyLen = 0;
+    m_lastLevel = 0;
+    m_zeroRun = 0;
+    m_pitch = 0;
+    m_pitchPos = 0;
+    m_lossSamples = 0;
+}
+
+// ============================================================
+// GOOD FRAMES
+// ============================================================
+
+void PacketLossConcealer::processGood(int16_t* frame, size_t samples) {
+    if (m_lossSamples > 0) {
+        // Cross-fade from the synthetic continuation into the real signal
+        size_t ola = RECOVER_OLA_8K * m_rateFactor;
+        if (ola > samples) ola = samples;
+        for (size_t j = 0; j < ola; j++) {
+            float w = static_cast<float>(j + 1) / static_cast<float>(ola + 1);
+            float synth = m_pitch ? nextSynthetic() : 0.0f;
+            frame[j] = saturate16(synth * (1.0f - w) + frame[j] * w);
+        }
+        m_lossSamples = 0;
+    }
+
+    int32_t sum = 0;
+    for (size_t i = 0; i < samples; i++) {
+        int32_t v = frame[i];
+        sum += (v < 0) ? -v : v;
+    }
+    m_lastLevel = samples ? sum / static_cast<int32_t>(samples) : 0;
+
+    appendHistory(frame, samples);
+}
+
+bool PacketLossConcealer::isCorrupt(const int16_t* frame, size_t samples) {
+    for (size_t i = 0; i < samples; i++) {
+        if (frame[i] != 0) {
+            m_zeroRun = 0;
+            return false;
+        }
+    }
+
+    if (m_zeroRun <= MAX_ZERO_LOSS_FRAMES) m_zeroRun++;
+    if (m_zeroRun > MAX_ZERO_LOSS_FRAMES) return false;
+    return m_lastLevel >= SILENCE_LEVEL || m_lossSamples > 0;
+}
+
+// ============================================================
+// CONCEALMENT
+// ============================================================
+
+bool PacketLossConcealer::conceal(int16_t* out, size_t samples) {
+    if (m_lossSamples == 0) {
+        startConcealment();
+    }
+
+    bool audible = (m_pitch != 0) && (gainAt(m_lossSamples) > 0.0f);
+
+    for (size_t i = 0; i < samples; i++) {
+        out[i] = m_pitch ? nextSynthetic() : 0;
+    }
+    if (!m_pitch) {
+        m_lossSamples += static_cast<uint32_t>(samples);
+    }
+
+    appendHistory(out, samples);
+    return audible;
+}
+
+void PacketLossConcealer::startConcealment() {
+    m_pitch = findPitch();
+    m_pitchPos = 0;
+    if (m_pitch == 0) return;
+
+    // Last pitch period of history, oldest first
+    const int16_t* end = m_history + m_historyLen;
+    memcpy(m_pitchBuf, end - m_pitch, m_pitch * sizeof(int16_t));
+
+    // Smooth the wrap-around joint: fade the period's tail into the samples
+    // that naturally precede its head
+    size_t ola = m_pitch / 4;
+    const int16_t* lead = end - m_pitch - ola;
+    for (size_t j = 0; j < ola; j++) {
+        float w = static_cast<float>(j + 1) / static_cast<float>(ola + 1);
+        int16_t& s = m_pitchBuf[m_pitch - ola + j];
+        s = saturate16(s * (1.0f - w) + lead[j] * w);
+    }
+}
+
+size_t PacketLossConcealer::findPitch() const {
+    size_t pitchMin = PITCH_MIN_8K * m_rateFactor;
+    size_t pitchMax = PITCH_MAX_8K * m_rateFactor;
+    size_t corrLen = CORR_LEN_8K * m_rateFactor;
+
+    // Need the template, the largest lag, and the wrap cross-fade lead-in
+    if (m_historyLen < corrLen + pitchMax + pitchMax / 4) return 0;
+
+    const int16_t* tmpl = m_history + m_historyLen - corrLen;
+
+    // Coarse search on a 2:1 decimated signal, even lags only.
+    // Maximize c / sqrt(e) for positive c, compared without the sqrt.
+    size_t best = 0;
+    float bestC = 0.0f;
+    float bestE = 1.0f;
+    for (size_t lag = pitchMin; lag <= pitchMax; lag += 2) {
+        const int16_t* seg = tmpl - lag;
+        float c = 0.0f;
+        float e = 1.0f;
+        for (size_t k = 0; k < corrLen; k += 2) {
+            float s = seg[k];
+            c += tmpl[k] * s;
+            e += s * s;
+        }
+        if (c > 0.0f && c * c * bestE > bestC * bestC * e) {
+            best = lag;
+            bestC = c;
+            bestE = e;
+        }
+    }
+    if (best == 0) return 0;
+
+    // Refine +-1 around the coarse pick at full rate
+    size_t lo = (best > pitchMin) ? best - 1 : best;
+    size_t hi = (best < pitchMax) ? best + 1 : best;
+    size_t refined = best;
+    bestC = 0.0f;
+    bestE = 1.0f;
+    for (size_t lag = lo; lag <= hi; lag++) {
+        const int16_t* seg = tmpl - lag;
+        float c = 0.0f;
+        float e = 1.0f;
+        for (size_t k = 0; k < corrLen; k++) {
+            float s = seg[k];
+            c += tmpl[k] * s;
+            e += s * s;
+        }
+        if (c > 0.0f && c * c * bestE > bestC * bestC * e) {
+            refined = lag;
+            bestC = c;
+            bestE = e;
+        }
+    }
+    return refined;
+}
+
+float PacketLossConcealer::gainAt(uint32_t lossSample) const {
+    uint32_t samplesPerMs = 8 * m_rateFactor;
+    uint32_t full = FULL_LEVEL_MS * samplesPerMs;
+    uint32_t mute = MUTE_MS * samplesPerMs;
+
+    if (lossSample < full) return 1.0f;
+    if (lossSample >= mute) return 0.0f;
+    return 1.0f - static_cast<float>(lossSample - full) / static_cast<float>(mute - full);
+}
+
+int16_t PacketLossConcealer::nextSynthetic() {
+    float g = gainAt(m_lossSamples);
+    int16_t s = saturate16(m_pitchBuf[m_pitchPos] * g);
+
+    m_pitchPos++;
+    if (m_pitchPos >= m_pitch) m_pitchPos = 0;
+    if (m_lossSamples < 0xFFFFFF) m_lossSamples++;
+    return s;
+}
+
+void PacketLossConcealer::appendHistory(const int16_t* samples, size_t count) {
+    size_t cap = HISTORY_MAX / 2 * m_rateFactor;
+
+    if (count >= cap) {
+        memcpy(m_history, samples + count - cap, cap * sizeof(int16_t));
+        m_historyLen = cap;
+        return;
+    }
+
+    size_t keep = m_historyLen;
+    if (keep + count > cap) keep = cap - count;
+    memmove(m_history, m_history + m_historyLen - keep, keep * sizeof(int16_t));
+    memcpy(m_history + keep, samples, count * sizeof(int16_t));
+    m_historyLen = keep + count;
+}
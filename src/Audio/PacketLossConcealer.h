@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Packet Loss Concealment (speaker path)
+ *
+ * Pitch-based waveform substitution in the style of G.711 Appendix I:
+ * - On the first missing frame, the pitch period of the recent history is
+ *   found by normalized autocorrelation (coarse search on a 2:1 decimated
+ *   signal, then refined at full rate)
+ * - The last pitch period is repeated to fill the gap; the wrap-around
+ *   joint of the period is smoothed with an overlap-add cross-fade
+ * - Full level for the first 10ms of a loss, then a linear fade to
+ *   silence at 60ms so long gaps don't buzz
+ * - On the first good frame after a loss, the synthetic signal is
+ *   overlap-added into the real one to avoid a click
+ *
+ * The concealer adds no delay: good frames pass through untouched except
+ * for the recovery cross-fade. Works at 8kHz (CVSD) and 16kHz (mSBC).
+ *
+ * Not thread-safe; owned by the audio engine task.
+ */
+class PacketLossConcealer {
+public:
+    /**
+     * Forget history and configure for a new stream
+     */
+    void reset(uint32_t sampleRate);
+
+    /**
+     * Pass a good frame through (in place)
+     * Cross-fades out of any concealment in progress, then records history.
+     */
+    void processGood(int16_t* frame, size_t samples);
+
+    /**
+     * Synthesize a replacement for a missing frame
+     * Outputs silence if there is no usable history yet.
+     * @return true if audio was synthesized, false if silence was written
+     */
+    bool conceal(int16_t* out, size_t samples);
+
+    /**
+     * Heuristic for frames the link zero-filled (e.g. mSBC CRC failure):
+     * all samples zero while the preceding audio was clearly not silent.
+     * The stack gives no bad-frame flag, so a zero run longer than
+     * MAX_ZERO_LOSS_FRAMES is taken as genuine digital silence and passes
+     * through (the concealment so far cross-fades into it).
+     * Call once per received frame, in order.
+     */
+    bool isCorrupt(const int16_t* frame, size_t samples);
+
+    bool isConcealing() const { return m_lossSamples > 0; }
+
+private:
+    // Sizes at 8kHz; doubled for 16kHz
+    static constexpr size_t PITCH_MIN_8K = 40;     // 5ms  (200Hz)
+    static constexpr size_t PITCH_MAX_8K = 120;    // 15ms (66Hz)
+    static constexpr size_t CORR_LEN_8K = 80;      // 10ms template
+    static constexpr size_t RECOVER_OLA_8K = 30;   // 3.75ms recovery cross-fade
+    static constexpr size_t HISTORY_MAX = 2 * (CORR_LEN_8K + PITCH_MAX_8K + PITCH_MAX_8K / 4);
+
+    // Attenuation schedule
+    static constexpr uint32_t FULL_LEVEL_MS = 10;
+    static constexpr uint32_t MUTE_MS = 60;
+
+    // Mean absolute level below which a zero frame is taken as genuine silence
+    static constexpr int32_t SILENCE_LEVEL = 64;
+
+    // Zero frames in a row concealed as loss; a longer run is real silence
+    static constexpr uint32_t MAX_ZERO_LOSS_FRAMES = 2;
+
+    uint32_t m_rateFactor = 2;       // 1 = 8kHz, 2 = 16kHz
+    size_t m_historyLen = 0;         // Valid samples in m_history
+    int16_t m_history[HISTORY_MAX];  // Most recent output, oldest first
+    int32_t m_lastLevel = 0;         // Mean |x| of the last good frame
+    uint32_t m_zeroRun = 0;          // Consecutive all-zero frames received
+
+    // Concealment state
+    int16_t m_pitchBuf[2 * PITCH_MAX_8K];
+    size_t m_pitch = 0;
+    size_t m_pitchPos = 0;
+    uint32_t m_lossSamples = 0;      // Samples concealed in the current loss
+
+    size_t findPitch() const;
+    void startConcealment();
+    float gainAt(uint32_t lossSample) const;
+    int16_t nextSynthetic();
+    void appendHistory(const int16_t* samples, size_t count);
+};
@@ -0,0 +1,267 @@
+#include "PreRollBuffer.h"
+#include "ImaAdpcm.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+extern "C" {
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+}
+
+// ============================================================
+// SETUP / CONTROL
+// ============================================================
+
+bool PreRollBuffer::begin(Storage preferred) {
+    if (m_blocks) return true;
+
+    if (preferred == Storage::Psram) {
+        m_blockBytes = sizeof(BlockHeader) + BLOCK_SAMPLES * sizeof(int16_t);
+        m_blocks = static_cast<uint8_t*>(heap_caps_malloc(BLOCK_COUNT * m_blockBytes, MALLOC_CAP_SPIRAM));
+        if (m_blocks) {
+            m_storage = Storage::Psram;
+            return true;
+        }
+    }
+
+    m_blockBytes = sizeof(BlockHeader) + BLOCK_SAMPLES / 2;
+    m_blocks = static_cast<uint8_t*>(heap_caps_malloc(BLOCK_COUNT * m_blockBytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+    m_storage = Storage::Adpcm;
+    return m_blocks != nullptr;
+}
+
+void PreRollBuffer::arm() {
+    if (!m_blocks || m_state.load(std::memory_order_acquire) != State::Off) return;
+
+    // Writer and reader are both idle while Off, so their state is ours
+    m_writeIdx.store(0, std::memory_order_relaxed);
+    m_readIdx.store(0, std::memory_order_relaxed);
+    m_stageFill = 0;
+    m_encPredictor = 0;
+    m_encIndex = 0;
+    m_decodedPos = 0;
+    m_decodedLen = 0;
+    m_finishing.store(false, std::memory_order_relaxed);
+    m_prevPause = false;
+    m_floor = 0xffff;
+    m_backlogMs.store(0, std::memory_order_relaxed);
+    m_catchUpMs.store(0, std::memory_order_relaxed);
+    m_skipped.store(0, std::memory_order_relaxed);
+    m_overwritten.store(0, std::memory_order_relaxed);
+    m_dropped.store(0, std::memory_order_relaxed);
+
+    m_state.store(State::Recording, std::memory_order_release);
+}
+
+void PreRollBuffer::cancel() {
+    m_state.store(State::Off, std::memory_order_release);
+    m_finishing.store(false, std::memory_order_relaxed);
+}
+
+// ============================================================
+// PRODUCER
+// ============================================================
+
+bool PreRollBuffer::write(const int16_t* samples, size_t count) {
+    State state = m_state.load(std::memory_order_acquire);
+    if (state == State::Off) return false;
+
+    if (state == State::Handover) {
+        // Whatever was staged belongs before this chunk, which goes live
+        if (m_stageFill > 0) commitBlock(state);
+        m_state.store(State::Off, std::memory_order_release);
+        return false;
+    }
+
+    while (count > 0) {
+        size_t n = std::min(count, BLOCK_SAMPLES - m_stageFill);
+        memcpy(m_stage + m_stageFill, samples, n * sizeof(int16_t));
+        m_stageFill += n;
+        samples += n;
+        count -= n;
+        if (m_stageFill == BLOCK_SAMPLES) commitBlock(state);
+    }
+    return true;
+}
+
+void PreRollBuffer::commitBlock(State state) {
+    uint32_t w = m_writeIdx.load(std::memory_order_relaxed);
+    uint32_t r = m_readIdx.load(std::memory_order_acquire);
+
+    if (w - r >= BLOCK_COUNT) {
+        if (state == State::Recording) {
+            // Keep the newest audio; the reader may have started in the
+            // meantime, in which case it owns the index and we drop instead
+            if (m_readIdx.compare_exchange_strong(r, r + 1, std::memory_order_acq_rel)) {
+                m_overwritten.fetch_add(1, std::memory_order_relaxed);
+            } else if (w - r >= BLOCK_COUNT) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                m_stageFill = 0;
+                return;
+            }
+        } else {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            m_stageFill = 0;
+            return;
+        }
+    }
+
+    uint8_t* block = slot(w);
+    BlockHeader header;
+    header.predictor = m_encPredictor;
+    header.stepIndex = m_encIndex;
+    header.samples = static_cast<uint8_t>(m_stageFill);
+    header.reserved = 0;
+
+    uint32_t sum = 0;
+    for (size_t i = 0; i < m_stageFill; i++) {
+        sum += static_cast<uint32_t>(std::abs(m_stage[i]));
+    }
+    header.level = static_cast<uint16_t>(sum / m_stageFill);
+
+    uint8_t* payload = block + sizeof(BlockHeader);
+    if (m_storage == Storage::Psram) {
+        memcpy(payload, m_stage, m_stageFill * sizeof(int16_t));
+    } else {
+        // Encoder state runs on across blocks; each header records where
+        // its block starts so any block decodes on its own
+        for (size_t i = 0; i < m_stageFill; i += 2) {
+            uint8_t lo = adpcmEncode(m_stage[i], m_encPredictor, m_encIndex);
+            uint8_t hi = (i + 1 < m_stageFill) ? adpcmEncode(m_stage[i + 1], m_encPredictor, m_encIndex) : 0;
+            payload[i / 2] = static_cast<uint8_t>(lo | (hi << 4));
+        }
+    }
+    memcpy(block, &header, sizeof(header));
+
+    m_stageFill = 0;
+    m_writeIdx.store(w + 1, std::memory_order_release);
+}
+
+// ============================================================
+// CONSUMER
+// ============================================================
+
+bool PreRollBuffer::isServing() const {
+    State state = m_state.load(std::memory_order_acquire);
+    return state == State::Recording || state == State::Draining ||
+        m_finishing.load(std::memory_order_relaxed);
+}
+
+size_t PreRollBuffer::available() const {
+    bool writerDone = m_state.load(std::memory_order_acquire) == State::Off;
+    uint32_t w = m_writeIdx.load(std::memory_order_acquire);
+    uint32_t r = m_readIdx.load(std::memory_order_acquire);
+    size_t count = m_decodedLen - m_decodedPos;
+    if (w == r) return count;
+
+    // Committed blocks are full, except the one flushed at handover - once
+    // the writer is done its header can be read safely
+    count += (w - r - 1) * BLOCK_SAMPLES;
+    if (writerDone) {
+        BlockHeader last;
+        memcpy(&last, slot(w - 1), sizeof(last));
+        return count + last.samples;
+    }
+    return count + BLOCK_SAMPLES;
+}
+
+bool PreRollBuffer::shouldHandOver() const {
+    if (m_state.load(std::memory_order_acquire) != State::Draining) return false;
+    uint32_t w = m_writeIdx.load(std::memory_order_acquire);
+    uint32_t r = m_readIdx.load(std::memory_order_acquire);
+    return w - r <= CATCH_UP_BLOCKS;
+}
+
+void PreRollBuffer::handOver() {
+    m_finishing.store(true, std::memory_order_relaxed);
+    m_catchUpMs.store(static_cast<uint32_t>((esp_timer_get_time() - m_drainStartUs) / 1000),
+        std::memory_order_relaxed);
+    m_state.store(State::Handover, std::memory_order_release);
+}
+
+bool PreRollBuffer::takeBlock() {
+    while (true) {
+        uint32_t r = m_readIdx.load(std::memory_order_acquire);
+        uint32_t w = m_writeIdx.load(std::memory_order_acquire);
+        if (w == r) return false;
+
+        const uint8_t* block = slot(r);
+        BlockHeader header;
+        memcpy(&header, block, sizeof(header));
+        const uint8_t* payload = block + sizeof(BlockHeader);
+
+        size_t len = header.samples;
+        if (m_storage == Storage::Psram) {
+            memcpy(m_decoded, payload, len * sizeof(int16_t));
+        } else {
+            int16_t predictor = header.predictor;
+            uint8_t index = header.stepIndex;
+            for (size_t i = 0; i < len; i++) {
+                uint8_t code = (i & 1) ? (payload[i / 2] >> 4) : (payload[i / 2] & 0x0f);
+                m_decoded[i] = adpcmStep(code, predictor, index);
+            }
+        }
+
+        // While recording, the writer may have overwritten this slot under
+        // us - it advanced m_readIdx first, so the CAS fails and we retry
+        if (!m_readIdx.compare_exchange_strong(r, r + 1, std::memory_order_acq_rel)) continue;
+
+        // Noise floor: follow dips at once, creep up slowly
+        if (header.level < m_floor) {
+            m_floor = header.level;
+        } else if (m_floor < 0xffff) {
+            m_floor++;
+        }
+
+        bool pause = header.level <= static_cast<uint32_t>(m_floor) * 2 + PAUSE_MARGIN;
+        bool skip = pause && m_prevPause && (w - (r + 1)) >= CATCH_UP_BLOCKS &&
+            !m_finishing.load(std::memory_order_relaxed);
+        m_prevPause = pause;
+        if (skip) {
+            m_skipped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        m_decodedPos = 0;
+        m_decodedLen = len;
+        return true;
+    }
+}
+
+size_t PreRollBuffer::read(int16_t* samples, size_t count) {
+    State expected = State::Recording;
+    if (m_state.compare_exchange_strong(expected, State::Draining, std::memory_order_acq_rel)) {
+        m_drainStartUs = esp_timer_get_time();
+        uint32_t w = m_writeIdx.load(std::memory_order_acquire);
+        uint32_t r = m_readIdx.load(std::memory_order_acquire);
+        m_backlogMs.store(static_cast<uint32_t>((w - r) * AudioConfig::FRAME_DURATION_US / 1000),
+            std::memory_order_relaxed);
+    }
+
+    size_t done = 0;
+    while (done < count) {
+        if (m_decodedPos == m_decodedLen && !takeBlock()) break;
+        size_t n = std::min(count - done, m_decodedLen - m_decodedPos);
+        memcpy(samples + done, m_decoded + m_decodedPos, n * sizeof(int16_t));
+        m_decodedPos += n;
+        done += n;
+    }
+
+    // Handed over and the writer has flushed its last block: fully drained
+    if (done < count && m_finishing.load(std::memory_order_relaxed) &&
+        m_state.load(std::memory_order_acquire) == State::Off) {
+        m_finishing.store(false, std::memory_order_relaxed);
+    }
+    return done;
+}
+
+PreRollBuffer::Stats PreRollBuffer::getStats() const {
+    Stats s;
+    s.backlogMs = m_backlogMs.load(std::memory_order_relaxed);
+    s.catchUpMs = m_catchUpMs.load(std::memory_order_relaxed);
+    s.skippedBlocks = m_skipped.load(std::memory_order_relaxed);
+    s.overwritten = m_overwritten.load(std::memory_order_relaxed);
+    s.dropped = m_dropped.load(std::memory_order_relaxed);
+    return s;
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "AudioConfig.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Mic Pre-roll Buffer
+ *
+ * Between the trigger and the SCO link coming up (300-800ms) the user is
+ * often already talking. Once armed, the capture task stores mic audio
+ * here instead of dropping it; when SCO connects the mic path drains the
+ * backlog first and then hands back to live capture.
+ *
+ *   arm() -> Recording: keeps the newest CAPACITY_MS, oldest overwritten
+ *   first read() -> Draining: writer appends, reader catches up
+ *   backlog ~empty -> Handover: writer's next chunk goes live -> Off
+ *
+ * Catching up: pause blocks (level near the noise floor, after another
+ * pause block) are skipped until CATCH_UP_BLOCKS remain, then the reader
+ * hands back to live capture.
+ * Speech is never time-compressed, so the phone's recognizer hears every
+ * word unaltered; the added latency is gone by the first pause.
+ * The echo canceller's speaker reference is not delayed to match the
+ * backlog, so it may need to re-converge after catch-up. The phone rarely
+ * talks back before then.
+ *
+ * Storage is a ring of 7.5ms blocks, either raw PCM (PSRAM) or IMA ADPCM
+ * (4:1, internal RAM). Each block carries its own codec state and level,
+ * so the oldest can be dropped without touching the others.
+ *
+ * Threading: arm()/cancel() from the control task, write() from the
+ * capture task, read()/handOver() from the mic path.
+ */
+class PreRollBuffer {
+public:
+    enum class Storage {
+        Psram,   // 16-bit PCM in external RAM
+        Adpcm    // IMA ADPCM in internal RAM
+    };
+
+    static constexpr uint32_t CAPACITY_MS = 2000;
+    static constexpr size_t BLOCK_SAMPLES = AudioConfig::FRAME_SAMPLES_16K;   // 7.5ms @ I2S rate
+
+    struct Stats {
+        uint32_t backlogMs;       // Audio queued when SCO came up
+        uint32_t catchUpMs;       // Time from SCO up to handing back to live capture
+        uint32_t skippedBlocks;   // Pause blocks dropped to catch up
+        uint32_t overwritten;     // Blocks lost to the CAPACITY_MS limit while recording
+        uint32_t dropped;         // Blocks lost because the ring was full while draining
+    };
+
+    /**
+     * Allocate storage
+     * @param preferred Psram falls back to Adpcm if no external RAM is available
+     * @return false if no storage could be allocated (pre-roll disabled)
+     */
+    bool begin(Storage preferred);
+
+    Storage storage() const { return m_storage; }
+
+    // ===== Control =====
+
+    /**
+     * Start recording (ignored unless idle)
+     */
+    void arm();
+
+    /**
+     * Stop and forget the backlog (session never came up, or ended)
+     */
+    void cancel();
+
+    // ===== Producer (capture task) =====
+
+    /**
+     * Offer captured samples
+     * @return true if stored, false if the caller should use the live path
+     */
+    bool write(const int16_t* samples, size_t count);
+
+    // ===== Consumer (mic path) =====
+
+    /**
+     * The consumer should read from here instead of the live path
+     */
+    bool isServing() const;
+
+    /**
+     * Samples that read() can hand out without waiting for the writer
+     */
+    size_t available() const;
+
+    /**
+     * Backlog is nearly drained: the consumer should flush its live path
+     * and call handOver()
+     */
+    bool shouldHandOver() const;
+    void handOver();
+    bool isHandedOver() const { return m_finishing.load(std::memory_order_relaxed); }
+
+    /**
+     * Copy out backlog (starts draining on the first call)
+     * Never skips below CATCH_UP_BLOCKS, so a count of up to BLOCK_SAMPLES
+     * is filled whenever available() covers it.
+     * @return Samples copied
+     */
+    size_t read(int16_t* samples, size_t count);
+
+    Stats getStats() const;
+
+private:
+    enum class State : uint8_t { Off, Recording, Draining, Handover };
+
+    struct BlockHeader {
+        int16_t predictor;   // ADPCM state at block start
+        uint8_t stepIndex;
+        uint8_t samples;     // Valid samples (last block may be partial)
+        uint16_t level;      // Mean |x|
+        uint16_t reserved;
+    };
+
+    static constexpr size_t BLOCK_COUNT =
+        (CAPACITY_MS * 1000 + AudioConfig::FRAME_DURATION_US - 1) / AudioConfig::FRAME_DURATION_US;
+    static constexpr uint32_t CATCH_UP_BLOCKS = 2;     // Backlog at which live capture takes over
+    static constexpr uint16_t PAUSE_MARGIN = 16;       // Mean |x| above 2x floor that is still a pause
+
+    Storage m_storage = Storage::Adpcm;
+    uint8_t* m_blocks = nullptr;
+    size_t m_blockBytes = 0;
+
+    std::atomic<State> m_state{State::Off};
+    std::atomic<uint32_t> m_writeIdx{0};   // Blocks, free-running
+    std::atomic<uint32_t> m_readIdx{0};    // Advanced by the reader, or by the writer when overwriting
+
+    // Writer state
+    int16_t m_stage[BLOCK_SAMPLES];
+    size_t m_stageFill = 0;
+    int16_t m_encPredictor = 0;
+    uint8_t m_encIndex = 0;
+
+    // Reader state
+    int16_t m_decoded[BLOCK_SAMPLES];
+    size_t m_decodedPos = 0;
+    size_t m_decodedLen = 0;
+    std::atomic<bool> m_finishing{false};   // Handed over, draining what is left
+    bool m_prevPause = false;
+    uint16_t m_floor = 0xffff;
+    int64_t m_drainStartUs = 0;
+
+    std::atomic<uint32_t> m_backlogMs{0};
+    std::atomic<uint32_t> m_catchUpMs{0};
+    std::atomic<uint32_t> m_skipped{0};
+    std::atomic<uint32_t> m_overwritten{0};
+    std::atomic<uint32_t> m_dropped{0};
+
+    void commitBlock(State state);
+    bool takeBlock();
+    uint8_t* slot(uint32_t index) const { return m_blocks + (index % BLOCK_COUNT) * m_blockBytes; }
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+/**
+ * Lock-free SPSC ring of 16-bit PCM samples
+ *
+ * One task writes, one other task reads. Indices are free-running and
+ * masked on access, so CAPACITY must be a power of two.
+ *
+ * The writer never overwrites unread samples; when the ring is full the
+ * excess is dropped and counted. The reader decides how much backlog to
+ * keep via skip().
+ */
+template <size_t CAPACITY>
+class SampleRing {
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+public:
+    /**
+     * Producer: append samples
+     * @return Number of samples stored (less than count if full)
+     */
+    size_t write(const int16_t* samples, size_t count) {
+        uint32_t w = m_writeIdx.load(std::memory_order_relaxed);
+        uint32_t r = m_readIdx.load(std::memory_order_acquire);
+        size_t space = CAPACITY - (w - r);
+        if (count > space) {
+            m_overflows.fetch_add(static_cast<uint32_t>(count - space), std::memory_order_relaxed);
+            count = space;
+        }
+
+        size_t pos = w & MASK;
+        size_t first = CAPACITY - pos;
+        if (first > count) first = count;
+        memcpy(&m_data[pos], samples, first * sizeof(int16_t));
+        memcpy(&m_data[0], samples + first, (count - first) * sizeof(int16_t));
+
+        m_writeIdx.store(w + static_cast<uint32_t>(count), std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Consumer: copy out the oldest samples
+     * @return Number of samples copied (less than count if not enough buffered)
+     */
+    size_t read(int16_t* samples, size_t count) {
+        uint32_t r = m_readIdx.load(std::memory_order_relaxed);
+        uint32_t w = m_writeIdx.load(std::memory_order_acquire);
+        size_t available = w - r;
+        if (count > available) count = available;
+
+        size_t pos = r & MASK;
+        size_t first = CAPACITY - pos;
+        if (first > count) first = count;
+        memcpy(samples, &m_data[pos], first * sizeof(int16_t));
+        memcpy(samples + first, &m_data[0], (count - first) * sizeof(int16_t));
+
+        m_readIdx.store(r + static_cast<uint32_t>(count), std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Consumer: discard the oldest samples
+     * @return Number of samples discarded
+     */
+    size_t skip(size_t count) {
+        uint32_t r = m_readIdx.load(std::memory_order_relaxed);
+        uint32_t w = m_writeIdx.load(std::memory_order_acquire);
+        size_t available = w - r;
+        if (count > available) count = available;
+        m_readIdx.store(r + static_cast<uint32_t>(count), std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Samples currently buffered (exact from the consumer side)
+     */
+    size_t available() const {
+        return m_writeIdx.load(std::memory_order_acquire) - m_readIdx.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Consumer: drop everything buffered
+     */
+    void flush() {
+        m_readIdx.store(m_writeIdx.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    uint32_t overflows() const { return m_overflows.load(std::memory_order_relaxed); }
+    void clearOverflows() { m_overflows.store(0, std::memory_order_relaxed); }
+
+    static constexpr size_t capacity() { return CAPACITY; }
+
+private:
+    static constexpr size_t MASK = CAPACITY - 1;
+
+    int16_t m_data[CAPACITY];
+    std::atomic<uint32_t> m_writeIdx{0};
+    std::atomic<uint32_t> m_readIdx{0};
+    std::atomic<uint32_t> m_overflows{0};
+};
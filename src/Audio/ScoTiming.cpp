@@ -0,0 +1,63 @@
+#include "ScoTiming.h"
+
+void ScoTiming::setCodec(Codec codec) {
+    m_codec.store(static_cast<uint8_t>(codec), std::memory_order_relaxed);
+    for (size_t d = 0; d < DIRECTIONS; d++) {
+        m_restart[d].store(true, std::memory_order_release);
+    }
+}
+
+void ScoTiming::record(Direction dir, int64_t startUs, int64_t endUs, uint32_t bytes) {
+    size_t d = static_cast<size_t>(dir);
+    Channel& ch = m_channels[m_codec.load(std::memory_order_relaxed)][d];
+
+    if (m_restart[d].exchange(false, std::memory_order_acquire)) {
+        m_lastStartUs[d] = 0;
+    }
+    if (m_lastStartUs[d] != 0) {
+        uint32_t interval = static_cast<uint32_t>(startUs - m_lastStartUs[d]);
+        ch.interval.add(interval);
+        if (interval > LATE_INTERVAL_US) {
+            ch.late.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    m_lastStartUs[d] = startUs;
+
+    ch.exec.add(static_cast<uint32_t>(endUs - startUs));
+    ch.bytes.add(bytes);
+}
+
+ScoTiming::Summary ScoTiming::getSummary(Direction dir, Codec codec) const {
+    const Channel& ch = m_channels[static_cast<size_t>(codec)][static_cast<size_t>(dir)];
+    Summary s;
+    s.calls = ch.exec.count();
+    s.late = ch.late.load(std::memory_order_relaxed);
+    s.intervalP50Us = ch.interval.percentile(50);
+    s.intervalP99Us = ch.interval.percentile(99);
+    s.intervalMaxUs = ch.interval.max();
+    s.execP50Us = ch.exec.percentile(50);
+    s.execP99Us = ch.exec.percentile(99);
+    s.execMaxUs = ch.exec.max();
+    s.bytesMin = ch.bytes.min();
+    s.bytesMax = ch.bytes.max();
+    return s;
+}
+
+void ScoTiming::reset() {
+    for (size_t c = 0; c < CODECS; c++) {
+        for (size_t d = 0; d < DIRECTIONS; d++) {
+            Channel& ch = m_channels[c][d];
+            ch.interval.reset();
+            ch.exec.reset();
+            ch.bytes.reset();
+            ch.late.store(0, std::memory_order_relaxed);
+        }
+    }
+    for (size_t d = 0; d < DIRECTIONS; d++) {
+        m_restart[d].store(true, std::memory_order_release);
+    }
+}
+
+const char* ScoTiming::codecName(Codec codec) {
+    return (codec == Codec::Msbc) ? "msbc" : "cvsd";
+}
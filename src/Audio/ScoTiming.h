@@ -0,0 +1,90 @@
+#pragma once
+
+#include "AudioConfig.h"
+#include "Histogram.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * SCO Callback Timing
+ *
+ * Every incoming and outgoing SCO data callback reports its start and
+ * end time (esp_timer_get_time()) and byte count. Per direction and per
+ * codec it keeps histograms of:
+ *
+ * - interval: start to start of consecutive calls (the stack's pacing)
+ * - exec: time spent inside our callback (what we cost the BTU task)
+ * - bytes: payload per call
+ *
+ * An interval over LATE_INTERVAL_US (1.5 frames) is counted as late.
+ * Counts accumulate from boot so long runs give real p99s; the first
+ * call after setCodec() starts a new interval chain and is not measured.
+ *
+ * record() is lock-free and allocation-free (a few atomic adds) and is
+ * called from the Bluedroid callback; summaries can be read from any task.
+ */
+class ScoTiming {
+public:
+    enum class Direction : uint8_t {
+        Incoming,    // Phone -> speaker
+        Outgoing     // Mic -> phone
+    };
+
+    enum class Codec : uint8_t {
+        Cvsd,
+        Msbc
+    };
+
+    static constexpr uint32_t LATE_INTERVAL_US = AudioConfig::FRAME_DURATION_US * 3 / 2;
+
+    struct Summary {
+        uint32_t calls;
+        uint32_t late;             // Intervals over LATE_INTERVAL_US
+        uint32_t intervalP50Us;
+        uint32_t intervalP99Us;
+        uint32_t intervalMaxUs;
+        uint32_t execP50Us;
+        uint32_t execP99Us;
+        uint32_t execMaxUs;
+        uint32_t bytesMin;
+        uint32_t bytesMax;
+    };
+
+    /**
+     * Link up with this codec (starts new interval chains)
+     */
+    void setCodec(Codec codec);
+
+    /**
+     * SCO callback: one call finished
+     */
+    void record(Direction dir, int64_t startUs, int64_t endUs, uint32_t bytes);
+
+    Summary getSummary(Direction dir, Codec codec) const;
+
+    Codec codec() const { return static_cast<Codec>(m_codec.load(std::memory_order_relaxed)); }
+
+    /**
+     * Clear every histogram
+     */
+    void reset();
+
+    static const char* codecName(Codec codec);
+
+private:
+    static constexpr size_t DIRECTIONS = 2;
+    static constexpr size_t CODECS = 2;
+
+    struct Channel {
+        Histogram<128, 250> interval;   // 0..32ms in 250us steps
+        Histogram<128, 20> exec;        // 0..2.56ms in 20us steps
+        Histogram<64, 8> bytes;         // 0..512 bytes
+        std::atomic<uint32_t> late{0};
+    };
+
+    Channel m_channels[CODECS][DIRECTIONS];
+    std::atomic<uint8_t> m_codec{0};
+    std::atomic<bool> m_restart[DIRECTIONS] = {};
+    int64_t m_lastStartUs[DIRECTIONS] = {0, 0};   // Callback context
+};
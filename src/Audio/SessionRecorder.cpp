@@ -0,0 +1,361 @@
+#include "SessionRecorder.h"
+#include "ImaAdpcm.h"
+#include <cstring>
+#include <dirent.h>
+
+extern "C" {
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_spiffs.h"
+#include "esp_timer.h"
+}
+
+// Mount point; the host tests point it at a scratch directory
+#ifndef SESSION_RECORDER_BASE_PATH
+#define SESSION_RECORDER_BASE_PATH "/spiffs"
+#endif
+
+static const char* BASE_PATH = SESSION_RECORDER_BASE_PATH;
+static const char* PARTITION_LABEL = "spiffs";
+static constexpr size_t MAX_FILES = 4;
+static const char* const STREAM_SUFFIX[2] = {"rx", "tx"};
+
+static inline void putLe16(uint8_t* p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+static inline void putLe32(uint8_t* p, uint32_t v) {
+    putLe16(p, static_cast<uint16_t>(v));
+    putLe16(p + 2, static_cast<uint16_t>(v >> 16));
+}
+
+// ============================================================
+// SETUP / CONTROL
+// ============================================================
+
+bool SessionRecorder::begin() {
+    if (m_task) return true;
+
+    esp_vfs_spiffs_conf_t conf = {};
+    conf.base_path = BASE_PATH;
+    conf.partition_label = PARTITION_LABEL;
+    conf.max_files = MAX_FILES;
+    conf.format_if_mount_failed = true;   // First boot only; erasing takes a while
+    if (esp_vfs_spiffs_register(&conf) != ESP_OK) return false;
+
+    size_t used = 0;
+    if (esp_spiffs_info(PARTITION_LABEL, &m_totalBytes, &used) != ESP_OK) return false;
+    scanSessions();
+
+    xTaskCreatePinnedToCore(
+        recorderTask,
+        "session_recorder",
+        TASK_STACK,
+        this,
+        AudioConfig::RECORDER_TASK_PRIORITY,
+        &m_task,
+        TASK_CORE
+    );
+    return true;
+}
+
+void SessionRecorder::start(uint32_t sampleRate) {
+    m_sampleRate.store(sampleRate, std::memory_order_relaxed);
+    m_generation.fetch_add(1, std::memory_order_release);
+    m_active.store(true, std::memory_order_release);
+}
+
+void SessionRecorder::stop() {
+    m_active.store(false, std::memory_order_release);
+}
+
+void SessionRecorder::record(Stream stream, const int16_t* samples, size_t count) {
+    if (!m_active.load(std::memory_order_acquire)) return;
+    Track& track = m_tracks[static_cast<size_t>(stream)];
+    if (track.ring.write(samples, count) < count) {
+        m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+SessionRecorder::Stats SessionRecorder::getStats() const {
+    Stats s;
+    s.session = m_session.load(std::memory_order_relaxed);
+    s.sessions = m_sessions.load(std::memory_order_relaxed);
+    s.deleted = m_deleted.load(std::memory_order_relaxed);
+    s.bytesWritten = m_bytesWritten.load(std::memory_order_relaxed);
+    uint32_t us = m_writeUs.load(std::memory_order_relaxed);
+    s.writeKBps = us ? static_cast<uint32_t>(static_cast<uint64_t>(s.bytesWritten) * 1000000 / 1024 / us) : 0;
+    s.maxWriteUs = m_maxWriteUs.load(std::memory_order_relaxed);
+    s.droppedFrames = m_droppedFrames.load(std::memory_order_relaxed);
+    return s;
+}
+
+// ============================================================
+// RECORDER TASK
+// ============================================================
+
+void SessionRecorder::recorderTask(void* arg) {
+    static_cast<SessionRecorder*>(arg)->recorderLoop();
+}
+
+void SessionRecorder::recorderLoop() {
+    while (true) {
+        bool active = m_active.load(std::memory_order_acquire);
+        uint32_t generation = m_generation.load(std::memory_order_acquire);
+
+        if (m_open && (!active || generation != m_openGeneration)) {
+            closeSession();
+        }
+        if (active && generation != m_openGeneration) {
+            openSession(generation, m_sampleRate.load(std::memory_order_relaxed));
+        }
+
+        if (m_open) {
+            for (size_t s = 0; s < STREAMS; s++) {
+                drain(m_tracks[s], false);
+            }
+            if (m_tracks[0].full || m_tracks[1].full) {
+                closeSession();   // Partition full of this session alone
+            }
+        } else if (active) {
+            discard();
+        } else {
+            for (size_t s = 0; s < STREAMS; s++) {
+                m_tracks[s].ring.flush();   // Frames queued just before stop()
+            }
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(POLL_MS));
+    }
+}
+
+// ============================================================
+// SESSIONS AND RETENTION
+// ============================================================
+
+void SessionRecorder::sessionPath(char* path, size_t size, uint32_t index, size_t stream) {
+    snprintf(path, size, "%s/s%05u_%s.wav", BASE_PATH, static_cast<unsigned>(index), STREAM_SUFFIX[stream]);
+}
+
+void SessionRecorder::scanSessions() {
+    DIR* dir = opendir(BASE_PATH);
+    if (!dir) return;
+
+    bool found = false;
+    uint32_t lowest = 0;
+    uint32_t highest = 0;
+    while (struct dirent* entry = readdir(dir)) {
+        unsigned index = 0;
+        if (sscanf(entry->d_name, "s%u_", &index) != 1) continue;
+        if (!found || index < lowest) lowest = index;
+        if (!found || index > highest) highest = index;
+        found = true;
+    }
+    closedir(dir);
+
+    if (found) {
+        m_oldest = lowest;
+        m_next = highest + 1;
+    }
+}
+
+void SessionRecorder::deleteSession(uint32_t index) {
+    char path[32];
+    for (size_t s = 0; s < STREAMS; s++) {
+        sessionPath(path, sizeof(path), index, s);
+        remove(path);
+    }
+    m_deleted.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool SessionRecorder::makeRoom(size_t bytes, size_t margin) {
+    while (true) {
+        size_t total = 0;
+        size_t used = 0;
+        if (esp_spiffs_info(PARTITION_LABEL, &total, &used) != ESP_OK) return false;
+        if (used < total && total - used >= bytes + margin) return true;
+
+        // Never the session being recorded
+        uint32_t limit = m_open ? m_session.load(std::memory_order_relaxed) : m_next;
+        if (m_oldest >= limit) return false;
+        deleteSession(m_oldest++);
+    }
+}
+
+void SessionRecorder::openSession(uint32_t generation, uint32_t sampleRate) {
+    m_openGeneration = generation;
+    m_openRate = sampleRate;
+    m_dropRemainder = 0;
+    if (!makeRoom(OPEN_RESERVE_BYTES, 0)) return;
+
+    uint32_t index = m_next++;
+    char path[32];
+    for (size_t s = 0; s < STREAMS; s++) {
+        Track& track = m_tracks[s];
+        sessionPath(path, sizeof(path), index, s);
+        track.file = fopen(path, "wb");
+        if (!track.file) {
+            for (size_t o = 0; o < s; o++) {
+                fclose(m_tracks[o].file);
+                m_tracks[o].file = nullptr;
+            }
+            return;
+        }
+        setvbuf(track.file, nullptr, _IONBF, 0);   // One write() per chunk
+
+        track.blockFill = 0;
+        track.samples = 0;
+        track.fileBytes = 0;
+        track.stepIndex = 0;
+        track.full = false;
+        writeHeader(track, track.chunk, false);
+        track.chunkFill = HEADER_BYTES;
+    }
+
+    m_open = true;
+    m_session.store(index, std::memory_order_relaxed);
+    m_sessions.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SessionRecorder::closeSession() {
+    for (size_t s = 0; s < STREAMS; s++) {
+        Track& track = m_tracks[s];
+        drain(track, true);
+        if (track.chunkFill > 0) {
+            writeChunk(track);
+        }
+
+        // Patch in the final sizes
+        uint8_t header[HEADER_BYTES];
+        writeHeader(track, header, true);
+        if (fseek(track.file, 0, SEEK_SET) == 0) {
+            fwrite(header, 1, HEADER_BYTES, track.file);
+        }
+        fclose(track.file);
+        track.file = nullptr;
+    }
+    m_open = false;
+}
+
+void SessionRecorder::discard() {
+    for (size_t s = 0; s < STREAMS; s++) {
+        countDropped(m_tracks[s].ring.skip(RING_SAMPLES));
+    }
+}
+
+void SessionRecorder::countDropped(size_t samples) {
+    size_t frame = AudioConfig::frameSamples(m_openRate);
+    m_dropRemainder += samples;
+    m_droppedFrames.fetch_add(static_cast<uint32_t>(m_dropRemainder / frame), std::memory_order_relaxed);
+    m_dropRemainder %= frame;
+}
+
+// ============================================================
+// ENCODING AND FLASH WRITES
+// ============================================================
+
+void SessionRecorder::drain(Track& track, bool final) {
+    while (true) {
+        track.blockFill += track.ring.read(track.block + track.blockFill, BLOCK_SAMPLES - track.blockFill);
+        if (track.blockFill < BLOCK_SAMPLES) break;
+        encodeBlock(track, BLOCK_SAMPLES);
+    }
+
+    if (final && track.blockFill > 0) {
+        size_t samples = track.blockFill;
+        memset(track.block + samples, 0, (BLOCK_SAMPLES - samples) * sizeof(int16_t));
+        encodeBlock(track, samples);
+    }
+}
+
+void SessionRecorder::encodeBlock(Track& track, size_t samples) {
+    track.blockFill = 0;
+    if (track.full) {
+        countDropped(samples);
+        return;
+    }
+
+    // WAV IMA ADPCM block: first sample verbatim, then 504 codes
+    uint8_t* out = track.chunk + track.chunkFill;
+    int16_t predictor = track.block[0];
+    putLe16(out, static_cast<uint16_t>(predictor));
+    out[2] = track.stepIndex;
+    out[3] = 0;
+    for (size_t i = 1; i < BLOCK_SAMPLES; i += 2) {
+        uint8_t lo = adpcmEncode(track.block[i], predictor, track.stepIndex);
+        uint8_t hi = adpcmEncode(track.block[i + 1], predictor, track.stepIndex);
+        out[4 + i / 2] = static_cast<uint8_t>(lo | (hi << 4));
+    }
+    track.samples += static_cast<uint32_t>(samples);
+    track.chunkFill += BLOCK_BYTES;
+
+    if (track.chunkFill == CHUNK_BYTES) {
+        writeChunk(track);
+    }
+}
+
+void SessionRecorder::writeChunk(Track& track) {
+    size_t bytes = track.chunkFill;
+    track.chunkFill = 0;
+    if (track.full) return;
+
+    size_t written = 0;
+    if (makeRoom(bytes, WRITE_MARGIN_BYTES)) {
+        int64_t start = esp_timer_get_time();
+        written = fwrite(track.chunk, 1, bytes, track.file);
+        uint32_t us = static_cast<uint32_t>(esp_timer_get_time() - start);
+
+        m_writeUs.fetch_add(us, std::memory_order_relaxed);
+        m_bytesWritten.fetch_add(static_cast<uint32_t>(written), std::memory_order_relaxed);
+        if (us > m_maxWriteUs.load(std::memory_order_relaxed)) {
+            m_maxWriteUs.store(us, std::memory_order_relaxed);
+        }
+    }
+    track.fileBytes += static_cast<uint32_t>(written);
+
+    if (written != bytes) {
+        track.full = true;
+        countDropped((bytes - written) / BLOCK_BYTES * BLOCK_SAMPLES);
+    }
+}
+
+void SessionRecorder::writeHeader(const Track& track, uint8_t* header, bool final) const {
+    // Open-ended sizes until the session closes (readers stream to EOF)
+    uint32_t dataBytes = 0xFFFFFFFF;
+    uint32_t riffBytes = 0xFFFFFFFF;
+    uint32_t samples = 0;
+    if (final) {
+        dataBytes = (track.fileBytes > HEADER_BYTES) ? track.fileBytes - HEADER_BYTES : 0;
+        riffBytes = HEADER_BYTES - 8 + dataBytes;
+        uint32_t blockSamples = dataBytes / BLOCK_BYTES * BLOCK_SAMPLES;
+        samples = (track.samples < blockSamples) ? track.samples : blockSamples;
+    }
+
+    memset(header, 0, HEADER_BYTES);
+    memcpy(header, "RIFF", 4);
+    putLe32(header + 4, riffBytes);
+    memcpy(header + 8, "WAVE", 4);
+
+    memcpy(header + 12, "fmt ", 4);
+    putLe32(header + 16, 20);
+    putLe16(header + 20, 0x0011);                  // IMA ADPCM
+    putLe16(header + 22, 1);
+    putLe32(header + 24, m_openRate);
+    putLe32(header + 28, static_cast<uint32_t>(m_openRate * BLOCK_BYTES / BLOCK_SAMPLES));
+    putLe16(header + 32, BLOCK_BYTES);
+    putLe16(header + 34, 4);
+    putLe16(header + 36, 2);
+    putLe16(header + 38, BLOCK_SAMPLES);
+
+    memcpy(header + 40, "fact", 4);
+    putLe32(header + 44, 4);
+    putLe32(header + 48, samples);
+
+    // Pad the header to one block so the data stays block-aligned
+    memcpy(header + 52, "JUNK", 4);
+    putLe32(header + 56, HEADER_BYTES - 68);
+
+    memcpy(header + HEADER_BYTES - 8, "data", 4);
+    putLe32(header + HEADER_BYTES - 4, dataBytes);
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "AudioConfig.h"
+#include "SampleRing.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+
+typedef struct tskTaskControlBlock* TaskHandle_t;
+
+/**
+ * SCO Session Recorder (SPIFFS)
+ *
+ * Keeps both directions of every voice session on the spiffs partition,
+ * for listening back when the assistant misheard:
+ *
+ *   /spiffs/s00042_rx.wav   phone -> speaker (what the user heard)
+ *   /spiffs/s00042_tx.wav   mic -> phone (what the phone was sent)
+ *
+ * Files are mono IMA ADPCM WAV at the link rate (4:1, 8KB/s per stream at
+ * 16kHz), readable by any audio tool.
+ *
+ * The audio callbacks only copy PCM into one SampleRing per stream; a
+ * full ring drops the frame (counted) and never waits. A low-priority
+ * task on core 0 encodes 505-sample ADPCM blocks and writes them in
+ * CHUNK_BYTES units, one flash write per ~250ms of a 16kHz stream.
+ *
+ * Retention is rolling: before a session opens, and before each write,
+ * the oldest sessions are deleted until there is room. The session being
+ * recorded is never deleted; if it alone fills the partition it is
+ * closed and the rest is counted as dropped.
+ *
+ * Flash writes pause instruction fetch on both cores for their duration
+ * (longer when SPIFFS erases a sector), so the recorder is a debug build
+ * option (-DSESSION_RECORDER) and writes as rarely as it can.
+ */
+class SessionRecorder {
+public:
+    enum class Stream : uint8_t {
+        Incoming,    // Phone -> speaker
+        Outgoing     // Mic -> phone
+    };
+
+    static constexpr size_t BLOCK_BYTES = 256;          // ADPCM block (WAV blockAlign)
+    static constexpr size_t BLOCK_SAMPLES = 505;        // Header sample + 2 per byte
+    static constexpr size_t CHUNK_BYTES = 4096;         // One flash write
+    static constexpr size_t OPEN_RESERVE_BYTES = 512 * 1024;  // Free space for a new session
+    static constexpr size_t WRITE_MARGIN_BYTES = 64 * 1024;   // Left free for SPIFFS GC
+
+    struct Stats {
+        uint32_t session;          // Index of the current/last session
+        uint32_t sessions;         // Sessions recorded since boot
+        uint32_t deleted;          // Sessions removed by retention
+        uint32_t bytesWritten;     // ADPCM bytes written since boot
+        uint32_t writeKBps;        // Flash throughput while writing
+        uint32_t maxWriteUs;       // Slowest chunk write
+        uint32_t droppedFrames;    // SCO frames not recorded
+    };
+
+    /**
+     * Mount the partition (formats it on first use) and start the task
+     * @return false if the partition could not be mounted
+     */
+    bool begin();
+
+    /**
+     * Start a session at the link sample rate (SCO connected)
+     */
+    void start(uint32_t sampleRate);
+
+    /**
+     * End the session; the task drains and closes its files (SCO disconnected)
+     */
+    void stop();
+
+    /**
+     * Audio callbacks: queue one frame; never blocks
+     */
+    void record(Stream stream, const int16_t* samples, size_t count);
+
+    Stats getStats() const;
+
+    size_t totalBytes() const { return m_totalBytes; }
+
+private:
+    static constexpr uint32_t TASK_STACK = 4096;
+    static constexpr int TASK_CORE = 0;                 // With Bluedroid, off the audio core
+    static constexpr uint32_t POLL_MS = 50;
+    static constexpr size_t RING_SAMPLES = 8192;        // 0.5s at 16kHz (flash write stalls)
+    static constexpr size_t HEADER_BYTES = BLOCK_BYTES; // Data stays block-aligned
+    static constexpr size_t STREAMS = 2;
+
+    struct Track {
+        SampleRing<RING_SAMPLES> ring;
+        FILE* file = nullptr;
+        int16_t block[BLOCK_SAMPLES];
+        size_t blockFill = 0;
+        uint8_t chunk[CHUNK_BYTES];
+        size_t chunkFill = 0;
+        uint32_t samples = 0;      // Encoded so far
+        uint32_t fileBytes = 0;    // Written, header included
+        uint8_t stepIndex = 0;
+        bool full = false;         // A write failed; the rest is dropped
+    };
+
+    TaskHandle_t m_task = nullptr;
+    std::atomic<bool> m_active{false};
+    std::atomic<uint32_t> m_generation{0};
+    std::atomic<uint32_t> m_sampleRate{0};
+    size_t m_totalBytes = 0;
+
+    // Task state
+    Track m_tracks[STREAMS];
+    bool m_open = false;
+    uint32_t m_openGeneration = 0;
+    uint32_t m_openRate = 0;
+    size_t m_dropRemainder = 0;    // Dropped samples short of a frame
+    uint32_t m_oldest = 0;         // Oldest session on flash
+    uint32_t m_next = 0;           // Index for the next session
+
+    std::atomic<uint32_t> m_session{0};
+    std::atomic<uint32_t> m_sessions{0};
+    std::atomic<uint32_t> m_deleted{0};
+    std::atomic<uint32_t> m_bytesWritten{0};
+    std::atomic<uint32_t> m_writeUs{0};
+    std::atomic<uint32_t> m_maxWriteUs{0};
+    std::atomic<uint32_t> m_droppedFrames{0};
+
+    static void recorderTask(void* arg);
+    void recorderLoop();
+    void scanSessions();
+    void openSession(uint32_t generation, uint32_t sampleRate);
+    void closeSession();
+    void drain(Track& track, bool final);
+    void discard();
+    void countDropped(size_t samples);
+    void encodeBlock(Track& track, size_t samples);
+    void writeChunk(Track& track);
+    bool makeRoom(size_t bytes, size_t margin);
+    void deleteSession(uint32_t index);
+    void writeHeader(const Track& track, uint8_t* header, bool final) const;
+    static void sessionPath(char* path, size_t size, uint32_t index, size_t stream);
+};
@@ -0,0 +1,107 @@
+#include "VoiceActivityDetector.h"
+#include <cmath>
+
+extern "C" {
+#include "esp_timer.h"
+}
+
+void VoiceActivityDetector::reset(uint32_t sampleRate) {
+    m_frameSamples = AudioConfig::frameSamples(sampleRate);
+    m_frameFill = 0;
+    m_frameEnergy = 0.0f;
+    m_floorDb = 0.0f;
+    m_floorPrimed = false;
+    m_speechRun = 0;
+    m_silentFrames = 0;
+    m_heardSpeech = false;
+    m_inSpeech.store(false, std::memory_order_relaxed);
+    m_endPending.store(false, std::memory_order_relaxed);
+
+    m_frames.store(0, std::memory_order_relaxed);
+    m_speechFrames.store(0, std::memory_order_relaxed);
+    m_endpoints.store(0, std::memory_order_relaxed);
+}
+
+bool VoiceActivityDetector::takeEndOfSpeech(int64_t* lastSpeechUs) {
+    if (!m_endPending.exchange(false, std::memory_order_acquire)) return false;
+    if (lastSpeechUs) *lastSpeechUs = m_eventSpeechUs;
+    return true;
+}
+
+VoiceActivityDetector::Stats VoiceActivityDetector::getStats() const {
+    Stats s;
+    s.frames = m_frames.load(std::memory_order_relaxed);
+    s.speechFrames = m_speechFrames.load(std::memory_order_relaxed);
+    s.endpoints = m_endpoints.load(std::memory_order_relaxed);
+    s.noiseFloorDb = m_noiseFloorDb.load(std::memory_order_relaxed);
+    return s;
+}
+
+// ============================================================
+// CLASSIFICATION
+// ============================================================
+
+void VoiceActivityDetector::process(const int16_t* samples, size_t count, bool farEndActive) {
+    for (size_t i = 0; i < count; i++) {
+        float s = samples[i];
+        m_frameEnergy += s * s;
+        if (++m_frameFill == m_frameSamples) {
+            classifyFrame(farEndActive);
+            m_frameFill = 0;
+            m_frameEnergy = 0.0f;
+        }
+    }
+}
+
+void VoiceActivityDetector::classifyFrame(bool farEndActive) {
+    float energyDb = 10.0f * log10f(m_frameEnergy / static_cast<float>(m_frameSamples) + 1.0f);
+    m_frames.fetch_add(1, std::memory_order_relaxed);
+
+    // Noise floor: follow quiet frames quickly, loud frames slowly
+    if (!m_floorPrimed) {
+        m_floorDb = energyDb;
+        m_floorPrimed = true;
+    } else if (energyDb < m_floorDb) {
+        m_floorDb += (energyDb - m_floorDb) * FLOOR_FALL;
+    } else {
+        m_floorDb += (energyDb - m_floorDb) * FLOOR_RISE;
+    }
+    m_noiseFloorDb.store(static_cast<int32_t>(m_floorDb), std::memory_order_relaxed);
+
+    float threshold = m_floorDb + m_thresholdDb.load(std::memory_order_relaxed);
+    bool voiced = energyDb > threshold && energyDb > MIN_SPEECH_DB;
+
+    if (voiced) {
+        if (m_speechRun < ONSET_FRAMES) m_speechRun++;
+    } else {
+        m_speechRun = 0;
+    }
+
+    if (m_speechRun >= ONSET_FRAMES) {
+        m_speechFrames.fetch_add(1, std::memory_order_relaxed);
+        m_inSpeech.store(true, std::memory_order_relaxed);
+        m_heardSpeech = true;
+        m_silentFrames = 0;
+        m_lastSpeechUs = esp_timer_get_time();
+        return;
+    }
+
+    m_inSpeech.store(false, std::memory_order_relaxed);
+    if (!m_heardSpeech) return;
+
+    // Hangover: count silence only while the far end is quiet too
+    if (farEndActive) {
+        m_silentFrames = 0;
+        return;
+    }
+
+    m_silentFrames++;
+    uint32_t silentMs = m_silentFrames * AudioConfig::FRAME_DURATION_US / 1000;
+    if (silentMs >= m_endSilenceMs.load(std::memory_order_relaxed)) {
+        m_heardSpeech = false;
+        m_silentFrames = 0;
+        m_eventSpeechUs = m_lastSpeechUs;
+        m_endpoints.fetch_add(1, std::memory_order_relaxed);
+        m_endPending.store(true, std::memory_order_release);
+    }
+}
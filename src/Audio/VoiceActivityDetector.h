@@ -0,0 +1,109 @@
+#pragma once
+
+#include "AudioConfig.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Voice Activity Detector with end-of-utterance hangover
+ *
+ * Classifies each 7.5ms frame of outgoing mic audio as speech or not,
+ * and raises a one-shot end-of-speech event once the user has spoken and
+ * then stayed silent for the configured timeout. BluetoothManager turns
+ * that event into AT+BVRA=0, so the SCO link and the phone's recognizer
+ * don't stay open after the user forgets to tap.
+ *
+ * - Frame energy is compared against an adaptive noise floor (fast to
+ *   fall, slow to rise); a frame is speech when it exceeds the floor by
+ *   the sensitivity threshold
+ * - Speech must persist for ONSET_FRAMES before it counts (clicks and
+ *   taps don't start an utterance)
+ * - While the far end is audible (TTS playing) the hangover is held, so
+ *   a reply is never cut off
+ *
+ * Threading: configuration setters and takeEndOfSpeech() from any task,
+ * reset()/process() from the mic path.
+ */
+class VoiceActivityDetector {
+public:
+    static constexpr uint32_t DEFAULT_END_SILENCE_MS = 1000;
+    static constexpr float DEFAULT_THRESHOLD_DB = 9.0f;
+
+    struct Stats {
+        uint32_t frames;         // Frames classified
+        uint32_t speechFrames;   // Frames classified as speech
+        uint32_t endpoints;      // End-of-speech events raised
+        int32_t noiseFloorDb;    // Current noise floor estimate (dB re 1 LSB)
+    };
+
+    /**
+     * Clear state for a new session (mic path side)
+     * @param sampleRate Link rate, 8000 or 16000
+     */
+    void reset(uint32_t sampleRate);
+
+    /**
+     * Silence after the last speech frame before end of speech is declared
+     */
+    void setEndSilenceMs(uint32_t ms) { m_endSilenceMs.store(ms, std::memory_order_relaxed); }
+    uint32_t getEndSilenceMs() const { return m_endSilenceMs.load(std::memory_order_relaxed); }
+
+    /**
+     * Sensitivity: dB above the noise floor for a frame to count as speech
+     * (lower = more sensitive)
+     */
+    void setThresholdDb(float db) { m_thresholdDb.store(db, std::memory_order_relaxed); }
+    float getThresholdDb() const { return m_thresholdDb.load(std::memory_order_relaxed); }
+
+    /**
+     * Classify outgoing mic audio
+     * @param samples Link-rate PCM (any block size)
+     * @param count Sample count
+     * @param farEndActive Speaker is playing far-end audio (holds the hangover)
+     */
+    void process(const int16_t* samples, size_t count, bool farEndActive);
+
+    bool isSpeech() const { return m_inSpeech.load(std::memory_order_relaxed); }
+
+    /**
+     * Consume a pending end-of-speech event
+     * @param lastSpeechUs Set to the esp_timer time of the last speech frame
+     * @return true once per detected end of utterance
+     */
+    bool takeEndOfSpeech(int64_t* lastSpeechUs);
+
+    Stats getStats() const;
+
+private:
+    static constexpr uint32_t ONSET_FRAMES = 3;          // 22.5ms of speech to start
+    static constexpr float FLOOR_FALL = 0.2f;            // Per frame, toward quieter frames
+    static constexpr float FLOOR_RISE = 0.01f;           // Per frame, toward louder frames
+    static constexpr float MIN_SPEECH_DB = 30.0f;        // Absolute floor (~mean |x| of 30)
+
+    std::atomic<uint32_t> m_endSilenceMs{DEFAULT_END_SILENCE_MS};
+    std::atomic<float> m_thresholdDb{DEFAULT_THRESHOLD_DB};
+
+    // Mic-path state
+    size_t m_frameSamples = AudioConfig::FRAME_SAMPLES_16K;
+    size_t m_frameFill = 0;
+    float m_frameEnergy = 0.0f;
+    float m_floorDb = 0.0f;
+    bool m_floorPrimed = false;
+    uint32_t m_speechRun = 0;
+    uint32_t m_silentFrames = 0;
+    bool m_heardSpeech = false;
+    std::atomic<bool> m_inSpeech{false};
+
+    // End-of-speech event (m_lastSpeechUs published by m_endPending)
+    int64_t m_lastSpeechUs = 0;
+    int64_t m_eventSpeechUs = 0;
+    std::atomic<bool> m_endPending{false};
+
+    std::atomic<uint32_t> m_frames{0};
+    std::atomic<uint32_t> m_speechFrames{0};
+    std::atomic<uint32_t> m_endpoints{0};
+    std::atomic<int32_t> m_noiseFloorDb{0};
+
+    void classifyFrame(bool farEndActive);
+};
@@ -0,0 +1,89 @@
+#include "WakeWordListener.h"
+
+extern "C" {
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+}
+
+bool WakeWordListener::begin(IBoard* board, const char* modelPath) {
+    if (m_task) return true;
+
+    if (!m_model.loadFile(modelPath)) return false;
+    if (!m_spotter.begin(&m_model)) return false;
+    m_board = board;
+
+    xTaskCreatePinnedToCore(
+        listenerTask,
+        "wake_word",
+        TASK_STACK,
+        this,
+        AudioConfig::WAKE_WORD_TASK_PRIORITY,
+        &m_task,
+        AudioConfig::AUDIO_TASK_CORE
+    );
+    return m_task != nullptr;
+}
+
+void WakeWordListener::setListening(bool listening) {
+    if (!m_task || listening == m_listening.load(std::memory_order_relaxed)) return;
+
+    if (listening) {
+        m_detected.store(false, std::memory_order_relaxed);
+        m_restart.store(true, std::memory_order_relaxed);
+        m_board->setWakeWordListening(true);
+        m_listening.store(true, std::memory_order_release);
+        xTaskNotifyGive(m_task);
+    } else {
+        m_listening.store(false, std::memory_order_relaxed);
+        m_board->setWakeWordListening(false);
+    }
+}
+
+bool WakeWordListener::takeDetection() {
+    if (!m_listening.load(std::memory_order_relaxed)) return false;
+    return m_detected.exchange(false, std::memory_order_acquire);
+}
+
+void WakeWordListener::logStats() {
+    if (!m_task) return;
+    KeywordSpotter::Stats s = m_spotter.getStats();
+    if (s.inferences == 0) return;
+    m_board->logf("[KWS] %u inferences %u hits, last %u cyc max %u, front end max %u cyc",
+                  s.inferences, s.detections, s.lastCycles, s.maxCycles, s.frontEndCycles);
+    m_spotter.resetStats();
+}
+
+// ============================================================
+// LISTENER TASK
+// ============================================================
+
+void WakeWordListener::listenerTask(void* arg) {
+    static_cast<WakeWordListener*>(arg)->listenerLoop();
+}
+
+void WakeWordListener::listenerLoop() {
+    while (true) {
+        if (!m_listening.load(std::memory_order_acquire)) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        // Whatever the spotter held from before the last session is stale;
+        // so is audio the ring kept from then
+        if (m_restart.exchange(false, std::memory_order_relaxed)) {
+            m_spotter.reset();
+            while (m_board->readWakeWordAudio(m_chunk, CHUNK_SAMPLES) > 0) {
+            }
+        }
+
+        size_t count = m_board->readWakeWordAudio(m_chunk, CHUNK_SAMPLES);
+        if (count == 0) {
+            // Nothing captured yet, or the mic is asleep
+            vTaskDelay(pdMS_TO_TICKS(POLL_MS));
+            continue;
+        }
+        if (m_spotter.process(m_chunk, count)) {
+            m_detected.store(true, std::memory_order_release);
+        }
+    }
+}
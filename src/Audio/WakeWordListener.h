@@ -0,0 +1,82 @@
+#pragma once
+
+#include "AudioConfig.h"
+#include "KeywordModel.h"
+#include "KeywordSpotter.h"
+#include "../HAL/IBoard.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+typedef struct tskTaskControlBlock* TaskHandle_t;
+
+/**
+ * Wake Word Listener ("Hey Badge")
+ *
+ * Runs the keyword spotter between sessions on its own task, pinned to
+ * the audio core below mic capture and playout:
+ *
+ *   mic --capture task--> MicDutyCycle --> listen ring --listener task--> KeywordSpotter
+ *
+ * The model is a KeywordModel blob on the spiffs partition (MODEL_PATH);
+ * without one begin() fails and nothing runs. The loop task turns
+ * listening on while the headset is connected and idle, and off as soon
+ * as a trigger goes out, so the pre-roll and the SCO mic path have the mic
+ * to themselves. A detection is taken by the loop task and starts a
+ * session exactly like isActionTriggered().
+ *
+ * Threading: begin()/setListening()/takeDetection()/logStats() from the
+ * loop task.
+ */
+class WakeWordListener {
+public:
+    static constexpr const char* MODEL_PATH = "/spiffs/kws.bin";
+
+    /**
+     * Load the model and start the listener task (idle until setListening(true))
+     * @return false if the model is missing or not supported
+     */
+    bool begin(IBoard* board, const char* modelPath = MODEL_PATH);
+
+    bool isReady() const { return m_task != nullptr; }
+
+    /**
+     * Listen for the keyword or not; turning on starts the stream afresh
+     */
+    void setListening(bool listening);
+
+    bool isListening() const { return m_listening.load(std::memory_order_relaxed); }
+
+    /**
+     * Consume a detection
+     * @return true once per keyword heard while listening
+     */
+    bool takeDetection();
+
+    const KeywordModel& model() const { return m_model; }
+
+    /**
+     * Log inference counts and cost since the last call ([KWS]) and clear them
+     */
+    void logStats();
+
+private:
+    static constexpr uint32_t TASK_STACK = 4096;
+    static constexpr size_t CHUNK_SAMPLES = 256;    // Even, as the spotter needs
+    static constexpr uint32_t POLL_MS = 20;         // One spotter hop
+
+    IBoard* m_board = nullptr;
+    TaskHandle_t m_task = nullptr;
+    KeywordModel m_model;
+    KeywordSpotter m_spotter;
+
+    std::atomic<bool> m_listening{false};
+    std::atomic<bool> m_restart{false};    // Set by setListening(true), consumed by the task
+    std::atomic<bool> m_detected{false};
+
+    // Listener-task state
+    int16_t m_chunk[CHUNK_SAMPLES];
+
+    static void listenerTask(void* arg);
+    void listenerLoop();
+};
@@ -11,23 +11,29 @@ extern "C" {
 #include "esp_hf_client_api.h"
 #include "esp_avrc_api.h"
 #include "esp_wifi.h"
+#include "esp_timer.h"
 }
 
 // Global instance for C callbacks
 BluetoothManager* g_btManager = nullptr;
 
-// Helper macro for logging (sends to BOTH serial and screen)
+// Helper macro for logging (serial and screen)
+// The board only queues the line - its UI task does the Serial and display
+// output - so these are safe in Bluedroid callbacks. Serial directly until
+// the board is attached.
 #define BT_LOG(msg) do { \
-    Serial.println(msg); \
     if (g_btManager && g_btManager->getBoard()) { \
         g_btManager->getBoard()->log(msg); \
+    } else { \
+        Serial.println(msg); \
     } \
 } while(0)
 
 #define BT_LOGF(fmt, ...) do { \
-    Serial.printf(fmt "\n", ##__VA_ARGS__); \
     if (g_btManager && g_btManager->getBoard()) { \
         g_btManager->getBoard()->logf(fmt, ##__VA_ARGS__); \
+    } else { \
+        Serial.printf(fmt "\n", ##__VA_ARGS__); \
     } \
 } while(0)
 
@@ -167,6 +173,7 @@ void BluetoothManager::init(const char* deviceName, IBoard* board) {
     // Small delay to ensure Bluedroid is fully ready
     vTaskDelay(pdMS_TO_TICKS(100));
 
+    m_audioEngine.begin(m_board, &m_jitterBuffer, &m_echoCanceller);
     initHfpClient();
     initAvrcpController();
     setDiscoverable();
@@ -348,6 +355,7 @@ void BluetoothManager::handleConnectionState(uint8_t state, esp_bd_addr_t& addr)
     switch (state) {
         case ESP_HF_CLIENT_CONNECTION_STATE_DISCONNECTED:
             m_board->log("[HFP] Disconnected");
+            m_board->stopPreRoll();
             m_slcConnected = false;
             m_scoConnected = false;
             m_board->setLedStatus(StatusState::Disconnected);
@@ -377,13 +385,57 @@ void BluetoothManager::handleConnectionState(uint8_t state, esp_bd_addr_t& addr)
 
 void BluetoothManager::handleAudioState(uint8_t state) {
     switch (state) {
-        case ESP_HF_CLIENT_AUDIO_STATE_DISCONNECTED:
+        case ESP_HF_CLIENT_AUDIO_STATE_DISCONNECTED: {
             m_board->log("[SCO] Disconnected");
             m_scoConnected = false;
+            m_audioEngine.setActive(false);
+            m_board->stopPreRoll();
+            m_latencyProbe.cancel();
+            if (m_recorder) m_recorder->stop();
+
+            JitterBuffer::Stats jb = m_jitterBuffer.getStats();
+            m_board->logf("[JB] under %u over %u trim %u",
+                jb.underruns, jb.overruns, jb.trimmed);
+            AudioEngine::Stats eng = m_audioEngine.getStats();
+            m_board->logf("[SPK] fill %u late %u max %uus",
+                eng.fillFrames, eng.lateFrames, eng.maxPeriodUs);
+            m_board->logf("[PLC] concealed %u max %uus",
+                eng.concealedFrames, eng.maxPlcUs);
+            m_board->logf("[CNG] spk %u mic %u",
+                eng.comfortFrames, m_micComfortFrames.load(std::memory_order_relaxed));
+            EarconMixer::Stats cue = m_audioEngine.getEarconStats();
+            m_board->logf("[CUE] played %u replaced %u max %uus",
+                cue.played, cue.replaced, eng.maxEarconUs);
+            m_board->logf("[SYNC] drift %d ppm", static_cast<int>(eng.driftPpm));
+            EchoCanceller::Stats aec = m_echoCanceller.getStats();
+            m_board->logf("[AEC] erle %ddB hold %u reset %u max %uus",
+                static_cast<int>(aec.erleDb), aec.frozenBlocks, aec.resets, aec.maxBlockUs);
+            NoiseSuppressor::Stats ns = m_noiseSuppressor.getStats();
+            m_board->logf("[NS] over budget %u/%u max %u cyc",
+                ns.overBudget, ns.frames, ns.maxCycles);
+            AutomaticGainControl::Stats agc = m_agc.getStats();
+            m_board->logf("[AGC] gain %ddB clip %u limit %u",
+                static_cast<int>(agc.gainDb), agc.clippedSamples, agc.limitedBlocks);
+            VoiceActivityDetector::Stats vad = m_vad.getStats();
+            m_board->logf("[VAD] speech %u/%u floor %ddB",
+                vad.speechFrames, vad.frames, static_cast<int>(vad.noiseFloorDb));
+            m_board->logSessionStats();
+            logCallbackTiming();
+            if (m_probeEnabled) {
+                LatencyProbe::Stats lat = m_latencyProbe.getStats();
+                m_board->logf("[LAT] rtt %u-%ums found %u/%u",
+                    lat.minUs / 1000, lat.maxUs / 1000, lat.detected, lat.probes);
+            }
+            if (m_recorder) {
+                SessionRecorder::Stats rec = m_recorder->getStats();
+                m_board->logf("[REC] s%05u %uKB %uKB/s max %uus drop %u",
+                    rec.session, rec.bytesWritten / 1024, rec.writeKBps, rec.maxWriteUs, rec.droppedFrames);
+            }
             if (m_slcConnected) {
                 m_board->setLedStatus(StatusState::Idle);
             }
             break;
+        }
 
         case ESP_HF_CLIENT_AUDIO_STATE_CONNECTING:
             m_board->log("[SCO] Connecting...");
@@ -391,46 +443,114 @@ void BluetoothManager::handleAudioState(uint8_t state) {
 
         case ESP_HF_CLIENT_AUDIO_STATE_CONNECTED:
             m_board->log("[SCO] CVSD 8kHz");
-            m_scoConnected = true;
             m_wideband = false;
-            m_board->setSampleRate(8000);
+            m_jitterBuffer.reset(8000);
+            m_micPathReset.store(true, std::memory_order_release);
+            m_timing.setCodec(ScoTiming::Codec::Cvsd);
+            m_lastTimingLogUs = esp_timer_get_time();
+            if (m_recorder) m_recorder->start(AudioConfig::SAMPLE_RATE_NARROWBAND);
+            m_scoConnected = true;
+            m_audioEngine.setActive(true);
             break;
 
         case ESP_HF_CLIENT_AUDIO_STATE_CONNECTED_MSBC:
             m_board->log("[SCO] mSBC 16kHz");
-            m_scoConnected = true;
             m_wideband = true;
-            m_board->setSampleRate(16000);
+            m_jitterBuffer.reset(16000);
+            m_micPathReset.store(true, std::memory_order_release);
+            m_timing.setCodec(ScoTiming::Codec::Msbc);
+            m_lastTimingLogUs = esp_timer_get_time();
+            if (m_recorder) m_recorder->start(AudioConfig::SAMPLE_RATE_WIDEBAND);
+            m_scoConnected = true;
+            m_audioEngine.setActive(true);
             break;
+
+        // The IDF 4.4 HF client negotiates CVSD and mSBC only; there is no
+        // LC3-SWB state to handle (see ARCHITECTURE.md 6.4)
     }
 }
 
 void BluetoothManager::handleIncomingAudio(const uint8_t* data, uint32_t len) {
     // Phone -> Speaker
     if (m_board && len > 0) {
-        // Debug: Log incoming audio packets periodically (every ~1 second at 50Hz callback rate)
-        static uint32_t audioPacketCount = 0;
-        audioPacketCount++;
-        if (audioPacketCount % 50 == 0) {
-            BT_LOGF("[RX Audio] Received packet #%u, %u bytes", audioPacketCount, len);
+        int64_t start = esp_timer_get_time();
+
+        // Copy into the jitter buffer; the audio engine drains it on the
+        // output clock and the stack may reuse 'data' as soon as we return
+        m_jitterBuffer.push(data, len, start);
+        if (m_recorder) {
+            m_recorder->record(SessionRecorder::Stream::Incoming,
+                reinterpret_cast<const int16_t*>(data), len / AudioConfig::BYTES_PER_SAMPLE);
         }
-
-        m_board->writeAudio(data, len);
+        m_latencyProbe.processIncoming(reinterpret_cast<const int16_t*>(data),
+            len / AudioConfig::BYTES_PER_SAMPLE, start);
+        m_timing.record(ScoTiming::Direction::Incoming, start, esp_timer_get_time(), len);
     }
 }
 
 uint32_t BluetoothManager::handleOutgoingAudio(uint8_t* data, uint32_t len) {
     // Mic -> Phone
     if (m_board && len > 0) {
-        uint32_t bytesRead = m_board->readAudio(data, len);
+        int64_t start = esp_timer_get_time();
+        if (m_micPathReset.exchange(false, std::memory_order_acquire)) {
+            m_echoCanceller.reset();
+            m_micResampler.reset();
+            m_micDownsampler.reset();
+            m_i2sToLink = m_wideband ? nullptr : &m_micDownsampler;
+            uint32_t linkRate = m_wideband ? AudioConfig::SAMPLE_RATE_WIDEBAND
+                                           : AudioConfig::SAMPLE_RATE_NARROWBAND;
+            m_noiseSuppressor.reset(linkRate);
+            m_agc.reset(linkRate);
+            m_vad.reset(linkRate);
+            m_micComfort.reset();
+            m_micComfortFrames.store(0, std::memory_order_relaxed);
+        }
 
-        // Debug: Log outgoing audio packets periodically (every ~1 second at 50Hz callback rate)
-        static uint32_t audioPacketCount = 0;
-        audioPacketCount++;
-        if (audioPacketCount % 50 == 0) {
-            BT_LOGF("[TX Audio] Sent packet #%u, %u bytes", audioPacketCount, bytesRead);
+        // Mirror the speaker-side drift correction: if the phone's clock runs
+        // fast it consumes mic audio faster than we capture it, so stretch
+        size_t outSamples = len / AudioConfig::BYTES_PER_SAMPLE;
+        m_micResampler.setRatioPpm(-m_audioEngine.driftPpm());
+        size_t inSamples = m_micResampler.inputFor(outSamples);
+        size_t i2sSamples = m_i2sToLink ? inSamples * 2 : inSamples;
+        if (i2sSamples > HalfbandDownsampler::MAX_INPUT) {
+            i2sSamples = HalfbandDownsampler::MAX_INPUT;
         }
 
+        int16_t* out = reinterpret_cast<int16_t*>(data);
+        size_t produced = 0;
+        uint32_t i2sBytes = i2sSamples * AudioConfig::BYTES_PER_SAMPLE;
+        // A short read hands out what is buffered (whole pairs when decimating)
+        size_t got = m_board->readAudio(reinterpret_cast<uint8_t*>(m_micBuffer), i2sBytes)
+                     / AudioConfig::BYTES_PER_SAMPLE;
+        if (got > 0) {
+            size_t linkSamples = m_i2sToLink ? got / 2 : got;
+            // Pre-roll backlog is up to PreRollBuffer::CAPACITY_MS older than
+            // the speaker reference and is not offset for; the canceller may
+            // need to re-converge once the mic path has caught up
+            m_echoCanceller.process(m_micBuffer, m_micBuffer, got);
+            if (m_i2sToLink) {
+                m_i2sToLink->process(m_micBuffer, got, m_micBuffer);
+            }
+            m_noiseSuppressor.process(m_micBuffer, m_micBuffer, linkSamples);
+            m_agc.process(m_micBuffer, m_micBuffer, linkSamples);
+            m_vad.process(m_micBuffer, linkSamples, m_audioEngine.isFarEndAudible());
+            produced = m_micResampler.process(m_micBuffer, linkSamples, out, outSamples);
+            m_micComfort.analyze(out, produced);
+        }
+
+        // Failed or short read: the stack always gets a full frame, with the
+        // rest filled by noise matched to what the phone has been hearing
+        if (produced < outSamples) {
+            m_micComfort.generate(out + produced, outSamples - produced);
+            m_micComfortFrames.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_latencyProbe.processOutgoing(out, outSamples, start);
+        uint32_t bytesRead = outSamples * AudioConfig::BYTES_PER_SAMPLE;
+        if (m_recorder) {
+            m_recorder->record(SessionRecorder::Stream::Outgoing, out, outSamples);
+        }
+
+        m_timing.record(ScoTiming::Direction::Outgoing, start, esp_timer_get_time(), bytesRead);
         return bytesRead;
     }
     return 0;
@@ -507,6 +627,11 @@ void BluetoothManager::stopBvra() {
     m_board->log("BVRA stop sent");
 }
 
+void BluetoothManager::armPreRoll() {
+    m_board->startPreRoll();
+    m_preRollArmedUs = esp_timer_get_time();
+}
+
 bool BluetoothManager::canTrigger() {
     if (!m_slcConnected) {
         m_board->log("Cannot trigger - not connected");
@@ -521,6 +646,92 @@ bool BluetoothManager::canTrigger() {
     return true;
 }
 
+void BluetoothManager::setVoiceActivityConfig(uint32_t endSilenceMs, float thresholdDb) {
+    m_vad.setEndSilenceMs(endSilenceMs);
+    m_vad.setThresholdDb(thresholdDb);
+}
+
+BluetoothManager::AutoStopStats BluetoothManager::getAutoStopStats() const {
+    AutoStopStats s;
+    s.vad = m_vad.getStats();
+    s.autoStops = m_autoStops;
+    s.lastDecisionMs = m_lastDecisionMs;
+    s.maxDecisionMs = m_maxDecisionMs;
+    return s;
+}
+
+void BluetoothManager::logCallbackTiming() {
+    // [TIM] rx cvsd n 4000 int 7.5/7.8/12.3ms late 2 exec 20/40/95us 60-120B
+    static const ScoTiming::Direction dirs[] = {ScoTiming::Direction::Incoming, ScoTiming::Direction::Outgoing};
+    static const char* const names[] = {"rx", "tx"};
+    ScoTiming::Codec codec = m_timing.codec();
+    for (size_t i = 0; i < 2; i++) {
+        ScoTiming::Summary t = m_timing.getSummary(dirs[i], codec);
+        m_board->logf("[TIM] %s %s n %u int %u.%u/%u.%u/%u.%ums late %u exec %u/%u/%uus %u-%uB",
+            names[i], ScoTiming::codecName(codec), t.calls,
+            t.intervalP50Us / 1000, t.intervalP50Us % 1000 / 100,
+            t.intervalP99Us / 1000, t.intervalP99Us % 1000 / 100,
+            t.intervalMaxUs / 1000, t.intervalMaxUs % 1000 / 100,
+            t.late, t.execP50Us, t.execP99Us, t.execMaxUs, t.bytesMin, t.bytesMax);
+    }
+    m_lastTimingLogUs = esp_timer_get_time();
+}
+
+void BluetoothManager::updateLatencyProbe() {
+    int64_t now = esp_timer_get_time();
+    if (m_scoConnected && now - m_lastProbeUs > PROBE_INTERVAL_MS * 1000LL) {
+        uint32_t rate = m_wideband ? AudioConfig::SAMPLE_RATE_WIDEBAND
+                                   : AudioConfig::SAMPLE_RATE_NARROWBAND;
+        if (m_latencyProbe.trigger(rate)) {
+            m_lastProbeUs = now;
+        }
+    }
+
+    uint32_t linkUs = 0;
+    if (!m_latencyProbe.takeResult(&linkUs)) return;
+
+    // Mouth-to-ear: mic buffering, the measured loop, then our playout path
+    uint32_t micUs = m_board->getMicLatencyUs();
+    uint32_t jitterUs = m_jitterBuffer.fill() * AudioConfig::FRAME_DURATION_US;
+    uint32_t outputUs = (AudioConfig::SPEAKER_QUEUE_FRAMES + AudioConfig::SPEAKER_DMA_BUF_COUNT)
+                        * AudioConfig::FRAME_DURATION_US;
+    m_board->logf("[LAT] %ums = mic %u + link %u + jb %u + out %u (%u%%)",
+        (micUs + linkUs + jitterUs + outputUs) / 1000, micUs / 1000, linkUs / 1000,
+        jitterUs / 1000, outputUs / 1000, m_latencyProbe.getStats().lastPeak);
+}
+
 void BluetoothManager::update() {
-    // Event processing happens in callbacks
+    // Connection and audio events are processed in callbacks.
+    // End of speech is raised on the mic path but the AT command is sent
+    // from here, outside the Bluedroid callback.
+    if (m_preRollArmedUs != 0) {
+        if (m_scoConnected) {
+            m_preRollArmedUs = 0;  // Mic path owns it now; stopped on SCO disconnect
+        } else if (esp_timer_get_time() - m_preRollArmedUs > PRE_ROLL_TIMEOUT_MS * 1000LL) {
+            m_preRollArmedUs = 0;
+            m_board->stopPreRoll();
+            m_board->log("[PRE] No audio link - dropped");
+        }
+    }
+
+    if (m_scoConnected && esp_timer_get_time() - m_lastTimingLogUs > TIMING_LOG_MS * 1000LL) {
+        logCallbackTiming();
+    }
+
+    if (m_probeEnabled) {
+        updateLatencyProbe();
+    }
+
+    int64_t lastSpeechUs = 0;
+    if (!m_vad.takeEndOfSpeech(&lastSpeechUs)) return;
+    if (!m_autoStop || !m_scoConnected) return;
+
+    uint32_t decisionMs = static_cast<uint32_t>((esp_timer_get_time() - lastSpeechUs) / 1000);
+    m_lastDecisionMs = decisionMs;
+    if (decisionMs > m_maxDecisionMs) m_maxDecisionMs = decisionMs;
+    m_autoStops++;
+
+    m_board->logf("[VAD] End of speech (%ums)", decisionMs);
+    playEarcon(EarconMixer::Cue::SessionStop);
+    stopBvra();
 }
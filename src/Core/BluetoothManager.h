@@ -1,6 +1,19 @@
 #pragma once
 
 #include "../HAL/IBoard.h"
+#include "../Audio/JitterBuffer.h"
+#include "../Audio/AudioEngine.h"
+#include "../Audio/AutomaticGainControl.h"
+#include "../Audio/ComfortNoise.h"
+#include "../Audio/EchoCanceller.h"
+#include "../Audio/FractionalResampler.h"
+#include "../Audio/HalfbandConverter.h"
+#include "../Audio/LatencyProbe.h"
+#include "../Audio/ScoTiming.h"
+#include "../Audio/SessionRecorder.h"
+#include "../Audio/NoiseSuppressor.h"
+#include "../Audio/VoiceActivityDetector.h"
+#include <atomic>
 #include <cstdint>
 
 // Forward declare ESP-IDF types to avoid including C headers in header
@@ -17,6 +30,17 @@ typedef uint8_t esp_bd_addr_t[6];
  * - Manage HFP Client connection and SCO audio link
  * - Send AVRCP media button commands to trigger GlassBridge
  * - Route audio between SCO link and board I2S
+ *
+ * Speaker path:
+ *   SCO callback -> JitterBuffer (copy) -> AudioEngine (core 1) -> IBoard::writeAudio
+ *
+ * Mic path:
+ *   IBoard::readAudio -> echo canceller -> [16k->8k for CVSD] -> noise suppressor
+ *     -> AGC -> drift resampler -> SCO callback
+ *           \-> voice activity detector (auto BVRA stop)
+ *
+ * The board's I2S runs at a fixed 16kHz; codec negotiation only selects
+ * whether the 2:1 converters are in the path.
  */
 class BluetoothManager {
 public:
@@ -29,6 +53,7 @@ public:
 
     /**
      * Called every loop iteration to process events
+     * (ends the voice session once the VAD reports end of speech)
      */
     void update();
 
@@ -56,6 +81,18 @@ public:
      */
     void stopBvra();
 
+    /**
+     * Start buffering mic audio before the trigger goes out
+     * Speech between the trigger and SCO coming up is sent first once the
+     * link is up; dropped if no SCO link follows within PRE_ROLL_TIMEOUT_MS.
+     */
+    void armPreRoll();
+
+    /**
+     * A trigger went out and its SCO link is not up yet
+     */
+    bool isPreRollArmed() const { return m_preRollArmedUs != 0; }
+
     /**
      * Check if trigger is allowed (debounce, state validation)
      * @return true if trigger should be processed
@@ -70,6 +107,71 @@ public:
     // Get the board reference (for callbacks)
     IBoard* getBoard() { return m_board; }
 
+    // Speaker jitter buffer counters (underruns, overruns, depth)
+    JitterBuffer::Stats getJitterStats() const { return m_jitterBuffer.getStats(); }
+
+    // Speaker playout counters (fill frames, late output periods)
+    AudioEngine::Stats getEngineStats() const { return m_audioEngine.getStats(); }
+
+    // SCO callback interval/execution/size percentiles (accumulated from boot)
+    ScoTiming::Summary getCallbackTiming(ScoTiming::Direction dir, ScoTiming::Codec codec) const {
+        return m_timing.getSummary(dir, codec);
+    }
+
+    /**
+     * Mix a UI cue into the speaker stream
+     * Only audible while SCO is up; returns false otherwise.
+     */
+    bool playEarcon(EarconMixer::Cue cue) { return m_audioEngine.playEarcon(cue); }
+
+    /**
+     * Rendered cue samples, for IBoard::playClip() while SCO is down
+     */
+    const int16_t* earconClip(EarconMixer::Cue cue, size_t* length) const {
+        return m_audioEngine.earconClip(cue, length);
+    }
+
+    // Mic noise suppression (on by default; safe to toggle during a call)
+    void setNoiseSuppression(bool enabled) { m_noiseSuppressor.setEnabled(enabled); }
+    NoiseSuppressor::Stats getNoiseStats() const { return m_noiseSuppressor.getStats(); }
+
+    // Mic automatic gain control (on by default; safe to toggle during a call)
+    void setAutoGain(bool enabled) { m_agc.setEnabled(enabled); }
+    AutomaticGainControl::Stats getGainStats() const { return m_agc.getStats(); }
+
+    /**
+     * End-of-utterance detection
+     * @param endSilenceMs Silence after speech before the session is stopped
+     * @param thresholdDb Speech threshold above the noise floor (lower = more sensitive)
+     */
+    void setVoiceActivityConfig(uint32_t endSilenceMs, float thresholdDb);
+
+    // Send AT+BVRA=0 automatically at end of speech (on by default)
+    void setAutoStop(bool enabled) { m_autoStop = enabled; }
+
+    // Time from the last speech frame to the automatic stop being sent
+    struct AutoStopStats {
+        VoiceActivityDetector::Stats vad;
+        uint32_t autoStops;        // Sessions ended by the VAD
+        uint32_t lastDecisionMs;   // Decision latency of the most recent stop
+        uint32_t maxDecisionMs;    // Worst decision latency
+    };
+    AutoStopStats getAutoStopStats() const;
+
+    /**
+     * Record both directions of every SCO session
+     */
+    void setSessionRecorder(SessionRecorder* recorder) { m_recorder = recorder; }
+
+    /**
+     * Round-trip latency diagnostic (off by default)
+     * While SCO is up a chirp replaces the mic audio every PROBE_INTERVAL_MS;
+     * the phone must loop the uplink back. Each match is logged with the
+     * on-device split (mic buffer, jitter buffer, speaker queue + DMA).
+     */
+    void setLatencyProbe(bool enabled) { m_probeEnabled = enabled; }
+    LatencyProbe::Stats getLatencyProbeStats() const { return m_latencyProbe.getStats(); }
+
     // Internal handlers called from C callbacks
     void handleConnectionState(uint8_t state, esp_bd_addr_t& addr);
     void handleAudioState(uint8_t state);
@@ -77,18 +179,61 @@ public:
     uint32_t handleOutgoingAudio(uint8_t* data, uint32_t len);
 
 private:
+    static constexpr uint32_t PRE_ROLL_TIMEOUT_MS = 10000;
+    static constexpr uint32_t TIMING_LOG_MS = 30000;   // Summary interval during a session
+    static constexpr uint32_t PROBE_INTERVAL_MS = 2000;
+
     IBoard* m_board = nullptr;
     bool m_slcConnected = false;   // Service Level Connection (HFP control channel)
     bool m_scoConnected = false;   // SCO audio link
     bool m_wideband = false;       // mSBC (true) or CVSD (false)
     uint8_t m_peerAddr[6] = {0};   // Connected device address
 
+    // Speaker playout (decoupled from the Bluedroid callback)
+    JitterBuffer m_jitterBuffer;
+    AudioEngine m_audioEngine;
+
+    // Mic processing (SCO outgoing-data callback context)
+    EchoCanceller m_echoCanceller;   // Reference fed by m_audioEngine
+    FractionalResampler m_micResampler;
+    HalfbandDownsampler m_micDownsampler;
+    HalfbandDownsampler* m_i2sToLink = nullptr;  // nullptr when the link runs at the I2S rate
+    NoiseSuppressor m_noiseSuppressor;           // Runs at the link rate
+    AutomaticGainControl m_agc;
+    VoiceActivityDetector m_vad;                 // Sees the final (levelled) signal
+    ComfortNoise m_micComfort;                   // Fills short mic reads
+    int16_t m_micBuffer[HalfbandDownsampler::MAX_INPUT];
+    std::atomic<uint32_t> m_micComfortFrames{0};
+    std::atomic<bool> m_micPathReset{false};
+
+    // SCO callback timing (recorded in callbacks, summarized from the loop)
+    ScoTiming m_timing;
+    int64_t m_lastTimingLogUs = 0;
+
+    // Round-trip latency probe (chirp in the callbacks, scheduled from the loop)
+    LatencyProbe m_latencyProbe;
+    bool m_probeEnabled = false;
+    int64_t m_lastProbeUs = 0;
+
+    // Automatic end of session (loop context)
+    bool m_autoStop = true;
+    uint32_t m_autoStops = 0;
+    uint32_t m_lastDecisionMs = 0;
+    uint32_t m_maxDecisionMs = 0;
+
+    // Pre-roll waiting for SCO (loop context; 0 = not armed)
+    int64_t m_preRollArmedUs = 0;
+
+    SessionRecorder* m_recorder = nullptr;
+
     void initNvs();
     void initController();
     void initBluedroid();
     void initHfpClient();
     void initAvrcpController();
     void setDiscoverable();
+    void logCallbackTiming();
+    void updateLatencyProbe();
 };
 
 // Global instance pointer (needed for C callbacks)
@@ -2,6 +2,31 @@
 #include <Arduino.h>
 #include <cstdarg>
 
+static void statusStyle(StatusState state, const char*& text, uint32_t& color) {
+    switch (state) {
+        case StatusState::Disconnected:
+            color = TFT_DARKGREY;
+            text = "Not Connected";
+            break;
+        case StatusState::Idle:
+            color = TFT_BLUE;
+            text = "Tap to Speak";
+            break;
+        case StatusState::Listening:
+            color = TFT_RED;
+            text = "Listening...";
+            break;
+        case StatusState::Speaking:
+            color = TFT_GREEN;
+            text = "Speaking...";
+            break;
+        default:
+            color = TFT_BLACK;
+            text = "Unknown";
+            break;
+    }
+}
+
 void Board_M5CoreS3::init() {
     // Configure M5Unified
     auto cfg = M5.config();
@@ -16,22 +41,35 @@ void Board_M5CoreS3::init() {
 
     // Configure speaker for voice audio
     auto spk_cfg = M5.Speaker.config();
-    spk_cfg.sample_rate = m_sampleRate;
+    spk_cfg.sample_rate = AudioConfig::I2S_SAMPLE_RATE;
     spk_cfg.stereo = false;              // Mono for voice
     spk_cfg.buzzer = false;              // Not using buzzer mode
     spk_cfg.magnification = 16;          // Volume multiplier
+    // Double-buffered DMA sized to one 7.5ms SCO frame; mixer task on the audio core
+    spk_cfg.dma_buf_len = AudioConfig::frameSamples(AudioConfig::I2S_SAMPLE_RATE);
+    spk_cfg.dma_buf_count = AudioConfig::SPEAKER_DMA_BUF_COUNT;
+    spk_cfg.task_priority = AudioConfig::SPEAKER_TASK_PRIORITY;
+    spk_cfg.task_pinned_core = AudioConfig::AUDIO_TASK_CORE;
     M5.Speaker.config(spk_cfg);
     M5.Speaker.begin();
     M5.Speaker.setVolume(200);           // 0-255
 
     // Configure microphone
     auto mic_cfg = M5.Mic.config();
-    mic_cfg.sample_rate = m_sampleRate;
+    mic_cfg.sample_rate = AudioConfig::I2S_SAMPLE_RATE;
     mic_cfg.stereo = false;              // Mono
-    mic_cfg.magnification = 16;          // Gain
+    mic_cfg.magnification = AudioConfig::MIC_MAGNIFICATION;  // Headroom; AGC sets the level
     M5.Mic.config(mic_cfg);
     M5.Mic.begin();
 
+    // Hand the mic to the capture task (keeps a ring filled ahead of readAudio)
+#if defined(MIC_LOW_LATENCY)
+    m_micCapture.setMode(M5MicCapture::Mode::LowLatency);
+#endif
+    // Pre-roll as plain PCM in PSRAM; ADPCM in internal RAM if there is none
+    bool preRoll = m_micCapture.enablePreRoll(PreRollBuffer::Storage::Psram);
+    m_micCapture.begin();
+
     // Initialize display
     M5.Display.setRotation(1);           // Landscape (320x240)
     M5.Display.setBrightness(128);
@@ -39,7 +77,7 @@ void Board_M5CoreS3::init() {
     // Clear screen and draw initial layout
     M5.Display.fillScreen(TFT_BLACK);
 
-    // Draw initial status
+    // Initial status (drawn by the compositor on its first frame)
     setLedStatus(StatusState::Disconnected);
 
     // Initialize log section background
@@ -48,14 +86,29 @@ void Board_M5CoreS3::init() {
     // Draw separator line
     M5.Display.drawFastHLine(0, LOG_Y_START, SCREEN_WIDTH, TFT_DARKGREY);
 
-    // Reserve log buffer space
-    m_logLines.reserve(LOG_BUFFER_SIZE);
+#ifdef LOG_HW_SCROLL
+    // Log lines scroll in hardware; everything above and below stays put
+    uint16_t scrollTop = PANEL_ROW_OFFSET + LOG_TEXT_Y;
+    uint16_t scrollArea = LOG_MAX_LINES * LOG_LINE_HEIGHT;
+    m_ui.defineScroll(scrollTop, scrollArea, PANEL_MEMORY_ROWS - scrollTop - scrollArea);
+    m_ui.setScrollStart(scrollTop);
+#endif
+
+    // From here on only the compositor task touches the display and Serial
+    if (!m_ui.begin(SCREEN_WIDTH, STATUS_HEIGHT, LOG_LINE_HEIGHT, renderFrame, this)) {
+        Serial.println("UI: no memory for back buffers, serial log only");
+    }
 
     // Initial log messages
     log("OpenBadge v1.0");
     log("Initializing...");
-    logf("Speaker: %d Hz mono", m_sampleRate);
-    logf("Mic: %d Hz mono", m_sampleRate);
+    logf("Speaker: %u Hz mono", AudioConfig::I2S_SAMPLE_RATE);
+    logf("Mic: %u Hz mono", AudioConfig::I2S_SAMPLE_RATE);
+    if (!preRoll) {
+        log("Pre-roll: no memory");
+    } else {
+        logf("Pre-roll: %s", (m_micCapture.getPreRollStorage() == PreRollBuffer::Storage::Psram) ? "PSRAM" : "ADPCM");
+    }
     log("Hardware ready");
 }
 
@@ -81,105 +134,149 @@ bool Board_M5CoreS3::isActionTriggered() {
 }
 
 void Board_M5CoreS3::setLedStatus(StatusState state) {
-    if (state == m_currentState) return;
-    m_currentState = state;
+    if (state == m_currentState.load(std::memory_order_relaxed)) return;
+    m_currentState.store(state, std::memory_order_relaxed);
+    m_ui.requestStatus();  // Starts the transition timer
 
-    // Select color and text based on state
-    uint32_t color;
     const char* text;
+    uint32_t color;
+    statusStyle(state, text, color);
+    logf("Status: %s", text);
+}
 
-    switch (state) {
-        case StatusState::Disconnected:
-            color = TFT_DARKGREY;
-            text = "Not Connected";
-            break;
-        case StatusState::Idle:
-            color = TFT_BLUE;
-            text = "Tap to Speak";
-            break;
-        case StatusState::Listening:
-            color = TFT_RED;
-            text = "Listening...";
-            break;
-        case StatusState::Speaking:
-            color = TFT_GREEN;
-            text = "Speaking...";
-            break;
-        default:
-            color = TFT_BLACK;
-            text = "Unknown";
-            break;
+// ============================================================
+// RENDERING (compositor task)
+// ============================================================
+
+void Board_M5CoreS3::renderFrame(void* arg) {
+    static_cast<Board_M5CoreS3*>(arg)->render();
+}
+
+void Board_M5CoreS3::render() {
+    if (!m_bannersCached) {
+        cacheBanners();
     }
 
-    drawStatusSection(text, color);
-    logf("Status: %s", text);
+    StatusState state = m_currentState.load(std::memory_order_relaxed);
+    if (!m_statusDrawn || state != m_drawnState) {
+        if (!m_ui.showCachedStatus(static_cast<size_t>(state))) {
+            const char* text;
+            uint32_t color;
+            statusStyle(state, text, color);
+            drawStatusSection(text, color);
+        }
+        m_ui.pushStatus();  // In flight while the log lines render
+        m_drawnState = state;
+        m_statusDrawn = true;
+    }
+
+    // Everything logged since the last frame is drawn in one pass
+    char record[LOG_RECORD_CHARS + 1];
+    size_t newLines = 0;
+    while (m_logQueue.pop(record)) {
+        Serial.println(record);
+        m_logLines.push(record);
+        newLines++;
+    }
+    uint32_t dropped = m_logQueue.takeDropped();
+    if (dropped > 0) {
+        snprintf(record, sizeof(record), "[LOG] %u lines dropped", static_cast<unsigned>(dropped));
+        Serial.println(record);
+        m_logLines.push(record);
+        newLines++;
+    }
+    if (newLines > 0) {
+        drawLogLines(newLines);
+    }
+}
+
+void Board_M5CoreS3::cacheBanners() {
+    // Once, on the first frame at boot: each banner is rendered here and
+    // every later state change just copies one in. The status canvas is
+    // left dirty, but the first frame always draws the current state next.
+    for (size_t i = 0; i < STATUS_STATES; i++) {
+        const char* text;
+        uint32_t color;
+        statusStyle(static_cast<StatusState>(i), text, color);
+        drawStatusSection(text, color);
+        if (!m_ui.cacheStatus(i)) break;  // Too many colours or no room: the rest render live
+    }
+    m_bannersCached = true;
 }
 
 void Board_M5CoreS3::drawStatusSection(const char* text, uint32_t bgColor) {
+    M5Canvas& canvas = m_ui.statusCanvas();
+
     // Fill status area with background color
-    M5.Display.fillRect(0, 0, SCREEN_WIDTH, STATUS_HEIGHT, bgColor);
+    canvas.fillScreen(bgColor);
 
     // Draw main status text (large, centered)
-    M5.Display.setFont(&fonts::FreeSansBold18pt7b);
-    M5.Display.setTextColor(TFT_WHITE, bgColor);
-    M5.Display.setTextDatum(middle_center);
-    M5.Display.drawString(text, SCREEN_WIDTH / 2, STATUS_HEIGHT / 2 - 10);
+    canvas.setFont(&fonts::FreeSansBold18pt7b);
+    canvas.setTextColor(TFT_WHITE, bgColor);
+    canvas.setTextDatum(middle_center);
+    canvas.drawString(text, SCREEN_WIDTH / 2, STATUS_HEIGHT / 2 - 10);
 
     // Draw "OpenBadge" label (small, bottom of status area)
-    M5.Display.setFont(&fonts::Font2);
-    M5.Display.setTextColor(TFT_LIGHTGREY, bgColor);
-    M5.Display.drawString("OpenBadge", SCREEN_WIDTH / 2, STATUS_HEIGHT - 15);
+    canvas.setFont(&fonts::Font2);
+    canvas.setTextColor(TFT_LIGHTGREY, bgColor);
+    canvas.drawString("OpenBadge", SCREEN_WIDTH / 2, STATUS_HEIGHT - 15);
 
-    // Redraw separator line
-    M5.Display.drawFastHLine(0, LOG_Y_START, SCREEN_WIDTH, TFT_DARKGREY);
+    // The whole region changed (separator and log are outside it)
+    m_ui.markStatusDirty(0, STATUS_HEIGHT);
 }
 
-void Board_M5CoreS3::addLogLine(const char* message) {
-    // Add to circular buffer
-    if (m_logLines.size() >= LOG_BUFFER_SIZE) {
-        m_logLines.erase(m_logLines.begin());
-    }
-    m_logLines.push_back(std::string(message));
-
-    // Redraw log section
-    drawLogSection();
-}
-
-void Board_M5CoreS3::drawLogSection() {
-    // Clear log area (preserve separator line)
-    M5.Display.fillRect(0, LOG_Y_START + 1, SCREEN_WIDTH, LOG_HEIGHT - 1, TFT_BLACK);
-
-    // Configure text for log display
-    M5.Display.setFont(&fonts::Font2);  // Small fixed-width-ish font
-    M5.Display.setTextColor(TFT_CYAN, TFT_BLACK);
-    M5.Display.setTextDatum(top_left);
+void Board_M5CoreS3::drawLogLines(size_t count) {
+    // Lines that scrolled past within the same frame are never drawn
+    if (count > LOG_MAX_LINES) count = LOG_MAX_LINES;
 
-    // Calculate how many lines to show (most recent)
-    int startIdx = 0;
-    if (m_logLines.size() > LOG_MAX_LINES) {
-        startIdx = m_logLines.size() - LOG_MAX_LINES;
+    int16_t rows[LOG_MAX_LINES];
+#ifdef LOG_HW_SCROLL
+    // Scroll first, so each reused slot is already at the bottom when redrawn
+    for (size_t i = 0; i < count; i++) {
+        rows[i] = m_logScroll.slotRow(m_logScroll.nextSlot());
+        m_logScroll.advance();
     }
-
-    // Draw visible lines
-    int y = LOG_Y_START + LOG_PADDING;
-    for (size_t i = startIdx; i < m_logLines.size(); i++) {
-        // Truncate long lines
-        std::string line = m_logLines[i];
-        if (line.length() > 38) {  // ~38 chars fit at this font size
-            line = line.substr(0, 35) + "...";
+    m_ui.setScrollStart(PANEL_ROW_OFFSET + LOG_TEXT_Y + m_logScroll.scrollRows());
+#else
+    // No scrolling: each new line overwrites the oldest in place and the
+    // marker moves to the newest, so the other lines are never pushed again
+    if (m_logMarkRow >= 0) {
+        m_ui.clearRect(0, LOG_TEXT_Y + m_logMarkRow, LOG_MARK_WIDTH, LOG_LINE_HEIGHT);
+    }
+    for (size_t i = 0; i < count; i++) {
+        rows[i] = m_logScroll.slotRow(m_logScroll.nextSlot());
+        m_logScroll.advance();
+    }
+    m_logMarkRow = rows[count - 1];
+#endif
+
+    // Each line renders into a strip while the previous one is pushed
+    // (already truncated when stored)
+    size_t first = m_logLines.size() - count;
+    for (size_t i = 0; i < count; i++) {
+        M5Canvas& line = m_ui.lineCanvas();
+        line.setFont(&fonts::Font2);  // Small fixed-width-ish font
+        line.setTextColor(TFT_CYAN, TFT_BLACK);
+        line.setTextDatum(top_left);
+        line.drawString(m_logLines.line(first + i), LOG_PADDING, 0);
+#ifndef LOG_HW_SCROLL
+        if (i + 1 == count) {
+            line.fillRect(0, 1, LOG_MARK_WIDTH, LOG_LINE_HEIGHT - 2, TFT_CYAN);
         }
-
-        M5.Display.drawString(line.c_str(), LOG_PADDING, y);
-        y += LOG_LINE_HEIGHT;
+#endif
+        m_ui.pushLine(LOG_TEXT_Y + rows[i]);
     }
 }
 
 void Board_M5CoreS3::log(const char* message) {
-    // Output to serial (always)
-    Serial.println(message);
+    if (!m_ui.isRunning()) {
+        Serial.println(message);
+        return;
+    }
 
-    // Add to screen log
-    addLogLine(message);
+    // Serial and screen output happen on the compositor task
+    m_logQueue.push(message);
+    m_ui.requestFrame();
 }
 
 void Board_M5CoreS3::logf(const char* format, ...) {
@@ -195,58 +292,84 @@ void Board_M5CoreS3::logf(const char* format, ...) {
 size_t Board_M5CoreS3::writeAudio(const uint8_t* data, size_t size) {
     if (size == 0) return 0;
 
-    // M5.Speaker.playRaw expects int16_t samples
-    size_t samples = size / sizeof(int16_t);
+    size_t written = 0;
+    while (written < size) {
+        size_t chunk = size - written;
+        if (chunk > sizeof(m_spkBuffers[0])) {
+            chunk = sizeof(m_spkBuffers[0]);
+        }
 
-    // playRaw parameters: (data, samples, sample_rate, stereo, repeat_count)
-    bool success = M5.Speaker.playRaw((const int16_t*)data, samples, m_sampleRate, false, 1, -1);
+        // Copy into our own buffer - playRaw() plays from the pointer later
+        int16_t* buffer = m_spkBuffers[m_spkBufferIdx];
+        m_spkBufferIdx = (m_spkBufferIdx + 1) % SPK_BUFFER_COUNT;
+        memcpy(buffer, data + written, chunk);
 
-    return success ? size : 0;
+        // playRaw parameters: (data, samples, sample_rate, stereo, repeat_count, channel)
+        // Blocks while two buffers are already queued on SPK_CHANNEL
+        if (!M5.Speaker.playRaw(buffer, chunk / sizeof(int16_t), AudioConfig::I2S_SAMPLE_RATE, false, 1, SPK_CHANNEL)) {
+            break;
+        }
+        written += chunk;
+    }
+
+    return written;
+}
+
+bool Board_M5CoreS3::playClip(const int16_t* samples, size_t count) {
+    if (count == 0) return false;
+
+    // Replaces whatever clip is still playing; SPK_CHANNEL is left alone
+    return M5.Speaker.playRaw(samples, count, AudioConfig::I2S_SAMPLE_RATE, false, 1, CLIP_CHANNEL, true);
 }
 
 size_t Board_M5CoreS3::readAudio(uint8_t* data, size_t size) {
     if (size == 0) return 0;
 
-    size_t samplesToRead = size / sizeof(int16_t);
-    if (samplesToRead > MIC_BUFFER_SAMPLES) {
-        samplesToRead = MIC_BUFFER_SAMPLES;
-    }
-
-    // Record synchronously (blocking)
-    if (M5.Mic.record(m_micBuffer, samplesToRead, m_sampleRate)) {
-        // Wait for recording to complete
-        while (M5.Mic.isRecording()) {
-            delayMicroseconds(100);
-        }
+    // Non-blocking: copies the latest captured frame from the ring
+    return m_micCapture.read(data, size);
+}
 
-        // Copy to output buffer
-        size_t bytesToCopy = samplesToRead * sizeof(int16_t);
-        memcpy(data, m_micBuffer, bytesToCopy);
-        return bytesToCopy;
-    }
+uint32_t Board_M5CoreS3::getMicLatencyUs() {
+    return m_micCapture.latencyUs();
+}
 
-    return 0;
+void Board_M5CoreS3::startPreRoll() {
+    m_micCapture.startPreRoll();
 }
 
-void Board_M5CoreS3::setSampleRate(int rate) {
-    if (rate == m_sampleRate) return;
+void Board_M5CoreS3::stopPreRoll() {
+    m_micCapture.stopPreRoll();
 
-    logf("Sample rate: %d -> %d Hz", m_sampleRate, rate);
-    m_sampleRate = rate;
+    PreRollBuffer::Stats s = m_micCapture.getPreRollStats();
+    if (s.backlogMs > 0) {
+        logf("[PRE] backlog %ums caught up %ums skip %u lost %u",
+             s.backlogMs, s.catchUpMs, s.skippedBlocks, s.overwritten + s.dropped);
+    }
+}
 
-    // Stop current audio operations
-    M5.Speaker.stop();
-    M5.Mic.end();
+void Board_M5CoreS3::setWakeWordListening(bool listening) {
+    m_micCapture.setListening(listening);
+}
 
-    // Reconfigure speaker
-    auto spk_cfg = M5.Speaker.config();
-    spk_cfg.sample_rate = rate;
-    M5.Speaker.config(spk_cfg);
-    M5.Speaker.begin();
+size_t Board_M5CoreS3::readWakeWordAudio(int16_t* samples, size_t count) {
+    return m_micCapture.readListening(samples, count);
+}
 
-    // Reconfigure microphone
-    auto mic_cfg = M5.Mic.config();
-    mic_cfg.sample_rate = rate;
-    M5.Mic.config(mic_cfg);
-    M5.Mic.begin();
+void Board_M5CoreS3::logSessionStats() {
+    M5MicCapture::Stats mic = m_micCapture.getStats();
+    logf("[MIC] short %u/%u skip %u over %u err %u",
+         mic.shortReads, mic.framesRead + mic.shortReads, mic.skipped, mic.overflows, mic.recordErrors);
+    m_micCapture.resetStats();
+
+    // The idle time before this session, if the wake word was listening
+    MicDutyCycle::Stats duty = m_micCapture.getDutyCycleStats();
+    if (duty.onMs + duty.offMs > 0) {
+        logf("[DUTY] mic on %ums off %ums, %u sleeps %u woken",
+             duty.onMs, duty.offMs, duty.sleeps, duty.wakeups);
+    }
+
+    M5Compositor::Stats ui = m_ui.getStats();
+    logf("[UI] status %u (%u cached) last %uus (frame %uus) max %uus",
+         ui.transitions, ui.cached, ui.lastUs, ui.lastFrameUs, ui.maxUs);
+    m_ui.resetStats();
 }
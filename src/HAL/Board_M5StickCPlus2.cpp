@@ -2,6 +2,31 @@
 #include <Arduino.h>
 #include <cstdarg>
 
+static void statusStyle(StatusState state, const char*& text, uint32_t& color) {
+    switch (state) {
+        case StatusState::Disconnected:
+            color = TFT_DARKGREY;
+            text = "Not Connected";
+            break;
+        case StatusState::Idle:
+            color = TFT_BLUE;
+            text = "Tap to Speak";
+            break;
+        case StatusState::Listening:
+            color = TFT_RED;
+            text = "Listening...";
+            break;
+        case StatusState::Speaking:
+            color = TFT_GREEN;
+            text = "Speaking...";
+            break;
+        default:
+            color = TFT_BLACK;
+            text = "Unknown";
+            break;
+    }
+}
+
 void Board_M5StickCPlus2::init() {
     // Configure M5Unified for StickC Plus2
     auto cfg = M5.config();
@@ -22,23 +47,39 @@ void Board_M5StickCPlus2::init() {
     /*
     // Configure speaker for voice audio (PAM8303 via I2S GPIO0)
     auto spk_cfg = M5.Speaker.config();
-    spk_cfg.sample_rate = m_sampleRate;
+    spk_cfg.sample_rate = AudioConfig::I2S_SAMPLE_RATE;
     spk_cfg.stereo = false;              // Mono for voice
     spk_cfg.buzzer = false;              // Not using buzzer mode
     spk_cfg.magnification = 16;          // Volume multiplier (may need tuning)
+    // Double-buffered DMA sized to one 7.5ms SCO frame; mixer task on the audio core
+    spk_cfg.dma_buf_len = AudioConfig::frameSamples(AudioConfig::I2S_SAMPLE_RATE);
+    spk_cfg.dma_buf_count = AudioConfig::SPEAKER_DMA_BUF_COUNT;
+    spk_cfg.task_priority = AudioConfig::SPEAKER_TASK_PRIORITY;
+    spk_cfg.task_pinned_core = AudioConfig::AUDIO_TASK_CORE;
     M5.Speaker.config(spk_cfg);
     M5.Speaker.begin();
     M5.Speaker.setVolume(200);           // 0-255 (may need tuning for PAM8303)
 
     // Configure microphone (SPM1423 PDM via GPIO34/GPIO0)
     auto mic_cfg = M5.Mic.config();
-    mic_cfg.sample_rate = m_sampleRate;
+    mic_cfg.sample_rate = AudioConfig::I2S_SAMPLE_RATE;
     mic_cfg.stereo = false;              // Mono
-    mic_cfg.magnification = 16;          // Gain (may need tuning for sensitivity)
+    mic_cfg.magnification = AudioConfig::MIC_MAGNIFICATION;  // Headroom; AGC sets the level
     M5.Mic.config(mic_cfg);
     M5.Mic.begin();
     */
 
+    // Hand the mic to the capture task (keeps a ring filled ahead of readAudio)
+    // Skipped while the internal mic is disabled above
+    if (M5.Mic.isEnabled()) {
+#if defined(MIC_LOW_LATENCY)
+        m_micCapture.setMode(M5MicCapture::Mode::LowLatency);
+#endif
+        // Pre-roll as 4:1 ADPCM in internal RAM (~18KB for 2s)
+        m_micCapture.enablePreRoll(PreRollBuffer::Storage::Adpcm);
+        m_micCapture.begin();
+    }
+
     // Initialize display (portrait orientation)
     // Try rotation 0 first; if display is upside down, try rotation 2
     M5.Display.setRotation(0);           // Portrait (135x240)
@@ -47,7 +88,7 @@ void Board_M5StickCPlus2::init() {
     // Clear screen and draw initial layout
     M5.Display.fillScreen(TFT_BLACK);
 
-    // Draw initial status
+    // Initial status (drawn by the compositor on its first frame)
     setLedStatus(StatusState::Disconnected);
 
     // Initialize log section background
@@ -56,8 +97,18 @@ void Board_M5StickCPlus2::init() {
     // Draw separator line
     M5.Display.drawFastHLine(0, LOG_Y_START, SCREEN_WIDTH, TFT_DARKGREY);
 
-    // Reserve log buffer space
-    m_logLines.reserve(LOG_BUFFER_SIZE);
+#ifdef LOG_HW_SCROLL
+    // Log lines scroll in hardware; everything above and below stays put
+    uint16_t scrollTop = PANEL_ROW_OFFSET + LOG_TEXT_Y;
+    uint16_t scrollArea = LOG_MAX_LINES * LOG_LINE_HEIGHT;
+    m_ui.defineScroll(scrollTop, scrollArea, PANEL_MEMORY_ROWS - scrollTop - scrollArea);
+    m_ui.setScrollStart(scrollTop);
+#endif
+
+    // From here on only the compositor task touches the display and Serial
+    if (!m_ui.begin(SCREEN_WIDTH, STATUS_HEIGHT, LOG_LINE_HEIGHT, renderFrame, this)) {
+        Serial.println("UI: no memory for back buffers, serial log only");
+    }
 
     // Initial log messages
     log("OpenBadge v1.0");
@@ -87,106 +138,150 @@ bool Board_M5StickCPlus2::isActionTriggered() {
 }
 
 void Board_M5StickCPlus2::setLedStatus(StatusState state) {
-    if (state == m_currentState) return;
-    m_currentState = state;
+    if (state == m_currentState.load(std::memory_order_relaxed)) return;
+    m_currentState.store(state, std::memory_order_relaxed);
+    m_ui.requestStatus();  // Starts the transition timer
 
-    // Select color and text based on state
-    uint32_t color;
     const char* text;
+    uint32_t color;
+    statusStyle(state, text, color);
+    logf("Status: %s", text);
+}
 
-    switch (state) {
-        case StatusState::Disconnected:
-            color = TFT_DARKGREY;
-            text = "Not Connected";
-            break;
-        case StatusState::Idle:
-            color = TFT_BLUE;
-            text = "Tap to Speak";
-            break;
-        case StatusState::Listening:
-            color = TFT_RED;
-            text = "Listening...";
-            break;
-        case StatusState::Speaking:
-            color = TFT_GREEN;
-            text = "Speaking...";
-            break;
-        default:
-            color = TFT_BLACK;
-            text = "Unknown";
-            break;
+// ============================================================
+// RENDERING (compositor task)
+// ============================================================
+
+void Board_M5StickCPlus2::renderFrame(void* arg) {
+    static_cast<Board_M5StickCPlus2*>(arg)->render();
+}
+
+void Board_M5StickCPlus2::render() {
+    if (!m_bannersCached) {
+        cacheBanners();
     }
 
-    drawStatusSection(text, color);
-    logf("Status: %s", text);
+    StatusState state = m_currentState.load(std::memory_order_relaxed);
+    if (!m_statusDrawn || state != m_drawnState) {
+        if (!m_ui.showCachedStatus(static_cast<size_t>(state))) {
+            const char* text;
+            uint32_t color;
+            statusStyle(state, text, color);
+            drawStatusSection(text, color);
+        }
+        m_ui.pushStatus();  // In flight while the log lines render
+        m_drawnState = state;
+        m_statusDrawn = true;
+    }
+
+    // Everything logged since the last frame is drawn in one pass
+    char record[LOG_RECORD_CHARS + 1];
+    size_t newLines = 0;
+    while (m_logQueue.pop(record)) {
+        Serial.println(record);
+        m_logLines.push(record);
+        newLines++;
+    }
+    uint32_t dropped = m_logQueue.takeDropped();
+    if (dropped > 0) {
+        snprintf(record, sizeof(record), "[LOG] %u lines dropped", static_cast<unsigned>(dropped));
+        Serial.println(record);
+        m_logLines.push(record);
+        newLines++;
+    }
+    if (newLines > 0) {
+        drawLogLines(newLines);
+    }
+}
+
+void Board_M5StickCPlus2::cacheBanners() {
+    // Once, on the first frame at boot: each banner is rendered here and
+    // every later state change just copies one in. The status canvas is
+    // left dirty, but the first frame always draws the current state next.
+    for (size_t i = 0; i < STATUS_STATES; i++) {
+        const char* text;
+        uint32_t color;
+        statusStyle(static_cast<StatusState>(i), text, color);
+        drawStatusSection(text, color);
+        if (!m_ui.cacheStatus(i)) break;  // Too many colours or no room: the rest render live
+    }
+    m_bannersCached = true;
 }
 
 void Board_M5StickCPlus2::drawStatusSection(const char* text, uint32_t bgColor) {
+    M5Canvas& canvas = m_ui.statusCanvas();
+
     // Fill status area with background color
-    M5.Display.fillRect(0, 0, SCREEN_WIDTH, STATUS_HEIGHT, bgColor);
+    canvas.fillScreen(bgColor);
 
     // Draw main status text (smaller font for narrow screen)
     // Core S3 uses FreeSansBold18pt7b, Plus2 uses FreeSansBold12pt7b
-    M5.Display.setFont(&fonts::FreeSansBold12pt7b);
-    M5.Display.setTextColor(TFT_WHITE, bgColor);
-    M5.Display.setTextDatum(middle_center);
-    M5.Display.drawString(text, SCREEN_WIDTH / 2, STATUS_HEIGHT / 2 - 8);
+    canvas.setFont(&fonts::FreeSansBold12pt7b);
+    canvas.setTextColor(TFT_WHITE, bgColor);
+    canvas.setTextDatum(middle_center);
+    canvas.drawString(text, SCREEN_WIDTH / 2, STATUS_HEIGHT / 2 - 8);
 
     // Draw "OpenBadge" label (small, bottom of status area)
-    M5.Display.setFont(&fonts::Font0);  // Tiny font for narrow screen
-    M5.Display.setTextColor(TFT_LIGHTGREY, bgColor);
-    M5.Display.drawString("OpenBadge", SCREEN_WIDTH / 2, STATUS_HEIGHT - 10);
-
-    // Redraw separator line
-    M5.Display.drawFastHLine(0, LOG_Y_START, SCREEN_WIDTH, TFT_DARKGREY);
-}
-
-void Board_M5StickCPlus2::addLogLine(const char* message) {
-    // Add to circular buffer
-    if (m_logLines.size() >= LOG_BUFFER_SIZE) {
-        m_logLines.erase(m_logLines.begin());
-    }
-    m_logLines.push_back(std::string(message));
+    canvas.setFont(&fonts::Font0);  // Tiny font for narrow screen
+    canvas.setTextColor(TFT_LIGHTGREY, bgColor);
+    canvas.drawString("OpenBadge", SCREEN_WIDTH / 2, STATUS_HEIGHT - 10);
 
-    // Redraw log section
-    drawLogSection();
+    // The whole region changed (separator and log are outside it)
+    m_ui.markStatusDirty(0, STATUS_HEIGHT);
 }
 
-void Board_M5StickCPlus2::drawLogSection() {
-    // Clear log area (preserve separator line)
-    M5.Display.fillRect(0, LOG_Y_START + 1, SCREEN_WIDTH, LOG_HEIGHT - 1, TFT_BLACK);
+void Board_M5StickCPlus2::drawLogLines(size_t count) {
+    // Lines that scrolled past within the same frame are never drawn
+    if (count > LOG_MAX_LINES) count = LOG_MAX_LINES;
 
-    // Configure text for log display
-    M5.Display.setFont(&fonts::Font0);  // Small font for narrow screen
-    M5.Display.setTextColor(TFT_CYAN, TFT_BLACK);
-    M5.Display.setTextDatum(top_left);
-
-    // Calculate how many lines to show (most recent)
-    int startIdx = 0;
-    if (m_logLines.size() > LOG_MAX_LINES) {
-        startIdx = m_logLines.size() - LOG_MAX_LINES;
+    int16_t rows[LOG_MAX_LINES];
+#ifdef LOG_HW_SCROLL
+    // Scroll first, so each reused slot is already at the bottom when redrawn
+    for (size_t i = 0; i < count; i++) {
+        rows[i] = m_logScroll.slotRow(m_logScroll.nextSlot());
+        m_logScroll.advance();
     }
-
-    // Draw visible lines
-    int y = LOG_Y_START + LOG_PADDING;
-    for (size_t i = startIdx; i < m_logLines.size(); i++) {
-        // Truncate long lines (narrow screen: ~22 chars fit)
-        std::string line = m_logLines[i];
-        if (line.length() > 22) {
-            line = line.substr(0, 19) + "...";
+    m_ui.setScrollStart(PANEL_ROW_OFFSET + LOG_TEXT_Y + m_logScroll.scrollRows());
+#else
+    // No scrolling: each new line overwrites the oldest in place and the
+    // marker moves to the newest, so the other lines are never pushed again
+    if (m_logMarkRow >= 0) {
+        m_ui.clearRect(0, LOG_TEXT_Y + m_logMarkRow, LOG_MARK_WIDTH, LOG_LINE_HEIGHT);
+    }
+    for (size_t i = 0; i < count; i++) {
+        rows[i] = m_logScroll.slotRow(m_logScroll.nextSlot());
+        m_logScroll.advance();
+    }
+    m_logMarkRow = rows[count - 1];
+#endif
+
+    // Each line renders into a strip while the previous one is pushed
+    // (already truncated when stored)
+    size_t first = m_logLines.size() - count;
+    for (size_t i = 0; i < count; i++) {
+        M5Canvas& line = m_ui.lineCanvas();
+        line.setFont(&fonts::Font0);  // Small font for narrow screen
+        line.setTextColor(TFT_CYAN, TFT_BLACK);
+        line.setTextDatum(top_left);
+        line.drawString(m_logLines.line(first + i), LOG_PADDING, 0);
+#ifndef LOG_HW_SCROLL
+        if (i + 1 == count) {
+            line.fillRect(0, 1, LOG_MARK_WIDTH, LOG_LINE_HEIGHT - 2, TFT_CYAN);
         }
-
-        M5.Display.drawString(line.c_str(), LOG_PADDING, y);
-        y += LOG_LINE_HEIGHT;
+#endif
+        m_ui.pushLine(LOG_TEXT_Y + rows[i]);
     }
 }
 
 void Board_M5StickCPlus2::log(const char* message) {
-    // Output to serial (always)
-    Serial.println(message);
+    if (!m_ui.isRunning()) {
+        Serial.println(message);
+        return;
+    }
 
-    // Add to screen log
-    addLogLine(message);
+    // Serial and screen output happen on the compositor task
+    m_logQueue.push(message);
+    m_ui.requestFrame();
 }
 
 void Board_M5StickCPlus2::logf(const char* format, ...) {
@@ -202,84 +297,89 @@ void Board_M5StickCPlus2::logf(const char* format, ...) {
 size_t Board_M5StickCPlus2::writeAudio(const uint8_t* data, size_t size) {
     if (size == 0) return 0;
 
-    // M5.Speaker.playRaw expects int16_t samples
-    size_t samples = size / sizeof(int16_t);
+    size_t written = 0;
+    bool success = true;
+    while (written < size) {
+        size_t chunk = size - written;
+        if (chunk > sizeof(m_spkBuffers[0])) {
+            chunk = sizeof(m_spkBuffers[0]);
+        }
 
-    // playRaw parameters: (data, samples, sample_rate, stereo, repeat_count, channel)
-    // PAM8303 speaker via I2S on GPIO0 (M5Unified handles routing)
-    bool success = M5.Speaker.playRaw((const int16_t*)data, samples, m_sampleRate, false, 1, -1);
+        // Copy into our own buffer - playRaw() plays from the pointer later
+        int16_t* buffer = m_spkBuffers[m_spkBufferIdx];
+        m_spkBufferIdx = (m_spkBufferIdx + 1) % SPK_BUFFER_COUNT;
+        memcpy(buffer, data + written, chunk);
 
-    // Debug: Log speaker playback periodically (every ~1 second at 50Hz callback rate)
-    static uint32_t playbackCount = 0;
-    playbackCount++;
-    if (playbackCount % 50 == 0) {
-        logf("[Speaker] Playback #%u: %zu bytes, %zu samples, %s",
-             playbackCount, size, samples, success ? "OK" : "FAIL");
+        // playRaw parameters: (data, samples, sample_rate, stereo, repeat_count, channel)
+        // PAM8303 speaker via I2S on GPIO0 (M5Unified handles routing)
+        // Blocks while two buffers are already queued on SPK_CHANNEL
+        success = M5.Speaker.playRaw(buffer, chunk / sizeof(int16_t), AudioConfig::I2S_SAMPLE_RATE, false, 1, SPK_CHANNEL);
+        if (!success) {
+            break;
+        }
+        written += chunk;
     }
 
-    return success ? size : 0;
+    return written;
+}
+
+bool Board_M5StickCPlus2::playClip(const int16_t* samples, size_t count) {
+    if (count == 0) return false;
+
+    // Replaces whatever clip is still playing; SPK_CHANNEL is left alone
+    return M5.Speaker.playRaw(samples, count, AudioConfig::I2S_SAMPLE_RATE, false, 1, CLIP_CHANNEL, true);
 }
 
 size_t Board_M5StickCPlus2::readAudio(uint8_t* data, size_t size) {
     if (size == 0) return 0;
 
-    size_t samplesToRead = size / sizeof(int16_t);
-    if (samplesToRead > MIC_BUFFER_SAMPLES) {
-        samplesToRead = MIC_BUFFER_SAMPLES;
-    }
-
-    // Record synchronously (blocking)
+    // Non-blocking: copies the latest captured frame from the ring
     // SPM1423 PDM mic via GPIO34/GPIO0 (M5Unified handles multiplexing with speaker)
-    if (M5.Mic.record(m_micBuffer, samplesToRead, m_sampleRate)) {
-        // Wait for recording to complete
-        while (M5.Mic.isRecording()) {
-            delayMicroseconds(100);
-        }
+    // Short reads are counted in M5MicCapture::Stats and logged per session
+    return m_micCapture.isRunning() ? m_micCapture.read(data, size) : 0;
+}
 
-        // Copy to output buffer
-        size_t bytesToCopy = samplesToRead * sizeof(int16_t);
-        memcpy(data, m_micBuffer, bytesToCopy);
+uint32_t Board_M5StickCPlus2::getMicLatencyUs() {
+    return m_micCapture.isRunning() ? m_micCapture.latencyUs() : 0;
+}
 
-        // Debug: Log microphone capture periodically (every ~1 second at 50Hz callback rate)
-        static uint32_t captureCount = 0;
-        captureCount++;
-        if (captureCount % 50 == 0) {
-            logf("[Mic] Capture #%u: %zu bytes, %zu samples",
-                 captureCount, bytesToCopy, samplesToRead);
-        }
+void Board_M5StickCPlus2::startPreRoll() {
+    m_micCapture.startPreRoll();
+}
 
-        return bytesToCopy;
-    }
+void Board_M5StickCPlus2::stopPreRoll() {
+    m_micCapture.stopPreRoll();
 
-    // Debug: Log mic failure periodically
-    static uint32_t failCount = 0;
-    failCount++;
-    if (failCount % 50 == 0) {
-        logf("[Mic] Failed to record after %u attempts", failCount);
+    PreRollBuffer::Stats s = m_micCapture.getPreRollStats();
+    if (s.backlogMs > 0) {
+        logf("[PRE] backlog %ums caught up %ums skip %u lost %u",
+             s.backlogMs, s.catchUpMs, s.skippedBlocks, s.overwritten + s.dropped);
     }
-
-    return 0;
 }
 
-void Board_M5StickCPlus2::setSampleRate(int rate) {
-    if (rate == m_sampleRate) return;
-
-    logf("Sample rate: %d -> %d Hz", m_sampleRate, rate);
-    m_sampleRate = rate;
+void Board_M5StickCPlus2::setWakeWordListening(bool listening) {
+    m_micCapture.setListening(listening);
+}
 
-    // Stop current audio operations
-    M5.Speaker.stop();
-    M5.Mic.end();
+size_t Board_M5StickCPlus2::readWakeWordAudio(int16_t* samples, size_t count) {
+    return m_micCapture.isRunning() ? m_micCapture.readListening(samples, count) : 0;
+}
 
-    // Reconfigure speaker
-    auto spk_cfg = M5.Speaker.config();
-    spk_cfg.sample_rate = rate;
-    M5.Speaker.config(spk_cfg);
-    M5.Speaker.begin();
+void Board_M5StickCPlus2::logSessionStats() {
+    M5MicCapture::Stats mic = m_micCapture.getStats();
+    logf("[MIC] short %u/%u skip %u over %u err %u",
+         mic.shortReads, mic.framesRead + mic.shortReads, mic.skipped, mic.overflows, mic.recordErrors);
+    m_micCapture.resetStats();
+
+    // The idle time before this session, if the wake word was listening
+    MicDutyCycle::Stats duty = m_micCapture.getDutyCycleStats();
+    if (duty.onMs + duty.offMs > 0) {
+        logf("[DUTY] mic on %ums off %ums, %u sleeps %u woken",
+             duty.onMs, duty.offMs, duty.sleeps, duty.wakeups);
+    }
 
-    // Reconfigure microphone
-    auto mic_cfg = M5.Mic.config();
-    mic_cfg.sample_rate = rate;
-    M5.Mic.config(mic_cfg);
-    M5.Mic.begin();
+    M5Compositor::Stats ui = m_ui.getStats();
+    logf("[UI] status %u (%u cached) last %uus (frame %uus) max %uus",
+         ui.transitions, ui.cached, ui.lastUs, ui.lastFrameUs, ui.maxUs);
+    m_ui.resetStats();
 }
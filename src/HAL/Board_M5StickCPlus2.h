@@ -1,9 +1,14 @@
 #pragma once
 
 #include "IBoard.h"
+#include "../Audio/AudioConfig.h"
+#include "LogQueue.h"
+#include "LogRing.h"
+#include "LogScroll.h"
+#include "M5Compositor.h"
+#include "M5MicCapture.h"
 #include <M5Unified.h>
-#include <vector>
-#include <string>
+#include <atomic>
 
 /**
  * M5StickC Plus2 Board Implementation
@@ -45,15 +50,23 @@ public:
     void log(const char* message) override;
     void logf(const char* format, ...) override;
     size_t writeAudio(const uint8_t* data, size_t size) override;
+    bool playClip(const int16_t* samples, size_t count) override;
     size_t readAudio(uint8_t* data, size_t size) override;
-    void setSampleRate(int rate) override;
+    uint32_t getMicLatencyUs() override;
+    void startPreRoll() override;
+    void stopPreRoll() override;
+    void setWakeWordListening(bool listening) override;
+    size_t readWakeWordAudio(int16_t* samples, size_t count) override;
+    void logSessionStats() override;
 
 private:
-    // Audio settings
-    int m_sampleRate = 16000;
-
-    // UI state
-    StatusState m_currentState = StatusState::Disconnected;
+    // UI state (set by setLedStatus(), drawn by the compositor task)
+    std::atomic<StatusState> m_currentState{StatusState::Disconnected};
+    StatusState m_drawnState = StatusState::Disconnected;
+    bool m_statusDrawn = false;
+    bool m_bannersCached = false;   // One banner per StatusState, see cacheBanners()
+    static constexpr size_t STATUS_STATES = static_cast<size_t>(StatusState::Speaking) + 1;
+    static_assert(STATUS_STATES <= M5Compositor::MAX_BANNERS, "Not enough banner slots");
 
     // Screen layout constants (portrait orientation)
     static constexpr int16_t SCREEN_WIDTH = 135;
@@ -62,24 +75,61 @@ private:
     static constexpr int16_t LOG_HEIGHT = SCREEN_HEIGHT - STATUS_HEIGHT;
     static constexpr int16_t LOG_Y_START = STATUS_HEIGHT;
     static constexpr int16_t LOG_LINE_HEIGHT = 16;
-    static constexpr int16_t LOG_MAX_LINES = LOG_HEIGHT / LOG_LINE_HEIGHT;  // ~10 lines
     static constexpr int16_t LOG_PADDING = 4;
+    static constexpr int16_t LOG_TEXT_Y = LOG_Y_START + LOG_PADDING;  // First line (below separator)
+    static constexpr int16_t LOG_MAX_LINES = (LOG_HEIGHT - LOG_PADDING) / LOG_LINE_HEIGHT;  // 9 lines
 
     // Button GPIO (for reference - M5Unified handles these)
     static constexpr int BTN_A_GPIO = 37;  // Main action button
     static constexpr int BTN_B_GPIO = 39;  // Power button
     static constexpr int BTN_C_GPIO = 35;  // Side button
 
-    // Log buffer (circular)
-    std::vector<std::string> m_logLines;
+    // Log buffer (circular, lines pre-truncated to the panel width)
     static constexpr size_t LOG_BUFFER_SIZE = 50;  // Keep last 50 lines in memory
+    static constexpr size_t LOG_LINE_CHARS = 22;   // Font0 at 135px
+    LogRing<LOG_BUFFER_SIZE, LOG_LINE_CHARS> m_logLines;
+
+    // Slot ring of the log area: fixed slots on screen, or panel memory
+    // with LOG_HW_SCROLL
+    LogScroll<LOG_MAX_LINES, LOG_LINE_HEIGHT> m_logScroll;
+
+#ifdef LOG_HW_SCROLL
+    // Hardware scroll geometry (ST7789v2: 320 memory rows, the 240 visible
+    // ones start at row 40; rotation 0 keeps rows in memory order) - not yet
+    // verified on a panel
+    static constexpr int16_t PANEL_MEMORY_ROWS = 320;
+    static constexpr int16_t PANEL_ROW_OFFSET = 40;
+#else
+    // Slots stay put and the newest line is marked in the left padding
+    static constexpr int16_t LOG_MARK_WIDTH = 2;
+    int16_t m_logMarkRow = -1;   // Slot row of the marked line (-1: none yet)
+#endif
+
+    // Lines waiting for the compositor task (log() may be called from any task)
+    static constexpr size_t LOG_QUEUE_RECORDS = 32;
+    static constexpr size_t LOG_RECORD_CHARS = 127;  // Full logf() line, for Serial
+    LogQueue<LOG_QUEUE_RECORDS, LOG_RECORD_CHARS> m_logQueue;
+
+    // Only task that draws or prints after init(); renderFrame() runs on it
+    M5Compositor m_ui;
+
+    // Speaker output buffers
+    // playRaw() keeps the pointer and queues at most two buffers per channel,
+    // so rotating through three guarantees we never overwrite queued audio
+    static constexpr size_t SPK_BUFFER_COUNT = 3;
+    static constexpr size_t SPK_BUFFER_SAMPLES = AudioConfig::MAX_OUTPUT_FRAME_SAMPLES;
+    static constexpr int SPK_CHANNEL = 0;  // Fixed virtual channel for SCO audio
+    static constexpr int CLIP_CHANNEL = 1; // UI clips outside a session
+    int16_t m_spkBuffers[SPK_BUFFER_COUNT][SPK_BUFFER_SAMPLES];
+    size_t m_spkBufferIdx = 0;
 
-    // Audio buffer for mic recording
-    static constexpr size_t MIC_BUFFER_SAMPLES = 256;
-    int16_t m_micBuffer[MIC_BUFFER_SAMPLES];
+    // Continuous mic capture (readAudio() just copies from its ring)
+    M5MicCapture m_micCapture;
 
-    // Internal methods
+    // Internal methods (compositor task)
+    static void renderFrame(void* arg);
+    void render();
+    void cacheBanners();
     void drawStatusSection(const char* text, uint32_t bgColor);
-    void drawLogSection();
-    void addLogLine(const char* message);
+    void drawLogLines(size_t count);
 };
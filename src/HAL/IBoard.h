@@ -49,12 +49,15 @@ public:
 
     /**
      * Update the status display section to reflect current state
+     * Returns immediately; the section is redrawn on the board's UI task.
      */
     virtual void setLedStatus(StatusState state) = 0;
 
     /**
      * Write a log message to the text section of the display
      * Also outputs to Serial for debugging
+     * Safe from any task, including Bluedroid and audio callbacks: the
+     * message is copied and output happens later on the board's UI task.
      * @param message The message to display (will be truncated if too long)
      */
     virtual void log(const char* message) = 0;
@@ -70,28 +73,80 @@ public:
 
     /**
      * Write PCM audio data to the speaker
-     * @param data PCM 16-bit signed samples (little-endian)
+     * Data is copied; the caller may reuse its buffer on return.
+     * May block for up to a frame while the output queue is full.
+     * @param data PCM 16-bit signed samples (little-endian) at AudioConfig::I2S_SAMPLE_RATE
      * @param size Number of bytes (not samples)
      * @return Number of bytes actually written
      */
     virtual size_t writeAudio(const uint8_t* data, size_t size) = 0;
 
+    /**
+     * Play a short UI clip on the speaker while no SCO session is streaming
+     * Data is not copied and must stay valid until the clip has played.
+     * Uses its own speaker channel, so it never queues behind writeAudio().
+     * @param samples Mono PCM 16-bit samples at AudioConfig::I2S_SAMPLE_RATE
+     * @param count Number of samples
+     * @return false if the speaker could not take the clip
+     */
+    virtual bool playClip(const int16_t* samples, size_t count) = 0;
+
     // ===== Audio Input (Mic -> Phone) =====
 
     /**
      * Read PCM audio data from the microphone
-     * @param data Buffer to fill with PCM 16-bit signed samples
+     * Called from the Bluedroid outgoing-audio callback - must not block.
+     * @param data Buffer to fill with PCM 16-bit signed samples at AudioConfig::I2S_SAMPLE_RATE
      * @param size Maximum bytes to read
      * @return Number of bytes actually read
      */
     virtual size_t readAudio(uint8_t* data, size_t size) = 0;
 
-    // ===== Audio Configuration =====
+    /**
+     * Age of the oldest sample handed out by the last readAudio() call
+     * (audio buffered between the mic and the SCO callback)
+     * @return Microseconds, 0 on boards without mic capture
+     */
+    virtual uint32_t getMicLatencyUs() = 0;
+
+    // ===== Pre-roll =====
+
+    /**
+     * Start keeping mic audio for a session that is about to come up
+     * readAudio() then returns that backlog first and catches up to live
+     * audio by itself. No-op on boards without mic capture.
+     */
+    virtual void startPreRoll() = 0;
+
+    /**
+     * Discard any pre-roll backlog and return readAudio() to live audio
+     * Call when the session ends or never came up.
+     */
+    virtual void stopPreRoll() = 0;
+
+    // ===== Wake word =====
+
+    /**
+     * Hand mic audio to the wake-word spotter while no session needs it
+     * While listening the mic may be duty-cycled (switched off while the
+     * room is quiet). Turn off before startPreRoll(). No-op on boards
+     * without mic capture.
+     */
+    virtual void setWakeWordListening(bool listening) = 0;
+
+    /**
+     * Copy out mic audio captured for the spotter (never blocks)
+     * @param samples Buffer for PCM 16-bit samples at AudioConfig::I2S_SAMPLE_RATE
+     * @param count Maximum samples to read
+     * @return Samples copied, 0 when none is waiting or without mic capture
+     */
+    virtual size_t readWakeWordAudio(int16_t* samples, size_t count) = 0;
+
+    // ===== Diagnostics =====
 
     /**
-     * Dynamically reconfigure I2S sample rate
-     * Called when SCO codec is negotiated (8000 for CVSD, 16000 for mSBC)
-     * @param rate Sample rate in Hz (8000 or 16000)
+     * Log the board's per-session counters (mic capture, UI timing) and clear them
+     * Call at SCO disconnect, with the other per-session stats.
      */
-    virtual void setSampleRate(int rate) = 0;
+    virtual void logSessionStats() = 0;
 };
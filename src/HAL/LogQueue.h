@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Lock-free multi-producer, single-consumer queue of log records
+ *
+ * Lets Bluedroid callbacks, the audio tasks and the loop hand a formatted
+ * line to the board UI task without touching the display or Serial: push()
+ * is a slot claim (one compare-and-swap) plus a bounded copy, and never
+ * blocks or allocates.
+ *
+ * Each slot carries a sequence number (bounded MPMC ring, one consumer):
+ *   seq == pos              free for the producer claiming pos
+ *   seq == pos + 1          written, ready for the consumer
+ *   seq == pos + RECORDS    consumed, free for the next lap
+ * A producer that finds its slot still unconsumed drops the record and
+ * counts it - a full queue never stalls the caller.
+ *
+ * Records longer than WIDTH characters are truncated.
+ */
+template <size_t RECORDS, size_t WIDTH>
+class LogQueue {
+    static_assert(RECORDS >= 2 && (RECORDS & (RECORDS - 1)) == 0, "RECORDS must be a power of two");
+
+public:
+    LogQueue() {
+        for (size_t i = 0; i < RECORDS; i++) {
+            m_records[i].seq.store(static_cast<uint32_t>(i), std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Queue a copy of message (any task)
+     * @return false if the queue was full and the record was dropped
+     */
+    bool push(const char* message) {
+        uint32_t pos = m_write.load(std::memory_order_relaxed);
+        Record* record;
+        while (true) {
+            record = &m_records[pos & (RECORDS - 1)];
+            uint32_t seq = record->seq.load(std::memory_order_acquire);
+            int32_t diff = static_cast<int32_t>(seq - pos);
+            if (diff == 0) {
+                // Slot is free: claim it (pos is reloaded on failure)
+                if (m_write.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                // Consumer is a full lap behind
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                // Another producer claimed pos first
+                pos = m_write.load(std::memory_order_relaxed);
+            }
+        }
+
+        size_t len = strnlen(message, WIDTH);
+        memcpy(record->text, message, len);
+        record->text[len] = '\0';
+        record->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Take the oldest record (consumer task only)
+     * @param out At least WIDTH + 1 bytes
+     * @return false if nothing is ready
+     */
+    bool pop(char* out) {
+        Record& record = m_records[m_read & (RECORDS - 1)];
+        if (record.seq.load(std::memory_order_acquire) != m_read + 1) return false;
+
+        memcpy(out, record.text, WIDTH + 1);
+        record.seq.store(m_read + RECORDS, std::memory_order_release);
+        m_read++;
+        return true;
+    }
+
+    /**
+     * Records dropped on a full queue since the last call (consumer task only)
+     */
+    uint32_t takeDropped() {
+        return m_dropped.exchange(0, std::memory_order_relaxed);
+    }
+
+private:
+    struct Record {
+        std::atomic<uint32_t> seq;
+        char text[WIDTH + 1];
+    };
+
+    Record m_records[RECORDS];
+    std::atomic<uint32_t> m_write{0};   // Next position to claim (producers)
+    uint32_t m_read = 0;                // Next position to consume (consumer)
+    std::atomic<uint32_t> m_dropped{0};
+};
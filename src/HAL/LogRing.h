@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+/**
+ * Fixed-capacity ring of log lines for the on-screen log
+ *
+ * LINES slots of WIDTH characters, allocated with the owner. push() is a
+ * bounded copy into the next slot (the oldest line is overwritten once
+ * full): no heap allocation and no shifting, so it is O(1) whatever the
+ * history length.
+ *
+ * Lines are truncated to WIDTH when stored - the visible width of the log
+ * panel - with "..." marking the cut, so drawing is a plain drawString().
+ *
+ * Not thread-safe; the owner serializes push() and reads.
+ */
+template <size_t LINES, size_t WIDTH>
+class LogRing {
+    static_assert(LINES > 0 && WIDTH > 3, "LogRing needs room for a line and an ellipsis");
+
+public:
+    /**
+     * Store a line, truncated to WIDTH characters
+     */
+    void push(const char* message) {
+        char* slot = m_slots[m_next];
+        size_t len = strnlen(message, WIDTH + 1);
+        if (len > WIDTH) {
+            memcpy(slot, message, WIDTH - 3);
+            memcpy(slot + WIDTH - 3, "...", 3);
+            len = WIDTH;
+        } else {
+            memcpy(slot, message, len);
+        }
+        slot[len] = '\0';
+
+        m_next = (m_next + 1 == LINES) ? 0 : m_next + 1;
+        if (m_count < LINES) m_count++;
+    }
+
+    size_t size() const { return m_count; }
+
+    /**
+     * Stored line by age (0 = oldest kept, size() - 1 = newest)
+     */
+    const char* line(size_t index) const {
+        size_t oldest = (m_count < LINES) ? 0 : m_next;
+        size_t slot = oldest + index;
+        if (slot >= LINES) slot -= LINES;
+        return m_slots[slot];
+    }
+
+    void clear() {
+        m_next = 0;
+        m_count = 0;
+    }
+
+private:
+    char m_slots[LINES][WIDTH + 1];
+    size_t m_next = 0;     // Slot for the next push()
+    size_t m_count = 0;
+};
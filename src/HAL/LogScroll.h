@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Scrolled log area bookkeeping
+ *
+ * The log area is LINES slots of LINE_HEIGHT rows used as a ring, and
+ * scrollRows() picks which slot is shown at the top of the area, so
+ * appending a line is:
+ *   1. draw the line into nextSlot() - the oldest line, about to scroll out
+ *   2. advance()
+ *   3. show the area from scrollRows()
+ * and only the new line is rendered; the others keep their pixels.
+ *
+ * By default nothing scrolls: the slots stay where they are on screen, a
+ * new line replaces the oldest in place and the board marks the newest, so
+ * step 3 is a no-op and each line costs one line of pixels. With
+ * LOG_HW_SCROLL the ring is panel memory and step 3 writes the panel's
+ * vertical scroll start (VSCRSADD, 0x37 on both the ILI9342C and the
+ * ST7789), still one line of pixels; slots are then in drawing
+ * coordinates, which the panel keeps mapping to the same memory rows
+ * whatever the scroll position.
+ *
+ * Until the area has filled, lines go top to bottom with no scrolling.
+ */
+template <size_t LINES, int16_t LINE_HEIGHT>
+class LogScroll {
+    static_assert(LINES > 0 && LINE_HEIGHT > 0, "LogScroll needs at least one line");
+
+public:
+    static constexpr int16_t AREA_ROWS = static_cast<int16_t>(LINES) * LINE_HEIGHT;
+
+    /**
+     * Slot the next line is drawn into (0 = top of the area in memory)
+     */
+    size_t nextSlot() const { return (m_count < LINES) ? m_count : m_top; }
+
+    /**
+     * Row offset of a slot from the top of the area
+     */
+    static int16_t slotRow(size_t slot) { return static_cast<int16_t>(slot) * LINE_HEIGHT; }
+
+    /**
+     * Account for a line drawn into nextSlot()
+     */
+    void advance() {
+        if (m_count < LINES) {
+            m_count++;
+        } else {
+            m_top = (m_top + 1 == LINES) ? 0 : m_top + 1;
+        }
+    }
+
+    /**
+     * Scroll start as a row offset into the area (the oldest slot shows first)
+     */
+    int16_t scrollRows() const { return slotRow(m_top); }
+
+    void reset() {
+        m_top = 0;
+        m_count = 0;
+    }
+
+private:
+    size_t m_top = 0;     // Slot shown at the top once the area is full
+    size_t m_count = 0;   // Slots filled so far (up to LINES)
+};
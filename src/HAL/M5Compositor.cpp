@@ -0,0 +1,224 @@
+#include "M5Compositor.h"
+#include "../Audio/AudioConfig.h"
+
+extern "C" {
+#include "esp_timer.h"
+}
+
+/**
+ * A 16-bit canvas buffer, typed as what it holds: RGB565 in panel byte
+ * order. pushImageDMA then copies it as is; as a plain uint16_t* it would
+ * be taken for native-order RGB565 and byte-swapped on the way out.
+ */
+static const lgfx::swap565_t* canvasPixels(M5Canvas& canvas) {
+    return static_cast<const lgfx::swap565_t*>(canvas.getBuffer());
+}
+
+bool M5Compositor::begin(int16_t width, int16_t statusHeight, int16_t lineHeight, RenderFn render, void* arg) {
+    if (m_task) return true;
+
+    // Internal RAM, so pushImageDMA can read the buffers directly
+    m_status.setColorDepth(16);
+    m_status.setPsram(false);
+    if (!m_status.createSprite(width, statusHeight)) return false;
+    for (size_t i = 0; i < LINE_BUFFERS; i++) {
+        m_lines[i].setColorDepth(16);
+        m_lines[i].setPsram(false);
+        if (!m_lines[i].createSprite(width, lineHeight)) {
+            for (size_t j = 0; j < i; j++) {
+                m_lines[j].deleteSprite();
+            }
+            m_status.deleteSprite();
+            return false;
+        }
+    }
+
+    m_width = width;
+    m_lineHeight = lineHeight;
+    m_render = render;
+    m_renderArg = arg;
+
+    xTaskCreatePinnedToCore(
+        compositorTask,
+        "ui_compositor",
+        TASK_STACK,
+        this,
+        AudioConfig::UI_TASK_PRIORITY,
+        &m_task,
+        TASK_CORE
+    );
+    return true;
+}
+
+void M5Compositor::requestFrame() {
+    if (m_task) {
+        xTaskNotifyGive(m_task);
+    }
+}
+
+void M5Compositor::requestStatus() {
+    int64_t none = 0;
+    m_statusRequestUs.compare_exchange_strong(none, esp_timer_get_time(), std::memory_order_relaxed);
+    requestFrame();
+}
+
+M5Compositor::Stats M5Compositor::getStats() const {
+    Stats s;
+    s.transitions = m_transitions.load(std::memory_order_relaxed);
+    s.cached = m_cachedTransitions.load(std::memory_order_relaxed);
+    s.lastUs = m_lastTransitionUs.load(std::memory_order_relaxed);
+    s.lastFrameUs = m_lastFrameUs.load(std::memory_order_relaxed);
+    s.maxUs = m_maxTransitionUs.load(std::memory_order_relaxed);
+    return s;
+}
+
+void M5Compositor::resetStats() {
+    m_transitions.store(0, std::memory_order_relaxed);
+    m_cachedTransitions.store(0, std::memory_order_relaxed);
+    m_lastTransitionUs.store(0, std::memory_order_relaxed);
+    m_lastFrameUs.store(0, std::memory_order_relaxed);
+    m_maxTransitionUs.store(0, std::memory_order_relaxed);
+}
+
+// ============================================================
+// COMPOSITOR TASK
+// ============================================================
+
+void M5Compositor::compositorTask(void* arg) {
+    static_cast<M5Compositor*>(arg)->compositorLoop();
+}
+
+void M5Compositor::compositorLoop() {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // One transaction per frame; endWrite() waits for the last transfer
+        int64_t frameStartUs = esp_timer_get_time();
+        M5.Display.startWrite();
+        m_render(m_renderArg);
+        pushStatus();
+        M5.Display.endWrite();
+
+        if (m_statusPushed) {
+            reportTransition(frameStartUs);
+        }
+
+        // Frame cap: requests made meanwhile leave a notification pending
+        vTaskDelay(pdMS_TO_TICKS(FRAME_MS));
+    }
+}
+
+/**
+ * Record how long the status change took to reach the panel: from
+ * requestStatus() (including the wait for a frame slot), and the frame
+ * itself
+ */
+void M5Compositor::reportTransition(int64_t frameStartUs) {
+    int64_t nowUs = esp_timer_get_time();
+    int64_t requestUs = m_statusRequestUs.exchange(0, std::memory_order_relaxed);
+    uint32_t frameUs = static_cast<uint32_t>(nowUs - frameStartUs);
+    uint32_t transitionUs = (requestUs != 0) ? static_cast<uint32_t>(nowUs - requestUs) : frameUs;
+
+    m_transitions.fetch_add(1, std::memory_order_relaxed);
+    if (m_statusFromCache) {
+        m_cachedTransitions.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_lastTransitionUs.store(transitionUs, std::memory_order_relaxed);
+    m_lastFrameUs.store(frameUs, std::memory_order_relaxed);
+    if (transitionUs > m_maxTransitionUs.load(std::memory_order_relaxed)) {
+        m_maxTransitionUs.store(transitionUs, std::memory_order_relaxed);
+    }
+    m_statusPushed = false;
+    m_statusFromCache = false;
+}
+
+// ============================================================
+// RENDERING
+// ============================================================
+
+void M5Compositor::markStatusDirty(int16_t y, int16_t height) {
+    int16_t bottom = y + height;
+    if (m_dirtyTop >= m_dirtyBottom) {
+        m_dirtyTop = y;
+        m_dirtyBottom = bottom;
+    } else {
+        if (y < m_dirtyTop) m_dirtyTop = y;
+        if (bottom > m_dirtyBottom) m_dirtyBottom = bottom;
+    }
+
+    if (m_dirtyTop < 0) m_dirtyTop = 0;
+    if (m_dirtyBottom > m_status.height()) m_dirtyBottom = m_status.height();
+}
+
+void M5Compositor::pushStatus() {
+    if (m_dirtyTop >= m_dirtyBottom) return;
+
+    const lgfx::swap565_t* pixels = canvasPixels(m_status);
+    M5.Display.pushImageDMA(0, m_dirtyTop, m_width, m_dirtyBottom - m_dirtyTop,
+                            pixels + static_cast<size_t>(m_dirtyTop) * m_width);
+    m_dirtyTop = 0;
+    m_dirtyBottom = 0;
+    m_statusPushed = true;
+}
+
+bool M5Compositor::cacheStatus(size_t index) {
+    if (index >= MAX_BANNERS) return false;
+
+    size_t pixels = static_cast<size_t>(m_status.width()) * m_status.height();
+    return m_banners[index].pack(static_cast<const uint16_t*>(m_status.getBuffer()), pixels);
+}
+
+bool M5Compositor::showCachedStatus(size_t index) {
+    if (index >= MAX_BANNERS || !m_banners[index].isPacked()) return false;
+
+    m_banners[index].unpack(static_cast<uint16_t*>(m_status.getBuffer()));
+    markStatusDirty(0, m_status.height());
+    m_statusFromCache = true;
+    return true;
+}
+
+M5Canvas& M5Compositor::lineCanvas() {
+    // The other strip may still be in flight; this one finished when it was
+    // queued (the bus waits for one transfer before starting the next)
+    M5Canvas& canvas = m_lines[m_lineIdx];
+    canvas.fillScreen(TFT_BLACK);
+    return canvas;
+}
+
+void M5Compositor::pushLine(int16_t y) {
+    const lgfx::swap565_t* pixels = canvasPixels(m_lines[m_lineIdx]);
+    M5.Display.pushImageDMA(0, y, m_width, m_lineHeight, pixels);
+    m_lineIdx = (m_lineIdx + 1) % LINE_BUFFERS;
+}
+
+void M5Compositor::clearRect(int16_t x, int16_t y, int16_t width, int16_t height) {
+    M5.Display.fillRect(x, y, width, height, TFT_BLACK);
+}
+
+// ============================================================
+// PANEL SCROLL
+// ============================================================
+
+void M5Compositor::defineScroll(uint16_t top, uint16_t area, uint16_t bottom) {
+    uint16_t params[3] = {top, area, bottom};
+    M5.Display.startWrite();
+    writePanelCommand(0x33, params, 3);  // VSCRDEF
+    M5.Display.endWrite();
+}
+
+void M5Compositor::setScrollStart(uint16_t row) {
+    M5.Display.startWrite();
+    writePanelCommand(0x37, &row, 1);    // VSCRSADD
+    M5.Display.endWrite();
+}
+
+/**
+ * Send a panel command with 16-bit big-endian parameters
+ */
+void M5Compositor::writePanelCommand(uint8_t command, const uint16_t* params, size_t count) {
+    M5.Display.writeCommand(command);
+    for (size_t i = 0; i < count; i++) {
+        M5.Display.writeData(static_cast<uint8_t>(params[i] >> 8));
+        M5.Display.writeData(static_cast<uint8_t>(params[i] & 0xFF));
+    }
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "PackedBanner.h"
+#include <M5Unified.h>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * UI Compositor (M5Unified)
+ *
+ * Owns every write to M5.Display after init: a low-priority task on core 0
+ * wakes on requestFrame() (any task, constant time) and calls the board's
+ * render function at most once per FRAME_MS. Bluetooth and audio tasks
+ * only ever queue state; nothing is rendered in their context.
+ *
+ * Rendering goes into RAM back buffers and reaches the panel with
+ * pushImageDMA, so the CPU draws the next piece while SPI sends the last:
+ *
+ *   Status region   One canvas, width x statusHeight. The board draws into
+ *                   statusCanvas() and marks the rows it touched; only that
+ *                   dirty band is pushed. Bands are full-width, so the
+ *                   canvas rows are contiguous and go out as one transfer.
+ *   Log lines       Two line-height strip canvases used alternately: one
+ *                   renders while the other is in flight. The board pushes
+ *                   each new line into a slot of the log area (see
+ *                   LogScroll) and nothing else: slots stay put and the
+ *                   newest is marked, or with LOG_HW_SCROLL the panel
+ *                   scrolls them, through registers written here.
+ *
+ * Status banners are cached packed (see PackedBanner): cacheStatus()
+ * keeps the status canvas at 4 bits per pixel, a quarter of its size, and
+ * showCachedStatus() expands it back, so a state change is a table lookup
+ * per pixel plus one DMA push instead of rendering large fonts. That fits
+ * internal RAM, so boards without PSRAM cache too; a banner that does not
+ * pack is drawn live. Each transition is timed from requestStatus() to
+ * the end of its push; getStats() keeps the count, last and max times.
+ *
+ * Shared by all M5Unified boards; layout and content stay in the board.
+ */
+class M5Compositor {
+public:
+    typedef void (*RenderFn)(void* arg);
+
+    static constexpr uint32_t FRAME_MS = 33;   // ~30fps cap
+    static constexpr size_t MAX_BANNERS = 4;   // Cached status banners
+
+    struct Stats {
+        uint32_t transitions;   // Status changes pushed to the panel
+        uint32_t cached;        // ...of which came from a cached banner
+        uint32_t lastUs;        // Last transition, requestStatus() to pushed
+        uint32_t lastFrameUs;   // Frame that pushed it
+        uint32_t maxUs;         // Slowest transition
+    };
+
+    /**
+     * Allocate the back buffers and start the task
+     * @param render Called on the compositor task once per frame with work
+     * @return false if the buffers could not be allocated (nothing is drawn)
+     */
+    bool begin(int16_t width, int16_t statusHeight, int16_t lineHeight, RenderFn render, void* arg);
+
+    /**
+     * Ask for a frame (any task; coalesced until the next frame slot)
+     */
+    void requestFrame();
+
+    bool isRunning() const { return m_task != nullptr; }
+
+    /**
+     * Ask for a frame that changes the status region (any task)
+     * Starts the transition timer unless one is already pending.
+     */
+    void requestStatus();
+
+    /**
+     * Status transition timing since the last resetStats() (any task)
+     */
+    Stats getStats() const;
+    void resetStats();
+
+    // ===== Rendering (compositor task, inside the render function) =====
+
+    M5Canvas& statusCanvas() { return m_status; }
+
+    /**
+     * Mark status rows as changed
+     */
+    void markStatusDirty(int16_t y, int16_t height);
+
+    /**
+     * Push the dirty status rows (no-op when clean)
+     */
+    void pushStatus();
+
+    /**
+     * Keep a packed copy of the whole status canvas as banner index
+     * @return false if it has too many colours or there is no room (draw
+     *         that state live)
+     */
+    bool cacheStatus(size_t index);
+
+    /**
+     * Copy cached banner index into the status canvas and mark it dirty
+     * @return false if that banner is not cached
+     */
+    bool showCachedStatus(size_t index);
+
+    /**
+     * Strip canvas for the next log line, cleared to black
+     */
+    M5Canvas& lineCanvas();
+
+    /**
+     * Push the strip from the last lineCanvas() to display row y
+     */
+    void pushLine(int16_t y);
+
+    /**
+     * Fill a display rectangle with black (small marks outside the strips)
+     */
+    void clearRect(int16_t x, int16_t y, int16_t width, int16_t height);
+
+    // ===== Panel vertical scroll (ILI9342C / ST7789) =====
+
+    /**
+     * Fixed top rows, scrolled rows and fixed bottom rows (panel memory rows)
+     */
+    void defineScroll(uint16_t top, uint16_t area, uint16_t bottom);
+
+    /**
+     * Panel memory row shown first in the scrolled area
+     */
+    void setScrollStart(uint16_t row);
+
+private:
+    static constexpr uint32_t TASK_STACK = 4096;
+    static constexpr int TASK_CORE = 0;        // With Bluedroid, off the audio core
+    static constexpr size_t LINE_BUFFERS = 2;
+
+    M5Canvas m_status;
+    M5Canvas m_lines[LINE_BUFFERS];
+    size_t m_lineIdx = 0;
+    int16_t m_width = 0;
+    int16_t m_lineHeight = 0;
+
+    // Dirty status band [top, bottom), empty when top >= bottom
+    int16_t m_dirtyTop = 0;
+    int16_t m_dirtyBottom = 0;
+
+    PackedBanner m_banners[MAX_BANNERS];
+
+    // Transition timing: request time (0 = none pending), and what the
+    // current frame pushed
+    std::atomic<int64_t> m_statusRequestUs{0};
+    bool m_statusPushed = false;
+    bool m_statusFromCache = false;
+
+    std::atomic<uint32_t> m_transitions{0};
+    std::atomic<uint32_t> m_cachedTransitions{0};
+    std::atomic<uint32_t> m_lastTransitionUs{0};
+    std::atomic<uint32_t> m_lastFrameUs{0};
+    std::atomic<uint32_t> m_maxTransitionUs{0};
+
+    RenderFn m_render = nullptr;
+    void* m_renderArg = nullptr;
+    TaskHandle_t m_task = nullptr;
+
+    static void compositorTask(void* arg);
+    void compositorLoop();
+    void reportTransition(int64_t frameStartUs);
+    void writePanelCommand(uint8_t command, const uint16_t* params, size_t count);
+};
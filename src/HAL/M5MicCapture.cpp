@@ -0,0 +1,191 @@
+#include "M5MicCapture.h"
+#include <M5Unified.h>
+
+void M5MicCapture::begin() {
+    if (m_task) return;
+
+    xTaskCreatePinnedToCore(
+        captureTask,
+        "mic_capture",
+        TASK_STACK,
+        this,
+        AudioConfig::CAPTURE_TASK_PRIORITY,
+        &m_task,
+        AudioConfig::AUDIO_TASK_CORE
+    );
+}
+
+// ============================================================
+// CAPTURE TASK
+// ============================================================
+
+void M5MicCapture::captureTask(void* arg) {
+    static_cast<M5MicCapture*>(arg)->captureLoop();
+}
+
+size_t M5MicCapture::chunkSamples() const {
+    size_t frame = AudioConfig::frameSamples(AudioConfig::I2S_SAMPLE_RATE);
+
+    // Half-frame chunks reach the ring sooner at the cost of more wakeups
+    return (getMode() == Mode::LowLatency) ? frame / 2 : frame;
+}
+
+void M5MicCapture::captureLoop() {
+    size_t chunkLen[RECORD_BUFFER_COUNT] = {0};
+    size_t next = 0;     // Next buffer to hand to record()
+    size_t queued = 0;   // Buffers handed to record() but not yet pushed
+    bool wasListening = false;
+
+    while (true) {
+        bool listening = m_listening.load(std::memory_order_relaxed);
+        if (listening && !wasListening) {
+            m_dutyCycle.reset(AudioConfig::I2S_SAMPLE_RATE);
+        }
+        wasListening = listening;
+
+        if (listening && m_dutyCycle.sleepDue()) {
+            sleepMic();
+            queued = 0;   // Buffers still queued at end() were abandoned
+            continue;
+        }
+
+        size_t chunk = chunkSamples();
+
+        // Blocks until the mic has room for another buffer
+        if (!M5.Mic.record(m_recordBuffers[next], chunk, AudioConfig::I2S_SAMPLE_RATE)) {
+            m_recordErrors.fetch_add(1, std::memory_order_relaxed);
+            queued = 0;
+            vTaskDelay(pdMS_TO_TICKS(100));
+            continue;
+        }
+        chunkLen[next] = chunk;
+        next = (next + 1) % RECORD_BUFFER_COUNT;
+        queued++;
+
+        // record() accepted a third buffer, so the oldest one is complete
+        if (queued == RECORD_BUFFER_COUNT) {
+            size_t done = next;  // Oldest outstanding buffer
+            if (!m_preRoll.write(m_recordBuffers[done], chunkLen[done])) {
+                m_ring.write(m_recordBuffers[done], chunkLen[done]);
+                if (listening && m_dutyCycle.onChunk(m_recordBuffers[done], chunkLen[done])) {
+                    m_listenRing.write(m_recordBuffers[done], chunkLen[done]);
+                }
+            }
+            queued--;
+        }
+    }
+}
+
+/**
+ * Mic off for MicDutyCycle::SLEEP_MS, or until listening ends or a
+ * pre-roll is armed
+ */
+void M5MicCapture::sleepMic() {
+    M5.Mic.end();
+    uint32_t slept = 0;
+    while (slept < MicDutyCycle::SLEEP_MS && m_listening.load(std::memory_order_relaxed)
+           && !m_preRoll.isServing()) {
+        vTaskDelay(pdMS_TO_TICKS(SLEEP_POLL_MS));
+        slept += SLEEP_POLL_MS;
+    }
+    M5.Mic.begin();
+    m_dutyCycle.onWake(slept);
+}
+
+// ============================================================
+// CONSUMER (Bluedroid outgoing-audio callback)
+// ============================================================
+
+size_t M5MicCapture::read(uint8_t* data, size_t size) {
+    size_t samples = size / sizeof(int16_t);
+    int16_t* out = reinterpret_cast<int16_t*>(data);
+
+    if (m_preRoll.isServing()) {
+        size_t done = readPreRoll(out, samples);
+        countRead(done, samples);
+        return done * sizeof(int16_t);
+    }
+
+    size_t available = m_ring.available();
+    m_lastBacklog.store(static_cast<uint32_t>(available), std::memory_order_relaxed);
+
+    // Bound the backlog: LowLatency keeps one chunk of slack beyond the
+    // request (so a chunk landing just after this read is not a short read
+    // next time), Fifo a few frames
+    size_t keep = (getMode() == Mode::LowLatency) ? samples + chunkSamples() : samples * MAX_BACKLOG_FRAMES;
+    if (available > keep) {
+        size_t dropped = m_ring.skip(available - keep);
+        m_skipped.fetch_add(static_cast<uint32_t>(dropped), std::memory_order_relaxed);
+        available = keep;
+    }
+
+    size_t done = (available < samples) ? partialCount(available) : samples;
+    m_ring.read(out, done);
+    countRead(done, samples);
+    return done * sizeof(int16_t);
+}
+
+/**
+ * Serve the pre-roll backlog, then the first live samples after handover
+ * @return Samples copied, less than count if not enough audio is buffered yet
+ */
+size_t M5MicCapture::readPreRoll(int16_t* samples, size_t count) {
+    if (m_preRoll.shouldHandOver()) {
+        // The ring only holds audio from before the pre-roll was armed;
+        // from the next chunk on the task writes live audio there again
+        m_ring.skip(m_ring.available());
+        m_preRoll.handOver();
+    }
+
+    size_t backlog = m_preRoll.available();
+    if (!m_preRoll.isHandedOver()) {
+        // Still draining - the task keeps appending to the backlog
+        return m_preRoll.read(samples, (backlog < count) ? partialCount(backlog) : count);
+    }
+
+    // Handed over: the last of the backlog, then live audio from the ring
+    size_t total = backlog + m_ring.available();
+    if (total < count) count = partialCount(total);
+    size_t done = m_preRoll.read(samples, count);
+    m_ring.read(samples + done, count - done);
+    return count;
+}
+
+/**
+ * Samples to hand out when fewer than requested are buffered: whole pairs,
+ * so a 2:1 decimator behind readAudio() stays aligned; the odd one waits
+ */
+size_t M5MicCapture::partialCount(size_t available) {
+    return available & ~static_cast<size_t>(1);
+}
+
+void M5MicCapture::countRead(size_t done, size_t requested) {
+    if (done == requested) {
+        m_framesRead.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        m_shortReads.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+uint32_t M5MicCapture::latencyUs() const {
+    uint32_t samples = m_lastBacklog.load(std::memory_order_relaxed) + static_cast<uint32_t>(chunkSamples());
+    return static_cast<uint32_t>(static_cast<uint64_t>(samples) * 1000000 / AudioConfig::I2S_SAMPLE_RATE);
+}
+
+M5MicCapture::Stats M5MicCapture::getStats() const {
+    Stats s;
+    s.framesRead = m_framesRead.load(std::memory_order_relaxed);
+    s.shortReads = m_shortReads.load(std::memory_order_relaxed);
+    s.overflows = m_ring.overflows();
+    s.skipped = m_skipped.load(std::memory_order_relaxed);
+    s.recordErrors = m_recordErrors.load(std::memory_order_relaxed);
+    return s;
+}
+
+void M5MicCapture::resetStats() {
+    m_framesRead.store(0, std::memory_order_relaxed);
+    m_shortReads.store(0, std::memory_order_relaxed);
+    m_skipped.store(0, std::memory_order_relaxed);
+    m_recordErrors.store(0, std::memory_order_relaxed);
+    m_ring.clearOverflows();
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "../Audio/AudioConfig.h"
+#include "../Audio/MicDutyCycle.h"
+#include "../Audio/PreRollBuffer.h"
+#include "../Audio/SampleRing.h"
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+typedef struct tskTaskControlBlock* TaskHandle_t;
+
+/**
+ * Continuous Microphone Capture (M5Unified)
+ *
+ * Runs M5.Mic on its own task and keeps a sample ring filled ahead of
+ * demand, so IBoard::readAudio() (called from the Bluedroid outgoing-audio
+ * callback) is a non-blocking memcpy instead of a record-and-wait.
+ *
+ * M5.Mic.record() queues at most two buffers, so the task rotates through
+ * three: once record() accepts buffer N, buffer N-2 is complete and can be
+ * pushed into the ring.
+ *
+ * While a pre-roll is armed the task records into a PreRollBuffer instead
+ * of the ring; read() serves that backlog first and switches back to the
+ * ring once it has caught up.
+ *
+ * While listening for the wake word (between sessions) every live chunk
+ * also goes to a second ring for the spotter, and MicDutyCycle may switch
+ * the mic off (M5.Mic.end()) between sniffs. An armed pre-roll or the end
+ * of listening wakes it within SLEEP_POLL_MS.
+ *
+ * Shared by all M5Unified boards - the mic is owned by this class after
+ * begin(), boards must not call M5.Mic directly.
+ */
+class M5MicCapture {
+public:
+    enum class Mode {
+        Fifo,        // Contiguous audio, backlog bounded to MAX_BACKLOG_FRAMES
+        LowLatency   // Backlog bounded to one chunk beyond the request - reader gets near-newest audio
+    };
+
+    struct Stats {
+        uint32_t framesRead;     // read() calls fully satisfied
+        uint32_t shortReads;     // read() calls served partially (not enough audio buffered)
+        uint32_t overflows;      // Samples dropped because the ring was full
+        uint32_t skipped;        // Samples discarded by the reader to bound latency
+        uint32_t recordErrors;   // M5.Mic.record() failures
+    };
+
+    /**
+     * Start the capture task (M5.Mic must already be configured)
+     * Captures at AudioConfig::I2S_SAMPLE_RATE for every SCO codec.
+     */
+    void begin();
+
+    void setMode(Mode mode) { m_mode.store(mode, std::memory_order_relaxed); }
+    Mode getMode() const { return m_mode.load(std::memory_order_relaxed); }
+
+    /**
+     * Copy captured audio out of the ring (never blocks)
+     * @param data Destination for PCM 16-bit signed samples
+     * @param size Bytes requested
+     * @return size on success; fewer bytes (possibly 0) if not enough
+     *         audio is buffered yet - whatever there is gets handed out
+     */
+    size_t read(uint8_t* data, size_t size);
+
+    bool isRunning() const { return m_task != nullptr; }
+
+    /**
+     * Age of the oldest sample at the last read(): ring backlog plus the
+     * chunk being recorded
+     */
+    uint32_t latencyUs() const;
+
+    Stats getStats() const;
+
+    /**
+     * Zero the counters (call once a session's stats have been logged)
+     */
+    void resetStats();
+
+    // ===== Pre-roll =====
+
+    /**
+     * Allocate pre-roll storage (before begin())
+     * @return false if nothing could be allocated - pre-roll stays disabled
+     */
+    bool enablePreRoll(PreRollBuffer::Storage storage) { return m_preRoll.begin(storage); }
+
+    PreRollBuffer::Storage getPreRollStorage() const { return m_preRoll.storage(); }
+
+    /**
+     * Start buffering mic audio for the session about to come up
+     */
+    void startPreRoll() { m_preRoll.arm(); }
+
+    /**
+     * Drop any remaining backlog and return to live capture
+     */
+    void stopPreRoll() { m_preRoll.cancel(); }
+
+    PreRollBuffer::Stats getPreRollStats() const { return m_preRoll.getStats(); }
+
+    // ===== Wake-word listening =====
+
+    /**
+     * Feed the listening ring, duty-cycling the mic while the room is quiet
+     * Turn off before a session needs continuous audio.
+     */
+    void setListening(bool listening) { m_listening.store(listening, std::memory_order_relaxed); }
+    bool isListening() const { return m_listening.load(std::memory_order_relaxed); }
+
+    /**
+     * Copy out audio captured for the spotter (never blocks)
+     * @return Samples copied, possibly 0 (always while the mic sleeps)
+     */
+    size_t readListening(int16_t* samples, size_t count) { return m_listenRing.read(samples, count); }
+
+    /**
+     * Duty cycling on or off; off keeps the mic on while listening
+     */
+    void setDutyCycling(bool enabled) { m_dutyCycle.setEnabled(enabled); }
+
+    MicDutyCycle::Stats getDutyCycleStats() const { return m_dutyCycle.getStats(); }
+
+private:
+    static constexpr uint32_t TASK_STACK = 3072;
+    static constexpr size_t RECORD_BUFFER_COUNT = 3;
+    static constexpr size_t RING_SAMPLES = 1024;        // 64ms @ 16kHz
+    static constexpr size_t MAX_BACKLOG_FRAMES = 3;
+    static constexpr size_t LISTEN_RING_SAMPLES = 2048;  // 128ms @ 16kHz
+    static constexpr uint32_t SLEEP_POLL_MS = 10;
+
+    SampleRing<RING_SAMPLES> m_ring;
+    SampleRing<LISTEN_RING_SAMPLES> m_listenRing;
+    PreRollBuffer m_preRoll;
+    MicDutyCycle m_dutyCycle;
+    std::atomic<bool> m_listening{false};
+    int16_t m_recordBuffers[RECORD_BUFFER_COUNT][AudioConfig::FRAME_SAMPLES_16K];
+
+    TaskHandle_t m_task = nullptr;
+    std::atomic<Mode> m_mode{Mode::Fifo};
+
+    std::atomic<uint32_t> m_framesRead{0};
+    std::atomic<uint32_t> m_shortReads{0};
+    std::atomic<uint32_t> m_skipped{0};
+    std::atomic<uint32_t> m_recordErrors{0};
+    std::atomic<uint32_t> m_lastBacklog{0};   // Samples buffered at the last read()
+
+    static void captureTask(void* arg);
+    void captureLoop();
+    void sleepMic();
+    size_t chunkSamples() const;
+    size_t readPreRoll(int16_t* samples, size_t count);
+    static size_t partialCount(size_t available);
+    void countRead(size_t done, size_t requested);
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+/**
+ * Status banner packed to 4 bits per pixel against its own palette
+ *
+ * A banner is a flat background, white text and a grey label, none of it
+ * anti-aliased, so it holds a handful of distinct 16-bit pixel values.
+ * pack() collects up to MAX_COLORS of them and stores one nibble per
+ * pixel (two pixels per byte, first pixel in the low nibble); unpack()
+ * expands it back bit-exact. Pixel values are opaque, so any byte order
+ * round-trips unchanged.
+ *
+ * A quarter of the 16-bit canvas: small enough for internal RAM on boards
+ * without PSRAM. A banner with more colours is refused and drawn live.
+ *
+ * No platform dependencies. Not thread-safe; the owner serializes calls.
+ */
+class PackedBanner {
+public:
+    static constexpr size_t MAX_COLORS = 16;
+
+    PackedBanner() = default;
+    ~PackedBanner() { delete[] m_data; }
+
+    PackedBanner(const PackedBanner&) = delete;
+    PackedBanner& operator=(const PackedBanner&) = delete;
+
+    static constexpr size_t packedBytes(size_t pixels) { return (pixels + 1) / 2; }
+
+    /**
+     * Pack count pixels, replacing any earlier contents
+     * @return false if they use more than MAX_COLORS values or there is no
+     *         memory (the banner is left empty)
+     */
+    bool pack(const uint16_t* pixels, size_t count) {
+        if (m_data && count != m_pixels) {
+            release();
+        }
+        if (!m_data) {
+            m_data = new (std::nothrow) uint8_t[packedBytes(count)];
+            if (!m_data) return false;
+            m_pixels = count;
+        }
+
+        m_colors = 0;
+        size_t last = 0;   // Runs of one colour skip the palette search
+        for (size_t i = 0; i < count; i++) {
+            uint16_t pixel = pixels[i];
+            if (m_colors == 0 || m_palette[last] != pixel) {
+                last = indexOf(pixel);
+                if (last == MAX_COLORS) {
+                    release();
+                    return false;
+                }
+            }
+            uint8_t& byte = m_data[i / 2];
+            if (i % 2 == 0) {
+                byte = static_cast<uint8_t>(last);
+            } else {
+                byte = static_cast<uint8_t>(byte | (last << 4));
+            }
+        }
+        m_packed = true;
+        return true;
+    }
+
+    /**
+     * Expand into out, which holds pixelCount() pixels
+     */
+    void unpack(uint16_t* out) const {
+        size_t pairs = m_pixels / 2;
+        for (size_t i = 0; i < pairs; i++) {
+            uint8_t byte = m_data[i];
+            out[2 * i] = m_palette[byte & 0x0F];
+            out[2 * i + 1] = m_palette[byte >> 4];
+        }
+        if (m_pixels % 2) {
+            out[m_pixels - 1] = m_palette[m_data[pairs] & 0x0F];
+        }
+    }
+
+    bool isPacked() const { return m_packed; }
+    size_t pixelCount() const { return m_pixels; }
+    size_t colors() const { return m_colors; }
+
+private:
+    uint8_t* m_data = nullptr;
+    size_t m_pixels = 0;
+    uint16_t m_palette[MAX_COLORS] = {};
+    size_t m_colors = 0;
+    bool m_packed = false;
+
+    /**
+     * Palette slot of a pixel value, added if new
+     * @return MAX_COLORS if the palette is full
+     */
+    size_t indexOf(uint16_t pixel) {
+        for (size_t c = 0; c < m_colors; c++) {
+            if (m_palette[c] == pixel) return c;
+        }
+        if (m_colors == MAX_COLORS) return MAX_COLORS;
+        m_palette[m_colors] = pixel;
+        return m_colors++;
+    }
+
+    void release() {
+        delete[] m_data;
+        m_data = nullptr;
+        m_pixels = 0;
+        m_colors = 0;
+        m_packed = false;
+    }
+};
@@ -30,14 +30,71 @@ extern "C" bool btInUse() { return true; }
 #include <Arduino.h>
 #include "HAL/BoardManager.h"
 #include "Core/BluetoothManager.h"
+#if defined(DSP_BENCHMARK)
+#include "Audio/DspBenchmark.h"
+#endif
+#if defined(SESSION_RECORDER)
+#include "Audio/SessionRecorder.h"
+#endif
+#if defined(WAKE_WORD)
+#include "Audio/WakeWordListener.h"
+#include "esp_spiffs.h"
+#endif
 
 // Global instances
 IBoard* g_board = nullptr;
 // g_btManager is declared in BluetoothManager.cpp
+#if defined(SESSION_RECORDER)
+static SessionRecorder s_recorder;
+#endif
+#if defined(WAKE_WORD)
+static WakeWordListener s_wakeWord;
+#endif
 
 // Device name advertised over Bluetooth
 static const char* DEVICE_NAME = "OpenBadge";
 
+/**
+ * Start a voice session (tap, Button A or the wake word)
+ */
+static void startSession() {
+    // Update UI to show we're activating
+    g_board->setLedStatus(StatusState::Listening);
+    if (!g_btManager->playEarcon(EarconMixer::Cue::Trigger)) {
+        // No playout yet (SCO is down): use the board speaker directly
+        size_t length = 0;
+        const int16_t* clip = g_btManager->earconClip(EarconMixer::Cue::Trigger, &length);
+        if (clip) g_board->playClip(clip, length);
+    }
+
+    // Keep what the user says until the SCO link is up
+    g_btManager->armPreRoll();
+
+    // Try multiple trigger methods (AVRCP might not be connected)
+    g_btManager->sendMediaButton();     // Try AVRCP Play/Pause first
+    g_btManager->sendBvra();            // Also send HFP voice recognition (works without AVRCP)
+
+    // Note: sendBvra() sends AT+BVRA=1 which tells the phone to start voice recognition
+    // This works even if AVRCP isn't connected, since it uses HFP which IS connected
+}
+
+#if defined(WAKE_WORD)
+/**
+ * The model lives on the spiffs partition; the session recorder may have
+ * mounted it already. Never formats: a missing model is not worth erasing
+ * the partition for.
+ */
+static void mountModelPartition() {
+    if (esp_spiffs_mounted("spiffs")) return;
+    esp_vfs_spiffs_conf_t conf = {};
+    conf.base_path = "/spiffs";
+    conf.partition_label = "spiffs";
+    conf.max_files = 2;
+    conf.format_if_mount_failed = false;
+    esp_vfs_spiffs_register(&conf);
+}
+#endif
+
 void setup() {
     // Initialize serial for debugging (also shown on screen)
     Serial.begin(115200);
@@ -48,12 +105,45 @@ void setup() {
     g_board = BoardManager::createBoard();
     g_board->init();
 
+#if defined(DSP_BENCHMARK)
+    // Before Bluetooth starts, so nothing else competes for the core
+    DspBenchmark::run(g_board);
+#endif
+
     // Allocate Bluetooth manager
     g_btManager = new BluetoothManager();
 
     // Now initialize Bluetooth (logs will appear on screen)
     g_btManager->init(DEVICE_NAME, g_board);
 
+#if defined(SESSION_RECORDER)
+    // Keeps both directions of each session on the spiffs partition
+    if (s_recorder.begin()) {
+        g_btManager->setSessionRecorder(&s_recorder);
+        g_board->logf("Recorder: %uKB", static_cast<unsigned>(s_recorder.totalBytes() / 1024));
+    } else {
+        g_board->log("Recorder: no spiffs partition");
+    }
+#endif
+
+#if defined(WAKE_WORD)
+    // Listens between sessions once a headset link is up
+    mountModelPartition();
+    if (s_wakeWord.begin(g_board)) {
+        const KeywordModel& model = s_wakeWord.model();
+        g_board->logf("Wake word: %u MACs, %u bytes", static_cast<unsigned>(model.macs()),
+                      static_cast<unsigned>(model.memoryBytes()));
+    } else {
+        g_board->logf("Wake word: no model at %s", WakeWordListener::MODEL_PATH);
+    }
+#endif
+
+#if defined(LATENCY_PROBE)
+    // Needs a phone that loops SCO audio back; the chirp replaces the mic
+    g_btManager->setLatencyProbe(true);
+    g_board->log("Latency probe: on");
+#endif
+
     g_board->log("Ready to pair!");
     g_board->log("Scan for 'OpenBadge'");
 }
@@ -76,28 +166,42 @@ void loop() {
             // This means user wants to STOP speaking
             g_board->log(">>> Stopping voice...");
             g_board->setLedStatus(StatusState::Idle);
+            g_btManager->playEarcon(EarconMixer::Cue::SessionStop);
             g_btManager->stopBvra();    // Send AT+BVRA=0 to end voice recognition
         } else if (g_btManager->canTrigger()) {
             // Button A pressed when idle - START speaking
-            // Update UI to show we're activating
-            g_board->setLedStatus(StatusState::Listening);
-
-            // Try multiple trigger methods (AVRCP might not be connected)
-            g_btManager->sendMediaButton();     // Try AVRCP Play/Pause first
-            g_btManager->sendBvra();            // Also send HFP voice recognition (works without AVRCP)
-
-            // Note: sendBvra() sends AT+BVRA=1 which tells the phone to start voice recognition
-            // This works even if AVRCP isn't connected, since it uses HFP which IS connected
+#if defined(WAKE_WORD)
+            s_wakeWord.setListening(false);   // Pre-roll and SCO take the mic
+#endif
+            startSession();
         }
         // canTrigger() logs the reason if it returns false
     }
 
+#if defined(WAKE_WORD)
+    // "Hey Badge" starts a session like a tap
+    if (s_wakeWord.takeDetection() && !currentScoState && g_btManager->canTrigger()) {
+        g_board->log(">>> Wake word");
+        s_wakeWord.setListening(false);
+        startSession();
+    }
+
+    // Listen only while connected and idle: not during a session, nor
+    // while a trigger waits for its SCO link
+    s_wakeWord.setListening(g_btManager->isConnected() && !g_btManager->isScoConnected()
+                            && !g_btManager->isPreRollArmed());
+#endif
+
     // Update UI based on SCO state changes
     if (currentScoState != lastScoState) {
         if (currentScoState) {
             // SCO just connected - voice session active
             g_board->setLedStatus(StatusState::Listening);
             g_board->log("Voice session started");
+            g_btManager->playEarcon(EarconMixer::Cue::SessionStart);
+#if defined(WAKE_WORD)
+            s_wakeWord.logStats();
+#endif
         } else {
             // SCO disconnected - session ended
             if (g_btManager->isConnected()) {
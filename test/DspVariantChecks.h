@@ -0,0 +1,310 @@
+#pragma once
+
+#include "../src/Audio/DspKernels.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+/**
+ * DSP kernel variant checks
+ *
+ * Shared by the host tests (DspXtensa against DspReference) and the
+ * on-target suite (Dsp - the PIE variant on the S3 - against DspReference).
+ *
+ * Every kernel runs on random and edge-case inputs (full-scale products,
+ * saturating sums, alternating extremes, zeros) at lengths around the
+ * unroll and vector widths, on 16-byte aligned and misaligned buffers,
+ * and in place for the kernels that allow out to alias in. Q15 and
+ * int8 and element-wise float results must be bit-exact; the float reductions
+ * (dotProduct, complexMac) and the recursive float biquad, whose sum
+ * order or contraction may differ, within a relative tolerance.
+ */
+namespace DspVariantChecks {
+
+static constexpr size_t MAX_N = 256;
+static constexpr size_t LENGTHS[] = {0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33,
+                                     63, 64, 65, 120, 127, 128, 129, 255, 256};
+static constexpr size_t OFFSETS[] = {0, 1, 3};   // Elements off 16-byte alignment
+static constexpr int PATTERNS = 5;
+static constexpr float FLOAT_TOLERANCE = 1e-5f;
+
+struct Report {
+    unsigned checked = 0;
+    unsigned failures = 0;
+    char first[128] = "";
+
+    void check(bool ok, const char* kernel, size_t n, size_t offset, int pattern) {
+        checked++;
+        if (ok) return;
+        if (failures++ == 0) {
+            snprintf(first, sizeof(first), "%s n=%u offset=%u pattern=%d", kernel,
+                     static_cast<unsigned>(n), static_cast<unsigned>(offset), pattern);
+        }
+    }
+};
+
+// Inputs and outputs, with room to misalign by up to OFFSETS' largest
+struct Buffers {
+    alignas(16) int16_t q15A[MAX_N + 8];
+    alignas(16) int16_t q15B[MAX_N + 8];
+    alignas(16) int16_t q15Ref[MAX_N + 8];
+    alignas(16) int16_t q15Out[MAX_N + 8];
+    alignas(16) int8_t q7A[MAX_N + 16];
+    alignas(16) int8_t q7B[MAX_N + 16];
+    alignas(16) float fA[2 * MAX_N + 8];
+    alignas(16) float fB[2 * MAX_N + 8];
+    alignas(16) float fRef[2 * MAX_N + 8];
+    alignas(16) float fOut[2 * MAX_N + 8];
+};
+
+inline uint32_t nextRandom(uint32_t& seed) {
+    seed = seed * 1664525u + 1013904223u;
+    return seed;
+}
+
+/**
+ * Fill the inputs with one pattern:
+ *   0 random full range, 1 all most-negative (full-scale products),
+ *   2 alternating extremes (saturating sums), 3 zeros, 4 small random
+ */
+inline void fill(Buffers& b, int pattern, uint32_t& seed) {
+    for (size_t i = 0; i < MAX_N + 8; i++) {
+        int16_t a;
+        int16_t c;
+        switch (pattern) {
+            case 0:
+                a = static_cast<int16_t>(nextRandom(seed) >> 16);
+                c = static_cast<int16_t>(nextRandom(seed) >> 16);
+                break;
+            case 1:
+                a = -32768;
+                c = -32768;
+                break;
+            case 2:
+                a = (i & 1) ? 32767 : -32768;
+                c = (i & 2) ? 32767 : -32768;
+                break;
+            case 3:
+                a = 0;
+                c = 0;
+                break;
+            default:
+                a = static_cast<int16_t>(static_cast<int32_t>(nextRandom(seed) >> 16) % 64);
+                c = static_cast<int16_t>(static_cast<int32_t>(nextRandom(seed) >> 16) % 64);
+                break;
+        }
+        b.q15A[i] = a;
+        b.q15B[i] = c;
+    }
+    // int8: the top byte of each Q15 input (the small pattern as is)
+    for (size_t i = 0; i < MAX_N + 16; i++) {
+        int16_t a = b.q15A[i % (MAX_N + 8)];
+        int16_t c = b.q15B[i % (MAX_N + 8)];
+        b.q7A[i] = static_cast<int8_t>(pattern == 4 ? a : a >> 8);
+        b.q7B[i] = static_cast<int8_t>(pattern == 4 ? c : c >> 8);
+    }
+    for (size_t i = 0; i < 2 * MAX_N + 8; i++) {
+        b.fA[i] = b.q15A[i % (MAX_N + 8)] / 32768.0f;
+        b.fB[i] = b.q15B[(i * 7) % (MAX_N + 8)] / 32768.0f;
+    }
+}
+
+inline bool closeEnough(float value, float reference, float scale) {
+    return fabsf(value - reference) <= FLOAT_TOLERANCE * scale + 1e-30f;
+}
+
+// ============================================================
+// Q15 AND INT8
+// ============================================================
+
+template <class V>
+void checkIntegerKernels(Report& r, Buffers& b, size_t n, size_t off, int pattern) {
+    const int16_t* a = b.q15A + off;
+    const int16_t* c = b.q15B + off;
+    int16_t* ref = b.q15Ref + off;
+    int16_t* out = b.q15Out + off;
+
+    r.check(V::dotProductQ15(a, c, n) == DspReference::dotProductQ15(a, c, n), "dotProductQ15", n, off, pattern);
+
+    DspReference::mixQ15(a, c, ref, n);
+    V::mixQ15(a, c, out, n);
+    r.check(memcmp(ref, out, n * sizeof(int16_t)) == 0, "mixQ15", n, off, pattern);
+    memcpy(out, a, n * sizeof(int16_t));
+    V::mixQ15(out, c, out, n);
+    r.check(memcmp(ref, out, n * sizeof(int16_t)) == 0, "mixQ15 in place", n, off, pattern);
+
+    // Boosts that saturate, and gains at the edge of the PIE path's range
+    // (2^shift and -(2^shift - 1): the full-scale products just fit)
+    const int16_t gains[] = {23170, 32767, -32768, -1, 16384, -16383, 2048};
+    const int shifts[] = {14, 15, 0, 7, 14, 14, 11};
+    for (size_t g = 0; g < sizeof(gains) / sizeof(gains[0]); g++) {
+        DspReference::gainQ15(a, ref, n, gains[g], shifts[g]);
+        V::gainQ15(a, out, n, gains[g], shifts[g]);
+        r.check(memcmp(ref, out, n * sizeof(int16_t)) == 0, "gainQ15", n, off, pattern);
+    }
+    for (size_t g = 0; g < 2; g++) {
+        memcpy(out, a, n * sizeof(int16_t));
+        V::gainQ15(out, out, n, gains[g], shifts[g]);
+        DspReference::gainQ15(a, ref, n, gains[g], shifts[g]);
+        r.check(memcmp(ref, out, n * sizeof(int16_t)) == 0, "gainQ15 in place", n, off, pattern);
+    }
+
+    DspReference::windowQ15(a, c, ref, n);
+    V::windowQ15(a, c, out, n);
+    r.check(memcmp(ref, out, n * sizeof(int16_t)) == 0, "windowQ15", n, off, pattern);
+    memcpy(out, a, n * sizeof(int16_t));
+    V::windowQ15(out, c, out, n);
+    r.check(memcmp(ref, out, n * sizeof(int16_t)) == 0, "windowQ15 in place", n, off, pattern);
+
+    const int8_t* a7 = b.q7A + off;
+    const int8_t* c7 = b.q7B + off;
+    r.check(V::dotProductQ7(a7, c7, n) == DspReference::dotProductQ7(a7, c7, n), "dotProductQ7", n, off, pattern);
+}
+
+template <class V>
+void checkBiquadQ15(Report& r, Buffers& b, size_t n, size_t off, int pattern) {
+    // A gentle lowpass, and a resonant high-gain section that saturates
+    static const BiquadQ15 STAGES[] = {
+        {3277, 6554, 3277, -9830, 3277},
+        {16384, -32768, 16384, -31000, 15500},
+        {8192, 16384, 8192, 0, 0},
+        {32767, 0, -32768, -16384, 8192},
+    };
+    const size_t stageCounts[] = {0, 1, 4};
+
+    for (size_t sc : stageCounts) {
+        int16_t refState[16] = {0};
+        int16_t outState[16] = {0};
+        const int16_t* in = b.q15A + off;
+        int16_t* ref = b.q15Ref + off;
+        int16_t* out = b.q15Out + off;
+
+        // Two calls, so the state carried between blocks is checked too
+        size_t half = n / 2;
+        DspReference::biquadCascadeQ15(STAGES, refState, sc, in, ref, half);
+        DspReference::biquadCascadeQ15(STAGES, refState, sc, in + half, ref + half, n - half);
+        V::biquadCascadeQ15(STAGES, outState, sc, in, out, half);
+        V::biquadCascadeQ15(STAGES, outState, sc, in + half, out + half, n - half);
+        r.check(memcmp(ref, out, n * sizeof(int16_t)) == 0 && memcmp(refState, outState, sizeof(refState)) == 0,
+                "biquadCascadeQ15", n, off, pattern);
+
+        memset(outState, 0, sizeof(outState));
+        memcpy(out, in, n * sizeof(int16_t));
+        V::biquadCascadeQ15(STAGES, outState, sc, out, out, half);
+        V::biquadCascadeQ15(STAGES, outState, sc, out + half, out + half, n - half);
+        r.check(memcmp(ref, out, n * sizeof(int16_t)) == 0, "biquadCascadeQ15 in place", n, off, pattern);
+    }
+}
+
+// ============================================================
+// FLOAT
+// ============================================================
+
+template <class V>
+void checkFloatKernels(Report& r, Buffers& b, size_t n, size_t off, int pattern) {
+    const float* a = b.fA + off;
+    const float* c = b.fB + off;
+    float* ref = b.fRef + off;
+    float* out = b.fOut + off;
+
+    float magnitude = 0.0f;
+    for (size_t i = 0; i < n; i++) magnitude += fabsf(a[i] * c[i]);
+    r.check(closeEnough(V::dotProduct(a, c, n), DspReference::dotProduct(a, c, n), magnitude),
+            "dotProduct", n, off, pattern);
+
+    DspReference::mix(a, c, ref, n);
+    V::mix(a, c, out, n);
+    r.check(memcmp(ref, out, n * sizeof(float)) == 0, "mix", n, off, pattern);
+    memcpy(out, a, n * sizeof(float));
+    V::mix(out, c, out, n);
+    r.check(memcmp(ref, out, n * sizeof(float)) == 0, "mix in place", n, off, pattern);
+
+    DspReference::scale(a, ref, n, 1.4142f);
+    V::scale(a, out, n, 1.4142f);
+    r.check(memcmp(ref, out, n * sizeof(float)) == 0, "scale", n, off, pattern);
+    memcpy(out, a, n * sizeof(float));
+    V::scale(out, out, n, 1.4142f);
+    r.check(memcmp(ref, out, n * sizeof(float)) == 0, "scale in place", n, off, pattern);
+
+    DspReference::multiply(a, c, ref, n);
+    V::multiply(a, c, out, n);
+    r.check(memcmp(ref, out, n * sizeof(float)) == 0, "multiply", n, off, pattern);
+    memcpy(out, a, n * sizeof(float));
+    V::multiply(out, c, out, n);
+    r.check(memcmp(ref, out, n * sizeof(float)) == 0, "multiply in place", n, off, pattern);
+
+    // n bins of interleaved re/im, accumulated onto a non-zero start
+    for (int conjugate = 0; conjugate < 2; conjugate++) {
+        for (size_t i = 0; i < 2 * n; i++) ref[i] = out[i] = c[(i * 5) % (n ? n : 1)];
+        DspReference::complexMac(a, c, ref, n, conjugate != 0);
+        V::complexMac(a, c, out, n, conjugate != 0);
+        bool ok = true;
+        for (size_t i = 0; i < 2 * n; i++) {
+            ok = ok && closeEnough(out[i], ref[i], 4.0f);
+        }
+        r.check(ok, conjugate ? "complexMac conj" : "complexMac", n, off, pattern);
+    }
+}
+
+template <class V>
+void checkBiquad(Report& r, Buffers& b, size_t n, size_t off, int pattern) {
+    static const Biquad STAGES[] = {
+        {0.2f, 0.4f, 0.2f, -0.6f, 0.2f},
+        {1.0f, -2.0f, 1.0f, -1.89f, 0.946f},
+        {0.5f, 1.0f, 0.5f, 0.0f, 0.0f},
+        {0.98f, 0.0f, -0.98f, -0.5f, 0.25f},
+    };
+    const size_t stageCounts[] = {0, 1, 4};
+
+    for (size_t sc : stageCounts) {
+        float refState[8] = {0};
+        float outState[8] = {0};
+        const float* in = b.fA + off;
+        float* ref = b.fRef + off;
+        float* out = b.fOut + off;
+
+        size_t half = n / 2;
+        DspReference::biquadCascade(STAGES, refState, sc, in, ref, half);
+        DspReference::biquadCascade(STAGES, refState, sc, in + half, ref + half, n - half);
+        V::biquadCascade(STAGES, outState, sc, in, out, half);
+        V::biquadCascade(STAGES, outState, sc, in + half, out + half, n - half);
+
+        float scale = 1.0f;
+        for (size_t i = 0; i < n; i++) scale = fmaxf(scale, fabsf(ref[i]));
+        bool ok = true;
+        for (size_t i = 0; i < n; i++) ok = ok && closeEnough(out[i], ref[i], scale);
+        r.check(ok, "biquadCascade", n, off, pattern);
+
+        memset(outState, 0, sizeof(outState));
+        memcpy(out, in, n * sizeof(float));
+        V::biquadCascade(STAGES, outState, sc, out, out, half);
+        V::biquadCascade(STAGES, outState, sc, out + half, out + half, n - half);
+        ok = true;
+        for (size_t i = 0; i < n; i++) ok = ok && closeEnough(out[i], ref[i], scale);
+        r.check(ok, "biquadCascade in place", n, off, pattern);
+    }
+}
+
+/**
+ * Compare variant V with DspReference on every kernel, length, alignment
+ * and input pattern
+ */
+template <class V>
+void checkAll(Report& r) {
+    static Buffers b;   // ~5KB: keep it off small task stacks
+    uint32_t seed = 12345;
+    for (int pattern = 0; pattern < PATTERNS; pattern++) {
+        for (size_t n : LENGTHS) {
+            for (size_t off : OFFSETS) {
+                fill(b, pattern, seed);
+                checkIntegerKernels<V>(r, b, n, off, pattern);
+                checkBiquadQ15<V>(r, b, n, off, pattern);
+                checkFloatKernels<V>(r, b, n, off, pattern);
+                checkBiquad<V>(r, b, n, off, pattern);
+            }
+        }
+    }
+}
+
+}  // namespace DspVariantChecks
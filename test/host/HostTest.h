@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+
+/**
+ * Minimal host test harness
+ *
+ * Each test_*.cpp builds into its own executable (one ctest entry). Test
+ * functions are plain void() functions run from main() with RUN_TEST();
+ * CHECK*() report a failure and carry on, so one run shows every broken
+ * expectation. main() returns HostTest::summary() for ctest.
+ */
+namespace HostTest {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline void fail(const char* file, int line, const char* what) {
+    printf("  FAIL %s:%d: %s\n", file, line, what);
+    failures()++;
+}
+
+inline void run(const char* name, void (*test)()) {
+    int before = failures();
+    test();
+    printf("%s %s\n", (failures() == before) ? "ok  " : "FAIL", name);
+}
+
+inline int summary() {
+    if (failures() > 0) {
+        printf("%d check(s) failed\n", failures());
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace HostTest
+
+#define RUN_TEST(fn) HostTest::run(#fn, fn)
+
+#define CHECK(cond)                                                   \
+    do {                                                              \
+        if (!(cond)) HostTest::fail(__FILE__, __LINE__, #cond);       \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                    \
+    do {                                                              \
+        long long a_ = static_cast<long long>(actual);                \
+        long long e_ = static_cast<long long>(expected);              \
+        if (a_ != e_) {                                               \
+            char msg_[160];                                           \
+            snprintf(msg_, sizeof(msg_), "%s == %s (%lld vs %lld)",   \
+                     #actual, #expected, a_, e_);                     \
+            HostTest::fail(__FILE__, __LINE__, msg_);                 \
+        }                                                             \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                       \
+    do {                                                              \
+        double a_ = static_cast<double>(actual);                      \
+        double e_ = static_cast<double>(expected);                    \
+        if (!(std::fabs(a_ - e_) <= (tolerance))) {                   \
+            char msg_[160];                                           \
+            snprintf(msg_, sizeof(msg_), "%s ~ %s (%g vs %g)",        \
+                     #actual, #expected, a_, e_);                     \
+            HostTest::fail(__FILE__, __LINE__, msg_);                 \
+        }                                                             \
+    } while (0)
@@ -0,0 +1,443 @@
+#pragma once
+
+#include "Audio/LogMelFrontEnd.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/**
+ * KeywordModel blobs for the host tests
+ *
+ * A network is described in float (weights, biases, and the scale and
+ * zero point chosen for each layer's output), quantized the way a
+ * converter would - symmetric per-channel int8 weights, int32 bias at
+ * input scale * weight scale, Q31 multiplier and shift per channel - and
+ * serialized in the KWS1 layout documented in KeywordModel.h.
+ *
+ * twoToneModel() is a hand-built detector for a synthetic two-syllable
+ * "keyword" (a low tone, then a high one; twoToneKeyword()), used by
+ * test_keyword_spotter and test_kws_eval in place of a trained model.
+ */
+namespace KwsModel {
+
+enum LayerType : uint8_t { CONV = 1, DEPTHWISE = 2, AVGPOOL = 3 };
+
+struct FloatLayer {
+    uint8_t type = CONV;
+    uint8_t kernelH = 1;
+    uint8_t kernelW = 1;
+    uint8_t strideH = 1;
+    uint8_t strideW = 1;
+    bool same = false;
+    uint16_t outChannels = 0;     // CONV only
+    std::vector<float> weights;   // CONV [out][kh][kw][in], DEPTHWISE [kh][kw][ch]
+    std::vector<float> bias;      // Per output channel (not AVGPOOL)
+    bool relu = false;
+    float outScale = 1.0f;
+    int8_t outZero = 0;
+};
+
+struct FloatModel {
+    uint16_t frames = 49;
+    uint8_t coefficients = 40;
+    uint8_t features = 0;         // LogMelFrontEnd::Output
+    uint8_t melBands = 40;
+    uint8_t classes = 2;
+    uint8_t keywordClass = 1;
+    float inputScale = 0.1f;
+    int8_t inputZero = 0;
+    std::vector<FloatLayer> layers;
+};
+
+struct QuantLayer {
+    uint8_t type;
+    uint8_t kernelH, kernelW, strideH, strideW;
+    bool same;
+    size_t inH, inW, inC, outH, outW, outC;
+    size_t padTop, padLeft;
+    int8_t inZero, outZero, actMin, actMax;
+    std::vector<int8_t> weights;
+    std::vector<int32_t> bias;
+    std::vector<int32_t> multiplier;
+    std::vector<int8_t> shift;
+};
+
+struct QuantModel {
+    FloatModel header;            // Layers unused
+    float outputScale;
+    std::vector<QuantLayer> layers;
+};
+
+/**
+ * m = multiplier * 2^(shift - 31), multiplier in [2^30, 2^31)
+ */
+inline void quantizeMultiplier(double m, int32_t& multiplier, int8_t& shift) {
+    if (m <= 0.0) {
+        multiplier = 0;
+        shift = 0;
+        return;
+    }
+    int exponent = 0;
+    double q = frexp(m, &exponent);
+    int64_t fixed = llround(q * 2147483648.0);
+    if (fixed == 2147483648LL) {
+        fixed /= 2;
+        exponent++;
+    }
+    if (exponent < -31) {
+        multiplier = 0;
+        shift = 0;
+        return;
+    }
+    multiplier = static_cast<int32_t>(fixed);
+    shift = static_cast<int8_t>(exponent > 30 ? 30 : exponent);
+}
+
+inline int8_t clampQ7(long v) {
+    return static_cast<int8_t>(v < -128 ? -128 : (v > 127 ? 127 : v));
+}
+
+/**
+ * Output shape of a windowed layer, as KeywordModel computes it
+ */
+inline void windowShape(const FloatLayer& l, size_t inH, size_t inW, QuantLayer& q) {
+    if (l.same) {
+        q.outH = (inH + l.strideH - 1) / l.strideH;
+        q.outW = (inW + l.strideW - 1) / l.strideW;
+        size_t needH = (q.outH - 1) * l.strideH + l.kernelH;
+        size_t needW = (q.outW - 1) * l.strideW + l.kernelW;
+        q.padTop = needH > inH ? (needH - inH) / 2 : 0;
+        q.padLeft = needW > inW ? (needW - inW) / 2 : 0;
+    } else {
+        q.outH = (inH - l.kernelH) / l.strideH + 1;
+        q.outW = (inW - l.kernelW) / l.strideW + 1;
+        q.padTop = 0;
+        q.padLeft = 0;
+    }
+}
+
+/**
+ * Quantize a float network (weights symmetric per channel)
+ */
+inline QuantModel quantize(const FloatModel& model) {
+    QuantModel out;
+    out.header = model;
+    out.header.layers.clear();
+
+    size_t h = model.frames;
+    size_t w = model.coefficients;
+    size_t c = 1;
+    float inScale = model.inputScale;
+    int8_t inZero = model.inputZero;
+
+    for (const FloatLayer& l : model.layers) {
+        QuantLayer q;
+        q.type = l.type;
+        q.kernelH = l.kernelH;
+        q.kernelW = l.kernelW;
+        q.strideH = l.strideH;
+        q.strideW = l.strideW;
+        q.same = l.same;
+        q.inH = h;
+        q.inW = w;
+        q.inC = c;
+        q.inZero = inZero;
+        q.outZero = l.outZero;
+        q.actMin = l.relu ? l.outZero : -128;
+        q.actMax = 127;
+
+        if (l.type == AVGPOOL) {
+            q.outH = 1;
+            q.outW = 1;
+            q.outC = c;
+            q.padTop = 0;
+            q.padLeft = 0;
+            int32_t m;
+            int8_t s;
+            quantizeMultiplier(static_cast<double>(inScale) / (l.outScale * h * w), m, s);
+            q.multiplier.push_back(m);
+            q.shift.push_back(s);
+        } else {
+            windowShape(l, h, w, q);
+            q.outC = (l.type == CONV) ? l.outChannels : c;
+            size_t perChannel = (l.type == CONV) ? l.kernelH * l.kernelW * c : l.kernelH * l.kernelW;
+            q.weights.resize(l.weights.size());
+            for (size_t ch = 0; ch < q.outC; ch++) {
+                // CONV rows are contiguous; DEPTHWISE channels interleave
+                auto index = [&](size_t j) { return (l.type == CONV) ? ch * perChannel + j : j * c + ch; };
+                float largest = 0.0f;
+                for (size_t j = 0; j < perChannel; j++) largest = fmaxf(largest, fabsf(l.weights[index(j)]));
+                float weightScale = (largest > 0.0f) ? largest / 127.0f : 1.0f;
+                for (size_t j = 0; j < perChannel; j++) {
+                    q.weights[index(j)] = clampQ7(lrintf(l.weights[index(j)] / weightScale));
+                }
+                double accScale = static_cast<double>(inScale) * weightScale;
+                q.bias.push_back(static_cast<int32_t>(llround(l.bias[ch] / accScale)));
+                int32_t m;
+                int8_t s;
+                quantizeMultiplier(accScale / l.outScale, m, s);
+                q.multiplier.push_back(m);
+                q.shift.push_back(s);
+            }
+        }
+
+        h = q.outH;
+        w = q.outW;
+        c = q.outC;
+        inScale = l.outScale;
+        inZero = l.outZero;
+        out.layers.push_back(q);
+    }
+    out.outputScale = inScale;
+    return out;
+}
+
+inline void put8(std::vector<uint8_t>& blob, uint8_t v) {
+    blob.push_back(v);
+}
+
+inline void put16(std::vector<uint8_t>& blob, uint16_t v) {
+    blob.push_back(static_cast<uint8_t>(v));
+    blob.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+inline void put32(std::vector<uint8_t>& blob, uint32_t v) {
+    for (int i = 0; i < 4; i++) blob.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+inline void putFloat(std::vector<uint8_t>& blob, float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    put32(blob, bits);
+}
+
+inline void pad4(std::vector<uint8_t>& blob) {
+    while (blob.size() % 4) blob.push_back(0);
+}
+
+/**
+ * The KWS1 blob of a quantized network
+ */
+inline std::vector<uint8_t> serialize(const QuantModel& model) {
+    const FloatModel& h = model.header;
+    std::vector<uint8_t> blob;
+    blob.insert(blob.end(), {'K', 'W', 'S', '1'});
+    put16(blob, h.frames);
+    put8(blob, h.coefficients);
+    put8(blob, h.features);
+    put8(blob, h.melBands);
+    put8(blob, h.classes);
+    put8(blob, h.keywordClass);
+    put8(blob, static_cast<uint8_t>(model.layers.size()));
+    putFloat(blob, h.inputScale);
+    put8(blob, static_cast<uint8_t>(h.inputZero));
+    pad4(blob);
+    putFloat(blob, model.outputScale);
+    while (blob.size() < 32) blob.push_back(0);
+
+    for (const QuantLayer& l : model.layers) {
+        put8(blob, l.type);
+        put8(blob, l.kernelH);
+        put8(blob, l.kernelW);
+        put8(blob, l.strideH);
+        put8(blob, l.strideW);
+        put8(blob, l.same ? 1 : 0);
+        put16(blob, static_cast<uint16_t>(l.type == CONV ? l.outC : 0));
+        put8(blob, static_cast<uint8_t>(l.outZero));
+        put8(blob, static_cast<uint8_t>(l.actMin));
+        put8(blob, static_cast<uint8_t>(l.actMax));
+        pad4(blob);
+
+        if (l.type != AVGPOOL) {
+            for (int8_t v : l.weights) put8(blob, static_cast<uint8_t>(v));
+            pad4(blob);
+            for (int32_t v : l.bias) put32(blob, static_cast<uint32_t>(v));
+        }
+        for (int32_t v : l.multiplier) put32(blob, static_cast<uint32_t>(v));
+        for (int8_t v : l.shift) put8(blob, static_cast<uint8_t>(v));
+        pad4(blob);
+    }
+    return blob;
+}
+
+inline std::vector<uint8_t> build(const FloatModel& model) {
+    return serialize(quantize(model));
+}
+
+// ============================================================
+// SYNTHETIC KEYWORD
+// ============================================================
+
+static constexpr float TWO_TONE_LOW_HZ = 700.0f;
+static constexpr float TWO_TONE_HIGH_HZ = 1800.0f;
+static constexpr uint32_t TWO_TONE_SYLLABLE_MS = 300;
+
+/**
+ * Add the keyword to out at a position: a low then a high syllable with
+ * 10ms raised-cosine edges
+ * @param gap Silence between the syllables, in samples
+ */
+inline void addTwoTone(std::vector<int16_t>& out, size_t at, uint32_t rate, float lowHz, float highHz,
+                       size_t syllable, size_t gap, float amplitude) {
+    const size_t ramp = rate / 100;
+    const float hz[2] = {lowHz, highHz};
+    for (int s = 0; s < 2; s++) {
+        size_t start = at + s * (syllable + gap);
+        for (size_t i = 0; i < syllable && start + i < out.size(); i++) {
+            float edge = 1.0f;
+            if (i < ramp) edge = 0.5f - 0.5f * cosf(3.14159265f * i / ramp);
+            if (syllable - i < ramp) edge = 0.5f - 0.5f * cosf(3.14159265f * (syllable - i) / ramp);
+            float v = out[start + i] + amplitude * edge * sinf(6.283185307f * hz[s] * i / rate);
+            out[start + i] = static_cast<int16_t>(fmaxf(-32768.0f, fminf(32767.0f, v)));
+        }
+    }
+}
+
+/**
+ * Mel bands that a tone at hz lights up: within 1 (natural log) of the
+ * strongest
+ */
+inline std::vector<size_t> bandsFor(float hz, size_t bands) {
+    LogMelFrontEnd frontEnd;
+    LogMelFrontEnd::Config config = {LogMelFrontEnd::Output::LogMel, static_cast<uint8_t>(bands),
+                                     static_cast<uint8_t>(bands), 0.1f, 0};
+    frontEnd.init(config);
+    int16_t window[LogMelFrontEnd::WINDOW];
+    for (size_t i = 0; i < LogMelFrontEnd::WINDOW; i++) {
+        window[i] = static_cast<int16_t>(8000.0f * sinf(6.283185307f * hz * i / LogMelFrontEnd::SAMPLE_RATE));
+    }
+    float features[LogMelFrontEnd::MAX_BANDS];
+    frontEnd.computeFloat(window, features);
+
+    float strongest = -1e9f;
+    for (size_t b = 0; b < bands; b++) strongest = fmaxf(strongest, features[b]);
+    std::vector<size_t> lit;
+    for (size_t b = 0; b < bands; b++) {
+        if (features[b] > strongest - 1.0f) lit.push_back(b);
+    }
+    return lit;
+}
+
+/**
+ * Hand-built detector for the two-tone keyword, shaped like a small CNN
+ * over 49 frames of 40 log-mel bands:
+ *
+ *   CONV 1x40       per frame, low- and high-tone band contrast (band
+ *                   energy over the frame's mean), less a margin; ReLU
+ *   DEPTHWISE 3x1   smooth each over three frames
+ *   CONV 24x1 /24   mean of each over the first and second half-second
+ *   CONV 2x1        a = low over high in the first half, b = high over
+ *                   low in the second; ReLU
+ *   CONV 1x1        a and relu(a - b), so the logit can take min(a, b)
+ *   CONV 1x1        keyword logit: min(a, b) less a threshold, so one
+ *                   tone alone (or the wrong order) never scores;
+ *                   background logit 0
+ */
+inline FloatModel twoToneModel() {
+    static constexpr size_t BANDS = 40;
+    static constexpr float MARGIN = 1.0f;      // Contrast below this is noise
+    static constexpr float THRESHOLD = 0.5f;   // Contrast in both halves for an even posterior
+    static constexpr float GAIN = 3.0f;        // Logit per unit of contrast
+
+    FloatModel model;
+    model.frames = 49;
+    model.coefficients = BANDS;
+    model.features = static_cast<uint8_t>(LogMelFrontEnd::Output::LogMel);
+    model.melBands = BANDS;
+    model.classes = 2;
+    model.keywordClass = 1;
+    model.inputScale = 0.1f;       // -14 (the floor) .. 11.5
+    model.inputZero = 12;
+
+    const float contrastScale = 16.0f / 255.0f;
+
+    FloatLayer contrast;
+    contrast.type = CONV;
+    contrast.kernelW = BANDS;
+    contrast.outChannels = 2;
+    contrast.relu = true;
+    contrast.outScale = contrastScale;
+    contrast.outZero = -128;
+    const float tones[2] = {TWO_TONE_LOW_HZ, TWO_TONE_HIGH_HZ};
+    for (int t = 0; t < 2; t++) {
+        std::vector<size_t> lit = bandsFor(tones[t], BANDS);
+        for (size_t b = 0; b < BANDS; b++) {
+            float inTone = 0.0f;
+            for (size_t l : lit) inTone += (l == b) ? 1.0f / lit.size() : 0.0f;
+            contrast.weights.push_back(inTone - 1.0f / BANDS);
+        }
+        contrast.bias.push_back(-MARGIN);
+    }
+
+    FloatLayer smooth;
+    smooth.type = DEPTHWISE;
+    smooth.kernelH = 3;
+    smooth.same = true;
+    smooth.weights.assign(3 * 2, 1.0f / 3.0f);
+    smooth.bias.assign(2, 0.0f);
+    smooth.relu = true;
+    smooth.outScale = contrastScale;
+    smooth.outZero = -128;
+
+    FloatLayer halves;
+    halves.type = CONV;
+    halves.kernelH = 24;
+    halves.strideH = 24;
+    halves.outChannels = 2;
+    for (size_t o = 0; o < 2; o++) {
+        for (size_t ky = 0; ky < 24; ky++) {
+            for (size_t i = 0; i < 2; i++) halves.weights.push_back((i == o) ? 1.0f / 24.0f : 0.0f);
+        }
+    }
+    halves.bias.assign(2, 0.0f);
+    halves.relu = true;
+    halves.outScale = contrastScale;
+    halves.outZero = -128;
+
+    FloatLayer orders;
+    orders.type = CONV;
+    orders.kernelH = 2;
+    orders.outChannels = 2;
+    // [a or b][half][1][tone]
+    const float lowFirst[4] = {1.0f, -1.0f, 0.0f, 0.0f};
+    const float highSecond[4] = {0.0f, 0.0f, -1.0f, 1.0f};
+    orders.weights.insert(orders.weights.end(), lowFirst, lowFirst + 4);
+    orders.weights.insert(orders.weights.end(), highSecond, highSecond + 4);
+    orders.bias.assign(2, 0.0f);
+    orders.relu = true;
+    orders.outScale = contrastScale;
+    orders.outZero = -128;
+
+    // min(a, b) = a - relu(a - b)
+    FloatLayer both;
+    both.type = CONV;
+    both.outChannels = 2;
+    const float minimum[4] = {1.0f, 0.0f, 1.0f, -1.0f};
+    both.weights.assign(minimum, minimum + 4);
+    both.bias.assign(2, 0.0f);
+    both.relu = true;
+    both.outScale = contrastScale;
+    both.outZero = -128;
+
+    FloatLayer logits;
+    logits.type = CONV;
+    logits.outChannels = 2;
+    // [class][a, relu(a - b)]
+    const float keyword[4] = {0.0f, 0.0f, GAIN, -GAIN};
+    logits.weights.assign(keyword, keyword + 4);
+    logits.bias.push_back(0.0f);
+    logits.bias.push_back(-GAIN * THRESHOLD);
+    logits.outScale = 0.2f;
+    logits.outZero = 0;
+
+    model.layers.push_back(contrast);
+    model.layers.push_back(smooth);
+    model.layers.push_back(halves);
+    model.layers.push_back(orders);
+    model.layers.push_back(both);
+    model.layers.push_back(logits);
+    return model;
+}
+
+}  // namespace KwsModel
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+/**
+ * Speech fixtures for the replay tests
+ *
+ * fixtures/voiced_16k.wav is generated by make_voiced_fixture.py; any
+ * 16-bit mono 8kHz or 16kHz WAV loads the same way.
+ */
+
+struct Recording {
+    uint32_t sampleRate = 0;
+    std::vector<int16_t> samples;
+};
+
+inline uint32_t le32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint16_t le16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+/**
+ * Load a 16-bit mono PCM WAV
+ * @return false if the file is missing or in another format
+ */
+inline bool loadWav(const char* path, Recording& rec) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    std::vector<uint8_t> file;
+    uint8_t buf[4096];
+    size_t got;
+    while ((got = fread(buf, 1, sizeof(buf), f)) > 0) file.insert(file.end(), buf, buf + got);
+    fclose(f);
+
+    if (file.size() < 12 || memcmp(&file[0], "RIFF", 4) != 0 || memcmp(&file[8], "WAVE", 4) != 0) return false;
+
+    bool haveFormat = false;
+    for (size_t pos = 12; pos + 8 <= file.size();) {
+        uint32_t size = le32(&file[pos + 4]);
+        const uint8_t* body = &file[pos + 8];
+        if (pos + 8 + size > file.size()) return false;
+
+        if (memcmp(&file[pos], "fmt ", 4) == 0 && size >= 16) {
+            if (le16(body) != 1 || le16(body + 2) != 1 || le16(body + 14) != 16) return false;
+            rec.sampleRate = le32(body + 4);
+            haveFormat = true;
+        } else if (memcmp(&file[pos], "data", 4) == 0 && haveFormat) {
+            rec.samples.resize(size / 2);
+            for (size_t i = 0; i < rec.samples.size(); i++) {
+                rec.samples[i] = static_cast<int16_t>(le16(body + 2 * i));
+            }
+            return rec.sampleRate == 8000 || rec.sampleRate == 16000;
+        }
+        pos += 8 + size + (size & 1);
+    }
+    return false;
+}
@@ -0,0 +1,113 @@
+#include "HostTest.h"
+#include "HAL/LogRing.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Host microbenchmark: the on-screen log store before and after LogRing.
+//
+// VectorLog is the code LogRing replaced in both boards' log(): a
+// std::vector<std::string> trimmed with erase(begin()) and grown with
+// push_back(), with lines truncated when drawn. Both stores take the same
+// messages and must end up holding the same visible lines; the timings
+// are printed, not checked, since they depend on the host.
+
+static constexpr size_t LINES = 50;         // LOG_BUFFER_SIZE
+static constexpr size_t VISIBLE = 8;        // CoreS3 LOG_MAX_LINES
+static constexpr size_t WIDTH = 38;         // CoreS3 LOG_LINE_CHARS
+static constexpr size_t MESSAGES = 64;
+static constexpr uint32_t PUSHES = 200000;
+
+class VectorLog {
+public:
+    VectorLog() { m_lines.reserve(LINES); }
+
+    void push(const char* message) {
+        if (m_lines.size() >= LINES) {
+            m_lines.erase(m_lines.begin());
+        }
+        m_lines.push_back(std::string(message));
+    }
+
+    // What the old redraw did for each visible line
+    std::string visible(size_t fromNewest) const {
+        std::string line = m_lines[m_lines.size() - 1 - fromNewest];
+        if (line.length() > WIDTH) {
+            line = line.substr(0, WIDTH - 3) + "...";
+        }
+        return line;
+    }
+
+private:
+    std::vector<std::string> m_lines;
+};
+
+/**
+ * Typical log lines, 24 to 87 characters (past the std::string SSO limit)
+ */
+static std::vector<std::string> makeMessages() {
+    std::vector<std::string> messages;
+    char text[128];
+    for (size_t i = 0; i < MESSAGES; i++) {
+        int len = snprintf(text, sizeof(text), "[BT] SCO frame %u: jb=%u plc=%u",
+                           static_cast<unsigned>(i * 7919), static_cast<unsigned>(i % 13),
+                           static_cast<unsigned>(i % 5));
+        size_t target = 24 + (i * 37) % 64;
+        for (; static_cast<size_t>(len) < target; len++) text[len] = static_cast<char>('a' + len % 26);
+        text[target] = '\0';
+        messages.push_back(text);
+    }
+    return messages;
+}
+
+static double nsPer(std::chrono::steady_clock::duration elapsed, uint32_t count) {
+    return std::chrono::duration<double, std::nano>(elapsed).count() / count;
+}
+
+static void test_push_cost() {
+    std::vector<std::string> messages = makeMessages();
+    VectorLog vectorLog;
+    static LogRing<LINES, WIDTH> ring;
+    size_t sink = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < PUSHES; i++) {
+        vectorLog.push(messages[i % MESSAGES].c_str());
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < PUSHES; i++) {
+        ring.push(messages[i % MESSAGES].c_str());
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    // A push followed by the redraw's read of the visible lines
+    for (uint32_t i = 0; i < PUSHES / 10; i++) {
+        vectorLog.push(messages[i % MESSAGES].c_str());
+        for (size_t v = 0; v < VISIBLE; v++) sink += vectorLog.visible(v).size();
+    }
+    auto t3 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < PUSHES / 10; i++) {
+        ring.push(messages[i % MESSAGES].c_str());
+        for (size_t v = 0; v < VISIBLE; v++) sink += strlen(ring.line(ring.size() - 1 - v));
+    }
+    auto t4 = std::chrono::steady_clock::now();
+
+    printf("  push            vector %7.1f ns   LogRing %7.1f ns\n", nsPer(t1 - t0, PUSHES), nsPer(t2 - t1, PUSHES));
+    printf("  push + %zu lines  vector %7.1f ns   LogRing %7.1f ns\n", VISIBLE,
+           nsPer(t3 - t2, PUSHES / 10), nsPer(t4 - t3, PUSHES / 10));
+
+    // Same visible lines from both
+    size_t differ = 0;
+    for (size_t v = 0; v < VISIBLE; v++) {
+        differ += (vectorLog.visible(v) != ring.line(ring.size() - 1 - v));
+    }
+    CHECK_EQ(differ, 0);
+    CHECK(sink > 0);
+}
+
+int main() {
+    RUN_TEST(test_push_cost);
+    return HostTest::summary();
+}
@@ -0,0 +1,617 @@
+#include "HostTest.h"
+#include "HAL/LogRing.h"
+#include "HAL/LogScroll.h"
+#include <M5GFX.h>
+#include <lgfx/v1/Bus.hpp>
+#include <lgfx/v1/panel/Panel_ILI9342.hpp>
+#include <lgfx/v1/panel/Panel_ST7789.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Host benchmark: what each appended log line sends to the panel.
+//
+// M5GFX itself renders and drives the panel: the real Panel_ILI9342
+// (CoreS3) and Panel_ST7789 (StickC Plus2, configured as M5GFX configures
+// it) talk to PanelBus, which stands in for the SPI bus. It parses the
+// command stream - CASET, RASET, RAMWR, MADCTL, VSCRDEF, VSCRSADD - into a
+// model of the controller's memory and its scroll mapping, and counts the
+// pixels and bytes that would cross the wire.
+//
+// Three ways of appending a line, one line per frame:
+//   repaint    The drawLogSection() the boards had before the compositor:
+//              clear the log area, drawString() every visible line
+//   wrap       The default drawLogLines(): the new line overwrites the
+//              oldest slot in place, a mark moves to the newest
+//   hwscroll   drawLogLines() with LOG_HW_SCROLL: the new line goes into the
+//              oldest slot and VSCRSADD scrolls it to the bottom
+//
+// Pixels, bytes and SPI time at 40MHz are per appended line; host time is
+// rendering plus the driver, with the memory model off. Each mode must
+// leave the screen showing the expected lines - read back through the
+// model, scroll mapping included - and the new modes must push one strip
+// per line. Whether the real controllers scroll as modelled (VSCRDEF rows,
+// MADCTL row order) is only settled on a panel.
+
+static constexpr int16_t LINE_HEIGHT = 16;       // LOG_LINE_HEIGHT, both boards
+static constexpr int16_t PADDING = 4;            // LOG_PADDING
+static constexpr int16_t MARK_WIDTH = 2;         // LOG_MARK_WIDTH
+static constexpr size_t LOG_BUFFER_SIZE = 50;
+static constexpr uint32_t SPI_HZ = 40000000;
+static constexpr size_t TIMED_LINES = 400;
+
+/**
+ * SPI bus into a model of the panel controller
+ *
+ * Pixels are kept as the two bytes that arrived, in memory order, so they
+ * compare directly with a 16-bit canvas buffer.
+ */
+class PanelBus : public lgfx::IBus {
+public:
+    struct Counts {
+        uint64_t pixels;
+        uint64_t bytes;
+        uint64_t commands;
+    };
+
+    PanelBus(uint16_t memoryWidth, uint16_t memoryRows)
+        : m_width(memoryWidth), m_rows(memoryRows), m_gram(static_cast<size_t>(memoryWidth) * memoryRows, 0) {}
+
+    Counts counts() const { return m_counts; }
+    void resetCounts() { m_counts = Counts(); }
+
+    /**
+     * false: count only, leave the memory model alone (timed runs)
+     */
+    void setModel(bool on) { m_model = on; }
+
+    uint8_t madctl() const { return m_madctl; }
+    uint16_t scrollTop() const { return m_scrollTop; }
+    uint16_t scrollArea() const { return m_scrollArea; }
+    uint16_t scrollBottom() const { return m_scrollBottom; }
+
+    /**
+     * Pixel shown on a panel line (memory row order, before the scroll)
+     */
+    uint16_t shown(uint16_t line, uint16_t column) const {
+        return m_gram[static_cast<size_t>(memoryRow(line)) * m_width + column];
+    }
+
+    lgfx::bus_type_t busType() const override { return lgfx::bus_type_t::bus_spi; }
+    bool init() override { return true; }
+    void release() override {}
+    void beginTransaction() override {}
+    void endTransaction() override {}
+    void wait() override {}
+    bool busy() const override { return false; }
+
+    void initDMA() override {}
+    void addDMAQueue(const uint8_t* data, uint32_t length) override { writeBytes(data, length, true, true); }
+    void execDMAQueue() override {}
+    uint8_t* getDMABuffer(uint32_t length) override {
+        m_dma.resize(length);
+        return m_dma.data();
+    }
+    void flush() override {}
+
+    bool writeCommand(uint32_t data, uint_fast8_t bitLength) override {
+        for (uint_fast8_t bit = 0; bit < bitLength; bit += 8) command(static_cast<uint8_t>(data >> bit));
+        return true;
+    }
+
+    void writeData(uint32_t data, uint_fast8_t bitLength) override {
+        for (uint_fast8_t bit = 0; bit < bitLength; bit += 8) dataByte(static_cast<uint8_t>(data >> bit));
+    }
+
+    void writeDataRepeat(uint32_t data, uint_fast8_t bitLength, uint32_t count) override {
+        while (count--) writeData(data, bitLength);
+    }
+
+    void writePixels(lgfx::pixelcopy_t* param, uint32_t length) override {
+        m_pixels.resize(length * (param->dst_bits >> 3));
+        param->fp_copy(m_pixels.data(), 0, length, param);
+        writeBytes(m_pixels.data(), static_cast<uint32_t>(m_pixels.size()), true, false);
+    }
+
+    void writeBytes(const uint8_t* data, uint32_t length, bool dc, bool) override {
+        for (uint32_t i = 0; i < length; i++) {
+            if (dc) {
+                dataByte(data[i]);
+            } else {
+                command(data[i]);
+            }
+        }
+    }
+
+    using lgfx::IBus::beginRead;
+    using lgfx::IBus::readBytes;
+    void beginRead() override {}
+    void endRead() override {}
+    uint32_t readData(uint_fast8_t) override { return 0; }
+    bool readBytes(uint8_t* dst, uint32_t length, bool) override {
+        memset(dst, 0, length);
+        return true;
+    }
+    void readPixels(void*, lgfx::pixelcopy_t*, uint32_t) override {}
+
+private:
+    static constexpr uint8_t CASET = 0x2A;
+    static constexpr uint8_t RASET = 0x2B;
+    static constexpr uint8_t RAMWR = 0x2C;
+    static constexpr uint8_t VSCRDEF = 0x33;
+    static constexpr uint8_t MADCTL = 0x36;
+    static constexpr uint8_t VSCRSADD = 0x37;
+
+    uint16_t m_width;
+    uint16_t m_rows;
+    std::vector<uint16_t> m_gram;
+    std::vector<uint8_t> m_dma;
+    std::vector<uint8_t> m_pixels;
+    bool m_model = true;
+    Counts m_counts = Counts();
+
+    uint8_t m_command = 0;
+    uint8_t m_params[8] = {};
+    size_t m_paramCount = 0;
+    uint16_t m_xs = 0, m_xe = 0, m_ys = 0, m_ye = 0;
+    uint16_t m_x = 0, m_y = 0;
+    uint8_t m_firstByte = 0;
+    bool m_haveFirst = false;
+
+    uint8_t m_madctl = 0;
+    uint16_t m_scrollTop = 0;
+    uint16_t m_scrollArea = 0;
+    uint16_t m_scrollBottom = 0;
+    uint16_t m_scrollStart = 0;
+
+    uint16_t param16(size_t index) const {
+        return static_cast<uint16_t>((m_params[index] << 8) | m_params[index + 1]);
+    }
+
+    /**
+     * Memory row on a panel line: lines in the scroll area start from the
+     * scroll start and wrap within the area
+     */
+    uint16_t memoryRow(uint16_t line) const {
+        if (m_scrollArea == 0 || line < m_scrollTop || line >= m_scrollTop + m_scrollArea) return line;
+        uint32_t row = m_scrollStart + (line - m_scrollTop);
+        if (row >= static_cast<uint32_t>(m_scrollTop + m_scrollArea)) row -= m_scrollArea;
+        return static_cast<uint16_t>(row);
+    }
+
+    void command(uint8_t c) {
+        m_counts.bytes++;
+        m_counts.commands++;
+        m_command = c;
+        m_paramCount = 0;
+        m_haveFirst = false;
+        if (c == RAMWR) {
+            m_x = m_xs;
+            m_y = m_ys;
+        }
+    }
+
+    void dataByte(uint8_t b) {
+        m_counts.bytes++;
+        if (m_command == RAMWR) {
+            if (!m_haveFirst) {
+                m_firstByte = b;
+                m_haveFirst = true;
+            } else {
+                writePixel(static_cast<uint16_t>(m_firstByte | (b << 8)));
+                m_haveFirst = false;
+            }
+            return;
+        }
+
+        if (m_paramCount < sizeof(m_params)) m_params[m_paramCount++] = b;
+        switch (m_command) {
+        case CASET:
+            if (m_paramCount == 4) {
+                m_xs = param16(0);
+                m_xe = param16(2);
+            }
+            break;
+        case RASET:
+            if (m_paramCount == 4) {
+                m_ys = param16(0);
+                m_ye = param16(2);
+            }
+            break;
+        case MADCTL:
+            m_madctl = b;
+            break;
+        case VSCRDEF:
+            if (m_paramCount == 6) {
+                m_scrollTop = param16(0);
+                m_scrollArea = param16(2);
+                m_scrollBottom = param16(4);
+            }
+            break;
+        case VSCRSADD:
+            if (m_paramCount == 2) m_scrollStart = param16(0);
+            break;
+        default:
+            break;
+        }
+    }
+
+    void writePixel(uint16_t value) {
+        m_counts.pixels++;
+        if (m_model && m_x < m_width && m_y < m_rows) {
+            m_gram[static_cast<size_t>(m_y) * m_width + m_x] = value;
+        }
+        if (++m_x > m_xe) {
+            m_x = m_xs;
+            if (++m_y > m_ye) m_y = m_ys;
+        }
+    }
+};
+
+// ============================================================
+// BOARDS
+// ============================================================
+
+enum class Controller { Ili9342c, St7789 };
+
+/**
+ * Log geometry from the board headers, and the panel as M5GFX sets it up
+ */
+struct Layout {
+    const char* name;
+    Controller controller;
+    int16_t width;
+    int16_t logYStart;        // LOG_Y_START (separator row)
+    int16_t logHeight;        // LOG_HEIGHT
+    int16_t textY;            // LOG_TEXT_Y
+    const lgfx::IFont* font;
+    uint16_t memoryRows;      // PANEL_MEMORY_ROWS
+    uint16_t rowOffset;       // PANEL_ROW_OFFSET
+    uint16_t columnOffset;
+};
+
+static const Layout CORES3 = {"CoreS3 (ILI9342C, 320x240)", Controller::Ili9342c, 320, 100, 140, 104,
+                              &fonts::Font2, 240, 0, 0};
+static const Layout STICKC = {"StickC Plus2 (ST7789, 135x240)", Controller::St7789, 135, 80, 160, 84,
+                              &fonts::Font0, 320, 40, 52};
+
+/**
+ * The panel, the emulated bus and what M5Compositor does with them: two
+ * line strips pushed by DMA, small clears, the scroll registers
+ */
+class Screen {
+public:
+    explicit Screen(const Layout& layout)
+        : m_layout(layout),
+          m_bus(layout.controller == Controller::Ili9342c ? 320 : 240,
+                layout.controller == Controller::Ili9342c ? 240 : 320) {
+        if (layout.controller == Controller::Ili9342c) {
+            // M5GFX's Panel_M5StackCoreS3, rotation 1 as Board_M5CoreS3 sets
+            m_panel.reset(new lgfx::Panel_ILI9342());
+            auto cfg = m_panel->config();
+            cfg.invert = true;
+            cfg.offset_rotation = 3;
+            m_panel->config(cfg);
+            m_rotation = 1;
+        } else {
+            // M5GFX's Panel_M5StickCPlus, rotation 0 as Board_M5StickCPlus2 sets
+            m_panel.reset(new lgfx::Panel_ST7789());
+            auto cfg = m_panel->config();
+            cfg.invert = true;
+            cfg.panel_width = 135;
+            cfg.panel_height = 240;
+            cfg.offset_x = 52;
+            cfg.offset_y = 40;
+            m_panel->config(cfg);
+            m_rotation = 0;
+        }
+        m_panel->setBus(&m_bus);
+        m_display.setPanel(m_panel.get());
+        m_display.init_without_reset();
+        m_display.setRotation(m_rotation);
+
+        for (M5Canvas& line : m_lines) {
+            line.setColorDepth(16);
+            line.setPsram(false);
+            line.createSprite(layout.width, LINE_HEIGHT);
+        }
+
+        // As the boards' init(): clear the log section, draw the separator
+        m_display.fillRect(0, layout.logYStart, layout.width, layout.logHeight, TFT_BLACK);
+        m_display.drawFastHLine(0, layout.logYStart, layout.width, TFT_DARKGREY);
+    }
+
+    lgfx::LGFX_Device& display() { return m_display; }
+    PanelBus& bus() { return m_bus; }
+
+    M5Canvas& lineCanvas() {
+        M5Canvas& canvas = m_lines[m_lineIdx];
+        canvas.fillScreen(TFT_BLACK);
+        return canvas;
+    }
+
+    void pushLine(int16_t y) {
+        M5Canvas& canvas = m_lines[m_lineIdx];
+        m_display.pushImageDMA(0, y, m_layout.width, LINE_HEIGHT,
+                               static_cast<const lgfx::swap565_t*>(canvas.getBuffer()));
+        m_lineIdx = (m_lineIdx + 1) % 2;
+    }
+
+    void clearRect(int16_t x, int16_t y, int16_t width, int16_t height) {
+        m_display.fillRect(x, y, width, height, TFT_BLACK);
+    }
+
+    void defineScroll(uint16_t top, uint16_t area, uint16_t bottom) {
+        uint16_t params[3] = {top, area, bottom};
+        writePanelCommand(0x33, params, 3);
+    }
+
+    void setScrollStart(uint16_t row) { writePanelCommand(0x37, &row, 1); }
+
+    /**
+     * Pixel at display coordinates as the panel shows it
+     */
+    uint16_t shown(int16_t x, int16_t y) const {
+        return m_bus.shown(static_cast<uint16_t>(y + m_layout.rowOffset),
+                           static_cast<uint16_t>(x + m_layout.columnOffset));
+    }
+
+private:
+    const Layout& m_layout;
+    PanelBus m_bus;
+    std::unique_ptr<lgfx::Panel_LCD> m_panel;
+    lgfx::LGFX_Device m_display;
+    uint8_t m_rotation = 0;
+    M5Canvas m_lines[2];
+    size_t m_lineIdx = 0;
+
+    void writePanelCommand(uint8_t command, const uint16_t* params, size_t count) {
+        m_display.startWrite();
+        m_display.writeCommand(command);
+        for (size_t i = 0; i < count; i++) {
+            m_display.writeData(static_cast<uint8_t>(params[i] >> 8));
+            m_display.writeData(static_cast<uint8_t>(params[i] & 0xFF));
+        }
+        m_display.endWrite();
+    }
+};
+
+// ============================================================
+// LOG MODES
+// ============================================================
+
+enum class Mode { Repaint, Wrap, HwScroll };
+
+static const char* modeName(Mode mode) {
+    switch (mode) {
+    case Mode::Repaint: return "repaint";
+    case Mode::Wrap: return "wrap";
+    case Mode::HwScroll: return "hwscroll";
+    }
+    return "?";
+}
+
+/**
+ * One board's on-screen log, drawn one way
+ */
+template <size_t LINES, size_t CHARS>
+class LogView {
+public:
+    LogView(const Layout& layout, Mode mode) : m_layout(layout), m_mode(mode), m_screen(layout) {
+        if (mode == Mode::HwScroll) {
+            // As the boards' init() with LOG_HW_SCROLL
+            uint16_t top = layout.rowOffset + layout.textY;
+            uint16_t area = LINES * LINE_HEIGHT;
+            m_screen.defineScroll(top, area, layout.memoryRows - top - area);
+            m_screen.setScrollStart(top);
+        }
+    }
+
+    Screen& screen() { return m_screen; }
+
+    /**
+     * Store a line and draw it, as one compositor frame
+     */
+    void append(const char* message) {
+        m_ring.push(message);
+        m_wrapSlots[m_appended % LINES] = m_ring.line(m_ring.size() - 1);
+        m_appended++;
+
+        lgfx::LGFX_Device& display = m_screen.display();
+        display.startWrite();
+        if (m_mode == Mode::Repaint) {
+            repaint();
+        } else {
+            drawLine();
+        }
+        display.endWrite();
+    }
+
+    /**
+     * Text expected in each visible slot, top to bottom
+     */
+    std::vector<std::string> expected() const {
+        std::vector<std::string> lines;
+        if (m_mode == Mode::Wrap) {
+            for (size_t i = 0; i < LINES; i++) lines.push_back(m_wrapSlots[i]);
+        } else {
+            size_t count = (m_ring.size() < LINES) ? m_ring.size() : LINES;
+            for (size_t i = 0; i < count; i++) lines.push_back(m_ring.line(m_ring.size() - count + i));
+        }
+        return lines;
+    }
+
+    /**
+     * Slot marked as newest (-1 when the mode has no mark)
+     */
+    int markedSlot() const {
+        return (m_mode == Mode::Wrap && m_appended > 0) ? static_cast<int>((m_appended - 1) % LINES) : -1;
+    }
+
+private:
+    const Layout& m_layout;
+    Mode m_mode;
+    Screen m_screen;
+    LogRing<LOG_BUFFER_SIZE, CHARS> m_ring;
+    LogScroll<LINES, LINE_HEIGHT> m_scroll;
+    int16_t m_markRow = -1;
+    std::string m_wrapSlots[LINES];
+    size_t m_appended = 0;
+
+    void repaint() {
+        lgfx::LGFX_Device& display = m_screen.display();
+        display.fillRect(0, m_layout.logYStart + 1, m_layout.width, m_layout.logHeight - 1, TFT_BLACK);
+        display.setFont(m_layout.font);
+        display.setTextColor(TFT_CYAN, TFT_BLACK);
+        display.setTextDatum(top_left);
+        size_t count = (m_ring.size() < LINES) ? m_ring.size() : LINES;
+        size_t first = m_ring.size() - count;
+        for (size_t i = 0; i < count; i++) {
+            display.drawString(m_ring.line(first + i), PADDING, m_layout.textY + static_cast<int16_t>(i) * LINE_HEIGHT);
+        }
+    }
+
+    void drawLine() {
+        int16_t row = m_scroll.slotRow(m_scroll.nextSlot());
+        m_scroll.advance();
+        if (m_mode == Mode::HwScroll) {
+            m_screen.setScrollStart(m_layout.rowOffset + m_layout.textY + m_scroll.scrollRows());
+        } else {
+            if (m_markRow >= 0) m_screen.clearRect(0, m_layout.textY + m_markRow, MARK_WIDTH, LINE_HEIGHT);
+            m_markRow = row;
+        }
+
+        M5Canvas& line = m_screen.lineCanvas();
+        line.setFont(m_layout.font);
+        line.setTextColor(TFT_CYAN, TFT_BLACK);
+        line.setTextDatum(top_left);
+        line.drawString(m_ring.line(m_ring.size() - 1), PADDING, 0);
+        if (m_mode == Mode::Wrap) line.fillRect(0, 1, MARK_WIDTH, LINE_HEIGHT - 2, TFT_CYAN);
+        m_screen.pushLine(m_layout.textY + row);
+    }
+};
+
+/**
+ * Log lines of 20 to 80 characters, cut to the panel width when stored
+ */
+static std::string message(size_t i) {
+    char text[96];
+    int len = snprintf(text, sizeof(text), "[BT] SCO frame %u: jb=%u plc=%u", static_cast<unsigned>(i * 7919),
+                       static_cast<unsigned>(i % 13), static_cast<unsigned>(i % 5));
+    size_t target = 20 + (i * 37) % 61;
+    for (; static_cast<size_t>(len) < target; len++) text[len] = static_cast<char>('a' + len % 26);
+    text[target] = '\0';
+    return text;
+}
+
+/**
+ * Visible slots that differ from a strip rendered with the expected text
+ */
+template <size_t LINES, size_t CHARS>
+static size_t wrongSlots(LogView<LINES, CHARS>& view, const Layout& layout) {
+    std::vector<std::string> lines = view.expected();
+    M5Canvas strip;
+    strip.setColorDepth(16);
+    strip.createSprite(layout.width, LINE_HEIGHT);
+
+    size_t wrong = 0;
+    for (size_t slot = 0; slot < lines.size(); slot++) {
+        strip.fillScreen(TFT_BLACK);
+        strip.setFont(layout.font);
+        strip.setTextColor(TFT_CYAN, TFT_BLACK);
+        strip.setTextDatum(top_left);
+        strip.drawString(lines[slot].c_str(), PADDING, 0);
+        if (static_cast<int>(slot) == view.markedSlot()) strip.fillRect(0, 1, MARK_WIDTH, LINE_HEIGHT - 2, TFT_CYAN);
+
+        const uint16_t* pixels = static_cast<const uint16_t*>(strip.getBuffer());
+        int16_t top = layout.textY + static_cast<int16_t>(slot) * LINE_HEIGHT;
+        size_t differ = 0;
+        for (int16_t y = 0; y < LINE_HEIGHT; y++) {
+            for (int16_t x = 0; x < layout.width; x++) {
+                differ += (view.screen().shown(x, top + y) != pixels[y * layout.width + x]);
+            }
+        }
+        wrong += (differ > 0);
+    }
+    return wrong;
+}
+
+struct Result {
+    double pixels;    // Per appended line
+    double bytes;
+    double commands;
+    double hostUs;
+};
+
+template <size_t LINES, size_t CHARS>
+static Result measure(const Layout& layout, Mode mode) {
+    LogView<LINES, CHARS> view(layout, mode);
+    PanelBus& bus = view.screen().bus();
+    size_t next = 0;
+
+    // Fill the area first: the steady state is a full log
+    for (size_t i = 0; i < LINES; i++) view.append(message(next++).c_str());
+
+    bus.setModel(false);
+    bus.resetCounts();
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < TIMED_LINES; i++) view.append(message(next++).c_str());
+    auto t1 = std::chrono::steady_clock::now();
+    PanelBus::Counts counts = bus.counts();
+    bus.setModel(true);
+
+    // With the model back on, enough lines to redraw every slot, then read
+    // the screen back
+    for (size_t i = 0; i < LINES + 3; i++) view.append(message(next++).c_str());
+    CHECK_EQ(wrongSlots(view, layout), 0);
+
+    // MADCTL keeps memory rows in drawing order (no MY, MV or ML), which
+    // the slot arithmetic and the scroll start rely on
+    CHECK_EQ(bus.madctl() & 0xB0, 0);
+    if (mode == Mode::HwScroll) {
+        CHECK_EQ(bus.scrollTop() + bus.scrollArea() + bus.scrollBottom(), layout.memoryRows);
+    }
+
+    Result r;
+    r.pixels = static_cast<double>(counts.pixels) / TIMED_LINES;
+    r.bytes = static_cast<double>(counts.bytes) / TIMED_LINES;
+    r.commands = static_cast<double>(counts.commands) / TIMED_LINES;
+    r.hostUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / TIMED_LINES;
+    return r;
+}
+
+template <size_t LINES, size_t CHARS>
+static void runBoard(const Layout& layout) {
+    printf("  %s, %zu lines\n", layout.name, LINES);
+    printf("  %-9s %9s %10s %6s %9s %9s\n", "mode", "px/line", "bytes/line", "cmds", "SPI us", "host us");
+
+    const Mode modes[] = {Mode::Repaint, Mode::Wrap, Mode::HwScroll};
+    for (Mode mode : modes) {
+        Result r = measure<LINES, CHARS>(layout, mode);
+        double spiUs = r.bytes * 8.0 * 1e6 / SPI_HZ;
+        printf("  %-9s %9.0f %10.0f %6.1f %9.1f %9.1f\n", modeName(mode), r.pixels, r.bytes, r.commands, spiUs,
+               r.hostUs);
+
+        // One strip per line, plus the mark cleared in wrap mode
+        if (mode != Mode::Repaint) {
+            CHECK(r.pixels <= layout.width * LINE_HEIGHT + MARK_WIDTH * LINE_HEIGHT);
+        }
+    }
+}
+
+static void test_cores3() {
+    runBoard<8, 38>(CORES3);
+}
+
+static void test_stickc_plus2() {
+    runBoard<9, 22>(STICKC);
+}
+
+int main() {
+    RUN_TEST(test_cores3);
+    RUN_TEST(test_stickc_plus2);
+    return HostTest::summary();
+}
@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""Regenerate voiced_16k.wav, the speech-like clip test_plc_replay replays.
+
+A source-filter synthesis rather than a recording, so the fixture carries
+no licensing baggage and is reproducible byte for byte: a glottal pulse
+train with a moving pitch contour through three formant resonators that
+glide between vowel targets, syllable envelopes with short pauses, and
+one fricative burst. That is enough of what concealment cares about -
+pitch drifting within a loss, formant transitions, onsets and unvoiced
+sounds - without the test depending on a real voice.
+
+    python3 test/host/fixtures/make_voiced_fixture.py
+"""
+
+import math
+import os
+import struct
+import wave
+
+RATE = 16000
+
+# (start s, length s, vowel, f0 at start Hz, f0 at end Hz, RMS); None = fricative
+SYLLABLES = [
+    (0.05, 0.22, "a", 120, 135, 4000),
+    (0.30, 0.18, "i", 140, 150, 2500),
+    (0.52, 0.08, None, 0, 0, 800),
+    (0.62, 0.25, "u", 150, 110, 3000),
+    (0.92, 0.20, "e", 180, 160, 3500),
+    (1.15, 0.30, "a", 105, 95, 4500),
+    (1.52, 0.16, "i", 200, 220, 2000),
+    (1.70, 0.10, None, 0, 0, 1200),
+    (1.84, 0.28, "e", 130, 145, 4000),
+    (2.14, 0.24, "u", 125, 100, 3000),
+]
+
+FORMANTS = {
+    "a": (730, 1090, 2440),
+    "i": (270, 2290, 3010),
+    "u": (300, 870, 2240),
+    "e": (530, 1840, 2480),
+}
+BANDWIDTHS = (60, 90, 120)
+LENGTH_S = 2.5
+
+
+class Lcg:
+    """Deterministic noise, independent of the Python version's random()"""
+
+    def __init__(self, seed):
+        self.state = seed
+
+    def uniform(self):
+        self.state = (self.state * 1103515245 + 12345) & 0x7FFFFFFF
+        return self.state / 0x3FFFFFFF - 1.0
+
+
+class Resonator:
+    def __init__(self):
+        self.y1 = 0.0
+        self.y2 = 0.0
+
+    def step(self, x, freq, bw):
+        r = math.exp(-math.pi * bw / RATE)
+        a1 = 2 * r * math.cos(2 * math.pi * freq / RATE)
+        a2 = -r * r
+        y = (1 - r) * x + a1 * self.y1 + a2 * self.y2
+        self.y2 = self.y1
+        self.y1 = y
+        return y
+
+
+def envelope(t, length):
+    ramp = 0.02
+    if t < ramp:
+        return 0.5 - 0.5 * math.cos(math.pi * t / ramp)
+    if t > length - ramp:
+        return 0.5 - 0.5 * math.cos(math.pi * (length - t) / ramp)
+    return 1.0
+
+
+def synthesize():
+    noise = Lcg(1)
+    resonators = [Resonator() for _ in FORMANTS["a"]]
+    samples = [0.0] * int(LENGTH_S * RATE)
+    phase = 0.0
+    glottal = 0.0
+    hp_prev = 0.0
+    previous = FORMANTS["a"]
+
+    for start, length, vowel, f0a, f0b, rms in SYLLABLES:
+        first = int(start * RATE)
+        count = int(length * RATE)
+        # Glide from the previous vowel's formants over the first 40ms
+        for n in range(count):
+            t = n / RATE
+            env = envelope(t, length)
+            if vowel is None:
+                # Fricative: high-passed noise
+                x = noise.uniform()
+                samples[first + n] = 0.25 * env * (x - hp_prev)
+                hp_prev = x
+                continue
+
+            f0 = f0a + (f0b - f0a) * t / length
+            phase += f0 / RATE
+            pulse = 0.0
+            if phase >= 1.0:
+                phase -= 1.0
+                pulse = 1.0
+            glottal = 0.9 * glottal + pulse + 0.02 * noise.uniform()
+
+            glide = min(1.0, t / 0.04)
+            y = glottal
+            for k, res in enumerate(resonators):
+                freq = previous[k] + (FORMANTS[vowel][k] - previous[k]) * glide
+                y = res.step(y, freq, BANDWIDTHS[k])
+            samples[first + n] = env * y
+        if vowel is not None:
+            previous = FORMANTS[vowel]
+
+        syllable = samples[first:first + count]
+        scale = rms / math.sqrt(sum(x * x for x in syllable) / count)
+        samples[first:first + count] = [x * scale for x in syllable]
+
+    return [max(-32768, min(32767, int(round(s)))) for s in samples]
+
+
+def main():
+    path = os.path.join(os.path.dirname(os.path.abspath(__file__)), "voiced_16k.wav")
+    pcm = synthesize()
+    with wave.open(path, "wb") as out:
+        out.setnchannels(1)
+        out.setsampwidth(2)
+        out.setframerate(RATE)
+        out.writeframes(struct.pack("<%dh" % len(pcm), *pcm))
+    print("wrote %s (%d samples)" % (path, len(pcm)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,59 @@
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#include "esp_spiffs.h"
+#include "esp_timer.h"
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <dirent.h>
+#include <sys/stat.h>
+
+static int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t esp_timer_get_time(void) {
+    return nowNs() / 1000;
+}
+
+uint32_t esp_cpu_get_ccount(void) {
+    return static_cast<uint32_t>(nowNs());
+}
+
+void* heap_caps_malloc(size_t size, uint32_t caps) {
+    (void)caps;
+    return malloc(size);
+}
+
+static std::string g_spiffsPath;
+static size_t g_spiffsTotal = 1024 * 1024;
+
+esp_err_t esp_vfs_spiffs_register(const esp_vfs_spiffs_conf_t* conf) {
+    g_spiffsPath = conf->base_path;
+    mkdir(conf->base_path, 0755);
+    struct stat st;
+    return (stat(conf->base_path, &st) == 0 && S_ISDIR(st.st_mode)) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_spiffs_info(const char* partition_label, size_t* total_bytes, size_t* used_bytes) {
+    (void)partition_label;
+    DIR* dir = opendir(g_spiffsPath.c_str());
+    if (!dir) return ESP_FAIL;
+
+    size_t used = 0;
+    while (struct dirent* entry = readdir(dir)) {
+        std::string path = g_spiffsPath + "/" + entry->d_name;
+        struct stat st;
+        if (stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) used += static_cast<size_t>(st.st_size);
+    }
+    closedir(dir);
+
+    *total_bytes = g_spiffsTotal;
+    *used_bytes = used;
+    return ESP_OK;
+}
+
+void host_spiffs_set_total(size_t bytes) {
+    g_spiffsTotal = bytes;
+}
@@ -0,0 +1,39 @@
+#include "freertos/task.h"
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+
+static std::mutex g_mutex;
+static std::map<const void*, uint32_t> g_delays;   // Per task, keyed by its argument
+static thread_local const void* t_task = nullptr;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* arg,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core) {
+    (void)name;
+    (void)stackDepth;
+    (void)priority;
+    (void)core;
+
+    // Task loops never return; the thread lives until the process exits
+    std::thread([fn, arg]() {
+        t_task = arg;
+        fn(arg);
+    }).detach();
+    if (handle) *handle = reinterpret_cast<TaskHandle_t>(arg);
+    return 1;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    (void)ticks;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_delays[t_task]++;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+uint32_t host_task_delays(const void* task) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    return g_delays[task];
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+// Host stand-in for M5Unified, just enough for M5MicCapture (which gets
+// FreeRTOS through it, as on the board). The mic hands out a running
+// sample count and only completes a record() when the test releases it,
+// so a test decides exactly how much audio has been captured. Quiet mode
+// records silence instead (the count still advances), and end()/begin()
+// are counted so a test can see the mic being duty-cycled.
+
+#include "freertos/task.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+class HostMic {
+public:
+    /**
+     * Blocks until the test releases a buffer, then fills it with the
+     * next samples of a running count
+     */
+    bool record(int16_t* data, size_t len, uint32_t sampleRate) {
+        (void)sampleRate;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_entered++;
+        m_changed.notify_all();
+        m_changed.wait(lock, [this]() { return m_permits > 0; });
+        m_permits--;
+        for (size_t i = 0; i < len; i++) {
+            data[i] = m_quiet ? 0 : static_cast<int16_t>(m_next);
+            m_next++;
+        }
+        return true;
+    }
+
+    bool isEnabled() const { return true; }
+
+    bool begin() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_begins++;
+        return true;
+    }
+
+    void end() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ends++;
+    }
+
+    /**
+     * Test side: record silence instead of the running count
+     */
+    void setQuiet(bool quiet) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quiet = quiet;
+    }
+
+    uint32_t ends() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_ends;
+    }
+
+    uint32_t begins() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_begins;
+    }
+
+    /**
+     * Test side: complete the next count record() calls and wait until the
+     * capture task has handled them and is back waiting in record()
+     */
+    void release(uint32_t count) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_changed.wait(lock, [this]() { return m_entered > m_released; });
+        m_released += count;
+        m_permits += count;
+        m_changed.notify_all();
+        m_changed.wait(lock, [this]() { return m_entered > m_released; });
+    }
+
+    /**
+     * Value the next captured sample will have
+     */
+    uint32_t next() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_next;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    uint32_t m_entered = 0;
+    uint32_t m_released = 0;
+    uint32_t m_permits = 0;
+    uint32_t m_next = 0;
+    uint32_t m_begins = 0;
+    uint32_t m_ends = 0;
+    bool m_quiet = false;
+};
+
+struct HostM5 {
+    HostMic Mic;
+};
+
+// Never destroyed: the capture thread is still waiting in record() at exit
+inline HostM5& hostM5() {
+    static HostM5* m5 = new HostM5();
+    return *m5;
+}
+
+#define M5 (hostM5())
@@ -0,0 +1,15 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF header: cycle counter (nanoseconds here)
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t esp_cpu_get_ccount(void);
+
+#ifdef __cplusplus
+}
+#endif
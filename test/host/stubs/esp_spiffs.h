@@ -0,0 +1,32 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF header: the "partition" is a plain
+// directory at base_path, and its used space is the size of the files in
+// it. The partition size is set by the test.
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    const char* base_path;
+    const char* partition_label;
+    size_t max_files;
+    bool format_if_mount_failed;
+} esp_vfs_spiffs_conf_t;
+
+esp_err_t esp_vfs_spiffs_register(const esp_vfs_spiffs_conf_t* conf);
+esp_err_t esp_spiffs_info(const char* partition_label, size_t* total_bytes, size_t* used_bytes);
+
+/**
+ * Host only: partition size reported by esp_spiffs_info()
+ */
+void host_spiffs_set_total(size_t bytes);
+
+#ifdef __cplusplus
+}
+#endif
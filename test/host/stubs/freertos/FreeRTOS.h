@@ -0,0 +1,11 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF header: the FreeRTOS base types
+
+#include <stdint.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
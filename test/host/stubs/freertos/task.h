@@ -0,0 +1,30 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF header: tasks run on detached std::threads
+// (FreeRtosStubs.cpp) and vTaskDelay() sleeps a millisecond whatever the
+// tick count, so polling loops turn over quickly
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct tskTaskControlBlock* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* arg,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core);
+
+void vTaskDelay(TickType_t ticks);
+
+/**
+ * Host only: vTaskDelay() calls so far by the task created with this
+ * argument. A task that polls with vTaskDelay() has run a full pass
+ * once this has moved by two.
+ */
+uint32_t host_task_delays(const void* task);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,181 @@
+#include "HostTest.h"
+#include "Audio/AutomaticGainControl.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+static constexpr uint32_t RATE = 16000;
+static constexpr size_t FRAME = AudioConfig::FRAME_SAMPLES_16K;
+static constexpr int32_t TARGET_PEAK = 8192;   // -12dBFS
+static constexpr int32_t LIMIT_PEAK = 29205;   // -1dBFS
+
+struct Talker {
+    size_t n = 0;
+
+    // 250Hz tone with a given peak (every 1ms sub-block holds a full cycle)
+    void frame(int16_t* out, size_t samples, uint32_t rate, float peak) {
+        for (size_t i = 0; i < samples; i++, n++) {
+            out[i] = static_cast<int16_t>(peak * sinf(2.0f * static_cast<float>(M_PI) * 250.0f * n / rate));
+        }
+    }
+};
+
+static int32_t peakOf(const int16_t* x, size_t samples) {
+    int32_t peak = 0;
+    for (size_t i = 0; i < samples; i++) peak = std::max(peak, abs(static_cast<int32_t>(x[i])));
+    return peak;
+}
+
+/**
+ * Run ms of audio at one level through the AGC
+ * @return Output peak over the last frame
+ */
+static int32_t run(AutomaticGainControl& agc, Talker& talker, uint32_t ms, float peak, uint32_t rate = RATE) {
+    size_t frame = rate * 75 / 10000;
+    std::vector<int16_t> buf(frame);
+    uint32_t frames = ms * 10 / 75;
+    for (uint32_t f = 0; f < frames; f++) {
+        talker.frame(buf.data(), frame, rate, peak);
+        agc.process(buf.data(), buf.data(), frame);
+    }
+    return peakOf(buf.data(), frame);
+}
+
+static float gainDbFor(float inPeak) {
+    return 20.0f * log10f(TARGET_PEAK / inPeak);
+}
+
+static void test_soft_talker_brought_up_to_target() {
+    AutomaticGainControl agc;
+    agc.reset(RATE);
+    Talker talker;
+
+    // +12dB start, +18dB wanted: recovery at ~8dB/s takes under a second
+    int32_t out = run(agc, talker, 3000, 1000.0f);
+    CHECK_NEAR(agc.getStats().gainDb, gainDbFor(1000.0f), 0.5f);
+    CHECK_NEAR(out, TARGET_PEAK, TARGET_PEAK / 10);
+}
+
+static void test_loud_talker_brought_down_at_once() {
+    AutomaticGainControl agc;
+    agc.reset(RATE);
+    Talker talker;
+
+    // The very first frame already sits under the limit, and the gain is
+    // on target after it
+    int32_t out = run(agc, talker, 8, 20000.0f);
+    CHECK(out <= LIMIT_PEAK);
+    CHECK_NEAR(agc.getStats().gainDb, gainDbFor(20000.0f), 0.5f);
+
+    out = run(agc, talker, 500, 20000.0f);
+    CHECK_NEAR(out, TARGET_PEAK, TARGET_PEAK / 10);
+}
+
+static void test_gain_recovers_at_about_8db_per_second() {
+    AutomaticGainControl agc;
+    agc.reset(RATE);
+    Talker talker;
+    run(agc, talker, 1000, 16000.0f);
+    float loudGain = agc.getStats().gainDb;
+
+    // The talker backs off 12dB: the gain climbs gradually, not at once
+    run(agc, talker, 300, 4000.0f);
+    float early = agc.getStats().gainDb - loudGain;
+    run(agc, talker, 700, 4000.0f);
+    float afterOneSecond = agc.getStats().gainDb - loudGain;
+
+    // +1/1024 per sub-block plus one LSB of rounding: faster at low gains
+    CHECK(early > 1.0f && early < 4.5f);
+    CHECK(afterOneSecond > 7.0f && afterOneSecond < 12.0f);
+
+    run(agc, talker, 2000, 4000.0f);
+    CHECK_NEAR(agc.getStats().gainDb, gainDbFor(4000.0f), 0.5f);
+}
+
+static void test_noise_gate_holds_gain_in_pauses() {
+    AutomaticGainControl agc;
+    agc.reset(RATE);
+    Talker talker;
+    run(agc, talker, 3000, 2000.0f);
+
+    // Once the envelope has decayed under the gate (~200ms), two more
+    // seconds of near-silence do not pump the gain up
+    run(agc, talker, 300, 60.0f);
+    float pauseGain = agc.getStats().gainDb;
+    CHECK(pauseGain < gainDbFor(200.0f));
+    run(agc, talker, 2000, 60.0f);
+    AutomaticGainControl::Stats s = agc.getStats();
+    CHECK_NEAR(s.gainDb, pauseGain, 0.01f);
+    CHECK(s.gatedBlocks > 2000);
+}
+
+static void test_sudden_burst_caught_in_its_sub_block() {
+    AutomaticGainControl agc;
+    agc.reset(RATE);
+    Talker talker;
+    run(agc, talker, 3000, 600.0f);   // Gain near the +24dB ceiling
+
+    // A shout lands in the middle of a frame: the gain drops within the
+    // sub-block it arrives in, so no sample goes over the target
+    std::vector<int16_t> buf(FRAME);
+    talker.frame(buf.data(), FRAME / 2, RATE, 600.0f);
+    talker.frame(buf.data() + FRAME / 2, FRAME / 2, RATE, 30000.0f);
+    agc.process(buf.data(), buf.data(), FRAME);
+    CHECK(peakOf(buf.data(), FRAME) <= TARGET_PEAK + 16);
+}
+
+static void test_clipped_input_is_counted() {
+    AutomaticGainControl agc;
+    agc.reset(RATE);
+    std::vector<int16_t> buf(FRAME, 0);
+    buf[10] = 32767;
+    buf[11] = -32768;
+    buf[12] = 32000;
+    agc.process(buf.data(), buf.data(), FRAME);
+    CHECK_EQ(agc.getStats().clippedSamples, 2);
+}
+
+static void test_disabled_applies_fixed_gain() {
+    AutomaticGainControl agc;
+    agc.reset(RATE);
+    agc.setEnabled(false);
+    Talker talker;
+
+    // The old fixed magnification: 16 / MIC_MAGNIFICATION
+    float fixedDb = 20.0f * log10f(16.0f / AudioConfig::MIC_MAGNIFICATION);
+    int32_t out = run(agc, talker, 2000, 1000.0f);
+    CHECK_NEAR(agc.getStats().gainDb, fixedDb, 0.01f);
+    CHECK_NEAR(out, 1000.0f * 16 / AudioConfig::MIC_MAGNIFICATION, 40);
+
+    // The limiter stays on
+    out = run(agc, talker, 100, 20000.0f);
+    CHECK_NEAR(out, LIMIT_PEAK, 16);
+    CHECK(agc.getStats().limitedBlocks >= 100);
+
+    // Re-enabled, it adapts from there
+    agc.setEnabled(true);
+    run(agc, talker, 500, 20000.0f);
+    CHECK_NEAR(agc.getStats().gainDb, gainDbFor(20000.0f), 0.5f);
+}
+
+static void test_narrowband_tracks_the_same() {
+    AutomaticGainControl agc;
+    agc.reset(8000);
+    Talker talker;
+    int32_t out = run(agc, talker, 3000, 1000.0f, 8000);
+    CHECK_NEAR(agc.getStats().gainDb, gainDbFor(1000.0f), 0.5f);
+    CHECK_NEAR(out, TARGET_PEAK, TARGET_PEAK / 10);
+}
+
+int main() {
+    RUN_TEST(test_soft_talker_brought_up_to_target);
+    RUN_TEST(test_loud_talker_brought_down_at_once);
+    RUN_TEST(test_gain_recovers_at_about_8db_per_second);
+    RUN_TEST(test_noise_gate_holds_gain_in_pauses);
+    RUN_TEST(test_sudden_burst_caught_in_its_sub_block);
+    RUN_TEST(test_clipped_input_is_counted);
+    RUN_TEST(test_disabled_applies_fixed_gain);
+    RUN_TEST(test_narrowband_tracks_the_same);
+    return HostTest::summary();
+}
@@ -0,0 +1,184 @@
+#include "HostTest.h"
+#include "Audio/AudioConfig.h"
+#include "Audio/ComfortNoise.h"
+#include <cmath>
+#include <vector>
+
+static constexpr size_t FRAME = AudioConfig::FRAME_SAMPLES_16K;
+
+/**
+ * Background noise at a given level: white, or through a one-pole lowpass
+ * (pole 0.9) for a spectrum the LPC model has to follow
+ */
+struct Background {
+    uint32_t seed = 12345;
+    float state = 0.0f;
+    float pole;
+
+    explicit Background(float p = 0.0f) : pole(p) {}
+
+    void frame(int16_t* out, size_t samples, float levelDb) {
+        // Unit-variance uniform noise, and the filter's power gain undone
+        float amplitude = 32768.0f * powf(10.0f, levelDb / 20.0f) * sqrtf(1.0f - pole * pole);
+        for (size_t i = 0; i < samples; i++) {
+            seed = seed * 1103515245u + 12345u;
+            float white = (static_cast<float>(seed >> 8) / 8388608.0f - 1.0f) * 1.7320508f;
+            state = pole * state + white;
+            out[i] = static_cast<int16_t>(amplitude * state);
+        }
+    }
+};
+
+static float levelDbOf(const std::vector<int16_t>& x) {
+    double power = 0.0;
+    for (int16_t s : x) power += static_cast<double>(s) * s;
+    return static_cast<float>(10.0 * log10(power / x.size() / (32768.0 * 32768.0) + 1e-12));
+}
+
+// Normalized lag-1 autocorrelation: 0 for white noise, the pole for the lowpass
+static float lag1(const std::vector<int16_t>& x) {
+    double r0 = 0.0;
+    double r1 = 0.0;
+    for (size_t i = 0; i < x.size(); i++) {
+        r0 += static_cast<double>(x[i]) * x[i];
+        if (i > 0) r1 += static_cast<double>(x[i]) * x[i - 1];
+    }
+    return (r0 > 0.0) ? static_cast<float>(r1 / r0) : 0.0f;
+}
+
+static void analyzeFrames(ComfortNoise& cng, Background& bg, uint32_t frames, float levelDb) {
+    int16_t frame[FRAME];
+    for (uint32_t f = 0; f < frames; f++) {
+        bg.frame(frame, FRAME, levelDb);
+        cng.analyze(frame, FRAME);
+    }
+}
+
+// One second of comfort noise, a frame at a time as the engine asks for it
+static std::vector<int16_t> generateSecond(ComfortNoise& cng) {
+    std::vector<int16_t> out(16000);
+    for (size_t pos = 0; pos + FRAME <= out.size(); pos += FRAME) {
+        cng.generate(&out[pos], FRAME);
+    }
+    out.resize(out.size() / FRAME * FRAME);
+    return out;
+}
+
+// ============================================================
+// LEVEL
+// ============================================================
+
+static void test_default_level_before_any_background() {
+    ComfortNoise cng;
+    cng.reset();
+    CHECK(!cng.hasModel());
+    CHECK_NEAR(cng.levelDb(), ComfortNoise::DEFAULT_LEVEL_DB, 0.01f);
+
+    std::vector<int16_t> out = generateSecond(cng);
+    CHECK_NEAR(levelDbOf(out), ComfortNoise::DEFAULT_LEVEL_DB, 1.0f);
+    CHECK_NEAR(lag1(out), 0.0f, 0.05f);
+}
+
+static void test_generated_level_matches_background() {
+    const float levels[] = {-60.0f, -45.0f, -30.0f};
+    for (float level : levels) {
+        ComfortNoise cng;
+        cng.reset();
+        Background bg;
+        analyzeFrames(cng, bg, 100, level);
+
+        CHECK(cng.hasModel());
+        CHECK_NEAR(cng.levelDb(), level, 0.5f);
+        CHECK_NEAR(levelDbOf(generateSecond(cng)), level, 1.0f);
+    }
+}
+
+static void test_spectral_shape_follows_background() {
+    ComfortNoise cng;
+    cng.reset();
+    Background bg(0.9f);
+    analyzeFrames(cng, bg, 100, -40.0f);
+
+    // The LPC fit reproduces a lowpass background, not white noise at
+    // the same power
+    std::vector<int16_t> out = generateSecond(cng);
+    CHECK_NEAR(levelDbOf(out), -40.0f, 1.5f);
+    CHECK_NEAR(lag1(out), 0.9f, 0.05f);
+}
+
+// ============================================================
+// BACKGROUND TRACKING
+// ============================================================
+
+static void test_speech_does_not_raise_the_level() {
+    ComfortNoise cng;
+    cng.reset();
+    Background bg;
+    Background talker(0.5f);
+    int16_t frame[FRAME];
+
+    // A conversation: mostly talk 30dB over the room, with short pauses
+    for (int f = 0; f < 400; f++) {
+        if (f % 8 < 2) {
+            bg.frame(frame, FRAME, -55.0f);
+        } else {
+            talker.frame(frame, FRAME, -25.0f);
+        }
+        cng.analyze(frame, FRAME);
+    }
+    CHECK_NEAR(cng.levelDb(), -55.0f, 1.0f);
+    CHECK_NEAR(levelDbOf(generateSecond(cng)), -55.0f, 1.5f);
+}
+
+static void test_floor_follows_a_louder_room() {
+    ComfortNoise cng;
+    cng.reset();
+    Background bg;
+    analyzeFrames(cng, bg, 100, -55.0f);
+
+    // 10dB more background (the fan came on): the floor creeps up until the
+    // new level counts as background, then the model takes it over
+    analyzeFrames(cng, bg, 50, -45.0f);
+    CHECK_NEAR(cng.levelDb(), -55.0f, 1.0f);
+    analyzeFrames(cng, bg, 400, -45.0f);
+    CHECK_NEAR(cng.levelDb(), -45.0f, 1.0f);
+
+    // A quieter room is adopted at once
+    analyzeFrames(cng, bg, 50, -60.0f);
+    CHECK_NEAR(cng.levelDb(), -60.0f, 1.0f);
+}
+
+static void test_digital_silence_gives_silence() {
+    ComfortNoise cng;
+    cng.reset();
+    int16_t zeros[FRAME] = {0};
+    for (int f = 0; f < 20; f++) cng.analyze(zeros, FRAME);
+
+    CHECK(cng.hasModel());
+    std::vector<int16_t> out = generateSecond(cng);
+    bool silent = true;
+    for (int16_t s : out) silent = silent && (s == 0);
+    CHECK(silent);
+}
+
+static void test_reset_forgets_the_model() {
+    ComfortNoise cng;
+    cng.reset();
+    Background bg;
+    analyzeFrames(cng, bg, 100, -30.0f);
+    cng.reset();
+
+    CHECK(!cng.hasModel());
+    CHECK_NEAR(levelDbOf(generateSecond(cng)), ComfortNoise::DEFAULT_LEVEL_DB, 1.0f);
+}
+
+int main() {
+    RUN_TEST(test_default_level_before_any_background);
+    RUN_TEST(test_generated_level_matches_background);
+    RUN_TEST(test_spectral_shape_follows_background);
+    RUN_TEST(test_speech_does_not_raise_the_level);
+    RUN_TEST(test_floor_follows_a_louder_room);
+    RUN_TEST(test_digital_silence_gives_silence);
+    RUN_TEST(test_reset_forgets_the_model);
+    return HostTest::summary();
+}
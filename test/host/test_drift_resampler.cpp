@@ -0,0 +1,167 @@
+#include "HostTest.h"
+#include "Audio/DriftCompensator.h"
+#include "Audio/FractionalResampler.h"
+#include <cmath>
+#include <cstdlib>
+
+static constexpr size_t FRAME = 120;   // 7.5ms at 16kHz
+static constexpr float RATE = 16000.0f;
+
+static int16_t tone(double n, double hz) {
+    return static_cast<int16_t>(lrint(12000.0 * sin(2.0 * M_PI * hz * n / RATE)));
+}
+
+// ============================================================
+// FRACTIONAL RESAMPLER
+// ============================================================
+
+static void test_unity_ratio_is_delayed_copy() {
+    FractionalResampler rs;
+    rs.reset();
+
+    int16_t in[FRAME];
+    int16_t out[FRAME + 4];
+    int16_t prev[2] = {0, 0};
+    for (int f = 0; f < 20; f++) {
+        for (size_t i = 0; i < FRAME; i++) in[i] = static_cast<int16_t>(rand() - RAND_MAX / 2);
+        size_t n = rs.process(in, FRAME, out, sizeof(out) / sizeof(out[0]));
+        CHECK_EQ(n, FRAME);
+        // Two samples of delay, bit-exact
+        CHECK_EQ(out[0], prev[0]);
+        CHECK_EQ(out[1], prev[1]);
+        for (size_t i = 2; i < FRAME; i++) CHECK_EQ(out[i], in[i - 2]);
+        prev[0] = in[FRAME - 2];
+        prev[1] = in[FRAME - 1];
+    }
+}
+
+static void test_long_run_rate_matches_ppm() {
+    const float ppms[] = {-1000.0f, -250.0f, 37.5f, 500.0f, 1000.0f};
+    for (float ppm : ppms) {
+        FractionalResampler rs;
+        rs.reset();
+        rs.setRatioPpm(ppm);
+
+        int16_t in[FRAME] = {0};
+        int16_t out[FRAME + 4];
+        size_t totalIn = 0;
+        size_t totalOut = 0;
+        for (int f = 0; f < 8000; f++) {   // 60s
+            totalOut += rs.process(in, FRAME, out, sizeof(out) / sizeof(out[0]));
+            totalIn += FRAME;
+        }
+        double expected = static_cast<double>(totalIn) / (1.0 + ppm * 1e-6);
+        CHECK_NEAR(static_cast<double>(totalOut), expected, 3.0);
+    }
+}
+
+static void test_input_for_yields_exact_output() {
+    const float ppms[] = {-1000.0f, -3.3f, 0.0f, 120.0f, 1000.0f};
+    const size_t sizes[] = {60, 120, 61, 1};
+    for (float ppm : ppms) {
+        FractionalResampler rs;
+        rs.reset();
+        int16_t in[FractionalResampler::MAX_INPUT] = {0};
+        int16_t out[FractionalResampler::MAX_INPUT];
+        for (int f = 0; f < 2000; f++) {
+            // Steered every frame, as the mic path does
+            rs.setRatioPpm(ppm * static_cast<float>(f % 7) / 6.0f);
+            size_t want = sizes[f % 4];
+            size_t need = rs.inputFor(want);
+            CHECK(need <= want + 2);
+            CHECK_EQ(rs.process(in, need, out, want), want);
+        }
+    }
+}
+
+static void test_tone_fidelity_under_drift() {
+    const double ppm = 300.0;
+    const double hz = 1000.0;
+    FractionalResampler rs;
+    rs.reset();
+    rs.setRatioPpm(static_cast<float>(ppm));
+
+    int16_t in[FRAME];
+    int16_t out[FRAME + 4];
+    size_t inPos = 0;
+    size_t outPos = 0;
+    double signal = 0.0;
+    double noise = 0.0;
+    for (int f = 0; f < 400; f++) {
+        for (size_t i = 0; i < FRAME; i++) in[i] = tone(static_cast<double>(inPos + i), hz);
+        inPos += FRAME;
+        size_t n = rs.process(in, FRAME, out, sizeof(out) / sizeof(out[0]));
+        for (size_t i = 0; i < n; i++, outPos++) {
+            if (outPos < 16) continue;   // Skip the start-up history
+            // Output k sits at input position k * step - 2 (two samples of delay)
+            double at = static_cast<double>(outPos) * (1.0 + ppm * 1e-6) - 2.0;
+            double ideal = 12000.0 * sin(2.0 * M_PI * hz * at / RATE);
+            signal += ideal * ideal;
+            noise += (out[i] - ideal) * (out[i] - ideal);
+        }
+    }
+    double snrDb = 10.0 * log10(signal / noise);
+    CHECK(snrDb > 50.0);
+}
+
+// ============================================================
+// DRIFT COMPENSATOR
+// ============================================================
+
+/**
+ * Closed loop: SCO produces frames driftPpm faster than I2S consumes them
+ * nominally; the compensator steers consumption. Returns the final ppm and
+ * the worst fill deviation after settling.
+ */
+static float simulateLoop(float driftPpm, float seconds, float* worstDeviation) {
+    const uint32_t target = 2;
+    DriftCompensator dc;
+    dc.reset();
+
+    double fill = target;
+    int updates = static_cast<int>(seconds * 1000.0f / 7.5f);
+    int settleAt = updates / 2;
+    *worstDeviation = 0.0f;
+    for (int u = 0; u < updates; u++) {
+        // Jitter buffer fill is only seen in whole frames
+        dc.update(static_cast<uint32_t>(fill < 0 ? 0 : lrint(fill)), target);
+        fill += (driftPpm - dc.ppm()) * 1e-6;
+        if (u >= settleAt) {
+            float dev = static_cast<float>(fabs(fill - target));
+            if (dev > *worstDeviation) *worstDeviation = dev;
+        }
+    }
+    return dc.ppm();
+}
+
+static void test_compensator_tracks_drift() {
+    const float drifts[] = {-400.0f, -50.0f, 150.0f, 400.0f};
+    for (float drift : drifts) {
+        float worst = 0.0f;
+        float ppm = simulateLoop(drift, 600.0f, &worst);
+        CHECK_NEAR(ppm, drift, 0.1f * fabsf(drift) + 10.0f);
+        CHECK(worst < 1.0f);
+    }
+}
+
+static void test_compensator_limits() {
+    float worst = 0.0f;
+    float ppm = simulateLoop(5000.0f, 60.0f, &worst);
+    CHECK_NEAR(ppm, DriftCompensator::MAX_PPM, 0.001);
+
+    DriftCompensator dc;
+    dc.reset();
+    CHECK_EQ(dc.ppm(), 0);
+    for (int i = 0; i < 100; i++) dc.update(2, 2);
+    CHECK_NEAR(dc.ppm(), 0.0f, 1e-6);
+}
+
+int main() {
+    RUN_TEST(test_unity_ratio_is_delayed_copy);
+    RUN_TEST(test_long_run_rate_matches_ppm);
+    RUN_TEST(test_input_for_yields_exact_output);
+    RUN_TEST(test_tone_fidelity_under_drift);
+    RUN_TEST(test_compensator_tracks_drift);
+    RUN_TEST(test_compensator_limits);
+    return HostTest::summary();
+}
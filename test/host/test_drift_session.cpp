@@ -0,0 +1,162 @@
+#include "HostTest.h"
+#include "Audio/AudioConfig.h"
+#include "Audio/DriftCompensator.h"
+#include "Audio/FractionalResampler.h"
+#include "Audio/JitterBuffer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+// Half an hour of SCO playout with the phone's clock off by +-200ppm,
+// through the real JitterBuffer, DriftCompensator and FractionalResampler
+// wired as AudioEngine wires them.
+//
+// Time is simulated. The producer pushes a frame every 7.5ms of the
+// phone's clock, with up to 1.5ms of arrival jitter. The consumer is the
+// engine loop: pop, drift update, resample, and the I2S output paced at
+// the badge's clock by the number of samples actually written. The same
+// session runs without the compensator (ratio held at 1:1) to show what
+// it saves. Each run reports underruns, trims, and the jitter-buffer
+// latency seen at each pop.
+
+static constexpr double SESSION_S = 30.0 * 60.0;
+static constexpr double JITTER_US = 1500.0;
+static constexpr float DRIFTS_PPM[] = {200.0f, -200.0f};
+static constexpr uint32_t SETTLE_S = 60;   // Latency range counted after this
+
+struct SessionResult {
+    JitterBuffer::Stats jb;
+    float finalPpm;
+    double meanLatencyMs;       // Jitter-buffer fill at each pop, after SETTLE_S
+    double minLatencyMs;
+    double maxLatencyMs;
+};
+
+/**
+ * One session at a link rate and phone clock error
+ * @param compensate false to hold the resampler at 1:1
+ */
+static SessionResult runSession(uint32_t rate, float driftPpm, bool compensate) {
+    static JitterBuffer jb;
+    DriftCompensator drift;
+    FractionalResampler resampler;
+    jb.reset(rate);
+    drift.reset();
+    resampler.reset();
+
+    const size_t frame = AudioConfig::frameSamples(rate);
+    const double framePeriodUs = AudioConfig::FRAME_DURATION_US / (1.0 + driftPpm * 1e-6);
+    const double frameMs = AudioConfig::FRAME_DURATION_US / 1000.0;
+
+    int16_t in[AudioConfig::MAX_FRAME_SIZE / 2];
+    int16_t popped[AudioConfig::MAX_FRAME_SIZE / 2];
+    int16_t out[FractionalResampler::MAX_INPUT];
+    for (size_t i = 0; i < frame; i++) {
+        in[i] = static_cast<int16_t>(8000.0 * sin(2.0 * M_PI * 440.0 * i / rate));
+    }
+
+    uint32_t seed = 4321;
+    uint64_t sent = 0;
+    double nextSendUs = 0.0;
+    double arrivalUs = 0.0;
+    double nextPlayUs = 0.0;   // The engine starts with the link
+    double latencySum = 0.0;
+    uint64_t latencyCount = 0;
+    SessionResult r;
+    r.minLatencyMs = 1e9;
+    r.maxLatencyMs = 0.0;
+
+    while (nextPlayUs < SESSION_S * 1e6) {
+        // Next arrival: the phone's frame clock plus jitter, never reordered
+        if (arrivalUs < nextSendUs) {
+            seed = seed * 1664525u + 1013904223u;
+            double jitter = JITTER_US * (seed >> 8) / 16777216.0;
+            arrivalUs = std::max(arrivalUs, nextSendUs + jitter);
+        }
+
+        if (arrivalUs <= nextPlayUs) {
+            jb.push(reinterpret_cast<const uint8_t*>(in), frame * sizeof(int16_t),
+                    static_cast<int64_t>(arrivalUs));
+            sent++;
+            nextSendUs = sent * framePeriodUs;
+            continue;
+        }
+
+        // Engine iteration; a miss plays a concealed frame of the nominal size
+        size_t len = jb.pop(reinterpret_cast<uint8_t*>(popped), sizeof(popped));
+        size_t samples = (len > 0) ? len / sizeof(int16_t) : frame;
+        if (compensate) {
+            drift.update(jb.fill(), jb.targetDepth());
+            resampler.setRatioPpm(drift.ppm());
+        }
+        size_t written = resampler.process(popped, samples, out, FractionalResampler::MAX_INPUT);
+
+        if (nextPlayUs >= SETTLE_S * 1e6) {
+            double latencyMs = jb.fill() * frameMs;
+            latencySum += latencyMs;
+            latencyCount++;
+            r.minLatencyMs = std::min(r.minLatencyMs, latencyMs);
+            r.maxLatencyMs = std::max(r.maxLatencyMs, latencyMs);
+        }
+
+        // The I2S clock takes what was written at the badge's nominal rate
+        nextPlayUs += written * 1e6 / rate;
+    }
+
+    r.jb = jb.getStats();
+    r.finalPpm = drift.ppm();
+    r.meanLatencyMs = latencyCount ? latencySum / latencyCount : 0.0;
+    return r;
+}
+
+static void printHeader() {
+    printf("  %6s %7s %6s %6s %6s %8s %17s\n", "rate", "drift", "comp", "under", "trim", "ppm", "jb ms min/avg/max");
+}
+
+static void printResult(uint32_t rate, float driftPpm, bool compensate, const SessionResult& r) {
+    printf("  %6u %+6.0f %6s %6u %6u %+8.1f %5.1f/%5.1f/%5.1f\n", static_cast<unsigned>(rate), driftPpm,
+           compensate ? "on" : "off", r.jb.underruns, r.jb.trimmed, r.finalPpm, r.minLatencyMs,
+           r.meanLatencyMs, r.maxLatencyMs);
+}
+
+// ============================================================
+// SESSIONS
+// ============================================================
+
+static void runRate(uint32_t rate) {
+    printHeader();
+    for (float drift : DRIFTS_PPM) {
+        SessionResult on = runSession(rate, drift, true);
+        SessionResult off = runSession(rate, drift, false);
+        printResult(rate, drift, true, on);
+        printResult(rate, drift, false, off);
+
+        // Compensated: no glitches in half an hour, latency held near target
+        CHECK_EQ(on.jb.underruns, 0);
+        CHECK_EQ(on.jb.trimmed, 0);
+        CHECK_EQ(on.jb.overruns, 0);
+        CHECK_NEAR(on.finalPpm, drift, 20.0f);
+        double frameMs = AudioConfig::FRAME_DURATION_US / 1000.0;
+        CHECK(on.maxLatencyMs <= (on.jb.targetDepth + JitterBuffer::TRIM_HYSTERESIS_FRAMES) * frameMs);
+
+        // Uncompensated, 30 minutes at 200ppm is 360ms: ~48 frames to trim,
+        // or as many underruns
+        uint32_t glitches = off.jb.underruns + off.jb.trimmed;
+        CHECK(glitches >= 20);
+    }
+}
+
+static void test_wideband_session() {
+    runRate(AudioConfig::SAMPLE_RATE_WIDEBAND);
+}
+
+static void test_narrowband_session() {
+    runRate(AudioConfig::SAMPLE_RATE_NARROWBAND);
+}
+
+int main() {
+    RUN_TEST(test_wideband_session);
+    RUN_TEST(test_narrowband_session);
+    return HostTest::summary();
+}
@@ -0,0 +1,73 @@
+#include "HostTest.h"
+#include "../DspVariantChecks.h"
+#include <cstdio>
+
+using DspVariantChecks::Report;
+
+// The reference with a wrapping (non-saturating) mix: the checks must see it
+struct WrappingMix : DspReference {
+    static void mixQ15(const int16_t* a, const int16_t* b, int16_t* out, size_t n) {
+        for (size_t i = 0; i < n; i++) out[i] = static_cast<int16_t>(a[i] + b[i]);
+    }
+};
+
+// The reference with a Q15 biquad that drops its state between calls
+struct StatelessBiquad : DspReference {
+    static void biquadCascadeQ15(const BiquadQ15* stages, int16_t* state, size_t stageCount,
+                                 const int16_t* in, int16_t* out, size_t n) {
+        for (size_t i = 0; i < 4 * stageCount; i++) state[i] = 0;
+        DspReference::biquadCascadeQ15(stages, state, stageCount, in, out, n);
+    }
+};
+
+// The reference with an int8 dot product that drops the tail past whole
+// 16-lane vectors, as a vector path without its scalar fixup would
+struct TruncatedDotQ7 : DspReference {
+    static int32_t dotProductQ7(const int8_t* a, const int8_t* b, size_t n) {
+        return DspReference::dotProductQ7(a, b, n & ~static_cast<size_t>(15));
+    }
+};
+
+static void test_xtensa_matches_reference() {
+    Report r;
+    DspVariantChecks::checkAll<DspXtensa>(r);
+    if (r.failures > 0) printf("  first mismatch: %s\n", r.first);
+    CHECK_EQ(r.failures, 0);
+    CHECK(r.checked > 10000);
+}
+
+static void test_reference_matches_itself() {
+    Report r;
+    DspVariantChecks::checkAll<DspReference>(r);
+    CHECK_EQ(r.failures, 0);
+}
+
+static void test_wrapping_mix_is_caught() {
+    Report r;
+    DspVariantChecks::checkAll<WrappingMix>(r);
+    CHECK(r.failures > 0);
+    CHECK(strncmp(r.first, "mixQ15", 6) == 0);
+}
+
+static void test_lost_biquad_state_is_caught() {
+    Report r;
+    DspVariantChecks::checkAll<StatelessBiquad>(r);
+    CHECK(r.failures > 0);
+    CHECK(strncmp(r.first, "biquadCascadeQ15", 16) == 0);
+}
+
+static void test_truncated_dot_q7_is_caught() {
+    Report r;
+    DspVariantChecks::checkAll<TruncatedDotQ7>(r);
+    CHECK(r.failures > 0);
+    CHECK(strncmp(r.first, "dotProductQ7", 12) == 0);
+}
+
+int main() {
+    RUN_TEST(test_xtensa_matches_reference);
+    RUN_TEST(test_reference_matches_itself);
+    RUN_TEST(test_wrapping_mix_is_caught);
+    RUN_TEST(test_lost_biquad_state_is_caught);
+    RUN_TEST(test_truncated_dot_q7_is_caught);
+    return HostTest::summary();
+}
@@ -0,0 +1,231 @@
+#include "HostTest.h"
+#include "Audio/EarconMixer.h"
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+typedef EarconMixer::Cue Cue;
+
+static constexpr uint32_t RATE = AudioConfig::I2S_SAMPLE_RATE;
+static constexpr size_t FRAME = AudioConfig::FRAME_SAMPLES_16K;
+
+static int16_t saturate16(int32_t v) {
+    return static_cast<int16_t>(std::min(std::max(v, static_cast<int32_t>(-32768)), static_cast<int32_t>(32767)));
+}
+
+// A cue sample at a Q15 gain, as mix() scales it
+static int16_t scaled(int16_t sample, int16_t gain) {
+    return saturate16((static_cast<int32_t>(sample) * gain) >> 15);
+}
+
+static std::vector<int16_t> clipOf(const EarconMixer& mixer, Cue cue) {
+    size_t length = 0;
+    const int16_t* data = mixer.clip(cue, &length);
+    return std::vector<int16_t>(data, data + length);
+}
+
+/**
+ * Mix into a stream of far-end audio in frames of varying size
+ * @return The mixed stream
+ */
+static std::vector<int16_t> mixStream(EarconMixer& mixer, const std::vector<int16_t>& far) {
+    static const size_t SIZES[] = {FRAME, FRAME + 1, FRAME - 1, 7, FRAME};
+    std::vector<int16_t> out(far);
+    size_t pos = 0;
+    for (size_t f = 0; pos < out.size(); f++) {
+        size_t n = std::min(SIZES[f % 5], out.size() - pos);
+        mixer.mix(&out[pos], n);
+        pos += n;
+    }
+    return out;
+}
+
+// ============================================================
+// CLIPS
+// ============================================================
+
+static void test_clips_are_rendered_at_the_i2s_rate() {
+    static EarconMixer mixer;
+    mixer.init();
+
+    // 60ms and 60+80ms of tone, padded to 8 samples
+    CHECK_EQ(clipOf(mixer, Cue::Trigger).size(), (RATE * 60 / 1000 + 7) / 8 * 8);
+    CHECK_EQ(clipOf(mixer, Cue::SessionStart).size(), (RATE * 140 / 1000 + 7) / 8 * 8);
+    CHECK_EQ(clipOf(mixer, Cue::SessionStop).size(), (RATE * 140 / 1000 + 7) / 8 * 8);
+
+    const Cue cues[] = {Cue::Trigger, Cue::SessionStart, Cue::SessionStop};
+    for (Cue cue : cues) {
+        std::vector<int16_t> clip = clipOf(mixer, cue);
+        int32_t peak = 0;
+        for (int16_t s : clip) peak = std::max(peak, abs(static_cast<int32_t>(s)));
+
+        // -6dBFS, with raised-cosine edges so a cue never clicks in or out
+        CHECK(peak > 16000 && peak <= 16384);
+        CHECK(abs(clip.front()) < 200);
+        CHECK(abs(clip.back()) < 200);
+    }
+
+    size_t length = 1;
+    CHECK(mixer.clip(Cue::COUNT, &length) == nullptr);
+    CHECK_EQ(length, 0);
+}
+
+// ============================================================
+// MIXING
+// ============================================================
+
+static void test_cue_is_added_over_far_end_audio() {
+    static EarconMixer mixer;
+    mixer.init();
+    std::vector<int16_t> clip = clipOf(mixer, Cue::SessionStart);
+
+    // Far-end audio keeps playing under the cue, sample-contiguous across
+    // frames of any size
+    std::vector<int16_t> far(clip.size() + 3 * FRAME);
+    for (size_t i = 0; i < far.size(); i++) far[i] = static_cast<int16_t>((i * 37) % 2000 - 1000);
+
+    CHECK(mixer.play(Cue::SessionStart));
+    std::vector<int16_t> out = mixStream(mixer, far);
+
+    size_t wrong = 0;
+    for (size_t i = 0; i < far.size(); i++) {
+        int16_t cue = (i < clip.size()) ? scaled(clip[i], EarconMixer::DEFAULT_GAIN) : 0;
+        wrong += (out[i] != saturate16(far[i] + cue));
+    }
+    CHECK_EQ(wrong, 0);
+    CHECK_EQ(mixer.getStats().played, 1);
+}
+
+static void test_idle_mixer_leaves_audio_untouched() {
+    static EarconMixer mixer;
+    mixer.init();
+    std::vector<int16_t> buf(FRAME, 1234);
+    CHECK_EQ(mixer.mix(buf.data(), FRAME), 0);
+    CHECK(std::all_of(buf.begin(), buf.end(), [](int16_t s) { return s == 1234; }));
+}
+
+static void test_loud_far_end_saturates_instead_of_wrapping() {
+    static EarconMixer mixer;
+    mixer.init();
+    std::vector<int16_t> clip = clipOf(mixer, Cue::Trigger);
+
+    // Full-scale far end and a full-gain cue: the sum clips to the rails
+    std::vector<int16_t> far(clip.size());
+    for (size_t i = 0; i < far.size(); i++) far[i] = (clip[i] >= 0) ? 30000 : -30000;
+
+    CHECK(mixer.play(Cue::Trigger, 32767));
+    std::vector<int16_t> out = mixStream(mixer, far);
+
+    size_t wrapped = 0;
+    size_t railed = 0;
+    for (size_t i = 0; i < far.size(); i++) {
+        wrapped += (far[i] > 0) ? (out[i] < far[i]) : (out[i] > far[i]);
+        railed += (out[i] == 32767 || out[i] == -32768);
+        CHECK_EQ(out[i], saturate16(far[i] + scaled(clip[i], 32767)));
+    }
+    CHECK_EQ(wrapped, 0);
+    CHECK(railed > far.size() / 2);
+}
+
+static void test_overlapping_cues_sum_with_their_own_gain() {
+    static EarconMixer mixer;
+    mixer.init();
+    std::vector<int16_t> start = clipOf(mixer, Cue::SessionStart);
+    std::vector<int16_t> trigger = clipOf(mixer, Cue::Trigger);
+
+    // The trigger joins two frames into the start cue, at half the gain
+    std::vector<int16_t> out(start.size(), 0);
+    CHECK(mixer.play(Cue::SessionStart, 32767));
+    CHECK_EQ(mixer.mix(&out[0], FRAME), 1);
+    CHECK_EQ(mixer.mix(&out[FRAME], FRAME), 1);
+    CHECK(mixer.play(Cue::Trigger, 16384));
+    CHECK_EQ(mixer.mix(&out[2 * FRAME], FRAME), 2);
+    for (size_t pos = 3 * FRAME; pos < out.size(); pos += FRAME) {
+        mixer.mix(&out[pos], std::min(FRAME, out.size() - pos));
+    }
+
+    size_t wrong = 0;
+    for (size_t i = 0; i < out.size(); i++) {
+        int16_t expected = scaled(start[i], 32767);
+        if (i >= 2 * FRAME && i - 2 * FRAME < trigger.size()) {
+            expected = saturate16(expected + scaled(trigger[i - 2 * FRAME], 16384));
+        }
+        wrong += (out[i] != expected);
+    }
+    CHECK_EQ(wrong, 0);
+    CHECK_EQ(mixer.getStats().replaced, 0);
+}
+
+// ============================================================
+// VOICES AND QUEUE
+// ============================================================
+
+static void test_third_cue_replaces_the_one_nearest_its_end() {
+    static EarconMixer mixer;
+    mixer.init();
+    std::vector<int16_t> trigger = clipOf(mixer, Cue::Trigger);
+    std::vector<int16_t> stop = clipOf(mixer, Cue::SessionStop);
+
+    std::vector<int16_t> buf(FRAME, 0);
+    mixer.play(Cue::SessionStart, 32767);
+    mixer.mix(buf.data(), FRAME);
+    mixer.play(Cue::Trigger, 32767);
+    mixer.mix(buf.data(), FRAME);
+
+    // The trigger (shorter) has less left than the start cue: it goes
+    mixer.play(Cue::SessionStop, 32767);
+    std::vector<int16_t> out(stop.size(), 0);
+    for (size_t pos = 0; pos < out.size(); pos += FRAME) {
+        mixer.mix(&out[pos], std::min(FRAME, out.size() - pos));
+    }
+    CHECK_EQ(mixer.getStats().replaced, 1);
+    CHECK_EQ(mixer.getStats().played, 3);
+
+    // Past where the trigger would have ended, only start + stop remain
+    std::vector<int16_t> start = clipOf(mixer, Cue::SessionStart);
+    size_t wrong = 0;
+    for (size_t i = trigger.size(); i + 2 * FRAME < start.size() && i < stop.size(); i++) {
+        int16_t expected = saturate16(scaled(start[i + 2 * FRAME], 32767) + scaled(stop[i], 32767));
+        wrong += (out[i] != expected);
+    }
+    CHECK_EQ(wrong, 0);
+}
+
+static void test_full_queue_drops_requests() {
+    static EarconMixer mixer;
+    mixer.init();
+    for (int i = 0; i < 4; i++) CHECK(mixer.play(Cue::Trigger));
+    CHECK(!mixer.play(Cue::Trigger));
+    CHECK(!mixer.play(Cue::COUNT));
+    CHECK_EQ(mixer.getStats().dropped, 2);
+
+    // Draining the queue makes room again
+    int16_t buf[FRAME] = {0};
+    mixer.mix(buf, FRAME);
+    CHECK(mixer.play(Cue::Trigger));
+}
+
+static void test_reset_silences_active_cues() {
+    static EarconMixer mixer;
+    mixer.init();
+    int16_t buf[FRAME] = {0};
+    mixer.play(Cue::SessionStart);
+    mixer.mix(buf, FRAME);
+    mixer.reset();
+
+    int16_t quiet[FRAME] = {0};
+    CHECK_EQ(mixer.mix(quiet, FRAME), 0);
+    CHECK(std::all_of(quiet, quiet + FRAME, [](int16_t s) { return s == 0; }));
+}
+
+int main() {
+    RUN_TEST(test_clips_are_rendered_at_the_i2s_rate);
+    RUN_TEST(test_cue_is_added_over_far_end_audio);
+    RUN_TEST(test_idle_mixer_leaves_audio_untouched);
+    RUN_TEST(test_loud_far_end_saturates_instead_of_wrapping);
+    RUN_TEST(test_overlapping_cues_sum_with_their_own_gain);
+    RUN_TEST(test_third_cue_replaces_the_one_nearest_its_end);
+    RUN_TEST(test_full_queue_drops_requests);
+    RUN_TEST(test_reset_silences_active_cues);
+    return HostTest::summary();
+}
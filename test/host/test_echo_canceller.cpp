@@ -0,0 +1,197 @@
+#include "HostTest.h"
+#include "Audio/EchoCanceller.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+static constexpr size_t FRAME = 120;          // 7.5ms at 16kHz, as the SCO mic path
+static constexpr size_t BULK_DELAY = 480;     // EchoCanceller's reference delay
+static constexpr size_t ACOUSTIC_DELAY = 40;  // 2.5ms speaker -> mic beyond that
+static constexpr size_t TAIL = 160;           // 10ms room response
+static constexpr size_t ECHO_DELAY = BULK_DELAY + ACOUSTIC_DELAY;
+static constexpr size_t HISTORY = ECHO_DELAY + TAIL;
+
+/**
+ * Speaker, echo path and near-end talker for one simulated call
+ */
+struct EchoRoom {
+    float path[TAIL];
+    int16_t spk[HISTORY + FRAME] = {};
+    uint32_t seed = 12345;
+    float colour = 0.0f;
+
+    explicit EchoRoom(float gain, uint32_t pathSeed = 1) {
+        // Decaying, sign-alternating taps: a crude small-room response
+        uint32_t s = pathSeed;
+        for (size_t j = 0; j < TAIL; j++) {
+            s = s * 1664525u + 1013904223u;
+            float r = static_cast<float>(static_cast<int32_t>(s)) / 2147483648.0f;
+            path[j] = gain * r * expf(-static_cast<float>(j) / 30.0f);
+        }
+    }
+
+    // Coloured noise at speech level as the far-end (speaker) signal
+    int16_t nextSpeaker() {
+        seed = seed * 1664525u + 1013904223u;
+        float white = static_cast<float>(static_cast<int32_t>(seed)) / 2147483648.0f;
+        colour = 0.8f * colour + white;
+        return static_cast<int16_t>(3000.0f * colour);
+    }
+
+    /**
+     * Advance one frame: speaker out, and mic = echo (+ near-end)
+     */
+    void frame(int16_t* speaker, int16_t* mic, const int16_t* nearEnd, bool speakerOn) {
+        memmove(spk, spk + FRAME, HISTORY * sizeof(int16_t));
+        for (size_t i = 0; i < FRAME; i++) {
+            spk[HISTORY + i] = speakerOn ? nextSpeaker() : 0;
+            speaker[i] = spk[HISTORY + i];
+
+            float echo = 0.0f;
+            for (size_t j = 0; j < TAIL; j++) {
+                echo += path[j] * spk[HISTORY + i - ECHO_DELAY - j];
+            }
+            if (nearEnd) echo += nearEnd[i];
+            mic[i] = static_cast<int16_t>(lrintf(echo));
+        }
+    }
+};
+
+static double power(const int16_t* x, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++) sum += static_cast<double>(x[i]) * x[i];
+    return sum / static_cast<double>(n);
+}
+
+/**
+ * Run frames of echo only; returns the ERLE (mic vs. output power) over the
+ * last second
+ */
+static double runEcho(EchoCanceller& aec, EchoRoom& room, int frames) {
+    int16_t speaker[FRAME];
+    int16_t mic[FRAME];
+    int16_t out[FRAME];
+    double micPower = 0.0;
+    double outPower = 0.0;
+    int measureFrom = frames - 133;
+    for (int f = 0; f < frames; f++) {
+        room.frame(speaker, mic, nullptr, true);
+        aec.pushReference(speaker, FRAME);
+        aec.process(mic, out, FRAME);
+        if (f >= measureFrom) {
+            micPower += power(mic, FRAME);
+            outPower += power(out, FRAME);
+        }
+    }
+    return 10.0 * log10(micPower / (outPower + 1.0));
+}
+
+static void test_converges_on_echo() {
+    EchoCanceller aec;
+    aec.reset();
+    EchoRoom room(0.5f);
+
+    double erle = runEcho(aec, room, 667);   // 5s
+    CHECK(erle > 20.0);
+    EchoCanceller::Stats s = aec.getStats();
+    CHECK(s.erleDb > 15.0f);
+    CHECK_EQ(s.resets, 0);
+    CHECK_EQ(s.refUnderruns, 0);
+}
+
+static void test_idle_speaker_passes_mic_through() {
+    EchoCanceller aec;
+    aec.reset();
+
+    // No reference: output is the mic one block (64 samples) later
+    int16_t mic[FRAME];
+    int16_t out[FRAME];
+    int16_t all[FRAME * 10];
+    int16_t got[FRAME * 10];
+    for (size_t f = 0; f < 10; f++) {
+        for (size_t i = 0; i < FRAME; i++) mic[i] = static_cast<int16_t>((f * FRAME + i) * 37);
+        memcpy(all + f * FRAME, mic, sizeof(mic));
+        aec.process(mic, out, FRAME);
+        memcpy(got + f * FRAME, out, sizeof(out));
+    }
+    for (size_t i = 0; i < 64; i++) CHECK_EQ(got[i], 0);
+    bool same = true;
+    for (size_t i = 64; i < FRAME * 10; i++) same = same && (got[i] == all[i - 64]);
+    CHECK(same);
+}
+
+static void test_double_talk_keeps_near_end() {
+    EchoCanceller aec;
+    aec.reset();
+    EchoRoom room(0.5f);
+    runEcho(aec, room, 667);
+    uint32_t frozenBefore = aec.getStats().frozenBlocks;
+
+    // Near-end talker at the echo's level for 1s: it must come through and
+    // must not wreck the converged filter
+    int16_t speaker[FRAME];
+    int16_t mic[FRAME];
+    int16_t out[FRAME];
+    int16_t nearEnd[FRAME];
+    double nearPower = 0.0;
+    double keptPower = 0.0;
+    size_t n = 0;
+    for (int f = 0; f < 133; f++) {
+        for (size_t i = 0; i < FRAME; i++, n++) {
+            nearEnd[i] = static_cast<int16_t>(4000.0 * sin(2.0 * M_PI * 300.0 * n / 16000.0));
+        }
+        room.frame(speaker, mic, nearEnd, true);
+        aec.pushReference(speaker, FRAME);
+        aec.process(mic, out, FRAME);
+        if (f > 10) {
+            nearPower += power(nearEnd, FRAME);
+            keptPower += power(out, FRAME);
+        }
+    }
+    double keptDb = 10.0 * log10(keptPower / nearPower);
+    CHECK(keptDb > -3.0);
+    CHECK(aec.getStats().frozenBlocks > frozenBefore);
+
+    // Echo alone again: still cancelled without re-learning from scratch
+    double erle = runEcho(aec, room, 133);
+    CHECK(erle > 15.0);
+}
+
+static void test_reference_stall_reprimes() {
+    EchoCanceller aec;
+    aec.reset();
+    EchoRoom room(0.5f);
+    runEcho(aec, room, 200);
+
+    // Speaker stops delivering: one underrun, then the mic path carries on
+    int16_t mic[FRAME] = {0};
+    int16_t out[FRAME];
+    for (int f = 0; f < 10; f++) aec.process(mic, out, FRAME);
+    CHECK_EQ(aec.getStats().refUnderruns, 1);
+
+    // And it re-primes once the reference flows again
+    double erle = runEcho(aec, room, 400);
+    CHECK(erle > 15.0);
+}
+
+static void test_path_change_reconverges() {
+    EchoCanceller aec;
+    aec.reset();
+    EchoRoom room(0.5f);
+    runEcho(aec, room, 667);
+
+    // Badge moved: different room response, same far end
+    EchoRoom moved(0.7f, 99);
+    moved.seed = room.seed;
+    double erle = runEcho(aec, moved, 1333);
+    CHECK(erle > 15.0);
+}
+
+int main() {
+    RUN_TEST(test_converges_on_echo);
+    RUN_TEST(test_idle_speaker_passes_mic_through);
+    RUN_TEST(test_double_talk_keeps_near_end);
+    RUN_TEST(test_reference_stall_reprimes);
+    RUN_TEST(test_path_change_reconverges);
+    return HostTest::summary();
+}
@@ -0,0 +1,203 @@
+#include "HostTest.h"
+#include "Audio/HalfbandConverter.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+static std::vector<int16_t> tone(float freq, uint32_t rate, size_t samples, float amplitude) {
+    std::vector<int16_t> out(samples);
+    for (size_t n = 0; n < samples; n++) {
+        out[n] = static_cast<int16_t>(amplitude * sinf(2.0f * static_cast<float>(M_PI) * freq * n / rate));
+    }
+    return out;
+}
+
+// Level of one frequency (Goertzel), relative to a full-scale sine, in dB
+static float levelDb(const int16_t* x, size_t samples, float freq, uint32_t rate) {
+    float coeff = 2.0f * cosf(2.0f * static_cast<float>(M_PI) * freq / rate);
+    float s1 = 0.0f;
+    float s2 = 0.0f;
+    for (size_t n = 0; n < samples; n++) {
+        float s = x[n] + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s;
+    }
+    float power = s1 * s1 + s2 * s2 - coeff * s1 * s2;
+    float amplitude = 2.0f * sqrtf(power > 0.0f ? power : 0.0f) / samples;
+    return 20.0f * log10f(amplitude / 32767.0f + 1e-9f);
+}
+
+static std::vector<int16_t> upsample(HalfbandUpsampler& up, const std::vector<int16_t>& in, size_t block) {
+    std::vector<int16_t> out(2 * in.size());
+    for (size_t pos = 0; pos < in.size(); pos += block) {
+        size_t n = (in.size() - pos < block) ? in.size() - pos : block;
+        up.process(&in[pos], n, &out[2 * pos]);
+    }
+    return out;
+}
+
+static std::vector<int16_t> downsample(HalfbandDownsampler& down, const std::vector<int16_t>& in, size_t block) {
+    std::vector<int16_t> out(in.size() / 2);
+    for (size_t pos = 0; pos < in.size(); pos += block) {
+        size_t n = (in.size() - pos < block) ? in.size() - pos : block;
+        down.process(&in[pos], n, &out[pos / 2]);
+    }
+    return out;
+}
+
+// ============================================================
+// UPSAMPLER
+// ============================================================
+
+static void test_upsampled_tone_keeps_level_and_delay() {
+    HalfbandUpsampler up;
+    up.reset();
+    std::vector<int16_t> in = tone(1000.0f, 8000, 960, 16000.0f);
+    std::vector<int16_t> out = upsample(up, in, 60);
+
+    // Group delay is 15.5 input samples, 31 output samples
+    std::vector<int16_t> ideal = tone(1000.0f, 16000, out.size() + 31, 16000.0f);
+    float err = 0.0f;
+    float sig = 0.0f;
+    for (size_t n = 200; n < out.size(); n++) {
+        float ref = ideal[n - 31];
+        err += (out[n] - ref) * (out[n] - ref);
+        sig += ref * ref;
+    }
+    CHECK(10.0f * log10f(sig / err) > 40.0f);
+}
+
+static void test_upsampling_image_is_rejected() {
+    HalfbandUpsampler up;
+    up.reset();
+    std::vector<int16_t> in = tone(1000.0f, 8000, 960, 16000.0f);
+    std::vector<int16_t> out = upsample(up, in, 120);
+
+    // 1kHz at 8kHz images to 7kHz at 16kHz
+    const int16_t* settled = &out[256];
+    size_t len = out.size() - 256;
+    float wanted = levelDb(settled, len, 1000.0f, 16000);
+    float image = levelDb(settled, len, 7000.0f, 16000);
+    CHECK_NEAR(wanted, 20.0f * log10f(16000.0f / 32767.0f), 0.1f);
+    CHECK(wanted - image > 65.0f);
+}
+
+static void test_upsampler_full_scale_saturates() {
+    HalfbandUpsampler up;
+    up.reset();
+
+    // A full-scale step overshoots (Gibbs); it must clip, not wrap
+    std::vector<int16_t> in(256, -32768);
+    for (size_t n = 128; n < in.size(); n++) in[n] = 32767;
+    std::vector<int16_t> out = upsample(up, in, 128);
+
+    // The step lands 31 output samples late; from there on the overshoot
+    // is clipped to +32767 and nothing wraps negative
+    bool wrapped = false;
+    bool clipped = false;
+    for (size_t n = 2 * 128 + 33; n < out.size(); n++) {
+        if (out[n] < 0) wrapped = true;
+        if (out[n] == 32767) clipped = true;
+    }
+    CHECK(!wrapped);
+    CHECK(clipped);
+}
+
+// ============================================================
+// DOWNSAMPLER
+// ============================================================
+
+static void test_downsampled_passband_is_flat() {
+    const float freqs[] = {300.0f, 1000.0f, 3000.0f, 3400.0f};
+    for (float freq : freqs) {
+        HalfbandDownsampler down;
+        down.reset();
+        std::vector<int16_t> out = downsample(down, tone(freq, 16000, 1920, 16000.0f), 120);
+        float level = levelDb(&out[64], out.size() - 64, freq, 8000);
+        CHECK_NEAR(level, 20.0f * log10f(16000.0f / 32767.0f), 0.2f);
+    }
+}
+
+static void test_downsampler_rejects_above_nyquist() {
+    // 5kHz and 6kHz would alias to 3kHz and 2kHz
+    const float freqs[] = {5000.0f, 6000.0f};
+    for (float freq : freqs) {
+        HalfbandDownsampler down;
+        down.reset();
+        std::vector<int16_t> out = downsample(down, tone(freq, 16000, 1920, 16000.0f), 120);
+        float alias = levelDb(&out[64], out.size() - 64, 8000.0f - freq, 8000);
+        CHECK(alias < 20.0f * log10f(16000.0f / 32767.0f) - 65.0f);
+    }
+}
+
+// ============================================================
+// STREAMING
+// ============================================================
+
+static void test_block_size_does_not_change_output() {
+    std::vector<int16_t> in = tone(440.0f, 16000, 2048, 12000.0f);
+    for (size_t n = 0; n < in.size(); n += 37) in[n] = static_cast<int16_t>(-in[n]);   // Some broadband content
+
+    HalfbandDownsampler a;
+    HalfbandDownsampler b;
+    a.reset();
+    b.reset();
+    CHECK(downsample(a, in, 256) == downsample(b, in, 34));
+
+    std::vector<int16_t> narrow(in.begin(), in.begin() + 1024);
+    HalfbandUpsampler c;
+    HalfbandUpsampler d;
+    c.reset();
+    d.reset();
+    CHECK(upsample(c, narrow, 128) == upsample(d, narrow, 7));
+}
+
+static void test_in_place_matches_separate_buffers() {
+    std::vector<int16_t> in = tone(1000.0f, 8000, 120, 10000.0f);
+
+    HalfbandUpsampler a;
+    HalfbandUpsampler b;
+    a.reset();
+    b.reset();
+    std::vector<int16_t> separate(240);
+    a.process(in.data(), 120, separate.data());
+    std::vector<int16_t> inPlace(240);
+    std::copy(in.begin(), in.end(), inPlace.begin());
+    b.process(inPlace.data(), 120, inPlace.data());
+    CHECK(separate == inPlace);
+
+    HalfbandDownsampler c;
+    HalfbandDownsampler d;
+    c.reset();
+    d.reset();
+    std::vector<int16_t> wide = tone(1000.0f, 16000, 240, 10000.0f);
+    std::vector<int16_t> out(120);
+    c.process(wide.data(), 240, out.data());
+    d.process(wide.data(), 240, wide.data());
+    CHECK(std::equal(out.begin(), out.end(), wide.begin()));
+}
+
+static void test_round_trip_preserves_speech_band() {
+    HalfbandDownsampler down;
+    HalfbandUpsampler up;
+    down.reset();
+    up.reset();
+    std::vector<int16_t> in = tone(800.0f, 16000, 3840, 16000.0f);
+    std::vector<int16_t> narrow = downsample(down, in, 120);
+    std::vector<int16_t> out = upsample(up, narrow, 60);
+
+    float level = levelDb(&out[256], out.size() - 256, 800.0f, 16000);
+    CHECK_NEAR(level, 20.0f * log10f(16000.0f / 32767.0f), 0.2f);
+}
+
+int main() {
+    RUN_TEST(test_upsampled_tone_keeps_level_and_delay);
+    RUN_TEST(test_upsampling_image_is_rejected);
+    RUN_TEST(test_upsampler_full_scale_saturates);
+    RUN_TEST(test_downsampled_passband_is_flat);
+    RUN_TEST(test_downsampler_rejects_above_nyquist);
+    RUN_TEST(test_block_size_does_not_change_output);
+    RUN_TEST(test_in_place_matches_separate_buffers);
+    RUN_TEST(test_round_trip_preserves_speech_band);
+    return HostTest::summary();
+}
@@ -0,0 +1,326 @@
+#include "HostTest.h"
+#include "Audio/JitterBuffer.h"
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+static constexpr size_t FRAME_BYTES = AudioConfig::FRAME_SIZE_16K;   // 7.5ms at 16kHz
+static constexpr int64_t FRAME_US = AudioConfig::FRAME_DURATION_US;
+
+// Frame whose samples all carry its sequence number
+static void makeFrame(uint8_t* frame, uint16_t seq) {
+    int16_t* samples = reinterpret_cast<int16_t*>(frame);
+    for (size_t i = 0; i < FRAME_BYTES / 2; i++) samples[i] = static_cast<int16_t>(seq);
+}
+
+static int16_t frameSeq(const uint8_t* frame) {
+    return reinterpret_cast<const int16_t*>(frame)[0];
+}
+
+// Expected target for a jitter estimate: 1 + ceil(3J / 7500), capped at 5
+static uint32_t depthFor(uint32_t jitterUs) {
+    uint32_t depth = 1 + (3 * jitterUs + FRAME_US - 1) / FRAME_US;
+    return (depth > JitterBuffer::MAX_DEPTH_FRAMES) ? JitterBuffer::MAX_DEPTH_FRAMES : depth;
+}
+
+/**
+ * Start a stream the way the firmware does: reset(), then the playout
+ * task's next pop() applies the flush before the first frame arrives
+ */
+static void startStream(JitterBuffer& jb, uint32_t rate = 16000) {
+    uint8_t out[AudioConfig::MAX_FRAME_SIZE];
+    jb.reset(rate);
+    CHECK_EQ(jb.pop(out, sizeof(out)), 0);
+}
+
+/**
+ * Push n frames whose arrival alternates between on time and offsetUs
+ * late, starting at sequence seq
+ */
+static void pushJittered(JitterBuffer& jb, uint16_t& seq, int n, int64_t offsetUs, bool popEach) {
+    uint8_t frame[FRAME_BYTES];
+    uint8_t out[AudioConfig::MAX_FRAME_SIZE];
+    for (int i = 0; i < n; i++) {
+        makeFrame(frame, seq);
+        int64_t arrival = seq * FRAME_US + ((seq & 1) ? offsetUs : 0);
+        jb.push(frame, FRAME_BYTES, arrival);
+        seq++;
+        if (popEach) jb.pop(out, sizeof(out));
+    }
+}
+
+// ============================================================
+// RING
+// ============================================================
+
+static void test_frames_are_copied_in_order() {
+    JitterBuffer jb;
+    startStream(jb);
+    uint8_t frame[FRAME_BYTES];
+    for (uint16_t i = 0; i < 3; i++) {
+        makeFrame(frame, i + 1);
+        CHECK(jb.push(frame, FRAME_BYTES, i * FRAME_US));
+    }
+    // The stack reuses its callback buffer as soon as push() returns
+    memset(frame, 0x55, sizeof(frame));
+
+    uint8_t out[AudioConfig::MAX_FRAME_SIZE];
+    for (int i = 1; i <= 3; i++) {
+        CHECK_EQ(jb.pop(out, sizeof(out)), FRAME_BYTES);
+        CHECK_EQ(frameSeq(out), i);
+    }
+    JitterBuffer::Stats s = jb.getStats();
+    CHECK_EQ(s.framesIn, 3);
+    CHECK_EQ(s.framesOut, 3);
+    CHECK_EQ(s.fill, 0);
+}
+
+static void test_oversized_packet_split_across_slots() {
+    JitterBuffer jb;
+    startStream(jb);
+    uint8_t packet[FRAME_BYTES + 40];
+    memset(packet, 1, FRAME_BYTES);
+    memset(packet + FRAME_BYTES, 2, 40);
+    CHECK(jb.push(packet, sizeof(packet), 0));
+    CHECK_EQ(jb.fill(), 2);
+
+    uint8_t out[AudioConfig::MAX_FRAME_SIZE];
+    CHECK_EQ(jb.pop(out, sizeof(out)), FRAME_BYTES);
+    CHECK_EQ(out[0], 1);
+    CHECK_EQ(jb.pop(out, sizeof(out)), 40);
+    CHECK_EQ(out[0], 2);
+}
+
+static void test_full_ring_drops_and_counts_overrun() {
+    JitterBuffer jb;
+    startStream(jb);
+    uint8_t frame[FRAME_BYTES];
+    for (uint16_t i = 0; i < JitterBuffer::CAPACITY_FRAMES; i++) {
+        makeFrame(frame, i);
+        CHECK(jb.push(frame, FRAME_BYTES, i * FRAME_US));
+    }
+    makeFrame(frame, 99);
+    CHECK(!jb.push(frame, FRAME_BYTES, JitterBuffer::CAPACITY_FRAMES * FRAME_US));
+
+    JitterBuffer::Stats s = jb.getStats();
+    CHECK_EQ(s.overruns, 1);
+    CHECK_EQ(s.framesIn, JitterBuffer::CAPACITY_FRAMES);
+    CHECK_EQ(s.fill, JitterBuffer::CAPACITY_FRAMES);
+}
+
+static void test_reset_flushes_and_clears_counters() {
+    JitterBuffer jb;
+    startStream(jb);
+    uint8_t frame[FRAME_BYTES];
+    makeFrame(frame, 1);
+    for (int i = 0; i < 10; i++) jb.push(frame, FRAME_BYTES, i * FRAME_US);
+    uint8_t out[AudioConfig::MAX_FRAME_SIZE];
+    jb.pop(out, sizeof(out));
+
+    jb.reset(8000);
+    CHECK_EQ(jb.sampleRate(), 8000);
+    // Each side applies the reset on its next call
+    CHECK_EQ(jb.pop(out, sizeof(out)), 0);
+    makeFrame(frame, 7);
+    jb.push(frame, AudioConfig::FRAME_SIZE_8K, 0);
+
+    JitterBuffer::Stats s = jb.getStats();
+    CHECK_EQ(s.framesIn, 1);
+    CHECK_EQ(s.overruns, 0);
+    CHECK_EQ(s.framesOut, 0);
+    CHECK_EQ(s.underruns, 0);
+    CHECK_EQ(s.fill, 1);
+    CHECK_EQ(jb.pop(out, sizeof(out)), AudioConfig::FRAME_SIZE_8K);
+    CHECK_EQ(frameSeq(out), 7);
+}
+
+// ============================================================
+// ADAPTIVE DEPTH
+// ============================================================
+
+static void test_steady_arrivals_keep_minimum_depth() {
+    JitterBuffer jb;
+    startStream(jb);
+    uint16_t seq = 0;
+    pushJittered(jb, seq, 200, 0, true);
+    JitterBuffer::Stats s = jb.getStats();
+    CHECK_EQ(s.jitterUs, 0);
+    CHECK_EQ(s.targetDepth, JitterBuffer::MIN_DEPTH_FRAMES);
+    CHECK_EQ(s.underruns, 0);
+}
+
+static void test_depth_follows_jitter_rule() {
+    // |D| settles at the offset, so J does too
+    const int64_t offsets[] = {1000, 2500, 6000, 9000};
+    for (int64_t offset : offsets) {
+        JitterBuffer jb;
+        startStream(jb);
+        uint16_t seq = 0;
+        pushJittered(jb, seq, 400, offset, true);
+        JitterBuffer::Stats s = jb.getStats();
+        CHECK_NEAR(s.jitterUs, offset, offset / 50);
+        CHECK_EQ(s.targetDepth, depthFor(s.jitterUs));
+    }
+}
+
+static void test_depth_capped_at_maximum() {
+    JitterBuffer jb;
+    startStream(jb);
+    uint16_t seq = 0;
+    pushJittered(jb, seq, 400, 30000, true);
+    JitterBuffer::Stats s = jb.getStats();
+    CHECK(1 + (3 * s.jitterUs) / FRAME_US > JitterBuffer::MAX_DEPTH_FRAMES);
+    CHECK_EQ(s.targetDepth, JitterBuffer::MAX_DEPTH_FRAMES);
+    // 5 frames of 7.5ms stay inside the 50ms budget
+    CHECK(s.targetDepth * FRAME_US < 50000);
+}
+
+static void test_stalls_beyond_budget_are_clamped() {
+    JitterBuffer jb;
+    startStream(jb);
+    uint16_t seq = 0;
+    pushJittered(jb, seq, 50, 0, true);
+
+    // A 2s link re-setup counts as one MAX_LATENCY_US deviation, not 2s
+    uint8_t frame[FRAME_BYTES];
+    makeFrame(frame, seq);
+    jb.push(frame, FRAME_BYTES, seq * FRAME_US + 2000000);
+    CHECK(jb.getStats().jitterUs <= AudioConfig::MAX_LATENCY_US / 16 + 1);
+}
+
+// ============================================================
+// PLAYOUT
+// ============================================================
+
+static void test_primes_to_target_before_playing() {
+    JitterBuffer jb;
+    startStream(jb);
+    uint16_t seq = 0;
+    // Build up a target of 4 frames without consuming, then drain
+    pushJittered(jb, seq, 400, 6000, true);
+    uint32_t target = jb.targetDepth();
+    CHECK_EQ(target, 4);
+
+    uint8_t out[AudioConfig::MAX_FRAME_SIZE];
+    while (jb.pop(out, sizeof(out)) > 0) {}
+    CHECK_EQ(jb.getStats().underruns, 1);
+
+    // Re-priming: nothing comes out until target frames are buffered
+    uint8_t frame[FRAME_BYTES];
+    for (uint32_t i = 0; i < target - 1; i++) {
+        makeFrame(frame, seq);
+        jb.push(frame, FRAME_BYTES, seq * FRAME_US);
+        seq++;
+        CHECK_EQ(jb.pop(out, sizeof(out)), 0);
+    }
+    uint16_t first = seq - static_cast<uint16_t>(target - 1);
+    makeFrame(frame, seq);
+    jb.push(frame, FRAME_BYTES, seq * FRAME_US + 6000);
+    CHECK_EQ(jb.pop(out, sizeof(out)), FRAME_BYTES);
+    CHECK_EQ(frameSeq(out), first);
+    // Priming pops are not underruns
+    CHECK_EQ(jb.getStats().underruns, 1);
+}
+
+static void test_underrun_counted_once_per_gap() {
+    JitterBuffer jb;
+    startStream(jb);
+    uint8_t frame[FRAME_BYTES];
+    uint8_t out[AudioConfig::MAX_FRAME_SIZE];
+    for (uint16_t i = 0; i < 2; i++) {
+        makeFrame(frame, i);
+        jb.push(frame, FRAME_BYTES, i * FRAME_US);
+    }
+    CHECK_EQ(jb.pop(out, sizeof(out)), FRAME_BYTES);
+    CHECK_EQ(jb.pop(out, sizeof(out)), FRAME_BYTES);
+
+    // The first empty pop is the underrun; the rest are priming
+    for (int i = 0; i < 5; i++) CHECK_EQ(jb.pop(out, sizeof(out)), 0);
+    CHECK_EQ(jb.getStats().underruns, 1);
+}
+
+static void test_trims_above_target_plus_hysteresis() {
+    JitterBuffer jb;
+    startStream(jb);
+    uint8_t frame[FRAME_BYTES];
+    uint8_t out[AudioConfig::MAX_FRAME_SIZE];
+
+    // Steady arrivals keep the target at 1; the consumer stalls for 6 frames
+    for (uint16_t i = 0; i < 6; i++) {
+        makeFrame(frame, i);
+        jb.push(frame, FRAME_BYTES, i * FRAME_US);
+    }
+    CHECK_EQ(jb.targetDepth(), 1);
+
+    // 6 > 1 + 2: one frame is dropped per pop until the fill is back to 3
+    CHECK_EQ(jb.pop(out, sizeof(out)), FRAME_BYTES);
+    CHECK_EQ(frameSeq(out), 1);
+    CHECK_EQ(jb.pop(out, sizeof(out)), FRAME_BYTES);
+    CHECK_EQ(frameSeq(out), 3);
+    CHECK_EQ(jb.getStats().fill, 2);
+    CHECK_EQ(jb.pop(out, sizeof(out)), FRAME_BYTES);
+    CHECK_EQ(frameSeq(out), 4);
+    CHECK_EQ(jb.getStats().trimmed, 2);
+}
+
+// ============================================================
+// PRODUCER / CONSUMER THREADS
+// ============================================================
+
+static void test_concurrent_frames_arrive_intact_and_ordered() {
+    static constexpr uint16_t FRAMES = 20000;
+    JitterBuffer jb;
+    startStream(jb);
+    std::atomic<bool> done{false};
+
+    std::thread producer([&]() {
+        uint8_t frame[FRAME_BYTES];
+        for (uint16_t i = 1; i <= FRAMES; i++) {
+            makeFrame(frame, i);
+            while (!jb.push(frame, FRAME_BYTES, i * FRAME_US)) std::this_thread::yield();
+        }
+        done.store(true);
+    });
+
+    uint8_t out[AudioConfig::MAX_FRAME_SIZE];
+    int last = 0;
+    bool intact = true;
+    bool ordered = true;
+    for (;;) {
+        size_t n = jb.pop(out, sizeof(out));
+        if (n == 0) {
+            if (done.load() && jb.fill() < jb.targetDepth()) break;
+            std::this_thread::yield();
+            continue;
+        }
+        int16_t seq = frameSeq(out);
+        const int16_t* samples = reinterpret_cast<const int16_t*>(out);
+        for (size_t i = 0; i < n / 2; i++) intact = intact && samples[i] == seq;
+        ordered = ordered && static_cast<uint16_t>(seq) > static_cast<uint16_t>(last);
+        last = seq;
+    }
+    producer.join();
+
+    CHECK(intact);
+    CHECK(ordered);
+    JitterBuffer::Stats s = jb.getStats();
+    // Everything pushed was either played, trimmed or is still buffered
+    CHECK_EQ(s.framesIn, s.framesOut + s.trimmed + s.fill);
+    CHECK_EQ(s.framesIn, FRAMES);
+}
+
+int main() {
+    RUN_TEST(test_frames_are_copied_in_order);
+    RUN_TEST(test_oversized_packet_split_across_slots);
+    RUN_TEST(test_full_ring_drops_and_counts_overrun);
+    RUN_TEST(test_reset_flushes_and_clears_counters);
+    RUN_TEST(test_steady_arrivals_keep_minimum_depth);
+    RUN_TEST(test_depth_follows_jitter_rule);
+    RUN_TEST(test_depth_capped_at_maximum);
+    RUN_TEST(test_stalls_beyond_budget_are_clamped);
+    RUN_TEST(test_primes_to_target_before_playing);
+    RUN_TEST(test_underrun_counted_once_per_gap);
+    RUN_TEST(test_trims_above_target_plus_hysteresis);
+    RUN_TEST(test_concurrent_frames_arrive_intact_and_ordered);
+    return HostTest::summary();
+}
@@ -0,0 +1,348 @@
+#include "HostTest.h"
+#include "KwsModelBuilder.h"
+#include "Audio/KeywordModel.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+using namespace KwsModel;
+
+// ============================================================
+// REFERENCE
+// ============================================================
+
+static int8_t requantizeReference(int64_t acc, const QuantLayer& l, size_t ch) {
+    int right = 31 - l.shift[ch];
+    int64_t v = (acc * l.multiplier[ch] + (static_cast<int64_t>(1) << (right - 1))) >> right;
+    v += l.outZero;
+    if (v < l.actMin) v = l.actMin;
+    if (v > l.actMax) v = l.actMax;
+    return static_cast<int8_t>(v);
+}
+
+/**
+ * The network run the plain way: every output a loop over its window,
+ * (x - zero point) * w in 64 bits, padding skipped
+ */
+static std::vector<int8_t> referenceInvoke(const QuantModel& model, const std::vector<int8_t>& input) {
+    std::vector<int8_t> act = input;
+    for (const QuantLayer& l : model.layers) {
+        std::vector<int8_t> out(l.outH * l.outW * l.outC);
+        if (l.type == AVGPOOL) {
+            for (size_t c = 0; c < l.inC; c++) {
+                int64_t sum = 0;
+                for (size_t p = 0; p < l.inH * l.inW; p++) sum += act[p * l.inC + c] - l.inZero;
+                out[c] = requantizeReference(sum, l, 0);
+            }
+        } else {
+            for (size_t oy = 0; oy < l.outH; oy++) {
+                for (size_t ox = 0; ox < l.outW; ox++) {
+                    for (size_t o = 0; o < l.outC; o++) {
+                        int64_t acc = l.bias[o];
+                        for (size_t ky = 0; ky < l.kernelH; ky++) {
+                            for (size_t kx = 0; kx < l.kernelW; kx++) {
+                                long iy = static_cast<long>(oy * l.strideH + ky) - static_cast<long>(l.padTop);
+                                long ix = static_cast<long>(ox * l.strideW + kx) - static_cast<long>(l.padLeft);
+                                if (iy < 0 || ix < 0 || iy >= static_cast<long>(l.inH) || ix >= static_cast<long>(l.inW)) {
+                                    continue;
+                                }
+                                const int8_t* px = &act[(iy * l.inW + ix) * l.inC];
+                                if (l.type == CONV) {
+                                    for (size_t i = 0; i < l.inC; i++) {
+                                        int8_t w = l.weights[((o * l.kernelH + ky) * l.kernelW + kx) * l.inC + i];
+                                        acc += static_cast<int64_t>(px[i] - l.inZero) * w;
+                                    }
+                                } else {
+                                    int8_t w = l.weights[(ky * l.kernelW + kx) * l.inC + o];
+                                    acc += static_cast<int64_t>(px[o] - l.inZero) * w;
+                                }
+                            }
+                        }
+                        out[(oy * l.outW + ox) * l.outC + o] = requantizeReference(acc, l, o);
+                    }
+                }
+            }
+        }
+        act = out;
+    }
+    return act;
+}
+
+// ============================================================
+// RANDOM DS-CNN
+// ============================================================
+
+struct Random {
+    uint32_t seed;
+    explicit Random(uint32_t s) : seed(s) {}
+    float uniform() {   // -1 .. 1
+        seed = seed * 1664525u + 1013904223u;
+        return static_cast<float>(static_cast<int32_t>(seed)) / 2147483648.0f;
+    }
+};
+
+static void randomize(FloatLayer& l, size_t weights, size_t fanIn, Random& random) {
+    float bound = 1.7f / sqrtf(static_cast<float>(fanIn));
+    for (size_t i = 0; i < weights; i++) l.weights.push_back(bound * random.uniform());
+    size_t channels = (l.type == CONV) ? l.outChannels : weights / (l.kernelH * l.kernelW);
+    for (size_t i = 0; i < channels; i++) l.bias.push_back(0.2f * random.uniform());
+}
+
+/**
+ * The usual DS-CNN shape at a small size: a strided 10x4 conv over 49
+ * frames of 10 MFCCs, two depthwise-separable blocks, global average
+ * pooling and a fully-connected classifier
+ */
+static FloatModel randomDsCnn(uint32_t seed, size_t channels = 24) {
+    Random random(seed);
+    FloatModel model;
+    model.frames = 49;
+    model.coefficients = 10;
+    model.features = static_cast<uint8_t>(LogMelFrontEnd::Output::Mfcc);
+    model.melBands = 40;
+    model.classes = 4;
+    model.keywordClass = 2;
+    model.inputScale = 0.05f;
+    model.inputZero = 3;
+
+    const float hidden = 1.0f / 32.0f;
+
+    FloatLayer first;
+    first.type = CONV;
+    first.kernelH = 10;
+    first.kernelW = 4;
+    first.strideH = 2;
+    first.strideW = 2;
+    first.same = true;
+    first.outChannels = static_cast<uint16_t>(channels);
+    first.relu = true;
+    first.outScale = hidden;
+    first.outZero = -128;
+    randomize(first, channels * 10 * 4, 40, random);
+    model.layers.push_back(first);
+
+    for (int block = 0; block < 2; block++) {
+        FloatLayer depthwise;
+        depthwise.type = DEPTHWISE;
+        depthwise.kernelH = 3;
+        depthwise.kernelW = 3;
+        depthwise.same = true;
+        depthwise.relu = true;
+        depthwise.outScale = hidden;
+        depthwise.outZero = -128;
+        randomize(depthwise, 9 * channels, 9, random);
+        model.layers.push_back(depthwise);
+
+        FloatLayer pointwise;
+        pointwise.type = CONV;
+        pointwise.outChannels = static_cast<uint16_t>(channels);
+        pointwise.relu = true;
+        pointwise.outScale = hidden;
+        pointwise.outZero = -128;
+        randomize(pointwise, channels * channels, channels, random);
+        model.layers.push_back(pointwise);
+    }
+
+    FloatLayer pool;
+    pool.type = AVGPOOL;
+    pool.outScale = hidden;
+    pool.outZero = -128;
+    model.layers.push_back(pool);
+
+    FloatLayer classifier;
+    classifier.type = CONV;
+    classifier.outChannels = model.classes;
+    classifier.outScale = 1.0f / 16.0f;
+    classifier.outZero = 0;
+    randomize(classifier, model.classes * channels, channels, random);
+    model.layers.push_back(classifier);
+    return model;
+}
+
+static std::vector<int8_t> randomInput(size_t size, uint32_t seed) {
+    Random random(seed);
+    std::vector<int8_t> input(size);
+    for (size_t i = 0; i < size; i++) input[i] = static_cast<int8_t>(lrintf(127.0f * random.uniform()));
+    return input;
+}
+
+// ============================================================
+// INFERENCE
+// ============================================================
+
+// Every path - im2col with same padding and stride, pointwise, depthwise,
+// pooling, the classifier - bit-exact against the plain loops, over
+// several networks and inputs (both channel counts keep some conv rows
+// off the 16-byte dotProductQ7 stride)
+static void test_ds_cnn_matches_reference() {
+    const size_t channelCounts[] = {24, 64};
+    size_t distinctLogits = 0;
+    for (size_t n = 0; n < 2; n++) {
+        QuantModel quant = quantize(randomDsCnn(100 + n, channelCounts[n]));
+        std::vector<uint8_t> blob = serialize(quant);
+        KeywordModel model;
+        CHECK(model.load(blob.data(), blob.size()));
+        CHECK_EQ(model.inputSize(), 49u * 10u);
+
+        for (uint32_t trial = 0; trial < 4; trial++) {
+            std::vector<int8_t> input = randomInput(model.inputSize(), 7 + trial);
+            std::vector<int8_t> expected = referenceInvoke(quant, input);
+            const int8_t* logits = model.invoke(input.data());
+            CHECK_EQ(expected.size(), 4u);
+            for (size_t c = 0; c < expected.size(); c++) {
+                CHECK_EQ(logits[c], expected[c]);
+                if (c > 0 && expected[c] != expected[0]) distinctLogits++;
+            }
+        }
+    }
+    // The random networks are not saturated into one answer
+    CHECK(distinctLogits > 8);
+}
+
+// Header fields come through, and the cost figures add up
+static void test_info_and_cost() {
+    FloatModel source = randomDsCnn(5);
+    std::vector<uint8_t> blob = build(source);
+    KeywordModel model;
+    CHECK(model.load(blob.data(), blob.size()));
+    const KeywordModel::Info& info = model.info();
+    CHECK_EQ(info.frames, 49);
+    CHECK_EQ(info.coefficients, 10);
+    CHECK_EQ(info.features, 1);
+    CHECK_EQ(info.classes, 4);
+    CHECK_EQ(info.keywordClass, 2);
+    CHECK_EQ(info.inputZeroPoint, 3);
+    CHECK_NEAR(info.inputScale, 0.05f, 1e-7f);
+    CHECK_NEAR(info.outputScale, 1.0f / 16.0f, 1e-7f);
+    CHECK_EQ(info.outputZeroPoint, 0);
+
+    // 25x5 after the first conv; 24 channels
+    uint32_t expected = 25 * 5 * 24 * 40              // First conv
+                      + 2 * (25 * 5 * 24 * 9          // Depthwise
+                             + 25 * 5 * 24 * 24)      // Pointwise
+                      + 25 * 5 * 24                   // Pooling
+                      + 4 * 24;                       // Classifier
+    CHECK_EQ(model.macs(), expected);
+    CHECK(model.memoryBytes() > blob.size());
+    CHECK(model.memoryBytes() < 2 * blob.size() + 16 * 1024);
+}
+
+// A file loads like the blob, and the blob is not needed afterwards
+static void test_load_file() {
+    QuantModel quant = quantize(randomDsCnn(9));
+    std::vector<uint8_t> blob = serialize(quant);
+    const char* path = "kws_model_test.bin";
+    FILE* f = fopen(path, "wb");
+    CHECK(f != nullptr);
+    if (!f) return;
+    fwrite(blob.data(), 1, blob.size(), f);
+    fclose(f);
+
+    KeywordModel model;
+    CHECK(model.loadFile(path));
+    remove(path);
+    CHECK(!model.loadFile(path));
+    CHECK(!model.isLoaded());
+
+    CHECK(model.loadFile("/nonexistent/kws.bin") == false);
+    {
+        std::vector<uint8_t> copy = blob;
+        CHECK(model.load(copy.data(), copy.size()));
+    }
+    std::vector<int8_t> input = randomInput(model.inputSize(), 3);
+    std::vector<int8_t> expected = referenceInvoke(quant, input);
+    const int8_t* logits = model.invoke(input.data());
+    for (size_t c = 0; c < expected.size(); c++) CHECK_EQ(logits[c], expected[c]);
+}
+
+// ============================================================
+// MALFORMED BLOBS
+// ============================================================
+
+static bool loads(const std::vector<uint8_t>& blob) {
+    KeywordModel model;
+    bool ok = model.load(blob.data(), blob.size());
+    CHECK_EQ(model.isLoaded(), ok);
+    return ok;
+}
+
+static void test_rejects_malformed_blobs() {
+    QuantModel quant = quantize(randomDsCnn(11));
+    std::vector<uint8_t> good = serialize(quant);
+    CHECK(loads(good));
+
+    std::vector<uint8_t> blob = good;
+    blob[0] = 'X';
+    CHECK(!loads(blob));
+
+    // Every truncation, and a trailing byte
+    bool anyLoaded = false;
+    for (size_t size = 0; size < good.size(); size += 4) {
+        std::vector<uint8_t> cut(good.begin(), good.begin() + size);
+        anyLoaded = anyLoaded || loads(cut);
+    }
+    CHECK(!anyLoaded);
+    blob = good;
+    blob.insert(blob.end(), 4, 0);
+    CHECK(!loads(blob));
+
+    // Header fields out of range
+    blob = good;
+    blob[10] = blob[9];           // keywordClass == classes
+    CHECK(!loads(blob));
+    blob = good;
+    blob[7] = 2;                  // Unknown feature type
+    CHECK(!loads(blob));
+
+    // A layer type the engine does not have
+    blob = good;
+    blob[32] = 9;
+    CHECK(!loads(blob));
+
+    // Shift out of range
+    QuantModel badShift = quant;
+    badShift.layers[1].shift[0] = 31;
+    CHECK(!loads(serialize(badShift)));
+
+    // The classifier does not end at 1x1xclasses
+    QuantModel wrongClasses = quant;
+    wrongClasses.header.classes = 3;
+    CHECK(!loads(serialize(wrongClasses)));
+    QuantModel noPool = quant;
+    noPool.layers.erase(noPool.layers.end() - 2);
+    CHECK(!loads(serialize(noPool)));
+
+    // A failed load leaves no model behind
+    KeywordModel model;
+    CHECK(model.load(good.data(), good.size()));
+    CHECK(!model.load(blob.data(), blob.size()));
+    CHECK(!model.isLoaded());
+}
+
+// ============================================================
+// BUILDER
+// ============================================================
+
+// The synthetic two-tone detector used by the spotter tests quantizes to
+// a valid blob that the engine runs like the reference
+static void test_two_tone_model_builds() {
+    QuantModel quant = quantize(twoToneModel());
+    std::vector<uint8_t> blob = serialize(quant);
+    KeywordModel model;
+    CHECK(model.load(blob.data(), blob.size()));
+    CHECK_EQ(model.info().classes, 2);
+    std::vector<int8_t> input = randomInput(model.inputSize(), 21);
+    std::vector<int8_t> expected = referenceInvoke(quant, input);
+    const int8_t* logits = model.invoke(input.data());
+    for (size_t c = 0; c < expected.size(); c++) CHECK_EQ(logits[c], expected[c]);
+}
+
+int main() {
+    RUN_TEST(test_ds_cnn_matches_reference);
+    RUN_TEST(test_info_and_cost);
+    RUN_TEST(test_load_file);
+    RUN_TEST(test_rejects_malformed_blobs);
+    RUN_TEST(test_two_tone_model_builds);
+    return HostTest::summary();
+}
@@ -0,0 +1,200 @@
+#include "HostTest.h"
+#include "KwsModelBuilder.h"
+#include "Audio/AudioConfig.h"
+#include "Audio/KeywordSpotter.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// The spotter streaming the synthetic two-tone keyword (KwsModelBuilder.h)
+// over a noise floor, in mic-sized blocks.
+
+static constexpr uint32_t RATE = KeywordSpotter::INPUT_RATE;
+static constexpr size_t FRAME = AudioConfig::FRAME_SAMPLES_16K;
+static constexpr float NOISE_AMPLITUDE = 300.0f;    // About -40 dBFS
+static constexpr float KEYWORD_AMPLITUDE = 3000.0f;  // 20dB over the noise
+
+static size_t ms(uint32_t milliseconds) {
+    return static_cast<size_t>(RATE) * milliseconds / 1000;
+}
+
+struct Noise {
+    uint32_t seed = 5;
+    float next() {
+        float sum = 0.0f;
+        for (int i = 0; i < 4; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            sum += static_cast<float>(static_cast<int32_t>(seed)) / 2147483648.0f;
+        }
+        return sum * 0.866f;
+    }
+};
+
+static std::vector<int16_t> background(uint32_t milliseconds) {
+    Noise noise;
+    std::vector<int16_t> out(ms(milliseconds));
+    for (int16_t& s : out) s = static_cast<int16_t>(NOISE_AMPLITUDE * noise.next());
+    return out;
+}
+
+static void addKeyword(std::vector<int16_t>& out, uint32_t atMs, float lowHz = KwsModel::TWO_TONE_LOW_HZ,
+                       float highHz = KwsModel::TWO_TONE_HIGH_HZ) {
+    KwsModel::addTwoTone(out, ms(atMs), RATE, lowHz, highHz, ms(KwsModel::TWO_TONE_SYLLABLE_MS), ms(50),
+                         KEYWORD_AMPLITUDE);
+}
+
+struct Spotter {
+    KeywordModel model;
+    KeywordSpotter spotter;
+
+    Spotter() {
+        std::vector<uint8_t> blob = KwsModel::build(KwsModel::twoToneModel());
+        CHECK(model.load(blob.data(), blob.size()));
+        CHECK(spotter.begin(&model));
+    }
+
+    /**
+     * Stream audio in blocks
+     * @return where each detection happened (end of the block, in samples)
+     */
+    std::vector<size_t> run(const std::vector<int16_t>& audio, size_t block = FRAME) {
+        std::vector<size_t> detections;
+        for (size_t pos = 0; pos < audio.size(); pos += block) {
+            size_t n = (audio.size() - pos < block) ? audio.size() - pos : block;
+            if (spotter.process(&audio[pos], n)) detections.push_back(pos + n);
+        }
+        return detections;
+    }
+};
+
+// ============================================================
+// DETECTION
+// ============================================================
+
+// Said once, detected once, shortly after it ends (the model needs the
+// whole keyword in its one-second window)
+static void test_detects_keyword_once() {
+    Spotter s;
+    std::vector<int16_t> audio = background(4000);
+    addKeyword(audio, 1000);
+    std::vector<size_t> detections = s.run(audio);
+    CHECK_EQ(detections.size(), 1u);
+    if (detections.size() == 1) {
+        size_t keywordEnd = ms(1000 + 2 * KwsModel::TWO_TONE_SYLLABLE_MS + 50);
+        CHECK(detections[0] > keywordEnd - ms(200));
+        CHECK(detections[0] < keywordEnd + ms(500));
+    }
+    KeywordSpotter::Stats stats = s.spotter.getStats();
+    CHECK_EQ(stats.detections, 1u);
+    // An inference every 4 hops of 20ms once 49 frames are in
+    CHECK(stats.inferences >= (4000 - 1000) / 80 - 2);
+    CHECK(stats.inferences <= 4000 / 80);
+    CHECK(stats.maxCycles >= stats.lastCycles);
+    CHECK(stats.frontEndCycles > 0);
+}
+
+// Noise, each tone alone and the tones the wrong way round never trigger
+static void test_lookalikes_do_not_trigger() {
+    Spotter s;
+    std::vector<int16_t> audio = background(8000);
+    const float lowHz = KwsModel::TWO_TONE_LOW_HZ;
+    const float highHz = KwsModel::TWO_TONE_HIGH_HZ;
+    addKeyword(audio, 1500, highHz, lowHz);
+    addKeyword(audio, 3500, lowHz, lowHz);
+    addKeyword(audio, 5500, highHz, highHz);
+    CHECK(s.run(audio).empty());
+    CHECK(s.spotter.score() < 0.5f);
+    CHECK_EQ(s.spotter.getStats().detections, 0u);
+}
+
+// Twice within REFRACTORY_MS counts once; twice well apart, twice
+static void test_refractory_period() {
+    Spotter close;
+    std::vector<int16_t> audio = background(5000);
+    addKeyword(audio, 1000);
+    addKeyword(audio, 1000 + KeywordSpotter::REFRACTORY_MS / 2);
+    CHECK_EQ(close.run(audio).size(), 1u);
+
+    Spotter apart;
+    audio = background(7000);
+    addKeyword(audio, 1000);
+    addKeyword(audio, 1000 + KeywordSpotter::REFRACTORY_MS + 1500);
+    CHECK_EQ(apart.run(audio).size(), 2u);
+}
+
+// Detection does not depend on how the mic blocks the audio
+static void test_block_size_does_not_matter() {
+    std::vector<int16_t> audio = background(4000);
+    addKeyword(audio, 1200);
+    Spotter a;
+    Spotter b;
+    Spotter c;
+    std::vector<size_t> byFrame = a.run(audio, FRAME);
+    std::vector<size_t> byPair = b.run(audio, 2);
+    std::vector<size_t> byLarge = c.run(audio, 1000);
+    CHECK_EQ(byFrame.size(), 1u);
+    CHECK_EQ(byPair.size(), 1u);
+    CHECK_EQ(byLarge.size(), 1u);
+    if (byFrame.size() == 1 && byPair.size() == 1 && byLarge.size() == 1) {
+        // Same hop: within one block of each other
+        CHECK(byPair[0] <= byFrame[0] && byFrame[0] - byPair[0] < FRAME);
+        CHECK(byLarge[0] >= byPair[0] && byLarge[0] - byPair[0] < 1000);
+    }
+}
+
+// ============================================================
+// CONTROL
+// ============================================================
+
+// reset() forgets the stream: a keyword cut in half by a session (the mic
+// handed away and back) is not stitched together
+static void test_reset_forgets_the_stream() {
+    Spotter s;
+    std::vector<int16_t> audio = background(3000);
+    addKeyword(audio, 1000);
+    size_t cut = ms(1000 + KwsModel::TWO_TONE_SYLLABLE_MS + 25);
+
+    std::vector<int16_t> first(audio.begin(), audio.begin() + cut);
+    std::vector<int16_t> second(audio.begin() + cut, audio.end());
+    CHECK(s.run(first).empty());
+    s.spotter.reset();
+    CHECK_EQ(s.spotter.score(), 0.0f);
+    CHECK(s.run(second).empty());
+
+    // Without the reset the same two halves detect
+    Spotter whole;
+    CHECK(whole.run(first).empty());
+    CHECK_EQ(whole.run(second).size(), 1u);
+}
+
+// The threshold is the smoothed posterior a detection needs
+static void test_threshold() {
+    Spotter s;
+    CHECK_NEAR(s.spotter.getThreshold(), KeywordSpotter::DEFAULT_THRESHOLD, 1e-6f);
+    s.spotter.setThreshold(1.01f);
+    std::vector<int16_t> audio = background(4000);
+    addKeyword(audio, 1000);
+    CHECK(s.run(audio).empty());
+    CHECK(s.spotter.getStats().inferences > 0);
+}
+
+static void test_begin_needs_a_model() {
+    KeywordModel empty;
+    KeywordSpotter spotter;
+    CHECK(!spotter.begin(&empty));
+    CHECK(!spotter.begin(nullptr));
+    int16_t silence[FRAME] = {0};
+    CHECK(!spotter.process(silence, FRAME));
+    CHECK_EQ(spotter.getStats().inferences, 0u);
+}
+
+int main() {
+    RUN_TEST(test_detects_keyword_once);
+    RUN_TEST(test_lookalikes_do_not_trigger);
+    RUN_TEST(test_refractory_period);
+    RUN_TEST(test_block_size_does_not_matter);
+    RUN_TEST(test_reset_forgets_the_stream);
+    RUN_TEST(test_threshold);
+    RUN_TEST(test_begin_needs_a_model);
+    return HostTest::summary();
+}
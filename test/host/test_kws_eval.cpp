@@ -0,0 +1,488 @@
+#include "HostTest.h"
+#include "KwsModelBuilder.h"
+#include "WavFixture.h"
+#include "Audio/AudioConfig.h"
+#include "Audio/HalfbandConverter.h"
+#include "Audio/KeywordSpotter.h"
+#include "Audio/MicDutyCycle.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Scores a keyword model the way the badge runs it: false rejects over
+// keyword clips, false accepts per hour of background, and the cost of
+// each inference.
+//
+//   test_kws_eval [model.bin corpus.txt]
+//   test_kws_eval --export kws.bin
+//
+// The corpus lists one 16-bit mono WAV (8kHz or 16kHz) per line, labelled:
+//
+//   keyword    clips/hey_badge_017.wav
+//   background clips/kitchen_10min.wav
+//
+// Paths are relative to the corpus file; '#' starts a comment. A keyword
+// clip counts as accepted if it triggers at least once; every trigger in
+// background audio is a false accept. Each clip gets a second of room tone
+// on either side, and streams in 7.5ms mic frames through MicDutyCycle
+// (asleep: SLEEP_MS of audio is never heard) into KeywordSpotter, with
+// duty cycling off and on.
+//
+// Without arguments the synthetic two-tone model (KwsModelBuilder.h) runs
+// against a generated corpus: the keyword at 20, 10 and 5dB SNR with
+// varied timing and pitch, and as background white noise, the speech
+// fixture and lookalikes (each tone alone, the wrong order, other tone
+// pairs). --export writes that model as a blob for the badge's SPIFFS.
+//
+// Times are host nanoseconds; the badge counts the same inferences in CPU
+// cycles ([KWS] in its log).
+
+static constexpr uint32_t RATE = KeywordSpotter::INPUT_RATE;
+static constexpr size_t FRAME = AudioConfig::FRAME_SAMPLES_16K;
+static constexpr uint32_t PAD_MS = 1000;
+static constexpr float ROOM_TONE = 30.0f;      // About -60 dBFS
+
+// Pass marks for the synthetic corpus, under what it measures. 5dB is
+// reported, not checked: duty-cycled, the VAD (9dB over the floor) never
+// wakes the mic for it.
+static constexpr float FRR_MAX = 0.05f;              // 20 and 10dB, duty cycling off
+static constexpr float FRR_DUTY_MAX = 0.10f;         // The same with the mic duty-cycled
+static constexpr float FA_PER_HOUR_MAX = 0.0f;
+static constexpr float MIC_ON_NOISE_MAX = 0.4f;      // Share of steady noise the mic is on for
+
+struct Clip {
+    bool keyword;
+    std::string name;      // Group the clip is reported under
+    std::vector<int16_t> samples;
+};
+
+struct Random {
+    uint32_t seed;
+    explicit Random(uint32_t s) : seed(s) {}
+    float uniform() {   // 0 .. 1
+        seed = seed * 1664525u + 1013904223u;
+        return static_cast<float>(seed >> 8) / 16777216.0f;
+    }
+    float gaussian() {
+        float sum = 0.0f;
+        for (int i = 0; i < 4; i++) sum += uniform() - 0.5f;
+        return sum * 1.732f;
+    }
+};
+
+static size_t ms(uint32_t milliseconds) {
+    return static_cast<size_t>(RATE) * milliseconds / 1000;
+}
+
+static int16_t saturate16(float v) {
+    if (v > 32767.0f) return 32767;
+    if (v < -32768.0f) return -32768;
+    return static_cast<int16_t>(lrintf(v));
+}
+
+static void addNoise(std::vector<int16_t>& x, float amplitude, Random& random) {
+    for (int16_t& s : x) s = saturate16(s + amplitude * random.gaussian());
+}
+
+/**
+ * A clip with room tone around it
+ */
+static std::vector<int16_t> padded(const std::vector<int16_t>& clip, Random& random) {
+    std::vector<int16_t> out(ms(PAD_MS), 0);
+    out.insert(out.end(), clip.begin(), clip.end());
+    out.insert(out.end(), ms(PAD_MS), 0);
+    addNoise(out, ROOM_TONE, random);
+    return out;
+}
+
+/**
+ * 16kHz, through the same half-band interpolator as the speaker path
+ */
+static std::vector<int16_t> to16k(const Recording& rec) {
+    if (rec.sampleRate == RATE) return rec.samples;
+    HalfbandUpsampler up;
+    up.reset();
+    std::vector<int16_t> out(rec.samples.size() * 2);
+    size_t written = 0;
+    const size_t block = HalfbandUpsampler::MAX_INPUT;
+    for (size_t pos = 0; pos < rec.samples.size(); pos += block) {
+        size_t n = std::min(block, rec.samples.size() - pos);
+        written += up.process(&rec.samples[pos], n, &out[written]);
+    }
+    out.resize(written);
+    return out;
+}
+
+// ============================================================
+// CORPUS
+// ============================================================
+
+static bool loadCorpus(const char* path, std::vector<Clip>& clips) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        printf("  cannot open %s\n", path);
+        return false;
+    }
+    std::string dir(path);
+    size_t slash = dir.find_last_of('/');
+    dir = (slash == std::string::npos) ? "" : dir.substr(0, slash + 1);
+
+    Random random(99);
+    char line[512];
+    bool ok = true;
+    while (fgets(line, sizeof(line), f)) {
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char label[32];
+        char file[400];
+        if (sscanf(line, "%31s %399s", label, file) != 2) continue;
+
+        bool keyword = strcmp(label, "keyword") == 0;
+        if (!keyword && strcmp(label, "background") != 0) {
+            printf("  unknown label '%s'\n", label);
+            ok = false;
+            continue;
+        }
+        std::string wav = (file[0] == '/') ? std::string(file) : dir + file;
+        Recording rec;
+        if (!loadWav(wav.c_str(), rec)) {
+            printf("  cannot load %s\n", wav.c_str());
+            ok = false;
+            continue;
+        }
+        Clip clip;
+        clip.keyword = keyword;
+        clip.name = label;
+        clip.samples = padded(to16k(rec), random);
+        clips.push_back(clip);
+    }
+    fclose(f);
+    return ok && !clips.empty();
+}
+
+static const float KEYWORD_SNRS_DB[] = {20.0f, 10.0f, 5.0f};
+static constexpr size_t KEYWORDS_PER_SNR = 40;
+
+/**
+ * The keyword as different speakers might say it: syllable lengths,
+ * gap, pitch and level varied
+ */
+static std::vector<int16_t> sayKeyword(Random& random, float lowHz, float highHz, float amplitude) {
+    size_t syllable = ms(250 + static_cast<uint32_t>(150 * random.uniform()));
+    size_t gap = ms(20 + static_cast<uint32_t>(100 * random.uniform()));
+    float pitch = 0.95f + 0.1f * random.uniform();
+    std::vector<int16_t> out(2 * syllable + gap, 0);
+    KwsModel::addTwoTone(out, 0, RATE, lowHz * pitch, highHz * pitch, syllable, gap, amplitude);
+    return out;
+}
+
+static std::string snrName(float snrDb) {
+    char name[32];
+    snprintf(name, sizeof(name), "keyword %.0fdB", snrDb);
+    return name;
+}
+
+static void syntheticCorpus(std::vector<Clip>& clips) {
+    Random random(2024);
+    const float lowHz = KwsModel::TWO_TONE_LOW_HZ;
+    const float highHz = KwsModel::TWO_TONE_HIGH_HZ;
+    const float noise = 300.0f;
+
+    for (float snrDb : KEYWORD_SNRS_DB) {
+        // Tone power a^2/2 against the noise's
+        float amplitude = noise * sqrtf(2.0f) * powf(10.0f, snrDb / 20.0f);
+        for (size_t i = 0; i < KEYWORDS_PER_SNR; i++) {
+            Clip clip;
+            clip.keyword = true;
+            clip.name = snrName(snrDb);
+            clip.samples = padded(sayKeyword(random, lowHz, highHz, amplitude), random);
+            addNoise(clip.samples, noise, random);
+            clips.push_back(clip);
+        }
+    }
+
+    // Ten minutes of noise at the keyword clips' level
+    Clip hiss;
+    hiss.keyword = false;
+    hiss.name = "white noise";
+    hiss.samples.assign(ms(600 * 1000), 0);
+    addNoise(hiss.samples, noise, random);
+    clips.push_back(hiss);
+
+    // The speech fixture, looped over a minute
+    Recording rec;
+    if (loadWav(KWS_FIXTURE, rec)) {
+        Clip speech;
+        speech.keyword = false;
+        speech.name = "speech";
+        std::vector<int16_t> voice = to16k(rec);
+        while (speech.samples.size() < ms(60 * 1000)) {
+            speech.samples.insert(speech.samples.end(), voice.begin(), voice.end());
+        }
+        speech.samples = padded(speech.samples, random);
+        clips.push_back(speech);
+    }
+
+    // Lookalikes, a minute of each, loud
+    struct Lookalike {
+        const char* name;
+        float first;
+        float second;
+    };
+    const Lookalike lookalikes[] = {
+        {"low tone twice", lowHz, lowHz},
+        {"high tone twice", highHz, highHz},
+        {"wrong order", highHz, lowHz},
+        {"other pair", 1000.0f, 2600.0f},
+    };
+    for (const Lookalike& l : lookalikes) {
+        Clip clip;
+        clip.keyword = false;
+        clip.name = l.name;
+        while (clip.samples.size() < ms(60 * 1000)) {
+            std::vector<int16_t> said = sayKeyword(random, l.first, l.second, 6000.0f);
+            std::vector<int16_t> around = padded(said, random);
+            clip.samples.insert(clip.samples.end(), around.begin(), around.end());
+        }
+        clips.push_back(clip);
+    }
+}
+
+// ============================================================
+// EVALUATION
+// ============================================================
+
+struct Cost {
+    uint32_t inferences = 0;
+    double inferenceNs = 0.0;     // Sum over inferences
+    uint32_t maxInferenceNs = 0;
+    uint32_t maxFrontEndNs = 0;
+    uint32_t micOnMs = 0;
+    uint32_t micOffMs = 0;
+};
+
+/**
+ * Stream one clip as the capture task hands it over
+ * @return detections
+ */
+static size_t listen(KeywordSpotter& spotter, MicDutyCycle& duty, const std::vector<int16_t>& audio, Cost& cost) {
+    spotter.reset();
+    spotter.resetStats();
+    duty.reset(RATE);
+
+    size_t detections = 0;
+    size_t asleepUntil = 0;
+    uint32_t seen = 0;
+    for (size_t pos = 0; pos + FRAME <= audio.size(); pos += FRAME) {
+        if (pos < asleepUntil) continue;
+        if (asleepUntil) {
+            duty.onWake(MicDutyCycle::SLEEP_MS);
+            asleepUntil = 0;
+        }
+        if (duty.onChunk(&audio[pos], FRAME)) {
+            if (spotter.process(&audio[pos], FRAME)) detections++;
+            KeywordSpotter::Stats s = spotter.getStats();
+            if (s.inferences != seen) {
+                seen = s.inferences;
+                cost.inferenceNs += s.lastCycles;
+            }
+        }
+        if (duty.sleepDue()) asleepUntil = pos + FRAME + ms(MicDutyCycle::SLEEP_MS);
+    }
+
+    KeywordSpotter::Stats s = spotter.getStats();
+    cost.inferences += s.inferences;
+    cost.maxInferenceNs = std::max(cost.maxInferenceNs, s.maxCycles);
+    cost.maxFrontEndNs = std::max(cost.maxFrontEndNs, s.frontEndCycles);
+    MicDutyCycle::Stats d = duty.getStats();
+    cost.micOnMs += d.onMs;
+    cost.micOffMs += d.offMs;
+    return detections;
+}
+
+struct Group {
+    std::string name;
+    bool keyword;
+    size_t clips = 0;
+    size_t accepted = 0;      // Keyword clips that triggered
+    size_t detections = 0;
+    double seconds = 0.0;
+    uint32_t micOnMs = 0;
+    uint32_t micOffMs = 0;
+
+    float micOnShare() const { return static_cast<float>(micOnMs) / std::max(1u, micOnMs + micOffMs); }
+};
+
+struct Report {
+    std::vector<Group> groups;
+    size_t keywordClips = 0;
+    size_t rejected = 0;
+    size_t falseAccepts = 0;
+    double backgroundHours = 0.0;
+    Cost cost;
+};
+
+static Report evaluate(KeywordModel& model, const std::vector<Clip>& clips, bool dutyCycle) {
+    KeywordSpotter spotter;
+    CHECK(spotter.begin(&model));
+    MicDutyCycle duty;
+    duty.setEnabled(dutyCycle);
+
+    Report report;
+    for (const Clip& clip : clips) {
+        Cost before = report.cost;
+        size_t detections = listen(spotter, duty, clip.samples, report.cost);
+        auto group = std::find_if(report.groups.begin(), report.groups.end(),
+                                  [&clip](const Group& g) { return g.name == clip.name; });
+        if (group == report.groups.end()) {
+            Group g;
+            g.name = clip.name;
+            g.keyword = clip.keyword;
+            report.groups.push_back(g);
+            group = report.groups.end() - 1;
+        }
+        group->clips++;
+        group->detections += detections;
+        group->seconds += static_cast<double>(clip.samples.size()) / RATE;
+        group->micOnMs += report.cost.micOnMs - before.micOnMs;
+        group->micOffMs += report.cost.micOffMs - before.micOffMs;
+        if (clip.keyword) {
+            report.keywordClips++;
+            if (detections > 0) {
+                group->accepted++;
+            } else {
+                report.rejected++;
+            }
+        } else {
+            report.falseAccepts += detections;
+            report.backgroundHours += static_cast<double>(clip.samples.size()) / RATE / 3600.0;
+        }
+    }
+    return report;
+}
+
+static void print(const Report& report, bool dutyCycle) {
+    printf("  duty cycling %s\n", dutyCycle ? "on" : "off");
+    for (const Group& g : report.groups) {
+        if (g.keyword) {
+            printf("    %-18s %3zu clips  FRR %5.1f%%", g.name.c_str(), g.clips,
+                   100.0 * (g.clips - g.accepted) / g.clips);
+        } else {
+            printf("    %-18s %5.1f min  %zu false accepts", g.name.c_str(), g.seconds / 60.0, g.detections);
+        }
+        if (dutyCycle) printf("  (mic on %.0f%%)", 100.0f * g.micOnShare());
+        printf("\n");
+    }
+    if (report.keywordClips) {
+        printf("    FRR %.1f%% (%zu of %zu)", 100.0 * report.rejected / report.keywordClips, report.rejected,
+               report.keywordClips);
+    }
+    if (report.backgroundHours > 0.0) {
+        printf("  FA %.2f per hour (%zu in %.2fh)", report.falseAccepts / report.backgroundHours,
+               report.falseAccepts, report.backgroundHours);
+    }
+    printf("\n");
+}
+
+// ============================================================
+// TESTS
+// ============================================================
+
+static const char* g_modelPath = nullptr;
+static const char* g_corpusPath = nullptr;
+static KeywordModel g_model;
+static std::vector<Clip> g_clips;
+
+static void test_model_and_corpus_load() {
+    if (g_modelPath) {
+        CHECK(g_model.loadFile(g_modelPath));
+    } else {
+        std::vector<uint8_t> blob = KwsModel::build(KwsModel::twoToneModel());
+        CHECK(g_model.load(blob.data(), blob.size()));
+    }
+    if (g_corpusPath) {
+        CHECK(loadCorpus(g_corpusPath, g_clips));
+    } else {
+        syntheticCorpus(g_clips);
+    }
+    CHECK(!g_clips.empty());
+    if (!g_model.isLoaded()) return;
+
+    const KeywordModel::Info& info = g_model.info();
+    printf("  model: %u frames x %u %s, %u classes, %u MACs per inference, %zu bytes\n",
+           info.frames, info.coefficients, info.features ? "MFCCs" : "log-mel bands", info.classes,
+           g_model.macs(), g_model.memoryBytes());
+}
+
+/**
+ * False rejects and accepts with the mic always on
+ */
+static void test_accuracy() {
+    if (!g_model.isLoaded() || g_clips.empty()) return;
+    Report report = evaluate(g_model, g_clips, false);
+    print(report, false);
+
+    const Cost& c = report.cost;
+    if (c.inferences) {
+        printf("    inference %.1fus mean, %.1fus max; front end %.1fus max per frame (host)\n",
+               c.inferenceNs / c.inferences / 1000.0, c.maxInferenceNs / 1000.0, c.maxFrontEndNs / 1000.0);
+    }
+    if (g_corpusPath) return;
+
+    // The synthetic corpus has pass marks
+    for (const Group& g : report.groups) {
+        if (!g.keyword) CHECK(g.detections <= FA_PER_HOUR_MAX * g.seconds / 3600.0);
+        if (g.keyword && g.name != snrName(5.0f)) CHECK(g.clips - g.accepted <= FRR_MAX * g.clips);
+    }
+}
+
+/**
+ * The same with the mic duty-cycled: what sleeping through a keyword's
+ * start costs, and the power it saves
+ */
+static void test_accuracy_duty_cycled() {
+    if (!g_model.isLoaded() || g_clips.empty()) return;
+    Report report = evaluate(g_model, g_clips, true);
+    print(report, true);
+    if (g_corpusPath) return;
+
+    for (const Group& g : report.groups) {
+        if (!g.keyword) CHECK(g.detections <= FA_PER_HOUR_MAX * g.seconds / 3600.0);
+        if (g.keyword && g.name != snrName(5.0f)) CHECK(g.clips - g.accepted <= FRR_DUTY_MAX * g.clips);
+    }
+    // Mostly asleep through steady noise
+    for (const Group& g : report.groups) {
+        if (g.name == "white noise") CHECK(g.micOnShare() < MIC_ON_NOISE_MAX);
+    }
+}
+
+static bool exportModel(const char* path) {
+    std::vector<uint8_t> blob = KwsModel::build(KwsModel::twoToneModel());
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(blob.data(), 1, blob.size(), f) == blob.size();
+    fclose(f);
+    printf("%s: %zu bytes\n", path, blob.size());
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && strcmp(argv[1], "--export") == 0) return exportModel(argv[2]) ? 0 : 1;
+    if (argc == 3) {
+        g_modelPath = argv[1];
+        g_corpusPath = argv[2];
+    } else if (argc != 1) {
+        printf("usage: %s [model.bin corpus.txt | --export model.bin]\n", argv[0]);
+        return 2;
+    }
+
+    RUN_TEST(test_model_and_corpus_load);
+    RUN_TEST(test_accuracy);
+    RUN_TEST(test_accuracy_duty_cycled);
+    return HostTest::summary();
+}
@@ -0,0 +1,173 @@
+#include "HostTest.h"
+#include "Audio/LatencyProbe.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+static constexpr int64_t FRAME_US = 7500;
+static constexpr int64_t START_US = 1000000;
+
+/**
+ * Phone that loops the uplink back after delaySamples, scaled by gain,
+ * with white noise at noiseLevel (peak) on top.
+ */
+class Loopback {
+public:
+    Loopback(uint32_t rate, size_t delaySamples, float gain, float noiseLevel)
+        : m_rate(rate), m_frame(rate * FRAME_US / 1000000), m_gain(gain), m_noise(noiseLevel),
+          m_line(delaySamples, 0) {}
+
+    size_t frame() const { return m_frame; }
+
+    /**
+     * One SCO interval: outgoing callback (mic frame in), then incoming
+     * callback (looped audio out), both at nowUs
+     */
+    void step(LatencyProbe& probe, int64_t nowUs) {
+        std::vector<int16_t> out(m_frame, 0);
+        probe.processOutgoing(out.data(), m_frame, nowUs);
+
+        std::vector<int16_t> in(m_frame);
+        for (size_t i = 0; i < m_frame; i++) {
+            m_line.push_back(out[i]);
+            float v = m_gain * m_line.front() + m_noise * noise();
+            m_line.erase(m_line.begin());
+            in[i] = static_cast<int16_t>(lrintf(v));
+        }
+        probe.processIncoming(in.data(), m_frame, nowUs);
+    }
+
+private:
+    uint32_t m_rate;
+    size_t m_frame;
+    float m_gain;
+    float m_noise;
+    std::vector<int16_t> m_line;
+    uint32_t m_seed = 1;
+
+    float noise() {
+        m_seed = m_seed * 1664525u + 1013904223u;
+        return static_cast<float>(static_cast<int32_t>(m_seed)) / 2147483648.0f;
+    }
+};
+
+/**
+ * Trigger one probe and run SCO intervals until it finishes
+ * @return Measured round trip, or -1 if nothing was measured
+ */
+static int64_t measure(LatencyProbe& probe, Loopback& loop, uint32_t rate, int64_t& nowUs) {
+    CHECK(probe.trigger(rate));
+    for (int i = 0; i < 400 && probe.isBusy(); i++) {
+        loop.step(probe, nowUs);
+        nowUs += FRAME_US;
+    }
+    uint32_t rtt = 0;
+    return probe.takeResult(&rtt) ? static_cast<int64_t>(rtt) : -1;
+}
+
+static int64_t samplesUs(size_t samples, uint32_t rate) {
+    return static_cast<int64_t>(samples) * 1000000 / rate;
+}
+
+static void test_clean_loopback_narrowband() {
+    LatencyProbe probe;
+    Loopback loop(8000, 1234, 1.0f, 0.0f);
+    int64_t now = START_US;
+    int64_t rtt = measure(probe, loop, 8000, now);
+    CHECK_NEAR(rtt, samplesUs(1234, 8000), 125);
+
+    LatencyProbe::Stats s = probe.getStats();
+    CHECK_EQ(s.probes, 1);
+    CHECK_EQ(s.detected, 1);
+    CHECK_EQ(s.missed, 0);
+    CHECK(s.lastPeak >= 95);
+}
+
+static void test_quiet_noisy_loopback_wideband() {
+    // Phone returns the chirp 26dB down under noise at a third of its level
+    LatencyProbe probe;
+    Loopback loop(16000, 3001, 0.05f, 140.0f);
+    int64_t now = START_US;
+    int64_t rtt = measure(probe, loop, 16000, now);
+    CHECK_NEAR(rtt, samplesUs(3001, 16000), 125);
+}
+
+static void test_repeated_probes_track_min_max() {
+    LatencyProbe probe;
+    Loopback loop(8000, 900, 0.5f, 20.0f);
+    int64_t now = START_US;
+    for (int i = 0; i < 5; i++) {
+        CHECK_NEAR(measure(probe, loop, 8000, now), samplesUs(900, 8000), 125);
+        now += 100 * FRAME_US;
+    }
+    LatencyProbe::Stats s = probe.getStats();
+    CHECK_EQ(s.probes, 5);
+    CHECK_EQ(s.detected, 5);
+    CHECK(s.maxUs - s.minUs <= 125);
+}
+
+static void test_no_loopback_times_out() {
+    LatencyProbe probe;
+    Loopback loop(8000, 600, 0.0f, 3000.0f);   // Noise only
+    int64_t now = START_US;
+    CHECK_EQ(measure(probe, loop, 8000, now), -1);
+
+    LatencyProbe::Stats s = probe.getStats();
+    CHECK_EQ(s.detected, 0);
+    CHECK_EQ(s.missed, 1);
+    CHECK(!probe.isBusy());
+    CHECK(now - START_US >= static_cast<int64_t>(LatencyProbe::TIMEOUT_US));
+}
+
+static void test_trigger_while_busy_is_refused() {
+    LatencyProbe probe;
+    CHECK(probe.trigger(8000));
+    CHECK(!probe.trigger(8000));
+    CHECK_EQ(probe.getStats().probes, 1);
+}
+
+static void test_cancel_leaves_nothing_for_the_next_session() {
+    // Narrowband session ends with a probe armed: the next session's first
+    // mic frame goes out untouched
+    LatencyProbe probe;
+    CHECK(probe.trigger(8000));
+    probe.cancel();
+    CHECK(!probe.isBusy());
+    std::vector<int16_t> out(120, 0);
+    probe.processOutgoing(out.data(), out.size(), START_US);
+    bool untouched = true;
+    for (int16_t s : out) untouched = untouched && (s == 0);
+    CHECK(untouched);
+
+    // Session ends while listening (the phone never looped back): not a miss
+    Loopback silent(8000, 600, 0.0f, 0.0f);
+    int64_t now = START_US;
+    CHECK(probe.trigger(8000));
+    for (int i = 0; i < 10; i++) {
+        silent.step(probe, now);
+        now += FRAME_US;
+    }
+    CHECK(probe.isBusy());
+    probe.cancel();
+    CHECK(!probe.isBusy());
+
+    // A wideband session measures cleanly, with nothing left over
+    Loopback loop(16000, 2000, 1.0f, 0.0f);
+    now += 10 * FRAME_US;
+    CHECK_NEAR(measure(probe, loop, 16000, now), samplesUs(2000, 16000), 125);
+    LatencyProbe::Stats s = probe.getStats();
+    CHECK_EQ(s.probes, 3);
+    CHECK_EQ(s.detected, 1);
+    CHECK_EQ(s.missed, 0);
+}
+
+int main() {
+    RUN_TEST(test_clean_loopback_narrowband);
+    RUN_TEST(test_quiet_noisy_loopback_wideband);
+    RUN_TEST(test_repeated_probes_track_min_max);
+    RUN_TEST(test_no_loopback_times_out);
+    RUN_TEST(test_trigger_while_busy_is_refused);
+    RUN_TEST(test_cancel_leaves_nothing_for_the_next_session);
+    return HostTest::summary();
+}
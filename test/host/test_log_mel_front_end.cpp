@@ -0,0 +1,167 @@
+#include "HostTest.h"
+#include "Audio/LogMelFrontEnd.h"
+#include <cmath>
+#include <cstdint>
+
+static constexpr size_t WINDOW = LogMelFrontEnd::WINDOW;
+static constexpr size_t BANDS = LogMelFrontEnd::MAX_BANDS;
+
+static LogMelFrontEnd::Config logMelConfig(float scale = 0.1f, int8_t zeroPoint = 12) {
+    LogMelFrontEnd::Config config = {LogMelFrontEnd::Output::LogMel, BANDS, BANDS, scale, zeroPoint};
+    return config;
+}
+
+static void tone(int16_t* out, float hz, float amplitude) {
+    for (size_t i = 0; i < WINDOW; i++) {
+        out[i] = static_cast<int16_t>(lrintf(amplitude * sinf(6.283185307f * hz * i / LogMelFrontEnd::SAMPLE_RATE)));
+    }
+}
+
+static size_t loudestBand(const float* features, size_t count) {
+    size_t best = 0;
+    for (size_t b = 1; b < count; b++) {
+        if (features[b] > features[best]) best = b;
+    }
+    return best;
+}
+
+// ============================================================
+// LOG-MEL
+// ============================================================
+
+// A tone lights up one region of the filterbank, higher tones higher bands,
+// and the bands far from it stay near the floor
+static void test_tone_peaks_in_its_band() {
+    LogMelFrontEnd frontEnd;
+    CHECK(frontEnd.init(logMelConfig()));
+    int16_t window[WINDOW];
+    float features[BANDS];
+
+    const float tones[] = {300.0f, 700.0f, 1200.0f, 1800.0f, 2800.0f, 3500.0f};
+    size_t previous = 0;
+    for (size_t t = 0; t < sizeof(tones) / sizeof(tones[0]); t++) {
+        tone(window, tones[t], 8000.0f);
+        frontEnd.computeFloat(window, features);
+        size_t peak = loudestBand(features, BANDS);
+        if (t > 0) CHECK(peak > previous);
+        previous = peak;
+        // Five bands away the Hann sidelobes are over 40dB (ln: 9) down
+        if (peak >= 5) CHECK(features[peak - 5] < features[peak] - 9.0f);
+        if (peak + 5 < BANDS) CHECK(features[peak + 5] < features[peak] - 9.0f);
+    }
+}
+
+// Twice the amplitude is four times the power: ln(4) up in every lit band
+static void test_level_is_log_power() {
+    LogMelFrontEnd frontEnd;
+    CHECK(frontEnd.init(logMelConfig()));
+    int16_t window[WINDOW];
+    float quiet[BANDS];
+    float loud[BANDS];
+
+    tone(window, 1000.0f, 4000.0f);
+    frontEnd.computeFloat(window, quiet);
+    tone(window, 1000.0f, 8000.0f);
+    frontEnd.computeFloat(window, loud);
+    size_t peak = loudestBand(loud, BANDS);
+    CHECK_NEAR(loud[peak] - quiet[peak], logf(4.0f), 0.05f);
+}
+
+// Digital silence is the log floor in every band, not -inf
+static void test_silence_is_the_floor() {
+    LogMelFrontEnd frontEnd;
+    CHECK(frontEnd.init(logMelConfig()));
+    int16_t window[WINDOW] = {0};
+    float features[BANDS];
+    frontEnd.computeFloat(window, features);
+    for (size_t b = 0; b < BANDS; b++) CHECK_NEAR(features[b], logf(1e-6f), 0.01f);
+}
+
+// ============================================================
+// MFCC AND QUANTIZATION
+// ============================================================
+
+// MFCCs are the orthonormal DCT-II of the log-mel bands
+static void test_mfcc_is_dct_of_log_mel() {
+    const size_t bands = 32;
+    const size_t coefficients = 12;
+    LogMelFrontEnd logMel;
+    LogMelFrontEnd mfcc;
+    LogMelFrontEnd::Config config = {LogMelFrontEnd::Output::LogMel, bands, bands, 0.1f, 0};
+    CHECK(logMel.init(config));
+    config.output = LogMelFrontEnd::Output::Mfcc;
+    config.coefficients = coefficients;
+    CHECK(mfcc.init(config));
+
+    int16_t window[WINDOW];
+    for (size_t i = 0; i < WINDOW; i++) {
+        window[i] = static_cast<int16_t>(lrintf(3000.0f * sinf(0.3f * i) + 2000.0f * sinf(1.1f * i + 0.5f)));
+    }
+    float bandValues[bands];
+    float coefficientValues[coefficients];
+    logMel.computeFloat(window, bandValues);
+    mfcc.computeFloat(window, coefficientValues);
+
+    for (size_t c = 0; c < coefficients; c++) {
+        double sum = 0.0;
+        for (size_t b = 0; b < bands; b++) sum += bandValues[b] * cos(M_PI * c * (b + 0.5) / bands);
+        double expected = sum * sqrt((c == 0 ? 1.0 : 2.0) / bands);
+        CHECK_NEAR(coefficientValues[c], expected, 1e-3);
+    }
+}
+
+// compute() is computeFloat() at the configured scale and zero point,
+// rounded and saturated to int8
+static void test_quantized_features_saturate() {
+    LogMelFrontEnd frontEnd;
+    const float scale = 0.05f;     // Only -6.4 .. 6.35 around zero point 0
+    CHECK(frontEnd.init(logMelConfig(scale, 0)));
+    int16_t window[WINDOW];
+    tone(window, 1000.0f, 20000.0f);
+    float features[BANDS];
+    int8_t quantized[BANDS];
+    frontEnd.computeFloat(window, features);
+    frontEnd.compute(window, quantized);
+
+    bool sawLow = false;
+    for (size_t b = 0; b < BANDS; b++) {
+        long expected = lrintf(features[b] / scale);
+        if (expected < -128) {
+            expected = -128;
+            sawLow = true;
+        }
+        if (expected > 127) expected = 127;
+        CHECK(labs(quantized[b] - expected) <= 1);
+    }
+    CHECK(sawLow);
+}
+
+static void test_rejects_bad_configs() {
+    LogMelFrontEnd frontEnd;
+    LogMelFrontEnd::Config config = logMelConfig();
+    config.bands = 0;
+    CHECK(!frontEnd.init(config));
+    config = logMelConfig();
+    config.bands = BANDS + 1;
+    config.coefficients = BANDS + 1;
+    CHECK(!frontEnd.init(config));
+    config = logMelConfig();
+    config.coefficients = 10;     // Log-mel is one feature per band
+    CHECK(!frontEnd.init(config));
+    config.output = LogMelFrontEnd::Output::Mfcc;
+    CHECK(frontEnd.init(config));
+    config.coefficients = BANDS + 1;
+    CHECK(!frontEnd.init(config));
+    config = logMelConfig(0.0f);
+    CHECK(!frontEnd.init(config));
+}
+
+int main() {
+    RUN_TEST(test_tone_peaks_in_its_band);
+    RUN_TEST(test_level_is_log_power);
+    RUN_TEST(test_silence_is_the_floor);
+    RUN_TEST(test_mfcc_is_dct_of_log_mel);
+    RUN_TEST(test_quantized_features_saturate);
+    RUN_TEST(test_rejects_bad_configs);
+    return HostTest::summary();
+}
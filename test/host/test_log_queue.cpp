@@ -0,0 +1,162 @@
+#include "HostTest.h"
+#include "HAL/LogQueue.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+static bool textIs(const char* actual, const char* expected) {
+    return strcmp(actual, expected) == 0;
+}
+
+// ============================================================
+// SINGLE THREAD
+// ============================================================
+
+static void test_empty_queue_pops_nothing() {
+    LogQueue<4, 16> queue;
+    char out[17];
+    CHECK(!queue.pop(out));
+    CHECK_EQ(queue.takeDropped(), 0);
+}
+
+static void test_records_pop_in_order() {
+    LogQueue<4, 16> queue;
+    char out[17];
+    CHECK(queue.push("first"));
+    CHECK(queue.push("second"));
+    CHECK(queue.pop(out));
+    CHECK(textIs(out, "first"));
+    CHECK(queue.pop(out));
+    CHECK(textIs(out, "second"));
+    CHECK(!queue.pop(out));
+}
+
+static void test_long_record_truncated() {
+    LogQueue<4, 8> queue;
+    char out[9];
+    CHECK(queue.push("0123456789abcdef"));
+    CHECK(queue.pop(out));
+    CHECK(textIs(out, "01234567"));
+
+    CHECK(queue.push(""));
+    CHECK(queue.pop(out));
+    CHECK(textIs(out, ""));
+}
+
+static void test_full_queue_drops_and_counts() {
+    LogQueue<4, 16> queue;
+    char out[17];
+    char text[32];
+    for (int i = 0; i < 4; i++) {
+        snprintf(text, sizeof(text), "r%d", i);
+        CHECK(queue.push(text));
+    }
+    CHECK(!queue.push("r4"));
+    CHECK(!queue.push("r5"));
+    CHECK_EQ(queue.takeDropped(), 2);
+    CHECK_EQ(queue.takeDropped(), 0);
+
+    // The queued records are untouched by the drops
+    for (int i = 0; i < 4; i++) {
+        snprintf(text, sizeof(text), "r%d", i);
+        CHECK(queue.pop(out));
+        CHECK(textIs(out, text));
+    }
+    CHECK(!queue.pop(out));
+
+    // Room again after the consumer caught up
+    CHECK(queue.push("r6"));
+    CHECK(queue.pop(out));
+    CHECK(textIs(out, "r6"));
+}
+
+static void test_slots_reused_across_laps() {
+    LogQueue<4, 16> queue;
+    char out[17];
+    char text[32];
+    for (int i = 0; i < 1000; i++) {
+        snprintf(text, sizeof(text), "lap %d", i);
+        CHECK(queue.push(text));
+        if (i % 3 == 2) {
+            // Let up to three records build up before draining
+            while (queue.pop(out)) {}
+        }
+    }
+    while (queue.pop(out)) {}
+    CHECK(textIs(out, "lap 999"));
+    CHECK_EQ(queue.takeDropped(), 0);
+}
+
+// ============================================================
+// CONCURRENT PRODUCERS
+// ============================================================
+
+static void test_concurrent_producers_lose_nothing_silently() {
+    static const int PRODUCERS = 4;
+    static const int RECORDS_EACH = 20000;
+    typedef LogQueue<16, 31> Queue;
+
+    Queue queue;
+    std::atomic<int> running{PRODUCERS};
+    std::atomic<uint32_t> accepted{0};
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; p++) {
+        producers.push_back(std::thread([&queue, &running, &accepted, p]() {
+            char text[32];
+            for (int i = 0; i < RECORDS_EACH; i++) {
+                snprintf(text, sizeof(text), "%d %d", p, i);
+                if (queue.push(text)) {
+                    accepted.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (i % 64 == 0) std::this_thread::yield();
+            }
+            running.fetch_sub(1, std::memory_order_release);
+        }));
+    }
+
+    // Consumer: every record intact, and each producer's records in order
+    int last[PRODUCERS];
+    for (int p = 0; p < PRODUCERS; p++) last[p] = -1;
+    uint32_t popped = 0;
+    uint32_t dropped = 0;
+    int corrupt = 0;
+    int reordered = 0;
+    char out[32];
+    while (true) {
+        bool done = running.load(std::memory_order_acquire) == 0;
+        while (queue.pop(out)) {
+            int p = -1;
+            int i = -1;
+            if (sscanf(out, "%d %d", &p, &i) != 2 || p < 0 || p >= PRODUCERS || i < 0 || i >= RECORDS_EACH) {
+                corrupt++;
+                continue;
+            }
+            if (i <= last[p]) reordered++;
+            last[p] = i;
+            popped++;
+        }
+        dropped += queue.takeDropped();
+        if (done) break;
+    }
+    for (size_t t = 0; t < producers.size(); t++) producers[t].join();
+    while (queue.pop(out)) popped++;
+    dropped += queue.takeDropped();
+
+    CHECK_EQ(corrupt, 0);
+    CHECK_EQ(reordered, 0);
+    CHECK_EQ(popped, accepted.load());
+    CHECK_EQ(popped + dropped, PRODUCERS * RECORDS_EACH);
+}
+
+int main() {
+    RUN_TEST(test_empty_queue_pops_nothing);
+    RUN_TEST(test_records_pop_in_order);
+    RUN_TEST(test_long_record_truncated);
+    RUN_TEST(test_full_queue_drops_and_counts);
+    RUN_TEST(test_slots_reused_across_laps);
+    RUN_TEST(test_concurrent_producers_lose_nothing_silently);
+    return HostTest::summary();
+}
@@ -0,0 +1,105 @@
+#include "HostTest.h"
+#include "HAL/LogRing.h"
+#include <cstdio>
+#include <cstring>
+
+static bool lineIs(const char* actual, const char* expected) {
+    return strcmp(actual, expected) == 0;
+}
+
+static void test_empty_ring() {
+    LogRing<4, 16> ring;
+    CHECK_EQ(ring.size(), 0);
+}
+
+static void test_lines_kept_oldest_first() {
+    LogRing<4, 16> ring;
+    ring.push("one");
+    ring.push("two");
+    ring.push("three");
+    CHECK_EQ(ring.size(), 3);
+    CHECK(lineIs(ring.line(0), "one"));
+    CHECK(lineIs(ring.line(1), "two"));
+    CHECK(lineIs(ring.line(2), "three"));
+}
+
+static void test_full_ring_overwrites_oldest() {
+    LogRing<4, 16> ring;
+    char text[32];
+    for (int i = 0; i < 10; i++) {
+        snprintf(text, sizeof(text), "line %d", i);
+        ring.push(text);
+    }
+    CHECK_EQ(ring.size(), 4);
+    CHECK(lineIs(ring.line(0), "line 6"));
+    CHECK(lineIs(ring.line(1), "line 7"));
+    CHECK(lineIs(ring.line(2), "line 8"));
+    CHECK(lineIs(ring.line(3), "line 9"));
+}
+
+static void test_wrap_at_every_position() {
+    // Newest is always last, whichever slot it landed in
+    LogRing<3, 16> ring;
+    char text[32];
+    for (int i = 0; i < 7; i++) {
+        snprintf(text, sizeof(text), "%d", i);
+        ring.push(text);
+        CHECK(lineIs(ring.line(ring.size() - 1), text));
+        if (i >= 2) {
+            snprintf(text, sizeof(text), "%d", i - 2);
+            CHECK(lineIs(ring.line(0), text));
+        }
+    }
+}
+
+static void test_exact_width_is_not_truncated() {
+    LogRing<2, 8> ring;
+    ring.push("12345678");
+    CHECK(lineIs(ring.line(0), "12345678"));
+}
+
+static void test_long_line_truncated_with_ellipsis() {
+    LogRing<2, 8> ring;
+    ring.push("123456789");
+    CHECK(lineIs(ring.line(0), "12345..."));
+    CHECK_EQ(strlen(ring.line(0)), 8);
+
+    // A long line must not leave its tail behind for a short one
+    ring.push("abcdefghijklmnopqrstuvwxyz");
+    ring.push("x");
+    CHECK(lineIs(ring.line(0), "abcde..."));
+    CHECK(lineIs(ring.line(1), "x"));
+}
+
+static void test_empty_line() {
+    LogRing<2, 8> ring;
+    ring.push("");
+    CHECK_EQ(ring.size(), 1);
+    CHECK(lineIs(ring.line(0), ""));
+}
+
+static void test_clear() {
+    LogRing<3, 16> ring;
+    ring.push("a");
+    ring.push("b");
+    ring.push("c");
+    ring.push("d");
+    ring.clear();
+    CHECK_EQ(ring.size(), 0);
+
+    ring.push("e");
+    CHECK_EQ(ring.size(), 1);
+    CHECK(lineIs(ring.line(0), "e"));
+}
+
+int main() {
+    RUN_TEST(test_empty_ring);
+    RUN_TEST(test_lines_kept_oldest_first);
+    RUN_TEST(test_full_ring_overwrites_oldest);
+    RUN_TEST(test_wrap_at_every_position);
+    RUN_TEST(test_exact_width_is_not_truncated);
+    RUN_TEST(test_long_line_truncated_with_ellipsis);
+    RUN_TEST(test_empty_line);
+    RUN_TEST(test_clear);
+    return HostTest::summary();
+}
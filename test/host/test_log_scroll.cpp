@@ -0,0 +1,109 @@
+#include "HostTest.h"
+#include "HAL/LogScroll.h"
+
+typedef LogScroll<4, 10> Scroll;
+
+/**
+ * Panel memory as LINES slots of line numbers; visible(row) reads the area
+ * the way the panel shows it, from the scroll start
+ */
+struct Panel {
+    int slots[4];
+    int16_t scroll;
+
+    Panel() : scroll(0) {
+        for (int i = 0; i < 4; i++) slots[i] = -1;
+    }
+
+    void append(Scroll& log, int line) {
+        slots[log.nextSlot()] = line;
+        log.advance();
+        scroll = log.scrollRows();
+    }
+
+    int visible(int index) const {
+        int row = (scroll + index * 10) % Scroll::AREA_ROWS;
+        return slots[row / 10];
+    }
+};
+
+static void test_area_geometry() {
+    CHECK_EQ(Scroll::AREA_ROWS, 40);
+    CHECK_EQ(Scroll::slotRow(0), 0);
+    CHECK_EQ(Scroll::slotRow(3), 30);
+}
+
+static void test_filling_goes_top_down_without_scrolling() {
+    Scroll log;
+    for (size_t i = 0; i < 4; i++) {
+        CHECK_EQ(log.nextSlot(), i);
+        log.advance();
+        CHECK_EQ(log.scrollRows(), 0);
+    }
+}
+
+static void test_full_area_redraws_oldest_slot_and_scrolls() {
+    Scroll log;
+    for (int i = 0; i < 4; i++) log.advance();
+
+    // The slot at the top (oldest) is redrawn and scrolled to the bottom
+    for (size_t i = 0; i < 9; i++) {
+        size_t top = i % 4;
+        CHECK_EQ(log.nextSlot(), top);
+        log.advance();
+        CHECK_EQ(log.scrollRows(), Scroll::slotRow((top + 1) % 4));
+    }
+}
+
+static void test_visible_lines_are_the_newest_in_order() {
+    Scroll log;
+    Panel panel;
+    for (int line = 0; line < 11; line++) {
+        panel.append(log, line);
+
+        // Top to bottom: oldest kept line first, newest last; blank below
+        // while filling
+        int shown = (line + 1 < 4) ? line + 1 : 4;
+        int first = line + 1 - shown;
+        for (int i = 0; i < shown; i++) {
+            CHECK_EQ(panel.visible(i), first + i);
+        }
+        for (int i = shown; i < 4; i++) {
+            CHECK_EQ(panel.visible(i), -1);
+        }
+    }
+}
+
+static void test_reset() {
+    Scroll log;
+    for (int i = 0; i < 6; i++) log.advance();
+    CHECK(log.scrollRows() != 0);
+
+    log.reset();
+    CHECK_EQ(log.nextSlot(), 0);
+    CHECK_EQ(log.scrollRows(), 0);
+    log.advance();
+    CHECK_EQ(log.nextSlot(), 1);
+    CHECK_EQ(log.scrollRows(), 0);
+}
+
+static void test_single_line_area() {
+    LogScroll<1, 8> log;
+    CHECK_EQ(log.nextSlot(), 0);
+    log.advance();
+    for (int i = 0; i < 3; i++) {
+        CHECK_EQ(log.nextSlot(), 0);
+        log.advance();
+        CHECK_EQ(log.scrollRows(), 0);
+    }
+}
+
+int main() {
+    RUN_TEST(test_area_geometry);
+    RUN_TEST(test_filling_goes_top_down_without_scrolling);
+    RUN_TEST(test_full_area_redraws_oldest_slot_and_scrolls);
+    RUN_TEST(test_visible_lines_are_the_newest_in_order);
+    RUN_TEST(test_reset);
+    RUN_TEST(test_single_line_area);
+    return HostTest::summary();
+}
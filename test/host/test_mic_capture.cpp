@@ -0,0 +1,253 @@
+#include "HostTest.h"
+#include "HAL/M5MicCapture.h"
+#include <M5Unified.h>
+#include <vector>
+
+// One capture task for the whole run, as on the board (its thread never
+// exits); each test settles it into a known state first. The stub mic
+// fills every chunk with a running sample count, so gaps and repeats show
+// up as breaks in the sequence.
+
+static constexpr size_t FRAME = AudioConfig::FRAME_SAMPLES_16K;
+static constexpr size_t PIPELINE = 2;   // Chunks recorded but not yet pushed (three buffers rotate)
+
+static M5MicCapture& capture() {
+    static M5MicCapture* mic = new M5MicCapture();
+    return *mic;
+}
+
+static size_t readSamples(int16_t* out, size_t count) {
+    return capture().read(reinterpret_cast<uint8_t*>(out), count * sizeof(int16_t)) / sizeof(int16_t);
+}
+
+/**
+ * Switch mode, push through chunks recorded at the old size, then empty
+ * the ring and zero the counters
+ */
+static void settle(M5MicCapture::Mode mode) {
+    capture().setMode(mode);
+    M5.Mic.release(PIPELINE + 1);
+
+    std::vector<int16_t> sink(4 * FRAME);
+    while (readSamples(sink.data(), sink.size()) > 0) {}
+    capture().resetStats();
+}
+
+static bool contiguous(const std::vector<int16_t>& samples) {
+    for (size_t i = 1; i < samples.size(); i++) {
+        if (samples[i] != static_cast<int16_t>(samples[i - 1] + 1)) return false;
+    }
+    return true;
+}
+
+/**
+ * Value of the newest sample that has reached the ring
+ */
+static int16_t newestPushed(size_t chunk) {
+    return static_cast<int16_t>(M5.Mic.next() - PIPELINE * chunk - 1);
+}
+
+// ============================================================
+// FIFO
+// ============================================================
+
+static void test_fifo_frames_are_contiguous() {
+    settle(M5MicCapture::Mode::Fifo);
+    M5.Mic.release(3);
+
+    std::vector<int16_t> all;
+    int16_t frame[FRAME];
+    for (int i = 0; i < 3; i++) {
+        CHECK_EQ(readSamples(frame, FRAME), FRAME);
+        all.insert(all.end(), frame, frame + FRAME);
+    }
+    CHECK(contiguous(all));
+    CHECK_EQ(all.back(), newestPushed(FRAME));
+
+    CHECK_EQ(readSamples(frame, FRAME), 0);
+    M5MicCapture::Stats s = capture().getStats();
+    CHECK_EQ(s.framesRead, 3);
+    CHECK_EQ(s.shortReads, 1);
+    CHECK_EQ(s.skipped, 0);
+}
+
+static void test_fifo_bounds_backlog_to_three_frames() {
+    settle(M5MicCapture::Mode::Fifo);
+    M5.Mic.release(6);
+
+    int16_t frame[FRAME];
+    CHECK_EQ(readSamples(frame, FRAME), FRAME);
+    CHECK_EQ(capture().getStats().skipped, 3 * FRAME);
+
+    // Latency is measured before the skip: six frames plus the chunk in flight
+    CHECK_EQ(capture().latencyUs(), 7 * AudioConfig::FRAME_DURATION_US);
+
+    // What is left is the newest audio, still contiguous with the frame read
+    std::vector<int16_t> all(frame, frame + FRAME);
+    for (int i = 0; i < 2; i++) {
+        CHECK_EQ(readSamples(frame, FRAME), FRAME);
+        all.insert(all.end(), frame, frame + FRAME);
+    }
+    CHECK(contiguous(all));
+    CHECK_EQ(all.back(), newestPushed(FRAME));
+}
+
+static void test_full_ring_counts_overflow() {
+    settle(M5MicCapture::Mode::Fifo);
+    M5.Mic.release(10);   // 10 frames into a 1024-sample ring
+
+    CHECK_EQ(capture().getStats().overflows, 10 * FRAME - 1024);
+}
+
+// ============================================================
+// LOW LATENCY
+// ============================================================
+
+static void test_low_latency_serves_newest_audio() {
+    settle(M5MicCapture::Mode::LowLatency);
+    const size_t chunk = FRAME / 2;
+    M5.Mic.release(8);
+
+    // One chunk of slack is kept beyond the request, the rest skipped
+    std::vector<int16_t> all(FRAME);
+    CHECK_EQ(readSamples(all.data(), FRAME), FRAME);
+    CHECK_EQ(capture().getStats().skipped, 8 * chunk - FRAME - chunk);
+
+    std::vector<int16_t> rest(FRAME);
+    CHECK_EQ(readSamples(rest.data(), FRAME), chunk);
+    all.insert(all.end(), rest.begin(), rest.begin() + chunk);
+    CHECK(contiguous(all));
+    CHECK_EQ(all.back(), newestPushed(chunk));
+
+    M5MicCapture::Stats s = capture().getStats();
+    CHECK_EQ(s.framesRead, 1);
+    CHECK_EQ(s.shortReads, 1);
+}
+
+// ============================================================
+// PRE-ROLL
+// ============================================================
+
+static void test_pre_roll_catches_up_then_goes_live() {
+    settle(M5MicCapture::Mode::Fifo);
+    capture().startPreRoll();
+    M5.Mic.release(20);
+
+    // Read twice as fast as audio arrives until live audio is flowing again
+    std::vector<int16_t> all;
+    int16_t frame[FRAME];
+    for (int i = 0; i < 80; i++) {
+        if (i & 1) M5.Mic.release(1);
+        size_t got = readSamples(frame, FRAME);
+        all.insert(all.end(), frame, frame + got);
+    }
+
+    // The count looks like a steady level, so catching up skips some of
+    // it - whole blocks only, never out of order, nothing lost elsewhere
+    size_t gap = 0;
+    bool wholeBlocks = true;
+    for (size_t i = 1; i < all.size(); i++) {
+        size_t step = static_cast<uint16_t>(all[i] - all[i - 1]);
+        if (step == 1) continue;
+        if (step <= 1 || (step - 1) % FRAME != 0) wholeBlocks = false;
+        gap += step - 1;
+    }
+    PreRollBuffer::Stats s = capture().getPreRollStats();
+    CHECK(wholeBlocks);
+    CHECK_EQ(gap, s.skippedBlocks * FRAME);
+    CHECK_EQ(s.dropped, 0);
+    CHECK_EQ(all.back(), newestPushed(FRAME));
+    CHECK(s.backlogMs > 0);
+}
+
+static void test_pre_roll_cancel_returns_to_live_capture() {
+    settle(M5MicCapture::Mode::Fifo);
+    capture().startPreRoll();
+    M5.Mic.release(5);
+    capture().stopPreRoll();
+    M5.Mic.release(3);
+
+    // The backlog is dropped; the ring picks up with the next chunks pushed
+    int16_t frame[FRAME];
+    CHECK_EQ(readSamples(frame, FRAME), FRAME);
+    CHECK_EQ(frame[0], static_cast<int16_t>(newestPushed(FRAME) - 3 * FRAME + 1));
+}
+
+// ============================================================
+// WAKE-WORD LISTENING
+// ============================================================
+
+static constexpr size_t SETTLE_FRAMES = (MicDutyCycle::SETTLE_MS * 16 + FRAME - 1) / FRAME;
+static constexpr size_t SNIFF_FRAMES = MicDutyCycle::SNIFF_MS * 16 / FRAME;
+
+/**
+ * Start listening: the chunk in flight was taken with listening off, the
+ * next ones settle the mic
+ */
+static void startListening() {
+    capture().setListening(true);
+    M5.Mic.release(1);
+    M5.Mic.release(SETTLE_FRAMES);
+}
+
+static void test_listening_ring_follows_live_capture() {
+    settle(M5MicCapture::Mode::Fifo);
+    capture().setDutyCycling(false);
+    startListening();
+    M5.Mic.release(4);
+
+    std::vector<int16_t> heard(8 * FRAME);
+    heard.resize(capture().readListening(heard.data(), heard.size()));
+    CHECK_EQ(heard.size(), 4 * FRAME);
+    CHECK(contiguous(heard));
+    CHECK_EQ(heard.back(), newestPushed(FRAME));
+    CHECK_EQ(M5.Mic.ends(), 0);
+
+    // Off from the chunk after the one in flight
+    capture().setListening(false);
+    M5.Mic.release(1);
+    capture().readListening(heard.data(), heard.size());
+    M5.Mic.release(4);
+    CHECK_EQ(capture().readListening(heard.data(), heard.size()), 0);
+    capture().setDutyCycling(true);
+}
+
+static void test_quiet_room_puts_mic_to_sleep() {
+    settle(M5MicCapture::Mode::Fifo);
+    M5.Mic.setQuiet(true);
+    uint32_t ends = M5.Mic.ends();
+    uint32_t begins = M5.Mic.begins();
+    startListening();
+
+    // A quiet sniff window, then the mic is off until the next record()
+    M5.Mic.release(SNIFF_FRAMES);
+    CHECK_EQ(M5.Mic.ends(), ends + 1);
+    CHECK_EQ(M5.Mic.begins(), begins + 1);
+
+    MicDutyCycle::Stats s = capture().getDutyCycleStats();
+    CHECK_EQ(s.sleeps, 1);
+    CHECK_EQ(s.wakeups, 0);
+    CHECK_EQ(s.offMs, MicDutyCycle::SLEEP_MS);
+
+    std::vector<int16_t> heard(16 * FRAME);
+    CHECK_EQ(capture().readListening(heard.data(), heard.size()), SNIFF_FRAMES * FRAME);
+
+    capture().setListening(false);
+    M5.Mic.setQuiet(false);
+}
+
+int main() {
+    capture().enablePreRoll(PreRollBuffer::Storage::Psram);
+    capture().begin();
+    CHECK(capture().isRunning());
+
+    RUN_TEST(test_fifo_frames_are_contiguous);
+    RUN_TEST(test_fifo_bounds_backlog_to_three_frames);
+    RUN_TEST(test_full_ring_counts_overflow);
+    RUN_TEST(test_low_latency_serves_newest_audio);
+    RUN_TEST(test_pre_roll_catches_up_then_goes_live);
+    RUN_TEST(test_pre_roll_cancel_returns_to_live_capture);
+    RUN_TEST(test_listening_ring_follows_live_capture);
+    RUN_TEST(test_quiet_room_puts_mic_to_sleep);
+    return HostTest::summary();
+}
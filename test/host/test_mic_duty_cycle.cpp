@@ -0,0 +1,170 @@
+#include "HostTest.h"
+#include "Audio/AudioConfig.h"
+#include "Audio/MicDutyCycle.h"
+#include <cmath>
+#include <cstdint>
+
+static constexpr uint32_t RATE = 16000;
+static constexpr size_t FRAME = AudioConfig::FRAME_SAMPLES_16K;   // 7.5ms
+
+// Whole mic frames that cover a duration
+static size_t framesFor(uint32_t ms) {
+    return (ms * (RATE / 1000) + FRAME - 1) / FRAME;
+}
+
+struct Mic {
+    MicDutyCycle duty;
+    int16_t frame[FRAME];
+    uint32_t seed = 1;
+    float phase = 0.0f;
+    size_t spoken = 0;
+
+    Mic() { duty.reset(RATE); }
+
+    // Room tone around -60 dBFS
+    void quiet() {
+        for (size_t i = 0; i < FRAME; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            frame[i] = static_cast<int16_t>(static_cast<int32_t>(seed) >> 26);
+        }
+    }
+
+    // Syllables: a voiced-level tone 150ms on, 100ms off
+    void speech() {
+        for (size_t i = 0; i < FRAME; i++) {
+            bool voiced = (spoken++ % (RATE / 4)) < RATE * 150 / 1000;
+            frame[i] = voiced ? static_cast<int16_t>(6000.0f * sinf(phase)) : 0;
+            phase += 6.283185307f * 220.0f / RATE;
+        }
+    }
+
+    /**
+     * Feed frames until a sleep is due
+     * @return frames fed (limit + 1 if no sleep came)
+     */
+    size_t untilSleep(bool talking, size_t limit) {
+        for (size_t n = 1; n <= limit; n++) {
+            talking ? speech() : quiet();
+            duty.onChunk(frame, FRAME);
+            if (duty.sleepDue()) return n;
+        }
+        return limit + 1;
+    }
+};
+
+// ============================================================
+// SNIFFING
+// ============================================================
+
+// In a quiet room: SETTLE_MS dropped, SNIFF_MS passed on, then sleep
+static void test_quiet_room_sniffs_then_sleeps() {
+    Mic mic;
+    size_t settle = framesFor(MicDutyCycle::SETTLE_MS);
+    for (size_t n = 0; n < settle; n++) {
+        mic.quiet();
+        CHECK(!mic.duty.onChunk(mic.frame, FRAME));
+    }
+    size_t sniff = MicDutyCycle::SNIFF_MS * (RATE / 1000) / FRAME;
+    for (size_t n = 0; n < sniff; n++) {
+        CHECK(!mic.duty.sleepDue());
+        mic.quiet();
+        CHECK(mic.duty.onChunk(mic.frame, FRAME));
+    }
+    CHECK(mic.duty.sleepDue());
+
+    MicDutyCycle::Stats s = mic.duty.getStats();
+    CHECK_EQ(s.sleeps, 1u);
+    CHECK_EQ(s.wakeups, 0u);
+    CHECK_EQ(s.onMs, (settle + sniff) * FRAME / (RATE / 1000));
+    CHECK_EQ(s.offMs, 0u);
+}
+
+// Waking settles again, and the off time is what the caller slept
+static void test_wake_settles_again() {
+    Mic mic;
+    size_t first = mic.untilSleep(false, 100);
+    CHECK(first <= 100);
+    mic.duty.onWake(MicDutyCycle::SLEEP_MS);
+    CHECK(!mic.duty.sleepDue());
+    mic.quiet();
+    CHECK(!mic.duty.onChunk(mic.frame, FRAME));
+
+    // The cycle repeats: same frames to the next sleep
+    mic.duty.onWake(0);
+    CHECK_EQ(mic.untilSleep(false, 100), first);
+    mic.duty.onWake(MicDutyCycle::SLEEP_MS / 2);
+
+    MicDutyCycle::Stats s = mic.duty.getStats();
+    CHECK_EQ(s.sleeps, 2u);
+    CHECK_EQ(s.offMs, MicDutyCycle::SLEEP_MS + MicDutyCycle::SLEEP_MS / 2);
+    // Duty cycle in a quiet room: a third of the time on, or less
+    CHECK(s.onMs * 3 <= s.onMs + s.offMs + MicDutyCycle::SLEEP_MS);
+}
+
+// ============================================================
+// SPEECH
+// ============================================================
+
+// Speech in a sniff keeps the mic on while it lasts and HOLD_MS after,
+// then one more quiet sniff before sleeping
+static void test_speech_holds_the_mic_on() {
+    Mic mic;
+    for (size_t n = 0; n < framesFor(MicDutyCycle::SETTLE_MS) + 2; n++) {
+        mic.quiet();
+        mic.duty.onChunk(mic.frame, FRAME);
+    }
+    // Twelve syllables, stopping as the last one ends
+    const size_t talk = framesFor(12 * 250 - 100);
+    CHECK_EQ(mic.untilSleep(true, talk), talk + 1);
+    CHECK_EQ(mic.duty.getStats().wakeups, 1u);
+
+    size_t quietFrames = mic.untilSleep(false, framesFor(5000));
+    size_t least = framesFor(MicDutyCycle::HOLD_MS + MicDutyCycle::SNIFF_MS) - 1;
+    CHECK(quietFrames >= least);
+    // The detector's own hangover is at most a few hundred ms
+    CHECK(quietFrames <= least + framesFor(500));
+    CHECK_EQ(mic.duty.getStats().sleeps, 1u);
+}
+
+// ============================================================
+// CONTROL
+// ============================================================
+
+// Disabled, the mic is never put to sleep, but audio still flows
+static void test_disabled_never_sleeps() {
+    Mic mic;
+    mic.duty.setEnabled(false);
+    CHECK(!mic.duty.isEnabled());
+    CHECK_EQ(mic.untilSleep(false, framesFor(5000)), framesFor(5000) + 1);
+    MicDutyCycle::Stats s = mic.duty.getStats();
+    CHECK_EQ(s.sleeps, 0u);
+    CHECK(s.onMs >= 5000 - 8);
+    CHECK(s.onMs <= 5000 + 8);
+
+    mic.duty.setEnabled(true);
+    CHECK(mic.untilSleep(false, framesFor(MicDutyCycle::SNIFF_MS) + 1) <= framesFor(MicDutyCycle::SNIFF_MS) + 1);
+}
+
+// reset() starts over: stats cleared, settling first
+static void test_reset_starts_over() {
+    Mic mic;
+    mic.untilSleep(false, 100);
+    mic.duty.onWake(MicDutyCycle::SLEEP_MS);
+    mic.duty.reset(RATE);
+    MicDutyCycle::Stats s = mic.duty.getStats();
+    CHECK_EQ(s.sleeps, 0u);
+    CHECK_EQ(s.offMs, 0u);
+    CHECK_EQ(s.onMs, 0u);
+    CHECK(!mic.duty.sleepDue());
+    mic.quiet();
+    CHECK(!mic.duty.onChunk(mic.frame, FRAME));
+}
+
+int main() {
+    RUN_TEST(test_quiet_room_sniffs_then_sleeps);
+    RUN_TEST(test_wake_settles_again);
+    RUN_TEST(test_speech_holds_the_mic_on);
+    RUN_TEST(test_disabled_never_sleeps);
+    RUN_TEST(test_reset_starts_over);
+    return HostTest::summary();
+}
@@ -0,0 +1,263 @@
+#include "HostTest.h"
+#include "WavFixture.h"
+#include "Audio/HalfbandConverter.h"
+#include "Audio/NoiseSuppressor.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Replays a recording mixed with background noise through NoiseSuppressor
+// and scores the output against the clean recording.
+//
+//   test_ns_replay [recording.wav]
+//
+// Defaults to fixtures/voiced_16k.wav, as test_plc_replay. The clip runs
+// at 16kHz in 120-sample frames (mSBC) and, decimated, at 8kHz in 60-sample
+// frames (CVSD). A second of noise alone leads in, as on a call that
+// connects before the user talks. Scores are segmental SNR over the speech
+// frames - each frame's SNR clamped to [-10, 35] dB, as in test_plc_replay -
+// before and after the stage (whose 15ms delay is taken out), and the
+// attenuation of the noise in the pauses. Each process() call is timed;
+// on the device the same frames are counted in cycles by the stage itself
+// ([NS] in the session log).
+
+static constexpr float SEG_MIN_DB = -10.0f;
+static constexpr float SEG_MAX_DB = 35.0f;
+static constexpr int32_t SILENT_LEVEL = 100;   // Mean |x| of clean frames counted as pauses
+static constexpr uint32_t LEAD_IN_MS = 1000;
+
+// Pass marks, a few dB under what the fixture measures
+static constexpr float GAIN_MIN_DB = 2.5f;        // Segmental SNR gain at 0 and 5dB input
+static constexpr float PAUSE_MIN_DB = 10.0f;      // Noise attenuation between syllables
+
+struct NoiseKind {
+    const char* name;
+    float pole;   // One-pole lowpass on white noise (0: white)
+};
+
+// Broadband hiss, and the low-heavy rumble of HVAC and fans
+static const NoiseKind NOISES[] = {
+    {"white", 0.0f},
+    {"rumble", 0.95f},
+};
+
+static const float INPUT_SNRS_DB[] = {0.0f, 5.0f, 10.0f};
+
+/**
+ * Unit-variance noise, roughly Gaussian (sum of four uniforms), optionally
+ * lowpassed with the filter's power gain undone
+ */
+struct Noise {
+    uint32_t seed = 777;
+    float state = 0.0f;
+    float pole;
+    float norm;
+
+    explicit Noise(float p) : pole(p), norm(sqrtf(1.0f - p * p)) {}
+
+    float next() {
+        float sum = 0.0f;
+        for (int i = 0; i < 4; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            sum += static_cast<float>(static_cast<int32_t>(seed)) / 2147483648.0f;
+        }
+        state = pole * state + sum * 0.866f;
+        return state * norm;
+    }
+};
+
+static int16_t saturate16(float v) {
+    if (v > 32767.0f) return 32767;
+    if (v < -32768.0f) return -32768;
+    return static_cast<int16_t>(lrintf(v));
+}
+
+static bool isSilent(const int16_t* x, size_t n) {
+    int64_t level = 0;
+    for (size_t i = 0; i < n; i++) level += (x[i] < 0) ? -x[i] : x[i];
+    return level / static_cast<int64_t>(n) < SILENT_LEVEL;
+}
+
+static double power(const int16_t* x, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++) sum += static_cast<double>(x[i]) * x[i];
+    return sum;
+}
+
+/**
+ * The recording at 8kHz, through the same half-band decimator as the mic
+ * path
+ */
+static Recording decimate(const Recording& rec) {
+    HalfbandDownsampler down;
+    down.reset();
+    Recording out;
+    out.sampleRate = rec.sampleRate / 2;
+    out.samples.resize(rec.samples.size() / 2);
+    const size_t block = HalfbandDownsampler::MAX_INPUT;
+    size_t written = 0;
+    for (size_t pos = 0; pos + 2 <= rec.samples.size(); pos += block) {
+        size_t n = std::min(block, rec.samples.size() - pos);
+        written += down.process(&rec.samples[pos], n, &out.samples[written]);
+    }
+    out.samples.resize(written);
+    return out;
+}
+
+struct Scene {
+    std::vector<int16_t> clean;   // Lead-in silence, then the recording
+    std::vector<int16_t> noisy;
+    size_t speechStart;
+};
+
+/**
+ * Clean and noisy input: noise scaled for snrDb against the speech frames
+ */
+static Scene mix(const Recording& rec, size_t frame, const NoiseKind& kind, float snrDb) {
+    Scene scene;
+    scene.speechStart = (rec.sampleRate * LEAD_IN_MS / 1000) / frame * frame;
+    size_t frames = (scene.speechStart + rec.samples.size()) / frame;
+    scene.clean.assign(frames * frame, 0);
+    std::copy(rec.samples.begin(), rec.samples.begin() + (frames * frame - scene.speechStart),
+              scene.clean.begin() + scene.speechStart);
+
+    double speech = 0.0;
+    size_t speechSamples = 0;
+    for (size_t pos = scene.speechStart; pos < scene.clean.size(); pos += frame) {
+        if (isSilent(&scene.clean[pos], frame)) continue;
+        speech += power(&scene.clean[pos], frame);
+        speechSamples += frame;
+    }
+    float rms = static_cast<float>(sqrt(speech / speechSamples) * pow(10.0, -snrDb / 20.0));
+
+    Noise noise(kind.pole);
+    scene.noisy.resize(scene.clean.size());
+    for (size_t i = 0; i < scene.clean.size(); i++) {
+        scene.noisy[i] = saturate16(scene.clean[i] + rms * noise.next());
+    }
+    return scene;
+}
+
+struct Timing {
+    double totalUs = 0.0;
+    double maxUs = 0.0;
+    size_t frames = 0;
+};
+
+/**
+ * Run the noisy input through the stage a frame at a time, timing each call
+ */
+static std::vector<int16_t> suppress(const Scene& scene, uint32_t rate, size_t frame, Timing& timing) {
+    static NoiseSuppressor ns;   // ~20KB of state
+    ns.reset(rate);
+    std::vector<int16_t> out(scene.noisy.size());
+    for (size_t pos = 0; pos < out.size(); pos += frame) {
+        auto t0 = std::chrono::steady_clock::now();
+        ns.process(&scene.noisy[pos], &out[pos], frame);
+        auto t1 = std::chrono::steady_clock::now();
+        double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+        timing.totalUs += us;
+        if (us > timing.maxUs) timing.maxUs = us;
+        timing.frames++;
+    }
+    return out;
+}
+
+struct Score {
+    float segSnrDb;      // Over speech frames
+    float pauseDb;       // Noise power removed in the pauses (0 for the input)
+};
+
+/**
+ * Score a signal against the clean input, delay samples late
+ */
+static Score score(const Scene& scene, const std::vector<int16_t>& x, size_t delay, size_t frame) {
+    float total = 0.0f;
+    size_t speechFrames = 0;
+    double noiseIn = 0.0;
+    double noiseOut = 0.0;
+    for (size_t pos = scene.speechStart; pos + delay + frame <= x.size(); pos += frame) {
+        const int16_t* ref = &scene.clean[pos];
+        const int16_t* got = &x[pos + delay];
+        if (isSilent(ref, frame)) {
+            noiseIn += power(&scene.noisy[pos], frame);
+            noiseOut += power(got, frame);
+            continue;
+        }
+        double signal = 0.0;
+        double err = 0.0;
+        for (size_t i = 0; i < frame; i++) {
+            double e = static_cast<double>(got[i]) - ref[i];
+            signal += static_cast<double>(ref[i]) * ref[i];
+            err += e * e;
+        }
+        float snr = (err > 0.0) ? static_cast<float>(10.0 * log10(signal / err)) : SEG_MAX_DB;
+        total += std::min(std::max(snr, SEG_MIN_DB), SEG_MAX_DB);
+        speechFrames++;
+    }
+    Score s;
+    s.segSnrDb = speechFrames ? total / speechFrames : 0.0f;
+    s.pauseDb = static_cast<float>(10.0 * log10((noiseIn + 1.0) / (noiseOut + 1.0)));
+    return s;
+}
+
+static const char* g_path = NS_FIXTURE;
+static Recording g_recording;
+
+static void test_fixture_loads() {
+    CHECK(loadWav(g_path, g_recording));
+    CHECK(g_recording.samples.size() >= g_recording.sampleRate / 2);
+}
+
+/**
+ * Every noise and input SNR at one link rate
+ */
+static void replayAt(const Recording& rec) {
+    // 7.5ms SCO frames; the stage is two hops late
+    size_t frame = rec.sampleRate * 75 / 10000;
+    size_t delay = 2 * frame;
+
+    printf("  %uHz, %zu-sample frames\n", static_cast<unsigned>(rec.sampleRate), frame);
+    printf("  %-8s %6s %9s %9s %7s %7s\n", "noise", "input", "seg in", "seg out", "gain", "pause");
+    Timing timing;
+    for (const NoiseKind& kind : NOISES) {
+        for (float snrDb : INPUT_SNRS_DB) {
+            Scene scene = mix(rec, frame, kind, snrDb);
+            std::vector<int16_t> out = suppress(scene, rec.sampleRate, frame, timing);
+            Score before = score(scene, scene.noisy, 0, frame);
+            Score after = score(scene, out, delay, frame);
+            float gain = after.segSnrDb - before.segSnrDb;
+            printf("  %-8s %4.0fdB %7.1fdB %7.1fdB %5.1fdB %5.1fdB\n", kind.name, snrDb, before.segSnrDb,
+                   after.segSnrDb, gain, after.pauseDb);
+
+            if (snrDb < 10.0f) CHECK(gain > GAIN_MIN_DB);
+            CHECK(gain > 0.0f);
+            CHECK(after.pauseDb > PAUSE_MIN_DB);
+        }
+    }
+    printf("  process(): %.1fus per frame, max %.1fus (host)\n", timing.totalUs / timing.frames, timing.maxUs);
+}
+
+static void test_wideband_replay() {
+    if (g_recording.samples.empty()) return;
+    if (g_recording.sampleRate == 16000) {
+        replayAt(g_recording);
+    }
+}
+
+static void test_narrowband_replay() {
+    if (g_recording.samples.empty()) return;
+    replayAt(g_recording.sampleRate == 16000 ? decimate(g_recording) : g_recording);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) g_path = argv[1];
+
+    RUN_TEST(test_fixture_loads);
+    RUN_TEST(test_wideband_replay);
+    RUN_TEST(test_narrowband_replay);
+    return HostTest::summary();
+}
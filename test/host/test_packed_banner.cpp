@@ -0,0 +1,107 @@
+#include "HostTest.h"
+#include "HAL/PackedBanner.h"
+#include <vector>
+
+// Pixel values as a swap565 canvas holds them (panel byte order)
+static constexpr uint16_t GREEN = 0xE007;
+static constexpr uint16_t WHITE = 0xFFFF;
+static constexpr uint16_t GREY = 0x18C6;
+
+/**
+ * A status banner: flat background, a block of "large text" and a
+ * one-pixel-stroked "label" underneath
+ */
+static std::vector<uint16_t> banner(int width, int height, uint16_t bg) {
+    std::vector<uint16_t> pixels(static_cast<size_t>(width) * height, bg);
+    for (int y = height / 4; y < height / 2; y++) {
+        for (int x = width / 4; x < 3 * width / 4; x++) {
+            if ((x / 3 + y / 2) % 3 != 0) pixels[y * width + x] = WHITE;
+        }
+    }
+    for (int x = 10; x < width - 10; x += 2) pixels[(3 * height / 4) * width + x] = GREY;
+    return pixels;
+}
+
+static bool roundTrips(const PackedBanner& packed, const std::vector<uint16_t>& pixels) {
+    std::vector<uint16_t> out(pixels.size(), 0x1234);
+    packed.unpack(out.data());
+    return out == pixels;
+}
+
+// ============================================================
+// PACKING
+// ============================================================
+
+static void test_banners_round_trip_exactly() {
+    // CoreS3 and StickC status canvases, and an odd pixel count
+    const int sizes[][2] = {{320, 100}, {135, 80}, {135, 81}};
+    for (const auto& size : sizes) {
+        std::vector<uint16_t> pixels = banner(size[0], size[1], GREEN);
+        PackedBanner packed;
+        CHECK(packed.pack(pixels.data(), pixels.size()));
+        CHECK(packed.isPacked());
+        CHECK_EQ(packed.colors(), 3);
+        CHECK_EQ(packed.pixelCount(), pixels.size());
+        CHECK(roundTrips(packed, pixels));
+    }
+    CHECK_EQ(PackedBanner::packedBytes(320 * 100), 16000);
+    CHECK_EQ(PackedBanner::packedBytes(135 * 81), 5468);
+}
+
+static void test_byte_order_is_kept() {
+    // Byte-swapped twins are different colours
+    std::vector<uint16_t> pixels = {0x001F, 0x1F00, 0x001F, 0xF800, 0x00F8};
+    PackedBanner packed;
+    CHECK(packed.pack(pixels.data(), pixels.size()));
+    CHECK_EQ(packed.colors(), 4);
+    CHECK(roundTrips(packed, pixels));
+}
+
+static void test_sixteen_colours_pack() {
+    std::vector<uint16_t> pixels(1000);
+    for (size_t i = 0; i < pixels.size(); i++) pixels[i] = static_cast<uint16_t>((i * 7) % 16 * 0x0841);
+    PackedBanner packed;
+    CHECK(packed.pack(pixels.data(), pixels.size()));
+    CHECK_EQ(packed.colors(), PackedBanner::MAX_COLORS);
+    CHECK(roundTrips(packed, pixels));
+}
+
+// ============================================================
+// REFUSAL AND REUSE
+// ============================================================
+
+static void test_seventeenth_colour_is_refused() {
+    // An anti-aliased edge would bring in-between shades: draw it live
+    std::vector<uint16_t> pixels = banner(135, 80, GREEN);
+    for (int i = 0; i < 13; i++) pixels[i] = static_cast<uint16_t>(0x1000 + i);
+    PackedBanner packed;
+    CHECK(packed.pack(pixels.data(), pixels.size()));
+    CHECK_EQ(packed.colors(), PackedBanner::MAX_COLORS);
+
+    pixels[500] = 0x4242;
+    CHECK(!packed.pack(pixels.data(), pixels.size()));
+    CHECK(!packed.isPacked());
+    CHECK_EQ(packed.pixelCount(), 0);
+}
+
+static void test_repack_replaces_contents() {
+    std::vector<uint16_t> first = banner(135, 80, GREEN);
+    std::vector<uint16_t> second = banner(135, 80, 0x1F00);
+    std::vector<uint16_t> smaller = banner(64, 20, GREY);
+    PackedBanner packed;
+    CHECK(packed.pack(first.data(), first.size()));
+    CHECK(packed.pack(second.data(), second.size()));
+    CHECK(roundTrips(packed, second));
+    CHECK(packed.pack(smaller.data(), smaller.size()));
+    CHECK_EQ(packed.pixelCount(), smaller.size());
+    CHECK(roundTrips(packed, smaller));
+}
+
+int main() {
+    RUN_TEST(test_banners_round_trip_exactly);
+    RUN_TEST(test_byte_order_is_kept);
+    RUN_TEST(test_sixteen_colours_pack);
+    RUN_TEST(test_seventeenth_colour_is_refused);
+    RUN_TEST(test_repack_replaces_contents);
+    return HostTest::summary();
+}
@@ -0,0 +1,206 @@
+#include "HostTest.h"
+#include "Audio/PacketLossConcealer.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+static constexpr uint32_t RATE = 16000;
+static constexpr size_t FRAME = 120;      // 7.5ms mSBC frame
+static constexpr size_t PERIOD = 128;     // 125Hz voiced pitch at 16kHz
+
+// Periodic, speech-level test signal: fundamental plus two harmonics
+static int16_t voiced(size_t n) {
+    float phase = 2.0f * static_cast<float>(M_PI) * static_cast<float>(n % PERIOD) / PERIOD;
+    return static_cast<int16_t>(6000.0f * sinf(phase) + 2500.0f * sinf(2 * phase) + 1200.0f * sinf(3 * phase));
+}
+
+static void fillVoiced(int16_t* frame, size_t start) {
+    for (size_t i = 0; i < FRAME; i++) frame[i] = voiced(start + i);
+}
+
+static bool allZero(const int16_t* frame) {
+    for (size_t i = 0; i < FRAME; i++) {
+        if (frame[i] != 0) return false;
+    }
+    return true;
+}
+
+static int32_t meanAbs(const int16_t* frame) {
+    int32_t sum = 0;
+    for (size_t i = 0; i < FRAME; i++) sum += abs(frame[i]);
+    return sum / static_cast<int32_t>(FRAME);
+}
+
+// Feed good voiced frames; returns the next sample index
+static size_t primeVoiced(PacketLossConcealer& plc, size_t frames) {
+    int16_t frame[FRAME];
+    size_t n = 0;
+    for (size_t f = 0; f < frames; f++, n += FRAME) {
+        fillVoiced(frame, n);
+        CHECK(!plc.isCorrupt(frame, FRAME));
+        plc.processGood(frame, FRAME);
+    }
+    return n;
+}
+
+static void test_good_frames_pass_through() {
+    PacketLossConcealer plc;
+    plc.reset(RATE);
+
+    int16_t frame[FRAME];
+    int16_t expected[FRAME];
+    for (size_t f = 0, n = 0; f < 10; f++, n += FRAME) {
+        fillVoiced(frame, n);
+        memcpy(expected, frame, sizeof(frame));
+        plc.processGood(frame, FRAME);
+        CHECK(memcmp(frame, expected, sizeof(frame)) == 0);
+    }
+    CHECK(!plc.isConcealing());
+}
+
+static void test_conceal_without_history_is_silent() {
+    PacketLossConcealer plc;
+    plc.reset(RATE);
+
+    int16_t out[FRAME];
+    memset(out, 0x55, sizeof(out));
+    CHECK(!plc.conceal(out, FRAME));
+    CHECK(allZero(out));
+}
+
+static void test_conceal_repeats_pitch_period() {
+    PacketLossConcealer plc;
+    plc.reset(RATE);
+    size_t n = primeVoiced(plc, 8);
+
+    int16_t out[FRAME];
+    CHECK(plc.conceal(out, FRAME));
+    CHECK(plc.isConcealing());
+
+    // Within the full-level window the substitute continues the waveform
+    int32_t maxErr = 0;
+    for (size_t i = 0; i < FRAME; i++) {
+        int32_t err = abs(out[i] - voiced(n + i));
+        if (err > maxErr) maxErr = err;
+    }
+    CHECK(maxErr < 1500);
+    CHECK(meanAbs(out) > 2000);
+}
+
+static void test_long_loss_fades_to_silence() {
+    PacketLossConcealer plc;
+    plc.reset(RATE);
+    primeVoiced(plc, 8);
+
+    // 60ms mute point = 8 frames of 7.5ms
+    int16_t out[FRAME];
+    for (int f = 0; f < 8; f++) plc.conceal(out, FRAME);
+    CHECK(!plc.conceal(out, FRAME));
+    CHECK(allZero(out));
+}
+
+static void test_recovery_has_no_click() {
+    PacketLossConcealer plc;
+    plc.reset(RATE);
+    size_t n = primeVoiced(plc, 8);
+
+    int16_t frame[FRAME];
+    plc.conceal(frame, FRAME);
+    n += FRAME;
+    int16_t lastSynthetic = frame[FRAME - 1];
+
+    fillVoiced(frame, n);
+    plc.processGood(frame, FRAME);
+    CHECK(!plc.isConcealing());
+    CHECK(abs(frame[0] - lastSynthetic) < 1500);
+}
+
+static void test_zero_frame_in_speech_is_concealed() {
+    PacketLossConcealer plc;
+    plc.reset(RATE);
+    primeVoiced(plc, 8);
+
+    int16_t frame[FRAME] = {0};
+    CHECK(plc.isCorrupt(frame, FRAME));
+}
+
+static void test_zero_run_becomes_silence() {
+    PacketLossConcealer plc;
+    plc.reset(RATE);
+    size_t n = primeVoiced(plc, 8);
+
+    // The first zero frames are concealed as loss, the run beyond that is
+    // genuine digital silence and passes through
+    int16_t frame[FRAME];
+    int concealed = 0;
+    for (int f = 0; f < 10; f++) {
+        memset(frame, 0, sizeof(frame));
+        if (plc.isCorrupt(frame, FRAME)) {
+            plc.conceal(frame, FRAME);
+            concealed++;
+        } else {
+            plc.processGood(frame, FRAME);
+            if (f > concealed) CHECK(allZero(frame));
+        }
+    }
+    CHECK_EQ(concealed, 2);
+    CHECK(!plc.isConcealing());
+
+    // Signal after the silence is good again, and a later dropout in it is
+    // concealed again
+    for (int f = 0; f < 4; f++, n += FRAME) {
+        fillVoiced(frame, n);
+        CHECK(!plc.isCorrupt(frame, FRAME));
+        plc.processGood(frame, FRAME);
+    }
+    memset(frame, 0, sizeof(frame));
+    CHECK(plc.isCorrupt(frame, FRAME));
+}
+
+static void test_zeros_after_quiet_audio_are_silence() {
+    PacketLossConcealer plc;
+    plc.reset(RATE);
+
+    int16_t frame[FRAME];
+    for (size_t i = 0; i < FRAME; i++) frame[i] = static_cast<int16_t>((i & 1) ? 20 : -20);
+    plc.processGood(frame, FRAME);
+
+    memset(frame, 0, sizeof(frame));
+    CHECK(!plc.isCorrupt(frame, FRAME));
+}
+
+static void test_narrowband() {
+    PacketLossConcealer plc;
+    plc.reset(8000);
+
+    // 60-sample CVSD frames, 80-sample (100Hz) period
+    int16_t frame[60];
+    size_t n = 0;
+    for (int f = 0; f < 10; f++) {
+        for (size_t i = 0; i < 60; i++, n++) {
+            frame[i] = static_cast<int16_t>(8000.0f * sinf(2.0f * static_cast<float>(M_PI) * (n % 80) / 80.0f));
+        }
+        plc.processGood(frame, 60);
+    }
+    CHECK(plc.conceal(frame, 60));
+    int32_t maxErr = 0;
+    for (size_t i = 0; i < 60; i++, n++) {
+        float expected = 8000.0f * sinf(2.0f * static_cast<float>(M_PI) * (n % 80) / 80.0f);
+        int32_t err = abs(frame[i] - static_cast<int32_t>(expected));
+        if (err > maxErr) maxErr = err;
+    }
+    CHECK(maxErr < 1000);
+}
+
+int main() {
+    RUN_TEST(test_good_frames_pass_through);
+    RUN_TEST(test_conceal_without_history_is_silent);
+    RUN_TEST(test_conceal_repeats_pitch_period);
+    RUN_TEST(test_long_loss_fades_to_silence);
+    RUN_TEST(test_recovery_has_no_click);
+    RUN_TEST(test_zero_frame_in_speech_is_concealed);
+    RUN_TEST(test_zero_run_becomes_silence);
+    RUN_TEST(test_zeros_after_quiet_audio_are_silence);
+    RUN_TEST(test_narrowband);
+    return HostTest::summary();
+}
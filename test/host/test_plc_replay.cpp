@@ -0,0 +1,172 @@
+#include "HostTest.h"
+#include "WavFixture.h"
+#include "Audio/PacketLossConcealer.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Replays a recording through PacketLossConcealer under fixed loss
+// patterns and scores it against zero-fill, the speaker path's behavior
+// without concealment.
+//
+//   test_plc_replay [recording.wav]
+//
+// Defaults to fixtures/voiced_16k.wav (see make_voiced_fixture.py); any
+// 16-bit mono 8kHz or 16kHz WAV can be passed instead. Scores are
+// segmental SNR - each frame's SNR clamped to [-10, 35] dB, silent frames
+// left out - over the lost frames, where zero-fill scores 0dB by
+// definition, and separately over the first good frame after each loss,
+// which the concealer cross-fades and zero-fill passes untouched.
+
+static constexpr float SEG_MIN_DB = -10.0f;
+static constexpr float SEG_MAX_DB = 35.0f;
+static constexpr int32_t SILENT_LEVEL = 100;   // Mean |x| of frames left out of the score
+
+// Pass marks, a few dB under what the fixture measures
+static constexpr float GAIN_MIN_DB = 2.5f;       // PLC over zero-fill on lost frames
+static constexpr float RECOVERY_MIN_DB = 7.0f;   // First good frame after a loss
+
+// ============================================================
+// LOSS PATTERNS
+// ============================================================
+
+struct LossPattern {
+    const char* name;
+    uint32_t everyFrames;   // Mean spacing between loss events
+    uint32_t burstFrames;   // Frames lost per event
+};
+
+// Link-level dropouts as the jitter buffer sees them: isolated SCO
+// packets, then the 2-4 frame bursts of a busy 2.4GHz channel
+static const LossPattern PATTERNS[] = {
+    {"single, 5%", 20, 1},
+    {"single, 15%", 7, 1},
+    {"burst 2, 10%", 20, 2},
+    {"burst 4, 10%", 40, 4},
+};
+
+/**
+ * Deterministic loss mask: events land at a jittered spacing around
+ * everyFrames, so every pattern hits onsets, steady vowels and decays
+ */
+static std::vector<bool> lossMask(const LossPattern& pattern, size_t frames) {
+    std::vector<bool> lost(frames, false);
+    uint32_t seed = 12345;
+    size_t next = pattern.everyFrames / 2;
+    while (next < frames) {
+        for (size_t i = 0; i < pattern.burstFrames && next + i < frames; i++) lost[next + i] = true;
+        seed = seed * 1103515245 + 12345;
+        size_t jitter = (seed >> 16) % pattern.everyFrames;
+        next += pattern.burstFrames + pattern.everyFrames / 2 + jitter;
+    }
+    return lost;
+}
+
+// ============================================================
+// REPLAY
+// ============================================================
+
+/**
+ * Run the recording through the speaker path's loss handling
+ * @param conceal true for PacketLossConcealer, false for zero-fill
+ */
+static std::vector<int16_t> replay(const Recording& rec, size_t frame, const std::vector<bool>& lost, bool conceal) {
+    PacketLossConcealer plc;
+    plc.reset(rec.sampleRate);
+
+    std::vector<int16_t> out(lost.size() * frame);
+    for (size_t f = 0; f < lost.size(); f++) {
+        int16_t* dst = &out[f * frame];
+        if (!lost[f]) {
+            memcpy(dst, &rec.samples[f * frame], frame * sizeof(int16_t));
+            if (conceal) plc.processGood(dst, frame);
+        } else if (conceal) {
+            plc.conceal(dst, frame);
+        } else {
+            memset(dst, 0, frame * sizeof(int16_t));
+        }
+    }
+    return out;
+}
+
+enum class Scored { Lost, Recovery };
+
+/**
+ * Segmental SNR over the lost frames, or over the first good frame after
+ * each loss
+ * @return dB; frames counts the frames scored
+ */
+static float segSnr(const Recording& rec, const std::vector<int16_t>& out, size_t frame,
+                    const std::vector<bool>& lost, Scored which, size_t& frames) {
+    float total = 0.0f;
+    frames = 0;
+    for (size_t f = 0; f < lost.size(); f++) {
+        bool recovery = !lost[f] && f > 0 && lost[f - 1];
+        if (which == Scored::Lost ? !lost[f] : !recovery) continue;
+
+        double signal = 0.0;
+        double noise = 0.0;
+        int64_t level = 0;
+        for (size_t i = f * frame; i < (f + 1) * frame; i++) {
+            double ref = rec.samples[i];
+            double err = ref - out[i];
+            signal += ref * ref;
+            noise += err * err;
+            level += (rec.samples[i] < 0) ? -rec.samples[i] : rec.samples[i];
+        }
+        if (level / static_cast<int64_t>(frame) < SILENT_LEVEL) continue;
+
+        float snr = (noise > 0.0) ? static_cast<float>(10.0 * log10(signal / noise)) : SEG_MAX_DB;
+        if (snr < SEG_MIN_DB) snr = SEG_MIN_DB;
+        if (snr > SEG_MAX_DB) snr = SEG_MAX_DB;
+        total += snr;
+        frames++;
+    }
+    return frames ? total / frames : 0.0f;
+}
+
+static const char* g_path = PLC_FIXTURE;
+static Recording g_recording;
+
+static void test_fixture_loads() {
+    CHECK(loadWav(g_path, g_recording));
+    CHECK(g_recording.samples.size() >= g_recording.sampleRate / 2);
+}
+
+static void test_concealment_beats_zero_fill() {
+    if (g_recording.samples.empty()) return;
+
+    // 7.5ms SCO frames: 60 samples CVSD, 120 mSBC
+    size_t frame = g_recording.sampleRate * 75 / 10000;
+    size_t frames = g_recording.samples.size() / frame;
+
+    printf("  %s: %zu frames of %zu samples\n", g_path, frames, frame);
+    printf("  %-14s %6s %10s %8s %8s %10s\n", "pattern", "lost", "zero-fill", "PLC", "gain", "recovery");
+    for (const LossPattern& pattern : PATTERNS) {
+        std::vector<bool> lost = lossMask(pattern, frames);
+        std::vector<int16_t> zeroFilled = replay(g_recording, frame, lost, false);
+        std::vector<int16_t> concealed = replay(g_recording, frame, lost, true);
+
+        size_t scored = 0;
+        size_t recovered = 0;
+        float zeroFill = segSnr(g_recording, zeroFilled, frame, lost, Scored::Lost, scored);
+        float plc = segSnr(g_recording, concealed, frame, lost, Scored::Lost, scored);
+        float recovery = segSnr(g_recording, concealed, frame, lost, Scored::Recovery, recovered);
+        printf("  %-14s %6zu %8.1fdB %6.1fdB %6.1fdB %8.1fdB\n", pattern.name, scored, zeroFill, plc,
+               plc - zeroFill, recovery);
+
+        CHECK(scored >= 10);
+        CHECK(plc - zeroFill > GAIN_MIN_DB);
+        CHECK(recovery > RECOVERY_MIN_DB);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) g_path = argv[1];
+
+    RUN_TEST(test_fixture_loads);
+    RUN_TEST(test_concealment_beats_zero_fill);
+    return HostTest::summary();
+}
@@ -0,0 +1,322 @@
+#include "HostTest.h"
+#include "Audio/PreRollBuffer.h"
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+static constexpr size_t BLOCK = PreRollBuffer::BLOCK_SAMPLES;
+static constexpr size_t BLOCK_COUNT =
+    (PreRollBuffer::CAPACITY_MS * 1000 + AudioConfig::FRAME_DURATION_US - 1) / AudioConfig::FRAME_DURATION_US;
+
+/**
+ * One block: sample 0 carries the block's number, the rest are speech
+ * level (loud) or silence
+ */
+static void makeBlock(int16_t* block, int number, bool loud) {
+    block[0] = static_cast<int16_t>(number);
+    for (size_t i = 1; i < BLOCK; i++) block[i] = loud ? static_cast<int16_t>((i & 1) ? 20000 : -20000) : 0;
+}
+
+static void writeBlock(PreRollBuffer& pre, int number, bool loud) {
+    int16_t block[BLOCK];
+    makeBlock(block, number, loud);
+    CHECK(pre.write(block, BLOCK));
+}
+
+/**
+ * Read whole blocks until the backlog is empty
+ * @return The block numbers in the order they came out
+ */
+static std::vector<int> drainBlocks(PreRollBuffer& pre) {
+    std::vector<int> numbers;
+    int16_t block[BLOCK];
+    while (pre.read(block, BLOCK) == BLOCK) numbers.push_back(block[0]);
+    return numbers;
+}
+
+// ============================================================
+// RECORDING
+// ============================================================
+
+static void test_idle_buffer_declines_audio() {
+    PreRollBuffer pre;
+    CHECK(pre.begin(PreRollBuffer::Storage::Psram));
+    int16_t block[BLOCK] = {0};
+    CHECK(!pre.write(block, BLOCK));
+    CHECK(!pre.isServing());
+}
+
+static void test_backlog_served_in_order() {
+    PreRollBuffer pre;
+    pre.begin(PreRollBuffer::Storage::Psram);
+    pre.arm();
+    CHECK(pre.isServing());
+    for (int i = 0; i < 6; i++) writeBlock(pre, i, i != 0);
+    CHECK_EQ(pre.available(), 6 * BLOCK);
+
+    std::vector<int> numbers = drainBlocks(pre);
+    CHECK_EQ(numbers.size(), 6);
+    for (size_t i = 0; i < numbers.size(); i++) CHECK_EQ(numbers[i], i);
+    CHECK_NEAR(pre.getStats().backlogMs, 45, 1);
+}
+
+static void test_odd_chunks_staged_into_blocks() {
+    PreRollBuffer pre;
+    pre.begin(PreRollBuffer::Storage::Psram);
+    pre.arm();
+
+    // Half-frame chunks, as the LowLatency capture mode writes them
+    std::vector<int16_t> audio(4 * BLOCK);
+    for (size_t i = 0; i < audio.size(); i++) audio[i] = static_cast<int16_t>(i);
+    for (size_t pos = 0; pos < audio.size(); pos += BLOCK / 2) {
+        CHECK(pre.write(&audio[pos], BLOCK / 2));
+    }
+
+    std::vector<int16_t> out(audio.size());
+    CHECK_EQ(pre.read(out.data(), out.size()), out.size());
+    CHECK(out == audio);
+}
+
+static void test_overflow_keeps_newest_blocks() {
+    PreRollBuffer pre;
+    pre.begin(PreRollBuffer::Storage::Psram);
+    pre.arm();
+    const int extra = 10;
+    for (int i = 0; i < static_cast<int>(BLOCK_COUNT) + extra; i++) writeBlock(pre, i, true);
+
+    PreRollBuffer::Stats s = pre.getStats();
+    CHECK_EQ(s.overwritten, extra);
+    CHECK_EQ(s.dropped, 0);
+    CHECK_EQ(pre.available(), BLOCK_COUNT * BLOCK);
+
+    // Blocks of equal level are pauses to the reader, so they are skipped
+    // down to the catch-up margin; what remains is the newest audio, in order
+    std::vector<int> numbers = drainBlocks(pre);
+    CHECK(!numbers.empty());
+    CHECK_EQ(numbers.front(), extra);
+    CHECK_EQ(numbers.back(), static_cast<int>(BLOCK_COUNT) + extra - 1);
+    for (size_t i = 1; i < numbers.size(); i++) CHECK(numbers[i] > numbers[i - 1]);
+}
+
+static void test_full_ring_drops_while_draining() {
+    PreRollBuffer pre;
+    pre.begin(PreRollBuffer::Storage::Psram);
+    pre.arm();
+    for (int i = 0; i < static_cast<int>(BLOCK_COUNT); i++) writeBlock(pre, i, (i & 1) != 0);
+
+    // The reader owns the oldest block now; the writer may not overwrite it
+    int16_t block[BLOCK];
+    CHECK_EQ(pre.read(block, 1), 1);
+    CHECK_EQ(block[0], 0);
+    writeBlock(pre, 9999, true);
+    PreRollBuffer::Stats s = pre.getStats();
+    CHECK_EQ(s.overwritten, 0);
+    CHECK_EQ(s.dropped, 0);   // One slot came free when the reader took block 0
+    writeBlock(pre, 10000, true);
+    CHECK_EQ(pre.getStats().dropped, 1);
+}
+
+// ============================================================
+// CATCH-UP
+// ============================================================
+
+static void test_catch_up_skips_repeated_pause_blocks() {
+    PreRollBuffer pre;
+    pre.begin(PreRollBuffer::Storage::Psram);
+    pre.arm();
+    // quiet, speech, speech, pause x4, speech, speech
+    const bool loud[] = {false, true, true, false, false, false, false, true, true};
+    for (int i = 0; i < 9; i++) writeBlock(pre, i, loud[i]);
+
+    // The first block of a pause is kept; the rest go while at least
+    // two blocks are still queued behind them
+    std::vector<int> numbers = drainBlocks(pre);
+    const int expected[] = {0, 1, 2, 3, 7, 8};
+    CHECK_EQ(numbers.size(), 6);
+    for (size_t i = 0; i < numbers.size() && i < 6; i++) CHECK_EQ(numbers[i], expected[i]);
+    CHECK_EQ(pre.getStats().skippedBlocks, 3);
+}
+
+static void test_speech_is_never_skipped() {
+    PreRollBuffer pre;
+    pre.begin(PreRollBuffer::Storage::Psram);
+    pre.arm();
+    writeBlock(pre, 0, false);   // Sets the noise floor
+    for (int i = 1; i < 40; i++) writeBlock(pre, i, true);
+    CHECK_EQ(drainBlocks(pre).size(), 40);
+    CHECK_EQ(pre.getStats().skippedBlocks, 0);
+}
+
+static void test_handover_flushes_partial_block_then_goes_live() {
+    PreRollBuffer pre;
+    pre.begin(PreRollBuffer::Storage::Psram);
+    pre.arm();
+    for (int i = 0; i < 5; i++) writeBlock(pre, i, i != 0);
+    int16_t partial[30];
+    for (int i = 0; i < 30; i++) partial[i] = static_cast<int16_t>(500 + i);
+    CHECK(pre.write(partial, 30));
+
+    // Draining until the writer is within CATCH_UP_BLOCKS
+    int16_t block[BLOCK];
+    CHECK(!pre.shouldHandOver());   // Still recording
+    CHECK_EQ(pre.read(block, BLOCK), BLOCK);
+    CHECK_EQ(block[0], 0);
+    CHECK(!pre.shouldHandOver());
+    CHECK_EQ(pre.read(block, BLOCK), BLOCK);
+    CHECK_EQ(pre.read(block, BLOCK), BLOCK);
+    CHECK(pre.shouldHandOver());
+    pre.handOver();
+    CHECK(pre.isHandedOver());
+    CHECK(pre.isServing());
+
+    // The capture task's next chunk goes live; the staged samples are kept
+    int16_t live[BLOCK] = {0};
+    CHECK(!pre.write(live, BLOCK));
+    CHECK(!pre.write(live, BLOCK));
+    CHECK_EQ(pre.available(), 2 * BLOCK + 30);
+
+    CHECK_EQ(pre.read(block, BLOCK), BLOCK);
+    CHECK_EQ(pre.read(block, BLOCK), BLOCK);
+    CHECK_EQ(block[0], 4);
+    CHECK_EQ(pre.read(block, BLOCK), 30);
+    CHECK_EQ(block[0], 500);
+    CHECK_EQ(block[29], 529);
+    // Fully drained: the mic path goes back to the live ring
+    CHECK(!pre.isServing());
+}
+
+// ============================================================
+// CONTROL
+// ============================================================
+
+static void test_rearm_after_cancel_starts_clean() {
+    PreRollBuffer pre;
+    pre.begin(PreRollBuffer::Storage::Psram);
+    pre.arm();
+    for (int i = 0; i < static_cast<int>(BLOCK_COUNT) + 3; i++) writeBlock(pre, i, true);
+    int16_t block[BLOCK];
+    pre.read(block, BLOCK);
+
+    pre.cancel();
+    CHECK(!pre.isServing());
+    CHECK(!pre.write(block, BLOCK));
+
+    pre.arm();
+    PreRollBuffer::Stats s = pre.getStats();
+    CHECK_EQ(s.overwritten, 0);
+    CHECK_EQ(s.backlogMs, 0);
+    CHECK_EQ(pre.available(), 0);
+
+    // Nothing from the cancelled session comes back, staging included
+    int16_t half[BLOCK / 2] = {0};
+    writeBlock(pre, 77, true);
+    CHECK(pre.write(half, BLOCK / 2));
+    CHECK_EQ(pre.read(block, BLOCK), BLOCK);
+    CHECK_EQ(block[0], 77);
+}
+
+static void test_arm_ignored_while_active() {
+    PreRollBuffer pre;
+    pre.begin(PreRollBuffer::Storage::Psram);
+    pre.arm();
+    writeBlock(pre, 1, true);
+    pre.arm();   // A second trigger before SCO is up
+    CHECK_EQ(pre.available(), BLOCK);
+}
+
+// ============================================================
+// STORAGE
+// ============================================================
+
+static void test_adpcm_blocks_decode_independently() {
+    PreRollBuffer pre;
+    CHECK(pre.begin(PreRollBuffer::Storage::Adpcm));
+    CHECK(pre.storage() == PreRollBuffer::Storage::Adpcm);
+    pre.arm();
+
+    // Over capacity, so decoding starts mid-stream from a block header
+    const size_t total = (BLOCK_COUNT + 20) * BLOCK;
+    std::vector<int16_t> audio(total);
+    for (size_t i = 0; i < total; i++) {
+        audio[i] = static_cast<int16_t>(lrint(8000.0 * sin(2.0 * M_PI * 400.0 * i / 16000.0)));
+    }
+    for (size_t pos = 0; pos < total; pos += BLOCK) pre.write(&audio[pos], BLOCK);
+    CHECK_EQ(pre.getStats().overwritten, 20);
+
+    // Steady tone: every block is a pause after the first, so only the
+    // catch-up margin and the first block come out; compare what does
+    std::vector<int16_t> out(BLOCK);
+    double signal = 0.0;
+    double noise = 0.0;
+    size_t blocks = 0;
+    while (pre.read(out.data(), BLOCK) == BLOCK) {
+        blocks++;
+        // Blocks hold 120 samples of a 40-sample period, so any block's
+        // samples match the source at the same phase
+        for (size_t i = 0; i < BLOCK; i++) {
+            double ref = audio[i];
+            signal += ref * ref;
+            noise += (out[i] - ref) * (out[i] - ref);
+        }
+    }
+    CHECK(blocks >= 2);
+    CHECK(10.0 * log10(signal / noise) > 25.0);
+}
+
+// ============================================================
+// CAPTURE TASK / MIC PATH THREADS
+// ============================================================
+
+static void test_reader_racing_overwriting_writer() {
+    // The writer overwrites the oldest block while the reader starts
+    // draining it; the reader must retry, never hand out a torn block
+    for (int round = 0; round < 50; round++) {
+        PreRollBuffer pre;
+        pre.begin(PreRollBuffer::Storage::Psram);
+        pre.arm();
+        std::atomic<bool> stop{false};
+
+        std::thread writer([&]() {
+            int16_t block[BLOCK];
+            for (int n = 1; n < 3 * static_cast<int>(BLOCK_COUNT) && !stop.load(); n++) {
+                for (size_t i = 0; i < BLOCK; i++) block[i] = static_cast<int16_t>(n);
+                pre.write(block, BLOCK);
+            }
+        });
+
+        // Start draining at some point while the writer is overwriting
+        std::this_thread::sleep_for(std::chrono::microseconds(round * 20));
+        int16_t block[BLOCK];
+        int last = 0;
+        bool whole = true;
+        bool ordered = true;
+        for (int k = 0; k < 200; k++) {
+            if (pre.read(block, BLOCK) != BLOCK) continue;
+            for (size_t i = 1; i < BLOCK; i++) whole = whole && block[i] == block[0];
+            ordered = ordered && block[0] > last;
+            last = block[0];
+        }
+        stop.store(true);
+        writer.join();
+
+        CHECK(whole);
+        CHECK(ordered);
+    }
+}
+
+int main() {
+    RUN_TEST(test_idle_buffer_declines_audio);
+    RUN_TEST(test_backlog_served_in_order);
+    RUN_TEST(test_odd_chunks_staged_into_blocks);
+    RUN_TEST(test_overflow_keeps_newest_blocks);
+    RUN_TEST(test_full_ring_drops_while_draining);
+    RUN_TEST(test_catch_up_skips_repeated_pause_blocks);
+    RUN_TEST(test_speech_is_never_skipped);
+    RUN_TEST(test_handover_flushes_partial_block_then_goes_live);
+    RUN_TEST(test_rearm_after_cancel_starts_clean);
+    RUN_TEST(test_arm_ignored_while_active);
+    RUN_TEST(test_adpcm_blocks_decode_independently);
+    RUN_TEST(test_reader_racing_overwriting_writer);
+    return HostTest::summary();
+}
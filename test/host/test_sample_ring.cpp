@@ -0,0 +1,136 @@
+#include "HostTest.h"
+#include "Audio/SampleRing.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+static std::vector<int16_t> ramp(int16_t start, size_t count) {
+    std::vector<int16_t> samples(count);
+    for (size_t i = 0; i < count; i++) samples[i] = static_cast<int16_t>(start + i);
+    return samples;
+}
+
+static void test_samples_come_out_in_order() {
+    SampleRing<16> ring;
+    std::vector<int16_t> in = ramp(0, 10);
+    CHECK_EQ(ring.write(in.data(), in.size()), 10);
+    CHECK_EQ(ring.available(), 10);
+
+    std::vector<int16_t> out(10);
+    CHECK_EQ(ring.read(out.data(), out.size()), 10);
+    CHECK(out == in);
+    CHECK_EQ(ring.available(), 0);
+}
+
+static void test_wrap_at_every_position() {
+    SampleRing<16> ring;
+    int16_t next = 0;
+    for (size_t offset = 0; offset < 16; offset++) {
+        // Move the indices one step, then push a chunk across the end
+        std::vector<int16_t> filler = ramp(next, 1);
+        ring.write(filler.data(), 1);
+        int16_t dummy;
+        ring.read(&dummy, 1);
+        next++;
+
+        std::vector<int16_t> in = ramp(next, 12);
+        CHECK_EQ(ring.write(in.data(), in.size()), 12);
+        std::vector<int16_t> out(12);
+        CHECK_EQ(ring.read(out.data(), out.size()), 12);
+        CHECK(out == in);
+        next = static_cast<int16_t>(next + 12);
+    }
+}
+
+static void test_full_ring_drops_newest_and_counts() {
+    SampleRing<16> ring;
+    std::vector<int16_t> in = ramp(0, 20);
+    CHECK_EQ(ring.write(in.data(), in.size()), 16);
+    CHECK_EQ(ring.overflows(), 4);
+
+    // Unread samples are never overwritten
+    std::vector<int16_t> out(16);
+    ring.read(out.data(), out.size());
+    CHECK(out == ramp(0, 16));
+
+    ring.clearOverflows();
+    CHECK_EQ(ring.overflows(), 0);
+}
+
+static void test_short_read_returns_what_is_buffered() {
+    SampleRing<16> ring;
+    std::vector<int16_t> in = ramp(0, 5);
+    ring.write(in.data(), in.size());
+
+    std::vector<int16_t> out(8, -1);
+    CHECK_EQ(ring.read(out.data(), out.size()), 5);
+    for (size_t i = 0; i < 5; i++) CHECK_EQ(out[i], i);
+    CHECK_EQ(out[5], -1);
+}
+
+static void test_skip_and_flush_drop_oldest() {
+    SampleRing<16> ring;
+    std::vector<int16_t> in = ramp(0, 10);
+    ring.write(in.data(), in.size());
+
+    CHECK_EQ(ring.skip(4), 4);
+    int16_t sample = 0;
+    ring.read(&sample, 1);
+    CHECK_EQ(sample, 4);
+
+    CHECK_EQ(ring.skip(100), 5);
+    CHECK_EQ(ring.available(), 0);
+
+    ring.write(in.data(), in.size());
+    ring.flush();
+    CHECK_EQ(ring.available(), 0);
+    CHECK_EQ(ring.overflows(), 0);
+}
+
+static void test_reader_racing_writer() {
+    // The capture task writes chunks while the audio callback reads frames
+    static SampleRing<256> ring;
+    static constexpr uint32_t TOTAL = 30000;
+    std::atomic<bool> done{false};
+
+    std::thread writer([&]() {
+        uint32_t next = 0;
+        int16_t chunk[60];
+        while (next < TOTAL) {
+            for (size_t i = 0; i < 60; i++) chunk[i] = static_cast<int16_t>(next + i);
+            if (ring.available() + 60 > ring.capacity()) {
+                std::this_thread::yield();
+                continue;
+            }
+            ring.write(chunk, 60);
+            next += 60;
+        }
+        done.store(true);
+    });
+
+    uint32_t expected = 0;
+    bool inOrder = true;
+    int16_t frame[120];
+    while (!done.load() || ring.available() > 0) {
+        size_t got = ring.read(frame, 120);
+        for (size_t i = 0; i < got; i++) {
+            if (frame[i] != static_cast<int16_t>(expected)) inOrder = false;
+            expected++;
+        }
+    }
+    writer.join();
+
+    CHECK(inOrder);
+    CHECK(expected >= TOTAL);
+    CHECK_EQ(ring.overflows(), 0);
+}
+
+int main() {
+    RUN_TEST(test_samples_come_out_in_order);
+    RUN_TEST(test_wrap_at_every_position);
+    RUN_TEST(test_full_ring_drops_newest_and_counts);
+    RUN_TEST(test_short_read_returns_what_is_buffered);
+    RUN_TEST(test_skip_and_flush_drop_oldest);
+    RUN_TEST(test_reader_racing_writer);
+    return HostTest::summary();
+}
@@ -0,0 +1,178 @@
+#include "HostTest.h"
+#include "Audio/Histogram.h"
+#include "Audio/ScoTiming.h"
+#include <cstdint>
+
+typedef ScoTiming::Direction Dir;
+typedef ScoTiming::Codec Codec;
+
+// ============================================================
+// HISTOGRAM
+// ============================================================
+
+static void test_empty_histogram_reports_zero() {
+    Histogram<10, 100> h;
+    CHECK_EQ(h.count(), 0);
+    CHECK_EQ(h.min(), 0);
+    CHECK_EQ(h.max(), 0);
+    CHECK_EQ(h.percentile(50), 0);
+    CHECK_EQ(h.percentile(99), 0);
+}
+
+static void test_percentile_is_bucket_upper_edge() {
+    Histogram<10, 100> h;
+    for (uint32_t v = 0; v < 100; v++) h.add(v * 5);   // 0..495, 20 per bucket
+    CHECK_EQ(h.count(), 100);
+    CHECK_EQ(h.min(), 0);
+    CHECK_EQ(h.max(), 495);
+    CHECK_EQ(h.percentile(1), 100);
+    CHECK_EQ(h.percentile(20), 100);
+    CHECK_EQ(h.percentile(21), 200);
+    CHECK_EQ(h.percentile(50), 300);
+    // Upper edge 500 is past the largest value: clamped to max
+    CHECK_EQ(h.percentile(99), 495);
+    CHECK_EQ(h.percentile(100), 495);
+}
+
+static void test_single_outlier_sets_p99_only_above_1pct() {
+    Histogram<10, 100> h;
+    for (int i = 0; i < 99; i++) h.add(150);
+    h.add(950);
+    CHECK_EQ(h.percentile(50), 200);
+    CHECK_EQ(h.percentile(99), 200);
+    CHECK_EQ(h.percentile(100), 950);
+
+    h.add(950);   // Now 2 of 101 (> 1%)
+    CHECK_EQ(h.percentile(99), 950);
+}
+
+static void test_values_past_range_report_true_max() {
+    Histogram<4, 10> h;   // Range 0..40
+    h.add(5);
+    h.add(1000000);
+    CHECK_EQ(h.max(), 1000000);
+    CHECK_EQ(h.percentile(50), 10);
+    CHECK_EQ(h.percentile(100), 1000000);
+}
+
+static void test_histogram_reset() {
+    Histogram<4, 10> h;
+    h.add(7);
+    h.add(33);
+    h.reset();
+    CHECK_EQ(h.count(), 0);
+    CHECK_EQ(h.max(), 0);
+    CHECK_EQ(h.min(), 0);
+    h.add(12);
+    CHECK_EQ(h.min(), 12);
+    CHECK_EQ(h.max(), 12);
+    CHECK_EQ(h.percentile(50), 12);
+}
+
+// ============================================================
+// SCO TIMING
+// ============================================================
+
+/**
+ * Record a run of callbacks every periodUs from startUs, each taking execUs
+ * @return Start time of the next call
+ */
+static int64_t feed(ScoTiming& t, Dir dir, int64_t startUs, int calls, int64_t periodUs,
+                    int64_t execUs, uint32_t bytes) {
+    for (int i = 0; i < calls; i++, startUs += periodUs) {
+        t.record(dir, startUs, startUs + execUs, bytes);
+    }
+    return startUs;
+}
+
+static void test_steady_pacing() {
+    ScoTiming t;
+    t.reset();
+    t.setCodec(Codec::Msbc);
+    feed(t, Dir::Incoming, 1000000, 400, 7500, 85, 60);
+
+    ScoTiming::Summary s = t.getSummary(Dir::Incoming, Codec::Msbc);
+    CHECK_EQ(s.calls, 400);
+    CHECK_EQ(s.late, 0);
+    CHECK_EQ(s.intervalP50Us, 7500);   // Bucket [7500, 7750) is clamped to the max
+    CHECK_EQ(s.intervalP99Us, 7500);
+    CHECK_EQ(s.intervalMaxUs, 7500);
+    CHECK_EQ(s.execP50Us, 85);
+    CHECK_EQ(s.execMaxUs, 85);
+    CHECK_EQ(s.bytesMin, 60);
+    CHECK_EQ(s.bytesMax, 60);
+
+    // Nothing leaked into the other direction or codec
+    CHECK_EQ(t.getSummary(Dir::Outgoing, Codec::Msbc).calls, 0);
+    CHECK_EQ(t.getSummary(Dir::Incoming, Codec::Cvsd).calls, 0);
+}
+
+static void test_bursty_pacing_counts_late() {
+    ScoTiming t;
+    t.reset();
+    t.setCodec(Codec::Cvsd);
+
+    // Stack delivers pairs: 15ms gap then an immediate second call
+    int64_t now = 1000000;
+    for (int i = 0; i < 100; i++) {
+        t.record(Dir::Outgoing, now, now + 50, 60);
+        t.record(Dir::Outgoing, now + 200, now + 250, 60);
+        now += 15000;
+    }
+    ScoTiming::Summary s = t.getSummary(Dir::Outgoing, Codec::Cvsd);
+    CHECK_EQ(s.calls, 200);
+    CHECK_EQ(s.late, 99);              // 14.8ms gaps, over 1.5 frames
+    CHECK(s.intervalP50Us <= 250);
+    CHECK(s.intervalP99Us >= 14750);
+    CHECK_EQ(s.intervalMaxUs, 14800);
+}
+
+static void test_codec_change_restarts_interval_chain() {
+    ScoTiming t;
+    t.reset();
+    t.setCodec(Codec::Cvsd);
+    int64_t now = feed(t, Dir::Incoming, 1000000, 10, 7500, 40, 60);
+
+    // A 2s gap between sessions must not count as a late interval
+    t.setCodec(Codec::Msbc);
+    feed(t, Dir::Incoming, now + 2000000, 10, 7500, 40, 60);
+
+    ScoTiming::Summary cvsd = t.getSummary(Dir::Incoming, Codec::Cvsd);
+    ScoTiming::Summary msbc = t.getSummary(Dir::Incoming, Codec::Msbc);
+    CHECK_EQ(cvsd.calls, 10);
+    CHECK_EQ(msbc.calls, 10);
+    CHECK_EQ(msbc.late, 0);
+    CHECK_EQ(msbc.intervalMaxUs, 7500);
+    CHECK_EQ(t.codec(), Codec::Msbc);
+}
+
+static void test_reset_clears_all_channels() {
+    ScoTiming t;
+    t.reset();
+    t.setCodec(Codec::Msbc);
+    feed(t, Dir::Incoming, 1000000, 5, 7500, 40, 60);
+    feed(t, Dir::Outgoing, 1000000, 5, 30000, 40, 60);
+    CHECK_EQ(t.getSummary(Dir::Outgoing, Codec::Msbc).late, 4);
+
+    t.reset();
+    feed(t, Dir::Outgoing, 2000000, 3, 7500, 40, 120);
+    ScoTiming::Summary s = t.getSummary(Dir::Outgoing, Codec::Msbc);
+    CHECK_EQ(s.calls, 3);
+    CHECK_EQ(s.late, 0);
+    CHECK_EQ(s.intervalMaxUs, 7500);
+    CHECK_EQ(s.bytesMin, 120);
+    CHECK_EQ(t.getSummary(Dir::Incoming, Codec::Msbc).calls, 0);
+}
+
+int main() {
+    RUN_TEST(test_empty_histogram_reports_zero);
+    RUN_TEST(test_percentile_is_bucket_upper_edge);
+    RUN_TEST(test_single_outlier_sets_p99_only_above_1pct);
+    RUN_TEST(test_values_past_range_report_true_max);
+    RUN_TEST(test_histogram_reset);
+    RUN_TEST(test_steady_pacing);
+    RUN_TEST(test_bursty_pacing_counts_late);
+    RUN_TEST(test_codec_change_restarts_interval_chain);
+    RUN_TEST(test_reset_clears_all_channels);
+    return HostTest::summary();
+}
@@ -0,0 +1,297 @@
+#include "HostTest.h"
+#include "Audio/ImaAdpcm.h"
+#include "Audio/SessionRecorder.h"
+#include "esp_spiffs.h"
+#include "freertos/task.h"
+#include <cmath>
+#include <cstring>
+#include <dirent.h>
+#include <string>
+#include <vector>
+
+// SESSION_RECORDER_BASE_PATH points the recorder at a scratch directory
+// in the build tree; the stub partition is that directory.
+
+static constexpr uint32_t RATE = 16000;
+static constexpr size_t FRAME = AudioConfig::FRAME_SAMPLES_16K;
+static constexpr size_t BATCH_FRAMES = 60;   // Fits the 8192-sample ring between task passes
+static const std::string DIR_PATH = SESSION_RECORDER_BASE_PATH;
+
+static std::string sessionFile(uint32_t index, const char* stream) {
+    char name[32];
+    snprintf(name, sizeof(name), "/s%05u_%s.wav", index, stream);
+    return DIR_PATH + name;
+}
+
+static void clearPartition() {
+    DIR* dir = opendir(DIR_PATH.c_str());
+    if (!dir) return;
+    while (struct dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') remove((DIR_PATH + "/" + entry->d_name).c_str());
+    }
+    closedir(dir);
+}
+
+static bool exists(const std::string& path) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (f) fclose(f);
+    return f != nullptr;
+}
+
+static void writeFile(const std::string& path, size_t bytes) {
+    FILE* f = fopen(path.c_str(), "wb");
+    std::vector<uint8_t> data(bytes, 0);
+    fwrite(data.data(), 1, data.size(), f);
+    fclose(f);
+}
+
+static std::vector<uint8_t> readFile(const std::string& path) {
+    std::vector<uint8_t> data;
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return data;
+    uint8_t buf[4096];
+    size_t got;
+    while ((got = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + got);
+    fclose(f);
+    return data;
+}
+
+static uint32_t le32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static uint16_t le16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+/**
+ * A recorder on a fresh task; never destroyed, its task outlives the test
+ */
+static SessionRecorder& newRecorder() {
+    SessionRecorder* rec = new SessionRecorder();
+    CHECK(rec->begin());
+    return *rec;
+}
+
+// Let the recorder task run at least one full pass
+static void waitPass(SessionRecorder& rec) {
+    uint32_t start = host_task_delays(&rec);
+    while (host_task_delays(&rec) < start + 2) {}
+}
+
+struct Tone {
+    float freq;
+    float amplitude;
+    size_t n = 0;
+
+    Tone(float f, float a) : freq(f), amplitude(a) {}
+
+    int16_t at(size_t i) const {
+        return static_cast<int16_t>(amplitude * sinf(2.0f * static_cast<float>(M_PI) * freq * i / RATE));
+    }
+
+    void frame(int16_t* out) {
+        for (size_t i = 0; i < FRAME; i++) out[i] = at(n++);
+    }
+};
+
+/**
+ * Record frames of both streams, pausing for the task between batches
+ */
+static void recordFrames(SessionRecorder& rec, Tone& rx, Tone& tx, size_t frames) {
+    int16_t frame[FRAME];
+    for (size_t f = 0; f < frames; f++) {
+        rx.frame(frame);
+        rec.record(SessionRecorder::Stream::Incoming, frame, FRAME);
+        tx.frame(frame);
+        rec.record(SessionRecorder::Stream::Outgoing, frame, FRAME);
+        if ((f + 1) % BATCH_FRAMES == 0) waitPass(rec);
+    }
+}
+
+/**
+ * Decode a session file's data and compare it with the tone it recorded
+ * @return SNR in dB
+ */
+static float decodedSnr(const std::vector<uint8_t>& file, const Tone& tone, size_t samples) {
+    std::vector<int16_t> decoded;
+    for (size_t pos = SessionRecorder::BLOCK_BYTES; pos + SessionRecorder::BLOCK_BYTES <= file.size();
+         pos += SessionRecorder::BLOCK_BYTES) {
+        const uint8_t* block = &file[pos];
+        int16_t predictor = static_cast<int16_t>(le16(block));
+        uint8_t index = block[2];
+        decoded.push_back(predictor);
+        for (size_t i = 4; i < SessionRecorder::BLOCK_BYTES; i++) {
+            decoded.push_back(adpcmStep(block[i] & 0x0F, predictor, index));
+            decoded.push_back(adpcmStep(block[i] >> 4, predictor, index));
+        }
+    }
+    if (decoded.size() < samples) return 0.0f;
+
+    double signal = 0.0;
+    double noise = 0.0;
+    for (size_t i = 0; i < samples; i++) {
+        double ref = tone.at(i);
+        signal += ref * ref;
+        noise += (decoded[i] - ref) * (decoded[i] - ref);
+    }
+    return static_cast<float>(10.0 * log10(signal / (noise + 1.0)));
+}
+
+// ============================================================
+// FILE LAYOUT
+// ============================================================
+
+static void test_session_files_are_block_aligned_adpcm_wav() {
+    clearPartition();
+    host_spiffs_set_total(4 * 1024 * 1024);
+    SessionRecorder& rec = newRecorder();
+
+    rec.start(RATE);
+    Tone rx(400.0f, 8000.0f);
+    Tone tx(1000.0f, 2000.0f);
+    recordFrames(rec, rx, tx, 8 * BATCH_FRAMES);   // 3.6s
+    rec.stop();
+    waitPass(rec);
+
+    const uint32_t samples = 8 * BATCH_FRAMES * FRAME;
+    const uint32_t blocks = (samples + SessionRecorder::BLOCK_SAMPLES - 1) / SessionRecorder::BLOCK_SAMPLES;
+    const uint32_t fileBytes = SessionRecorder::BLOCK_BYTES * (1 + blocks);
+
+    const char* streams[] = {"rx", "tx"};
+    const Tone* tones[] = {&rx, &tx};
+    for (int s = 0; s < 2; s++) {
+        std::vector<uint8_t> file = readFile(sessionFile(0, streams[s]));
+        CHECK_EQ(file.size(), fileBytes);
+        if (file.size() != fileBytes) continue;
+        const uint8_t* h = file.data();
+
+        CHECK(memcmp(h, "RIFF", 4) == 0);
+        CHECK_EQ(le32(h + 4), fileBytes - 8);
+        CHECK(memcmp(h + 8, "WAVE", 4) == 0);
+
+        CHECK(memcmp(h + 12, "fmt ", 4) == 0);
+        CHECK_EQ(le16(h + 20), 0x0011);   // IMA ADPCM
+        CHECK_EQ(le16(h + 22), 1);
+        CHECK_EQ(le32(h + 24), RATE);
+        CHECK_EQ(le16(h + 32), SessionRecorder::BLOCK_BYTES);
+        CHECK_EQ(le16(h + 34), 4);
+        CHECK_EQ(le16(h + 38), SessionRecorder::BLOCK_SAMPLES);
+
+        CHECK(memcmp(h + 40, "fact", 4) == 0);
+        CHECK_EQ(le32(h + 48), samples);
+
+        // Data starts one block in
+        CHECK(memcmp(h + SessionRecorder::BLOCK_BYTES - 8, "data", 4) == 0);
+        CHECK_EQ(le32(h + SessionRecorder::BLOCK_BYTES - 4), blocks * SessionRecorder::BLOCK_BYTES);
+
+        // Each stream holds its own audio
+        CHECK(decodedSnr(file, *tones[s], samples) > 20.0f);
+        CHECK(decodedSnr(file, *tones[1 - s], samples) < 3.0f);
+    }
+
+    SessionRecorder::Stats st = rec.getStats();
+    CHECK_EQ(st.sessions, 1);
+    CHECK_EQ(st.session, 0);
+    CHECK_EQ(st.bytesWritten, 2 * fileBytes);
+    CHECK_EQ(st.droppedFrames, 0);
+}
+
+// ============================================================
+// SESSIONS AND RETENTION
+// ============================================================
+
+static void test_numbering_continues_after_reboot() {
+    clearPartition();
+    host_spiffs_set_total(4 * 1024 * 1024);
+    writeFile(sessionFile(7, "rx"), 1024);
+    writeFile(sessionFile(7, "tx"), 1024);
+    SessionRecorder& rec = newRecorder();
+
+    Tone rx(400.0f, 8000.0f);
+    Tone tx(1000.0f, 2000.0f);
+    rec.start(RATE);
+    recordFrames(rec, rx, tx, BATCH_FRAMES);
+
+    // A new SCO link while recording: one session ends, the next begins
+    rec.start(RATE);
+    waitPass(rec);
+    recordFrames(rec, rx, tx, BATCH_FRAMES);
+    rec.stop();
+    waitPass(rec);
+
+    CHECK(exists(sessionFile(7, "rx")));
+    CHECK(exists(sessionFile(8, "rx")) && exists(sessionFile(8, "tx")));
+    CHECK(exists(sessionFile(9, "rx")) && exists(sessionFile(9, "tx")));
+    CHECK_EQ(rec.getStats().sessions, 2);
+    CHECK_EQ(rec.getStats().session, 9);
+}
+
+static void test_retention_deletes_oldest_sessions() {
+    clearPartition();
+
+    // Four old sessions of 40KB in 600KB: a new one needs 512KB free, so
+    // the two oldest go
+    host_spiffs_set_total(600 * 1024);
+    for (uint32_t i = 0; i < 4; i++) {
+        writeFile(sessionFile(i, "rx"), 20 * 1024);
+        writeFile(sessionFile(i, "tx"), 20 * 1024);
+    }
+    SessionRecorder& rec = newRecorder();
+
+    Tone rx(400.0f, 8000.0f);
+    Tone tx(1000.0f, 2000.0f);
+    rec.start(RATE);
+    recordFrames(rec, rx, tx, BATCH_FRAMES);
+    rec.stop();
+    waitPass(rec);
+
+    CHECK(!exists(sessionFile(0, "rx")) && !exists(sessionFile(0, "tx")));
+    CHECK(!exists(sessionFile(1, "rx")) && !exists(sessionFile(1, "tx")));
+    CHECK(exists(sessionFile(2, "rx")) && exists(sessionFile(3, "tx")));
+    CHECK(exists(sessionFile(4, "rx")) && exists(sessionFile(4, "tx")));
+    CHECK_EQ(rec.getStats().deleted, 2);
+    CHECK_EQ(rec.getStats().session, 4);
+}
+
+// ============================================================
+// AUDIO CALLBACK SIDE
+// ============================================================
+
+static void test_frames_only_queued_while_active() {
+    clearPartition();
+    host_spiffs_set_total(4 * 1024 * 1024);
+    SessionRecorder& rec = newRecorder();
+
+    int16_t frame[FRAME] = {0};
+    for (int i = 0; i < 200; i++) rec.record(SessionRecorder::Stream::Incoming, frame, FRAME);
+    waitPass(rec);
+    CHECK_EQ(rec.getStats().droppedFrames, 0);
+    CHECK_EQ(rec.getStats().sessions, 0);
+}
+
+static void test_full_ring_drops_frames() {
+    clearPartition();
+    host_spiffs_set_total(4 * 1024 * 1024);
+    SessionRecorder& rec = newRecorder();
+    rec.start(RATE);
+    waitPass(rec);
+
+    // Half a second of audio arrives while the task is stalled on flash
+    int16_t frame[FRAME] = {0};
+    for (int i = 0; i < 200; i++) rec.record(SessionRecorder::Stream::Outgoing, frame, FRAME);
+    CHECK(rec.getStats().droppedFrames > 0);
+
+    rec.stop();
+    waitPass(rec);
+}
+
+int main() {
+    RUN_TEST(test_session_files_are_block_aligned_adpcm_wav);
+    RUN_TEST(test_numbering_continues_after_reboot);
+    RUN_TEST(test_retention_deletes_oldest_sessions);
+    RUN_TEST(test_frames_only_queued_while_active);
+    RUN_TEST(test_full_ring_drops_frames);
+    clearPartition();
+    return HostTest::summary();
+}
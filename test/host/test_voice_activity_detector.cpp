@@ -0,0 +1,199 @@
+#include "HostTest.h"
+#include "Audio/VoiceActivityDetector.h"
+#include "esp_timer.h"
+#include <cmath>
+#include <vector>
+
+static constexpr uint32_t RATE = 16000;
+static constexpr size_t FRAME = AudioConfig::FRAME_SAMPLES_16K;
+
+// Frames of silence that make up the default 1000ms end timeout (7.5ms each, rounded up)
+static constexpr uint32_t END_FRAMES = 134;
+
+struct Source {
+    uint32_t seed = 1;
+    size_t n = 0;
+
+    // Background noise, uniform in +-amplitude
+    int16_t noise(int32_t amplitude) {
+        seed = seed * 1103515245 + 12345;
+        return static_cast<int16_t>(static_cast<int32_t>((seed >> 16) % (2 * amplitude + 1)) - amplitude);
+    }
+
+    // Voiced speech stand-in: a 200Hz tone over the background
+    int16_t voice(int32_t amplitude, int32_t background) {
+        float v = amplitude * sinf(2.0f * static_cast<float>(M_PI) * 200.0f * n++ / RATE);
+        return static_cast<int16_t>(v + noise(background));
+    }
+};
+
+static void feed(VoiceActivityDetector& vad, Source& src, uint32_t frames, int32_t speech, int32_t background,
+                 bool farEnd = false, size_t block = FRAME) {
+    std::vector<int16_t> audio(frames * FRAME);
+    for (int16_t& s : audio) s = speech ? src.voice(speech, background) : src.noise(background);
+    for (size_t pos = 0; pos < audio.size(); pos += block) {
+        size_t n = (audio.size() - pos < block) ? audio.size() - pos : block;
+        vad.process(&audio[pos], n, farEnd);
+    }
+}
+
+// Speech, then silence until one frame short of the timeout
+static void speakThenPause(VoiceActivityDetector& vad, Source& src) {
+    feed(vad, src, 40, 0, 30);
+    feed(vad, src, 60, 8000, 30);
+    CHECK(vad.isSpeech());
+    feed(vad, src, END_FRAMES - 1, 0, 30);
+    CHECK(!vad.isSpeech());
+}
+
+static void test_background_noise_is_not_speech() {
+    VoiceActivityDetector vad;
+    vad.reset(RATE);
+    Source src;
+    feed(vad, src, 400, 0, 300);
+
+    CHECK(!vad.isSpeech());
+    CHECK(!vad.takeEndOfSpeech(nullptr));
+    VoiceActivityDetector::Stats s = vad.getStats();
+    CHECK_EQ(s.frames, 400);
+    CHECK_EQ(s.speechFrames, 0);
+}
+
+static void test_end_of_speech_after_timeout() {
+    VoiceActivityDetector vad;
+    vad.reset(RATE);
+    Source src;
+
+    int64_t before = esp_timer_get_time();
+    speakThenPause(vad, src);
+    int64_t after = esp_timer_get_time();
+    CHECK(!vad.takeEndOfSpeech(nullptr));
+
+    feed(vad, src, 1, 0, 30);
+    int64_t lastSpeechUs = 0;
+    CHECK(vad.takeEndOfSpeech(&lastSpeechUs));
+    CHECK(lastSpeechUs >= before && lastSpeechUs <= after);
+
+    // One event per utterance, and silence alone does not raise another
+    CHECK(!vad.takeEndOfSpeech(nullptr));
+    feed(vad, src, 2 * END_FRAMES, 0, 30);
+    CHECK(!vad.takeEndOfSpeech(nullptr));
+
+    VoiceActivityDetector::Stats s = vad.getStats();
+    CHECK_EQ(s.endpoints, 1);
+    CHECK_EQ(s.speechFrames, 60 - 2);   // The onset frames are not counted
+}
+
+static void test_click_does_not_start_an_utterance() {
+    VoiceActivityDetector vad;
+    vad.reset(RATE);
+    Source src;
+    feed(vad, src, 40, 0, 30);
+
+    // Two loud frames are a tap on the case, not speech
+    feed(vad, src, 2, 12000, 30);
+    CHECK(!vad.isSpeech());
+    feed(vad, src, 2 * END_FRAMES, 0, 30);
+    CHECK(!vad.takeEndOfSpeech(nullptr));
+    CHECK_EQ(vad.getStats().speechFrames, 0);
+}
+
+static void test_far_end_audio_holds_the_hangover() {
+    VoiceActivityDetector vad;
+    vad.reset(RATE);
+    Source src;
+    speakThenPause(vad, src);
+
+    // The assistant starts replying: however long it talks, no endpoint
+    feed(vad, src, 4 * END_FRAMES, 0, 30, true);
+    CHECK(!vad.takeEndOfSpeech(nullptr));
+
+    // Once it stops, the full timeout runs again from there
+    feed(vad, src, END_FRAMES - 1, 0, 30);
+    CHECK(!vad.takeEndOfSpeech(nullptr));
+    feed(vad, src, 1, 0, 30);
+    CHECK(vad.takeEndOfSpeech(nullptr));
+}
+
+static void test_end_silence_is_configurable() {
+    VoiceActivityDetector vad;
+    vad.reset(RATE);
+    vad.setEndSilenceMs(300);
+    Source src;
+    feed(vad, src, 40, 0, 30);
+    feed(vad, src, 20, 8000, 30);
+
+    feed(vad, src, 39, 0, 30);   // 292.5ms
+    CHECK(!vad.takeEndOfSpeech(nullptr));
+    feed(vad, src, 1, 0, 30);    // 300ms
+    CHECK(vad.takeEndOfSpeech(nullptr));
+}
+
+static void test_floor_tracks_loud_background() {
+    // Speech ~12dB over a loud background counts at the default threshold
+    // and is ignored at a stricter one
+    const float thresholds[] = {VoiceActivityDetector::DEFAULT_THRESHOLD_DB, 20.0f};
+    for (float threshold : thresholds) {
+        VoiceActivityDetector vad;
+        vad.reset(RATE);
+        vad.setThresholdDb(threshold);
+        Source src;
+        feed(vad, src, 200, 0, 1500);
+        int32_t floorDb = vad.getStats().noiseFloorDb;
+        CHECK_NEAR(floorDb, 10.0f * log10f(1500.0f * 1500.0f / 3.0f), 2.0f);
+
+        feed(vad, src, 40, 4800, 1500);
+        bool detected = vad.getStats().speechFrames > 0;
+        CHECK(detected == (threshold < 12.0f));
+    }
+}
+
+static void test_narrowband_and_odd_blocks() {
+    VoiceActivityDetector vad;
+    vad.reset(8000);
+    Source src;
+
+    // 60-sample frames fed in 37-sample pieces; the endpoint timing is in
+    // frames of 7.5ms whatever the rate
+    std::vector<int16_t> audio;
+    for (uint32_t f = 0; f < 40; f++) {
+        for (size_t i = 0; i < 60; i++) audio.push_back(src.noise(30));
+    }
+    for (uint32_t f = 0; f < 60; f++) {
+        for (size_t i = 0; i < 60; i++) audio.push_back(src.voice(8000, 30));
+    }
+    for (uint32_t f = 0; f < END_FRAMES; f++) {
+        for (size_t i = 0; i < 60; i++) audio.push_back(src.noise(30));
+    }
+    for (size_t pos = 0; pos < audio.size(); pos += 37) {
+        size_t n = (audio.size() - pos < 37) ? audio.size() - pos : 37;
+        vad.process(&audio[pos], n, false);
+    }
+
+    CHECK_EQ(vad.getStats().frames, 40 + 60 + END_FRAMES);
+    CHECK(vad.takeEndOfSpeech(nullptr));
+}
+
+static void test_reset_drops_pending_event() {
+    VoiceActivityDetector vad;
+    vad.reset(RATE);
+    Source src;
+    speakThenPause(vad, src);
+    feed(vad, src, 1, 0, 30);
+
+    vad.reset(RATE);
+    CHECK(!vad.takeEndOfSpeech(nullptr));
+    CHECK_EQ(vad.getStats().endpoints, 0);
+}
+
+int main() {
+    RUN_TEST(test_background_noise_is_not_speech);
+    RUN_TEST(test_end_of_speech_after_timeout);
+    RUN_TEST(test_click_does_not_start_an_utterance);
+    RUN_TEST(test_far_end_audio_holds_the_hangover);
+    RUN_TEST(test_end_silence_is_configurable);
+    RUN_TEST(test_floor_tracks_loud_background);
+    RUN_TEST(test_narrowband_and_odd_blocks);
+    RUN_TEST(test_reset_drops_pending_event);
+    return HostTest::summary();
+}
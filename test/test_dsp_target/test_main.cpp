@@ -0,0 +1,57 @@
+/**
+ * DSP kernel variants on the device
+ *
+ *   pio test -e m5stack-cores3 -f test_dsp_target
+ *
+ * Compares Dsp (DspPie on the S3, DspXtensa on the ESP32) and DspXtensa
+ * against DspReference with the same checks the host suite runs, so the
+ * PIE assembly and the Xtensa build of the unrolled kernels are covered
+ * where they actually run. src/ is not built for tests, so the kernel
+ * sources are compiled here.
+ */
+#include <Arduino.h>
+#include <unity.h>
+#include "../DspVariantChecks.h"
+#include "../../src/Audio/DspKernels.cpp"
+#include "../../src/Audio/DspKernelsPie.cpp"
+
+template <class V>
+static void checkVariant() {
+    DspVariantChecks::Report r;
+    DspVariantChecks::checkAll<V>(r);
+    Serial.printf("%u checks, %u failed\n", r.checked, r.failures);
+    TEST_ASSERT_MESSAGE(r.checked > 10000, "too few checks ran");
+    TEST_ASSERT_EQUAL_UINT_MESSAGE(0, r.failures, r.first);
+}
+
+static void test_xtensa_matches_reference() {
+    checkVariant<DspXtensa>();
+}
+
+static void test_dsp_matches_reference() {
+    checkVariant<Dsp>();
+}
+
+#if defined(DSP_HAS_PIE)
+static void test_pie_matches_reference() {
+    checkVariant<DspPie>();
+}
+#endif
+
+void setUp() {}
+void tearDown() {}
+
+void setup() {
+    delay(2000);   // Let the monitor attach
+    UNITY_BEGIN();
+    RUN_TEST(test_xtensa_matches_reference);
+    RUN_TEST(test_dsp_matches_reference);
+#if defined(DSP_HAS_PIE)
+    RUN_TEST(test_pie_matches_reference);
+#else
+    TEST_MESSAGE("no PIE on this target: DspPie not checked");
+#endif
+    UNITY_END();
+}
+
+void loop() {}